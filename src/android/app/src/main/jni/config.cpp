@@ -161,6 +161,7 @@ void Config::ReadValues() {
     } else {
         Settings::values.frame_limit = 0;
     }
+    ReadSetting("Renderer", Settings::values.frame_pacing);
 
     ReadSetting("Renderer", Settings::values.render_3d);
     ReadSetting("Renderer", Settings::values.factor_3d);
@@ -202,6 +203,7 @@ void Config::ReadValues() {
     // Audio
     ReadSetting("Audio", Settings::values.audio_emulation);
     ReadSetting("Audio", Settings::values.enable_audio_stretching);
+    ReadSetting("Audio", Settings::values.parallel_dsp_sources);
     ReadSetting("Audio", Settings::values.volume);
     ReadSetting("Audio", Settings::values.output_type);
     ReadSetting("Audio", Settings::values.output_device);
@@ -268,6 +270,8 @@ void Config::ReadValues() {
     ReadSetting("Debugging", Settings::values.renderer_debug);
     ReadSetting("Debugging", Settings::values.use_gdbstub);
     ReadSetting("Debugging", Settings::values.gdbstub_port);
+    ReadSetting("Debugging", Settings::values.boot_snapshot_frame);
+    ReadSetting("Debugging", Settings::values.exefs_code_cache_size);
 
     for (const auto& service_module : Service::service_module_map) {
         bool use_lle = sdl2_config->GetBoolean("Debugging", "LLE\\" + service_module.name, false);
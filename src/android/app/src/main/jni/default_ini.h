@@ -144,6 +144,12 @@ vsync_enabled =
 # 0: Off, 1: On (default)
 use_frame_limit =
 
+# How frames are paced by the frame limiter. Low latency predicts the time the next frame takes to
+# emulate and delays its start, so that it reads input as late as possible and ends right before
+# it is due. Has no effect when the speed is not limited.
+# 0 (default): Sleep after each frame, 1: Low latency
+frame_pacing =
+
 # Limits the speed of the game to run no faster than this value as a percentage of target speed
 # 1 - 9999: Speed limit as a percentage of target game speed. 100 (default)
 frame_limit =
@@ -240,6 +246,11 @@ enable_dsp_lle_thread =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not to process HLE DSP sources on worker threads
+# Output is identical either way; this only moves work off the emulation thread.
+# 0 (default): No, 1: Yes
+parallel_dsp_sources =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
@@ -338,6 +349,16 @@ renderer_debug =
 use_gdbstub=false
 gdbstub_port=24689
 
+# Frame of a title at which a boot snapshot of it is saved. Later boots of the title start from the
+# snapshot instead of booting, mapping its memory copy-on-write where the host allows it.
+# 0 (default): Off, otherwise the frame number
+boot_snapshot_frame =
+
+# Maximum size in MiB of the cache of decompressed ExeFS .code sections, shared by the instances
+# booting titles on this host. The least recently stored sections are removed past it.
+# 0 (default): Off, otherwise the size in MiB
+exefs_code_cache_size =
+
 # To LLE a service module add "LLE\<module name>=true"
 
 [WebService]
@@ -4,9 +4,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
-#include <deque>
+#include <vector>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
 
 namespace AudioCore {
@@ -23,8 +28,104 @@ using StereoFrame16 = std::array<std::array<s16, 2>, samples_per_frame>;
 /// The DSP is quadraphonic internally.
 using QuadFrame32 = std::array<std::array<s32, 4>, samples_per_frame>;
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
+/**
+ * A variable length buffer of signed PCM16 stereo samples. Samples are stored contiguously so that
+ * they can be processed with vector instructions, and are consumed from the front by advancing a
+ * read position rather than by moving the remaining samples.
+ */
+class StereoBuffer16 {
+public:
+    using value_type = std::array<s16, 2>;
+
+    /// Number of free slots kept before the first sample for PushFront.
+    static constexpr std::size_t headroom = 2;
+
+    StereoBuffer16() = default;
+    explicit StereoBuffer16(std::size_t size)
+        : samples(headroom + size), read_position(headroom) {}
+
+    std::size_t size() const {
+        return samples.size() - read_position;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    void clear() {
+        samples.clear();
+        read_position = 0;
+    }
+
+    value_type* data() {
+        return samples.data() + read_position;
+    }
+
+    const value_type* data() const {
+        return samples.data() + read_position;
+    }
+
+    value_type& operator[](std::size_t index) {
+        return samples[read_position + index];
+    }
+
+    const value_type& operator[](std::size_t index) const {
+        return samples[read_position + index];
+    }
+
+    value_type* begin() {
+        return data();
+    }
+
+    value_type* end() {
+        return samples.data() + samples.size();
+    }
+
+    const value_type* begin() const {
+        return data();
+    }
+
+    const value_type* end() const {
+        return samples.data() + samples.size();
+    }
+
+    /// Inserts a sample before the first sample. The headroom reserved on construction and the
+    /// slots freed by DiscardFront are reused, so this usually does not move the samples.
+    void PushFront(const value_type& sample) {
+        if (read_position == 0) {
+            samples.insert(samples.begin(), headroom, value_type{});
+            read_position = headroom;
+        }
+        samples[--read_position] = sample;
+    }
+
+    /// Drops the first count samples of the buffer.
+    void DiscardFront(std::size_t count) {
+        read_position += std::min(count, size());
+        if (read_position == samples.size()) {
+            clear();
+        }
+    }
+
+private:
+    std::vector<value_type> samples;
+    std::size_t read_position = 0;
+
+    template <class Archive>
+    void save(Archive& ar, const unsigned int) const {
+        const std::vector<value_type> remaining(begin(), end());
+        ar << remaining;
+    }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int) {
+        ar >> samples;
+        read_position = 0;
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+    friend class boost::serialization::access;
+};
 
 constexpr std::size_t num_dsp_pipe = 8;
 enum class DspPipe {
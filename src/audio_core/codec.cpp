@@ -8,6 +8,7 @@
 #include <cstring>
 #include "audio_core/audio_types.h"
 #include "audio_core/codec.h"
+#include "audio_core/dsp_kernels.h"
 #include "common/assert.h"
 #include "common/common_types.h"
 
@@ -110,15 +111,9 @@ StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
     StereoBuffer16 ret(sample_count);
 
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            s16 sample;
-            std::memcpy(&sample, data + i * sizeof(s16), sizeof(s16));
-            ret[i].fill(sample);
-        }
+        Kernels::GetKernels().mono_to_stereo(data, ret.data(), sample_count);
     } else {
-        for (std::size_t i = 0; i < sample_count; ++i) {
-            std::memcpy(&ret[i], data + i * sizeof(s16) * 2, 2 * sizeof(s16));
-        }
+        std::memcpy(ret.data(), data, sample_count * sizeof(s16) * 2);
     }
 
     return ret;
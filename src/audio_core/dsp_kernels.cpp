@@ -0,0 +1,312 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "audio_core/dsp_kernels.h"
+#include "common/arch.h"
+#include "common/logging/log.h"
+
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include "common/x64/cpu_detect.h"
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+#if CITRA_ARCH(x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE4_1 __attribute__((target("sse4.1")))
+#else
+#define TARGET_SSE4_1
+#endif
+
+namespace AudioCore::Kernels {
+
+namespace {
+
+constexpr u64 scale_factor = 1 << 24;
+constexpr u64 scale_mask = scale_factor - 1;
+
+void MixIntoQuadGeneric(QuadFrame32& dest, const StereoFrame16& src,
+                        const std::array<float, 4>& gains) {
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        dest[samplei][0] += static_cast<s32>(gains[0] * src[samplei][0]);
+        dest[samplei][1] += static_cast<s32>(gains[1] * src[samplei][1]);
+        dest[samplei][2] += static_cast<s32>(gains[2] * src[samplei][0]);
+        dest[samplei][3] += static_cast<s32>(gains[3] * src[samplei][1]);
+    }
+}
+
+void InterpolateLinearGeneric(const std::array<s16, 2>* input, u64 fposition, u64 step,
+                              std::array<s16, 2>* output, std::size_t count) {
+    // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
+    for (std::size_t i = 0; i < count; i++, fposition += step) {
+        const auto& x0 = input[fposition / scale_factor];
+        const auto& x1 = input[fposition / scale_factor + 1];
+        const u64 fraction = fposition & scale_mask;
+
+        // This is a saturated subtraction. (Verified by black-box fuzzing.)
+        const s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
+        const s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
+
+        output[i] = {
+            static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
+            static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
+        };
+    }
+}
+
+void MonoToStereoGeneric(const u8* input, std::array<s16, 2>* output, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        s16 sample;
+        std::memcpy(&sample, input + i * sizeof(s16), sizeof(s16));
+        output[i].fill(sample);
+    }
+}
+
+void SimpleFilterGeneric(StereoFrame16& frame, s32 b0, s32 a1, std::array<s16, 2>& y1) {
+    for (auto& sample : frame) {
+        for (std::size_t i = 0; i < 2; i++) {
+            const s32 tmp = (b0 * sample[i] + a1 * y1[i]) >> 15;
+            sample[i] = static_cast<s16>(std::clamp(tmp, -32768, 32767));
+        }
+        y1 = sample;
+    }
+}
+
+void BiquadFilterGeneric(StereoFrame16& frame, const BiquadCoefficients& coeffs,
+                         BiquadHistory& history) {
+    for (auto& sample : frame) {
+        const std::array<s16, 2> x0 = sample;
+        for (std::size_t i = 0; i < 2; i++) {
+            const s32 tmp = (coeffs.b0 * x0[i] + coeffs.b1 * history.x1[i] +
+                             coeffs.b2 * history.x2[i] + coeffs.a1 * history.y1[i] +
+                             coeffs.a2 * history.y2[i]) >>
+                            14;
+            sample[i] = static_cast<s16>(std::clamp(tmp, -32768, 32767));
+        }
+        history.x2 = history.x1;
+        history.x1 = x0;
+        history.y2 = history.y1;
+        history.y1 = sample;
+    }
+}
+
+constexpr KernelSet generic_kernels{
+    .name = "Generic",
+    .mix_into_quad = MixIntoQuadGeneric,
+    .interpolate_linear = InterpolateLinearGeneric,
+    .mono_to_stereo = MonoToStereoGeneric,
+    .simple_filter = SimpleFilterGeneric,
+    .biquad_filter = BiquadFilterGeneric,
+};
+
+#if CITRA_ARCH(x86_64)
+
+/// Loads a stereo sample into the low 32 bits of a vector.
+__m128i LoadStereo(const std::array<s16, 2>& sample) {
+    s32 value;
+    std::memcpy(&value, sample.data(), sizeof(value));
+    return _mm_cvtsi32_si128(value);
+}
+
+/// Stores the low 32 bits of a vector as a stereo sample.
+void StoreStereo(std::array<s16, 2>& sample, __m128i value) {
+    const s32 raw = _mm_cvtsi128_si32(value);
+    std::memcpy(sample.data(), &raw, sizeof(raw));
+}
+
+void MixIntoQuadSSE2(QuadFrame32& dest, const StereoFrame16& src,
+                     const std::array<float, 4>& gains) {
+    const __m128 gain = _mm_loadu_ps(gains.data());
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        // [L, R] -> [L, R, L, R], sign-extended to 32 bits
+        __m128i sample = LoadStereo(src[samplei]);
+        sample = _mm_unpacklo_epi32(sample, sample);
+        sample = _mm_srai_epi32(_mm_unpacklo_epi16(sample, sample), 16);
+
+        // Same single precision multiply and truncating conversion as the generic version
+        const __m128 product = _mm_mul_ps(_mm_cvtepi32_ps(sample), gain);
+        auto* out = reinterpret_cast<__m128i*>(dest[samplei].data());
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), _mm_cvttps_epi32(product)));
+    }
+}
+
+void MonoToStereoSSE2(const u8* input, std::array<s16, 2>* output, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i samples =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * sizeof(s16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                         _mm_unpacklo_epi16(samples, samples));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 4),
+                         _mm_unpackhi_epi16(samples, samples));
+    }
+    MonoToStereoGeneric(input + i * sizeof(s16), output + i, count - i);
+}
+
+TARGET_SSE4_1 void InterpolateLinearSSE41(const std::array<s16, 2>* input, u64 fposition,
+                                          u64 step, std::array<s16, 2>* output,
+                                          std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2, fposition += 2 * step) {
+        const u64 fposition0 = fposition;
+        const u64 fposition1 = fposition + step;
+        const std::size_t n0 = static_cast<std::size_t>(fposition0 / scale_factor);
+        const std::size_t n1 = static_cast<std::size_t>(fposition1 / scale_factor);
+        const s32 fraction0 = static_cast<s32>(fposition0 & scale_mask);
+        const s32 fraction1 = static_cast<s32>(fposition1 & scale_mask);
+
+        // [L0, R0, L1, R1] of x0 and x1
+        const __m128i x0 =
+            _mm_insert_epi32(LoadStereo(input[n0]), _mm_cvtsi128_si32(LoadStereo(input[n1])), 1);
+        const __m128i x1 = _mm_insert_epi32(LoadStereo(input[n0 + 1]),
+                                            _mm_cvtsi128_si32(LoadStereo(input[n1 + 1])), 1);
+
+        // Saturated subtraction, then the 64-bit products fraction * delta. Only the low 16 bits
+        // of x0 + (product >> 24) survive the final narrowing, so a logical shift is sufficient.
+        const __m128i delta = _mm_cvtepi16_epi32(_mm_subs_epi16(x1, x0));
+        const __m128i fraction = _mm_setr_epi32(fraction0, fraction0, fraction1, fraction1);
+        const __m128i even = _mm_srli_epi64(_mm_mul_epi32(fraction, delta), 24);
+        const __m128i odd = _mm_srli_epi64(
+            _mm_mul_epi32(_mm_srli_epi64(fraction, 32), _mm_srli_epi64(delta, 32)), 24);
+        const __m128i offset = _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+
+        // Truncate to 16 bits: sign-extend the low half so the saturating pack is exact
+        __m128i result = _mm_add_epi32(_mm_cvtepi16_epi32(x0), offset);
+        result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(result, result));
+    }
+    InterpolateLinearGeneric(input, fposition, step, output + i, count - i);
+}
+
+TARGET_SSE4_1 void SimpleFilterSSE41(StereoFrame16& frame, s32 b0, s32 a1,
+                                     std::array<s16, 2>& y1) {
+    const __m128i b0_vec = _mm_set1_epi32(b0);
+    const __m128i a1_vec = _mm_set1_epi32(a1);
+    __m128i y1_vec = _mm_cvtepi16_epi32(LoadStereo(y1));
+    for (auto& sample : frame) {
+        const __m128i x0_vec = _mm_cvtepi16_epi32(LoadStereo(sample));
+        const __m128i sum =
+            _mm_add_epi32(_mm_mullo_epi32(b0_vec, x0_vec), _mm_mullo_epi32(a1_vec, y1_vec));
+        // The saturating pack performs the clamp
+        const __m128i y0 = _mm_packs_epi32(_mm_srai_epi32(sum, 15), _mm_setzero_si128());
+        StoreStereo(sample, y0);
+        y1_vec = _mm_cvtepi16_epi32(y0);
+    }
+    StoreStereo(y1, _mm_packs_epi32(y1_vec, y1_vec));
+}
+
+TARGET_SSE4_1 void BiquadFilterSSE41(StereoFrame16& frame, const BiquadCoefficients& coeffs,
+                                     BiquadHistory& history) {
+    // Lanes 0-1 hold x[n-k] and lanes 2-3 hold y[n-k], so each multiply covers two taps
+    const __m128i b0_vec = _mm_set1_epi32(coeffs.b0);
+    const __m128i tap1 = _mm_setr_epi32(coeffs.b1, coeffs.b1, coeffs.a1, coeffs.a1);
+    const __m128i tap2 = _mm_setr_epi32(coeffs.b2, coeffs.b2, coeffs.a2, coeffs.a2);
+    __m128i hist1 = _mm_cvtepi16_epi32(
+        _mm_unpacklo_epi32(LoadStereo(history.x1), LoadStereo(history.y1)));
+    __m128i hist2 = _mm_cvtepi16_epi32(
+        _mm_unpacklo_epi32(LoadStereo(history.x2), LoadStereo(history.y2)));
+    for (auto& sample : frame) {
+        const __m128i x0 = _mm_cvtepi16_epi32(LoadStereo(sample));
+        __m128i sum = _mm_add_epi32(_mm_mullo_epi32(tap1, hist1), _mm_mullo_epi32(tap2, hist2));
+        // Fold the y terms onto the x terms
+        sum = _mm_add_epi32(sum, _mm_unpackhi_epi64(sum, sum));
+        sum = _mm_add_epi32(sum, _mm_mullo_epi32(b0_vec, x0));
+        const __m128i y0 = _mm_packs_epi32(_mm_srai_epi32(sum, 14), _mm_setzero_si128());
+        StoreStereo(sample, y0);
+
+        hist2 = hist1;
+        hist1 = _mm_unpacklo_epi64(x0, _mm_cvtepi16_epi32(y0));
+    }
+    const __m128i packed1 = _mm_packs_epi32(hist1, hist1);
+    const __m128i packed2 = _mm_packs_epi32(hist2, hist2);
+    StoreStereo(history.x1, packed1);
+    StoreStereo(history.y1, _mm_srli_si128(packed1, 4));
+    StoreStereo(history.x2, packed2);
+    StoreStereo(history.y2, _mm_srli_si128(packed2, 4));
+}
+
+constexpr KernelSet sse2_kernels{
+    .name = "SSE2",
+    .mix_into_quad = MixIntoQuadSSE2,
+    .interpolate_linear = InterpolateLinearGeneric,
+    .mono_to_stereo = MonoToStereoSSE2,
+    .simple_filter = SimpleFilterGeneric,
+    .biquad_filter = BiquadFilterGeneric,
+};
+
+constexpr KernelSet sse41_kernels{
+    .name = "SSE4.1",
+    .mix_into_quad = MixIntoQuadSSE2,
+    .interpolate_linear = InterpolateLinearSSE41,
+    .mono_to_stereo = MonoToStereoSSE2,
+    .simple_filter = SimpleFilterSSE41,
+    .biquad_filter = BiquadFilterSSE41,
+};
+
+#elif CITRA_ARCH(arm64)
+
+void MixIntoQuadNEON(QuadFrame32& dest, const StereoFrame16& src,
+                     const std::array<float, 4>& gains) {
+    const float32x4_t gain = vld1q_f32(gains.data());
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        // [L, R] -> [L, R, L, R]
+        const int16x4_t sample = vreinterpret_s16_s32(
+            vld1_dup_s32(reinterpret_cast<const int32_t*>(src[samplei].data())));
+        // vcvtq_s32_f32 rounds towards zero, like the cast in the generic version
+        const float32x4_t product = vmulq_f32(vcvtq_f32_s32(vmovl_s16(sample)), gain);
+        s32* out = dest[samplei].data();
+        vst1q_s32(out, vaddq_s32(vld1q_s32(out), vcvtq_s32_f32(product)));
+    }
+}
+
+void MonoToStereoNEON(const u8* input, std::array<s16, 2>* output, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t samples = vreinterpretq_s16_u8(vld1q_u8(input + i * sizeof(s16)));
+        int16x8x2_t stereo;
+        stereo.val[0] = samples;
+        stereo.val[1] = samples;
+        vst2q_s16(reinterpret_cast<s16*>(output + i), stereo);
+    }
+    MonoToStereoGeneric(input + i * sizeof(s16), output + i, count - i);
+}
+
+constexpr KernelSet neon_kernels{
+    .name = "NEON",
+    .mix_into_quad = MixIntoQuadNEON,
+    .interpolate_linear = InterpolateLinearGeneric,
+    .mono_to_stereo = MonoToStereoNEON,
+    .simple_filter = SimpleFilterGeneric,
+    .biquad_filter = BiquadFilterGeneric,
+};
+
+#endif
+
+const KernelSet& SelectKernels() {
+#if CITRA_ARCH(x86_64)
+    const KernelSet& kernels = Common::GetCPUCaps().sse4_1 ? sse41_kernels : sse2_kernels;
+#elif CITRA_ARCH(arm64)
+    const KernelSet& kernels = neon_kernels;
+#else
+    const KernelSet& kernels = generic_kernels;
+#endif
+    LOG_INFO(Audio_DSP, "Using {} DSP kernels", kernels.name);
+    return kernels;
+}
+
+} // Anonymous namespace
+
+const KernelSet& GetGenericKernels() {
+    return generic_kernels;
+}
+
+const KernelSet& GetKernels() {
+    static const KernelSet& kernels = SelectKernels();
+    return kernels;
+}
+
+} // namespace AudioCore::Kernels
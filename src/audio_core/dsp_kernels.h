@@ -0,0 +1,67 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "audio_core/audio_types.h"
+#include "common/common_types.h"
+
+namespace AudioCore::Kernels {
+
+/// Coefficients of the second-order filter, see SourceConfiguration::Configuration::BiquadFilter.
+struct BiquadCoefficients {
+    s32 a1, a2, b0, b1, b2;
+};
+
+/// History of the second-order filter.
+struct BiquadHistory {
+    std::array<s16, 2> x1; ///< x[n-1]
+    std::array<s16, 2> x2; ///< x[n-2]
+    std::array<s16, 2> y1; ///< y[n-1]
+    std::array<s16, 2> y2; ///< y[n-2]
+};
+
+/**
+ * The inner loops of the HLE DSP. The generic implementation defines the exact output of each
+ * routine; implementations using vector instructions must be bit-exact with it.
+ */
+struct KernelSet {
+    /// Name of the implementation, for logging and benchmarks.
+    const char* name;
+
+    /**
+     * Mixes a stereo frame into a quadraphonic frame. Channels 0 and 2 of dest receive the left
+     * channel of src and channels 1 and 3 the right channel, each scaled by the matching gain.
+     */
+    void (*mix_into_quad)(QuadFrame32& dest, const StereoFrame16& src,
+                          const std::array<float, 4>& gains);
+
+    /**
+     * Linearly interpolates count stereo samples. Output sample i lies between input[n] and
+     * input[n + 1], where n and the fraction between them are given by fposition + i * step in
+     * fixed point with 24 fractional bits. The caller guarantees that input[n + 1] is valid.
+     */
+    void (*interpolate_linear)(const std::array<s16, 2>* input, u64 fposition, u64 step,
+                               std::array<s16, 2>* output, std::size_t count);
+
+    /// Converts count (possibly unaligned) mono PCM16 samples to stereo.
+    void (*mono_to_stereo)(const u8* input, std::array<s16, 2>* output, std::size_t count);
+
+    /// Applies y[n] = (b0 * x[n] + a1 * y[n-1]) >> 15 in-place. y1 holds y[n-1].
+    void (*simple_filter)(StereoFrame16& frame, s32 b0, s32 a1, std::array<s16, 2>& y1);
+
+    /// Applies the normalised second-order filter in-place.
+    void (*biquad_filter)(StereoFrame16& frame, const BiquadCoefficients& coeffs,
+                          BiquadHistory& history);
+};
+
+/// Returns the portable implementation of the kernels.
+const KernelSet& GetGenericKernels();
+
+/// Returns the fastest implementation of the kernels supported by the host CPU.
+const KernelSet& GetKernels();
+
+} // namespace AudioCore::Kernels
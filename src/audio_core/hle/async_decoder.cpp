@@ -0,0 +1,57 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "audio_core/hle/async_decoder.h"
+
+namespace AudioCore::HLE {
+
+AsyncDecoder::AsyncDecoder(std::unique_ptr<DecoderBase> decoder_)
+    : decoder(std::move(decoder_)), worker(1, "AACDecoder") {}
+
+AsyncDecoder::~AsyncDecoder() = default;
+
+std::optional<BinaryMessage> AsyncDecoder::ProcessRequest(const BinaryMessage& request) {
+    // The decoder is stateful, so wait for earlier requests to keep them ordered
+    worker.WaitForRequests();
+    return decoder->ProcessRequest(request);
+}
+
+bool AsyncDecoder::IsValid() const {
+    return decoder->IsValid();
+}
+
+void AsyncDecoder::QueueRequest(const BinaryMessage& request) {
+    {
+        std::scoped_lock lock{response_mutex};
+        num_pending++;
+    }
+    worker.QueueWork([this, request] {
+        auto response = decoder->ProcessRequest(request);
+        std::scoped_lock lock{response_mutex};
+        responses.push_back(std::move(response));
+    });
+}
+
+bool AsyncDecoder::HasPendingRequests() const {
+    std::scoped_lock lock{response_mutex};
+    return num_pending != 0;
+}
+
+std::vector<BinaryMessage> AsyncDecoder::CollectResponses() {
+    worker.WaitForRequests();
+
+    std::scoped_lock lock{response_mutex};
+    std::vector<BinaryMessage> result;
+    result.reserve(responses.size());
+    for (auto& response : responses) {
+        if (response) {
+            result.push_back(*response);
+        }
+    }
+    responses.clear();
+    num_pending = 0;
+    return result;
+}
+
+} // namespace AudioCore::HLE
@@ -0,0 +1,53 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "audio_core/hle/decoder.h"
+#include "common/thread_worker.h"
+
+namespace AudioCore::HLE {
+
+/**
+ * Runs another decoder on a dedicated thread. Requests are processed in submission order as soon
+ * as they are queued, so by the time the emulated DSP is due to reply the data is usually already
+ * decoded.
+ */
+class AsyncDecoder final : public DecoderBase {
+public:
+    explicit AsyncDecoder(std::unique_ptr<DecoderBase> decoder);
+    ~AsyncDecoder() override;
+
+    /// Processes a request synchronously, after every queued request has completed.
+    std::optional<BinaryMessage> ProcessRequest(const BinaryMessage& request) override;
+    bool IsValid() const override;
+
+    /// Queues a request to be processed on the decoder thread.
+    void QueueRequest(const BinaryMessage& request);
+
+    /// Returns true if any queued request has not been collected yet.
+    bool HasPendingRequests() const;
+
+    /**
+     * Waits for every queued request to complete and returns their responses in submission order.
+     * Requests that produced no response are skipped.
+     */
+    std::vector<BinaryMessage> CollectResponses();
+
+private:
+    std::unique_ptr<DecoderBase> decoder;
+
+    mutable std::mutex response_mutex;
+    std::vector<std::optional<BinaryMessage>> responses;
+    std::size_t num_pending = 0;
+
+    // Declared last so that the thread is joined before the state it uses is destroyed.
+    Common::ThreadWorker worker;
+};
+
+} // namespace AudioCore::HLE
@@ -39,11 +39,11 @@ void SourceFilters::ProcessFrame(StereoFrame16& frame) {
         return;
 
     if (simple_filter_enabled) {
-        FilterFrame(frame, simple_filter);
+        simple_filter.ProcessFrame(frame);
     }
 
     if (biquad_filter_enabled) {
-        FilterFrame(frame, biquad_filter);
+        biquad_filter.ProcessFrame(frame);
     }
 }
 
@@ -63,53 +63,31 @@ void SourceFilters::SimpleFilter::Configure(
     b0 = config.b0;
 }
 
-std::array<s16, 2> SourceFilters::SimpleFilter::ProcessSample(const std::array<s16, 2>& x0) {
-    std::array<s16, 2> y0;
-    for (std::size_t i = 0; i < 2; i++) {
-        const s32 tmp = (b0 * x0[i] + a1 * y1[i]) >> 15;
-        y0[i] = std::clamp(tmp, -32768, 32767);
-    }
-
-    y1 = y0;
-
-    return y0;
+void SourceFilters::SimpleFilter::ProcessFrame(StereoFrame16& frame) {
+    Kernels::GetKernels().simple_filter(frame, b0, a1, y1);
 }
 
 // BiquadFilter
 
 void SourceFilters::BiquadFilter::Reset() {
-    x1.fill(0);
-    x2.fill(0);
-    y1.fill(0);
-    y2.fill(0);
+    history = {};
     // Configure as passthrough.
-    a1 = a2 = b1 = b2 = 0;
-    b0 = 1 << 14;
+    coeffs.a1 = coeffs.a2 = coeffs.b1 = coeffs.b2 = 0;
+    coeffs.b0 = 1 << 14;
 }
 
 void SourceFilters::BiquadFilter::Configure(
     SourceConfiguration::Configuration::BiquadFilter config) {
 
-    a1 = config.a1;
-    a2 = config.a2;
-    b0 = config.b0;
-    b1 = config.b1;
-    b2 = config.b2;
+    coeffs.a1 = config.a1;
+    coeffs.a2 = config.a2;
+    coeffs.b0 = config.b0;
+    coeffs.b1 = config.b1;
+    coeffs.b2 = config.b2;
 }
 
-std::array<s16, 2> SourceFilters::BiquadFilter::ProcessSample(const std::array<s16, 2>& x0) {
-    std::array<s16, 2> y0;
-    for (std::size_t i = 0; i < 2; i++) {
-        const s32 tmp = (b0 * x0[i] + b1 * x1[i] + b2 * x2[i] + a1 * y1[i] + a2 * y2[i]) >> 14;
-        y0[i] = std::clamp(tmp, -32768, 32767);
-    }
-
-    x2 = x1;
-    x1 = x0;
-    y2 = y1;
-    y1 = y0;
-
-    return y0;
+void SourceFilters::BiquadFilter::ProcessFrame(StereoFrame16& frame) {
+    Kernels::GetKernels().biquad_filter(frame, coeffs, history);
 }
 
 } // namespace AudioCore::HLE
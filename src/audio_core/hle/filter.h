@@ -6,6 +6,7 @@
 
 #include <array>
 #include "audio_core/audio_types.h"
+#include "audio_core/dsp_kernels.h"
 #include "audio_core/hle/shared_memory.h"
 #include "common/common_types.h"
 
@@ -67,11 +68,10 @@ private:
         void Configure(SourceConfiguration::Configuration::SimpleFilter config);
 
         /**
-         * Processes a single stereo PCM16 sample.
-         * @param x0 Input sample
-         * @return Output sample
+         * Processes a frame in-place.
+         * @param frame Audio samples to process. Modified in-place.
          */
-        std::array<s16, 2> ProcessSample(const std::array<s16, 2>& x0);
+        void ProcessFrame(StereoFrame16& frame);
 
     private:
         // Configuration
@@ -95,20 +95,16 @@ private:
         void Configure(SourceConfiguration::Configuration::BiquadFilter config);
 
         /**
-         * Processes a single stereo PCM16 sample.
-         * @param x0 Input sample
-         * @return Output sample
+         * Processes a frame in-place.
+         * @param frame Audio samples to process. Modified in-place.
          */
-        std::array<s16, 2> ProcessSample(const std::array<s16, 2>& x0);
+        void ProcessFrame(StereoFrame16& frame);
 
     private:
         // Configuration
-        s32 a1, a2, b0, b1, b2;
+        Kernels::BiquadCoefficients coeffs;
         // Internal state
-        std::array<s16, 2> x1;
-        std::array<s16, 2> x2;
-        std::array<s16, 2> y1;
-        std::array<s16, 2> y2;
+        Kernels::BiquadHistory history;
     } biquad_filter;
 };
 
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <thread>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -15,6 +17,7 @@
 #elif ANDROID
 #include "audio_core/hle/mediandk_decoder.h"
 #endif
+#include "audio_core/hle/async_decoder.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/decoder.h"
 #include "audio_core/hle/fdk_decoder.h"
@@ -28,6 +31,8 @@
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 
@@ -76,11 +81,13 @@ private:
     void ResetPipes();
     void WriteU16(DspPipe pipe_number, u16 value);
     void AudioPipeWriteStructAddresses();
+    void BinaryPipeWriteResponses();
 
     std::size_t CurrentRegionIndex() const;
     HLE::SharedMemory& ReadRegion();
     HLE::SharedMemory& WriteRegion();
 
+    void TickSources(HLE::SharedMemory& read, HLE::SharedMemory& write);
     StereoFrame16 GenerateCurrentFrame();
     bool Tick();
     void AudioTickCallback(s64 cycles_late);
@@ -102,12 +109,23 @@ private:
     Core::Timing& core_timing;
     Core::TimingEventType* tick_event{};
 
-    std::unique_ptr<HLE::DecoderBase> decoder{};
+    std::unique_ptr<HLE::AsyncDecoder> decoder{};
+
+    /// Workers that tick sources in parallel, present while Settings::parallel_dsp_sources is set.
+    std::unique_ptr<Common::ThreadWorker> source_workers{};
+    std::size_t num_source_workers{};
 
     std::weak_ptr<DSP_DSP> dsp_dsp{};
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        // Requests still being decoded are not part of the state, so complete them first. The
+        // responses of the replaced state are dropped when loading.
+        if constexpr (Archive::is_saving::value) {
+            BinaryPipeWriteResponses();
+        } else {
+            decoder->CollectResponses();
+        }
         ar& dsp_state;
         ar& pipe_data;
         ar& dsp_memory.raw_memory;
@@ -151,18 +169,20 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory, Core::Timing&
         source.SetMemory(memory);
     }
 
+    std::unique_ptr<HLE::DecoderBase> backend;
     for (auto& factory : decoder_backends) {
-        decoder = factory(memory);
-        if (decoder && decoder->IsValid()) {
+        backend = factory(memory);
+        if (backend && backend->IsValid()) {
             break;
         }
     }
 
-    if (!decoder || !decoder->IsValid()) {
+    if (!backend || !backend->IsValid()) {
         LOG_WARNING(Audio_DSP,
                     "Unable to load any decoders, this could cause missing audio in some games");
-        decoder = std::make_unique<HLE::NullDecoder>();
+        backend = std::make_unique<HLE::NullDecoder>();
     }
+    decoder = std::make_unique<HLE::AsyncDecoder>(std::move(backend));
 
     tick_event =
         core_timing.RegisterEvent("AudioCore::DspHle::tick_event", [this](u64, s64 cycles_late) {
@@ -300,7 +320,6 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer)
         return;
     }
     case DspPipe::Binary: {
-        // TODO(B3N30): Make this async, and signal the interrupt
         HLE::BinaryMessage request{};
         if (sizeof(request) != buffer.size()) {
             LOG_CRITICAL(Audio_DSP, "got binary pipe with wrong size {}", buffer.size());
@@ -313,12 +332,8 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer)
             UNIMPLEMENTED();
             return;
         }
-        std::optional<HLE::BinaryMessage> response = decoder->ProcessRequest(request);
-        if (response) {
-            const HLE::BinaryMessage& value = *response;
-            pipe_data[static_cast<u32>(pipe_number)].resize(sizeof(value));
-            std::memcpy(pipe_data[static_cast<u32>(pipe_number)].data(), &value, sizeof(value));
-        }
+        // The response is written to the pipe on the next audio frame, as the DSP would.
+        decoder->QueueRequest(request);
         break;
     }
     default:
@@ -386,6 +401,18 @@ void DspHle::Impl::AudioPipeWriteStructAddresses() {
     }
 }
 
+void DspHle::Impl::BinaryPipeWriteResponses() {
+    if (!decoder->HasPendingRequests()) {
+        return;
+    }
+    // Like the synchronous path did, each response replaces whatever the application did not read.
+    std::vector<u8>& data = pipe_data[static_cast<u32>(DspPipe::Binary)];
+    for (const HLE::BinaryMessage& response : decoder->CollectResponses()) {
+        data.resize(sizeof(response));
+        std::memcpy(data.data(), &response, sizeof(response));
+    }
+}
+
 size_t DspHle::Impl::CurrentRegionIndex() const {
     // The region with the higher frame counter is chosen unless there is wraparound.
     // This function only returns a 0 or 1.
@@ -413,16 +440,48 @@ HLE::SharedMemory& DspHle::Impl::WriteRegion() {
     return CurrentRegionIndex() != 0 ? dsp_memory.region_0 : dsp_memory.region_1;
 }
 
+void DspHle::Impl::TickSources(HLE::SharedMemory& read, HLE::SharedMemory& write) {
+    const auto tick_range = [this, &read, &write](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            write.source_statuses.status[i] = sources[i].Tick(read.source_configurations.config[i],
+                                                              read.adpcm_coefficients.coeff[i]);
+        }
+    };
+
+    if (!Settings::values.parallel_dsp_sources.GetValue()) {
+        source_workers.reset();
+        tick_range(0, HLE::num_sources);
+        return;
+    }
+
+    if (!source_workers) {
+        // The emulation thread ticks a share of the sources itself, so a small pool is enough.
+        num_source_workers = std::clamp(std::thread::hardware_concurrency(), 2U, 4U) - 1;
+        source_workers = std::make_unique<Common::ThreadWorker>(num_source_workers, "DspSources");
+    }
+
+    // Every source owns its state and its status slot, so sources can be ticked in any order.
+    const std::size_t num_chunks = num_source_workers + 1;
+    const std::size_t chunk_size = (HLE::num_sources + num_chunks - 1) / num_chunks;
+    for (std::size_t begin = chunk_size; begin < HLE::num_sources; begin += chunk_size) {
+        const std::size_t end = std::min(begin + chunk_size, HLE::num_sources);
+        source_workers->QueueWork([&tick_range, begin, end] { tick_range(begin, end); });
+    }
+    tick_range(0, std::min(chunk_size, HLE::num_sources));
+    source_workers->WaitForRequests();
+}
+
 StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
     HLE::SharedMemory& read = ReadRegion();
     HLE::SharedMemory& write = WriteRegion();
 
     std::array<QuadFrame32, 3> intermediate_mixes = {};
 
-    // Generate intermediate mixes
+    TickSources(read, write);
+
+    // Generate intermediate mixes. This is done in source order so that the output does not
+    // depend on how the sources were ticked.
     for (std::size_t i = 0; i < HLE::num_sources; i++) {
-        write.source_statuses.status[i] =
-            sources[i].Tick(read.source_configurations.config[i], read.adpcm_coefficients.coeff[i]);
         for (std::size_t mix = 0; mix < 3; mix++) {
             sources[i].MixInto(intermediate_mixes[mix], mix);
         }
@@ -457,6 +516,8 @@ bool DspHle::Impl::Tick() {
 }
 
 void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
+    BinaryPipeWriteResponses();
+
     if (Tick()) {
         // TODO(merry): Signal all the other interrupts as appropriate.
         if (auto service = dsp_dsp.lock()) {
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include "audio_core/codec.h"
+#include "audio_core/dsp_kernels.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/source.h"
 #include "audio_core/interpolate.h"
@@ -29,14 +30,8 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
     if (!state.enabled)
         return;
 
-    const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
-    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
-        // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
-        dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
-        dest[samplei][1] += static_cast<s32>(gains[1] * current_frame[samplei][1]);
-        dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
-        dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
-    }
+    // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
+    Kernels::GetKernels().mix_into_quad(dest, current_frame, state.gain.at(intermediate_mix_id));
 }
 
 void Source::Reset() {
@@ -224,9 +219,7 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
                 if (state.current_buffer.size() < state.current_sample_number) {
                     state.current_sample_number = 0;
                 } else {
-                    state.current_buffer.erase(
-                        state.current_buffer.begin(),
-                        std::next(state.current_buffer.begin(), state.current_sample_number));
+                    state.current_buffer.DiscardFront(state.current_sample_number);
                 }
             }
         }
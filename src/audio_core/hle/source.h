@@ -7,7 +7,6 @@
 #include <array>
 #include <vector>
 #include <boost/serialization/array.hpp>
-#include <boost/serialization/deque.hpp>
 #include <boost/serialization/priority_queue.hpp>
 #include <boost/serialization/vector.hpp>
 #include <queue>
@@ -138,7 +137,7 @@ private:
         u32 current_sample_number = 0;
         u32 next_sample_number = 0;
         PAddr current_buffer_physical_address = 0;
-        AudioInterp::StereoBuffer16 current_buffer = {};
+        StereoBuffer16 current_buffer = {};
 
         // buffer_id state
 
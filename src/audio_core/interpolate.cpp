@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include "audio_core/dsp_kernels.h"
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
@@ -11,10 +12,10 @@ namespace AudioCore::AudioInterp {
 // Calculations are done in fixed point with 24 fractional bits.
 // (This is not verified. This was chosen for minimal error.)
 constexpr u64 scale_factor = 1 << 24;
-constexpr u64 scale_mask = scale_factor - 1;
 
 /// Here we step over the input in steps of rate, until we consume all of the input.
-/// Three adjacent samples are passed to fn each step.
+/// fn is called once with the number of output samples to produce; output sample i is computed
+/// from input samples n and n + 1, where n is the integer part of fposition + i * step.
 template <typename Function>
 static void StepOverSamples(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
                             std::size_t& outputi, Function fn) {
@@ -23,54 +24,58 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
     if (input.empty())
         return;
 
-    input.insert(input.begin(), {state.xn2, state.xn1});
+    // The two historical samples precede the input. StereoBuffer16 keeps headroom for these, so
+    // the input is not moved.
+    input.PushFront(state.xn1);
+    input.PushFront(state.xn2);
 
     const u64 step_size = static_cast<u64>(rate * scale_factor);
-    u64 fposition = state.fposition;
-    std::size_t inputi = 0;
-
-    while (outputi < output.size()) {
-        inputi = static_cast<std::size_t>(fposition / scale_factor);
-
-        if (inputi + 2 >= input.size()) {
-            inputi = input.size() - 2;
-            break;
-        }
+    const u64 fposition = state.fposition;
+    const std::size_t remaining = output.size() - outputi;
+
+    // Number of output samples for which the sample after the next one is still available
+    const u64 end_position = static_cast<u64>(input.size() - 2) * scale_factor;
+    u64 available = 0;
+    if (fposition < end_position) {
+        available = step_size == 0 ? remaining
+                                   : (end_position - fposition + step_size - 1) / step_size;
+    }
+    const std::size_t count = static_cast<std::size_t>(std::min<u64>(available, remaining));
 
-        u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+    fn(input.data(), fposition, step_size, output.data() + outputi, count);
+    outputi += count;
 
-        fposition += step_size;
+    std::size_t inputi = 0;
+    if (count < remaining) {
+        // Ran out of input
+        inputi = input.size() - 2;
+    } else if (count != 0) {
+        // Filled the output, continue from the last sample used
+        inputi = static_cast<std::size_t>((fposition + (count - 1) * step_size) / scale_factor);
     }
 
     state.xn2 = input[inputi];
     state.xn1 = input[inputi + 1];
-    state.fposition = fposition - inputi * scale_factor;
+    state.fposition = fposition + count * step_size - inputi * scale_factor;
 
-    input.erase(input.begin(), std::next(input.begin(), inputi + 2));
+    input.DiscardFront(inputi + 2);
 }
 
 void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
           std::size_t& outputi) {
-    StepOverSamples(
-        state, input, rate, output, outputi,
-        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; });
+    StepOverSamples(state, input, rate, output, outputi,
+                    [](const std::array<s16, 2>* in, u64 fposition, u64 step,
+                       std::array<s16, 2>* out, std::size_t count) {
+                        for (std::size_t i = 0; i < count; i++, fposition += step) {
+                            out[i] = in[fposition / scale_factor];
+                        }
+                    });
 }
 
 void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
             std::size_t& outputi) {
-    // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
     StepOverSamples(state, input, rate, output, outputi,
-                    [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
-                        // This is a saturated subtraction. (Verified by black-box fuzzing.)
-                        s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
-                        s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
-
-                        return std::array<s16, 2>{
-                            static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
-                            static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
-                        };
-                    });
+                    Kernels::GetKernels().interpolate_linear);
 }
 
 } // namespace AudioCore::AudioInterp
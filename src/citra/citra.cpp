@@ -184,7 +184,11 @@ static void InitializeLogging() {
 
     const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     FileUtil::CreateFullPath(log_dir);
-    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    if (Settings::values.binary_log.GetValue()) {
+        Log::AddBackend(std::make_unique<Log::BinaryFileBackend>(log_dir + BINARY_LOG_FILE));
+    } else {
+        Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -141,6 +141,12 @@ texture_filter =
 # 5 - 995: Speed limit as a percentage of target game speed. 0 for unthrottled. 100 (default)
 frame_limit =
 
+# How frames are paced by the frame limiter. Low latency predicts the time the next frame takes to
+# emulate and delays its start, so that it reads input as late as possible and ends right before
+# it is due. Has no effect when the speed is not limited.
+# 0 (default): Sleep after each frame, 1: Low latency
+frame_pacing =
+
 # Overrides the frame limiter to use frame_limit_alternate instead of frame_limit.
 # 0: Off (default), 1: On
 use_frame_limit_alternate =
@@ -251,6 +257,11 @@ enable_dsp_lle_thread =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not to process HLE DSP sources on worker threads
+# Output is identical either way; this only moves work off the emulation thread.
+# 0 (default): No, 1: Yes
+parallel_dsp_sources =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
@@ -333,6 +344,11 @@ camera_inner_flip =
 # Examples: *:Debug Kernel.SVC:Trace Service.*:Critical
 log_filter = *:Info
 
+# Whether to write the log file in a compact binary format, without formatting messages.
+# Convert it to text with citra-log-decoder.
+# 0 (default): No, 1: Yes
+binary_log =
+
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
@@ -341,6 +357,16 @@ record_frame_times =
 use_gdbstub=false
 gdbstub_port=24689
 
+# Frame of a title at which a boot snapshot of it is saved. Later boots of the title start from the
+# snapshot instead of booting, mapping its memory copy-on-write where the host allows it.
+# 0 (default): Off, otherwise the frame number
+boot_snapshot_frame =
+
+# Maximum size in MiB of the cache of decompressed ExeFS .code sections, shared by the instances
+# booting titles on this host. The least recently stored sections are removed past it.
+# 0 (default): Off, otherwise the size in MiB
+exefs_code_cache_size =
+
 # Whether to enable additional debugging information during emulation
 # 0 (default): Off, 1: On
 renderer_debug =
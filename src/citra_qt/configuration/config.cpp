@@ -274,6 +274,7 @@ void Config::ReadAudioValues() {
     ReadGlobalSetting(Settings::values.volume);
 
     if (global) {
+        ReadBasicSetting(Settings::values.parallel_dsp_sources);
         ReadBasicSetting(Settings::values.output_type);
         ReadBasicSetting(Settings::values.output_device);
         ReadBasicSetting(Settings::values.input_type);
@@ -482,6 +483,8 @@ void Config::ReadDebuggingValues() {
         qt_config->value(QStringLiteral("record_frame_times"), false).toBool();
     ReadBasicSetting(Settings::values.use_gdbstub);
     ReadBasicSetting(Settings::values.gdbstub_port);
+    ReadBasicSetting(Settings::values.boot_snapshot_frame);
+    ReadBasicSetting(Settings::values.exefs_code_cache_size);
     ReadBasicSetting(Settings::values.renderer_debug);
     ReadBasicSetting(Settings::values.dump_command_buffers);
 
@@ -528,6 +531,7 @@ void Config::ReadMiscellaneousValues() {
     qt_config->beginGroup(QStringLiteral("Miscellaneous"));
 
     ReadBasicSetting(Settings::values.log_filter);
+    ReadBasicSetting(Settings::values.binary_log);
 
     qt_config->endGroup();
 }
@@ -638,6 +642,7 @@ void Config::ReadRendererValues() {
     ReadGlobalSetting(Settings::values.use_vsync_new);
     ReadGlobalSetting(Settings::values.resolution_factor);
     ReadGlobalSetting(Settings::values.frame_limit);
+    ReadGlobalSetting(Settings::values.frame_pacing);
 
     ReadGlobalSetting(Settings::values.bg_red);
     ReadGlobalSetting(Settings::values.bg_green);
@@ -851,6 +856,7 @@ void Config::SaveAudioValues() {
     WriteGlobalSetting(Settings::values.volume);
 
     if (global) {
+        WriteBasicSetting(Settings::values.parallel_dsp_sources);
         WriteBasicSetting(Settings::values.output_type);
         WriteBasicSetting(Settings::values.output_device);
         WriteBasicSetting(Settings::values.input_type);
@@ -994,6 +1000,8 @@ void Config::SaveDebuggingValues() {
     qt_config->setValue(QStringLiteral("record_frame_times"), Settings::values.record_frame_times);
     WriteBasicSetting(Settings::values.use_gdbstub);
     WriteBasicSetting(Settings::values.gdbstub_port);
+    WriteBasicSetting(Settings::values.boot_snapshot_frame);
+    WriteBasicSetting(Settings::values.exefs_code_cache_size);
     WriteBasicSetting(Settings::values.renderer_debug);
 
     qt_config->beginGroup(QStringLiteral("LLE"));
@@ -1039,6 +1047,7 @@ void Config::SaveMiscellaneousValues() {
     qt_config->beginGroup(QStringLiteral("Miscellaneous"));
 
     WriteBasicSetting(Settings::values.log_filter);
+    WriteBasicSetting(Settings::values.binary_log);
 
     qt_config->endGroup();
 }
@@ -1117,6 +1126,7 @@ void Config::SaveRendererValues() {
     WriteGlobalSetting(Settings::values.use_vsync_new);
     WriteGlobalSetting(Settings::values.resolution_factor);
     WriteGlobalSetting(Settings::values.frame_limit);
+    WriteGlobalSetting(Settings::values.frame_pacing);
 
     WriteGlobalSetting(Settings::values.bg_red);
     WriteGlobalSetting(Settings::values.bg_green);
@@ -247,6 +247,8 @@ ConfigureSystem::ConfigureSystem(QWidget* parent)
     ui->combo_download_set->setCurrentIndex(0);    // set to Minimal
     ui->combo_download_region->setCurrentIndex(0); // set to the base region
 
+    // Game list loaders may be decrypting titles on other threads with the same key slots
+    auto key_slots_lock = HW::AES::LockKeySlots();
     HW::AES::InitKeys(true);
     bool keys_available = HW::AES::IsKeyXAvailable(HW::AES::KeySlotID::NCCHSecure1) &&
                           HW::AES::IsKeyXAvailable(HW::AES::KeySlotID::NCCHSecure2);
@@ -257,6 +259,7 @@ ConfigureSystem::ConfigureSystem(QWidget* parent)
             break;
         }
     }
+    key_slots_lock.unlock();
     if (keys_available) {
         ui->button_start_download->setEnabled(true);
         ui->combo_download_set->setEnabled(true);
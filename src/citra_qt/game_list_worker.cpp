@@ -17,7 +17,8 @@
 #include "common/file_util.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/fs/archive.h"
-#include "core/loader/loader.h"
+#include "core/loader/game_metadata_cache.h"
+#include "core/loader/smdh.h"
 
 namespace {
 bool HasSupportedFileExtension(const std::string& file_name) {
@@ -32,11 +33,11 @@ GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
 
 GameListWorker::~GameListWorker() = default;
 
-void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
-                                             GameListDir* parent_dir) {
-    const auto callback = [this, recursion, parent_dir](u64* num_entries_out,
-                                                        const std::string& directory,
-                                                        const std::string& virtual_name) -> bool {
+void GameListWorker::CollectGameFiles(const std::string& dir_path, unsigned int recursion,
+                                      std::vector<std::string>& file_paths) {
+    const auto callback = [this, recursion, &file_paths](u64* num_entries_out,
+                                                         const std::string& directory,
+                                                         const std::string& virtual_name) -> bool {
         if (stop_processing) {
             // Breaks the callback loop.
             return false;
@@ -45,88 +46,108 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader) {
-                return true;
-            }
+            file_paths.push_back(physical_name);
+        } else if (is_dir && recursion > 0) {
+            watch_list.append(QString::fromStdString(physical_name));
+            CollectGameFiles(physical_name, recursion - 1, file_paths);
+        }
 
-            bool executable = false;
-            const auto res = loader->IsExecutable(executable);
-            if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
-                return true;
-            }
+        return true;
+    };
 
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh;
-            // Look for an update icon if available
-            if (!(program_id & ~0x00040000FFFFFFFF)) {
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
-                if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
-                }
-            }
+    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+}
 
-            if (!Loader::IsValidSMDH(smdh)) {
-                // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
-            }
+void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
+                                             GameListDir* parent_dir) {
+    std::vector<std::string> file_paths;
+    CollectGameFiles(dir_path, recursion, file_paths);
+
+    // The files are only opened if they changed since they were cached, on several threads
+    const std::vector<Loader::GameMetadata> metadata =
+        metadata_cache.Get(file_paths, stop_processing);
+
+    // Look for update icons if available
+    std::vector<std::string> update_paths;
+    std::vector<std::size_t> update_indices;
+    for (std::size_t i = 0; i < metadata.size(); ++i) {
+        const u64 program_id = metadata[i].program_id;
+        if (metadata[i].file_type == Loader::FileType::Error || !metadata[i].is_executable ||
+            (program_id & ~0x00040000FFFFFFFF)) {
+            continue;
+        }
+        std::string update_path = Service::AM::GetTitleContentPath(
+            Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
+        if (FileUtil::Exists(update_path)) {
+            update_paths.push_back(std::move(update_path));
+            update_indices.push_back(i);
+        }
+    }
+    const std::vector<Loader::GameMetadata> update_metadata =
+        metadata_cache.Get(update_paths, stop_processing);
+    std::vector<const std::vector<u8>*> update_smdhs(metadata.size());
+    for (std::size_t i = 0; i < update_indices.size(); ++i) {
+        update_smdhs[update_indices[i]] = &update_metadata[i].smdh;
+    }
 
-            const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
-            if (Loader::IsValidSMDH(smdh)) {
-                if (system_title) {
-                    auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
-                    if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
-                        // Skip system titles without the visible flag.
-                        return true;
-                    }
-                }
-            } else if (UISettings::values.game_list_hide_no_icon || system_title) {
-                // Skip this invalid entry
-                return true;
-            }
+    for (std::size_t i = 0; i < metadata.size(); ++i) {
+        if (stop_processing) {
+            return;
+        }
 
-            auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
-
-            // The game list uses this as compatibility number for untested games
-            QString compatibility(QStringLiteral("99"));
-            if (it != compatibility_list.end())
-                compatibility = it->second.first;
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id),
-                    new GameListItemCompat(compatibility),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                },
-                parent_dir);
+        const std::string& physical_name = file_paths[i];
+        const Loader::GameMetadata& entry = metadata[i];
+        if (entry.file_type == Loader::FileType::Error || !entry.is_executable) {
+            continue;
+        }
 
-        } else if (is_dir && recursion > 0) {
-            watch_list.append(QString::fromStdString(physical_name));
-            AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir);
+        const u64 program_id = entry.program_id;
+        std::vector<u8> smdh;
+        if (update_smdhs[i] && Loader::IsValidSMDH(*update_smdhs[i])) {
+            smdh = *update_smdhs[i];
+        } else {
+            // Use the original smdh if there is no valid update smdh
+            smdh = entry.smdh;
         }
 
-        return true;
-    };
+        const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
+        if (Loader::IsValidSMDH(smdh)) {
+            if (system_title) {
+                auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
+                if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
+                    // Skip system titles without the visible flag.
+                    continue;
+                }
+            }
+        } else if (UISettings::values.game_list_hide_no_icon || system_title) {
+            // Skip this invalid entry
+            continue;
+        }
 
-    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+        auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
+
+        // The game list uses this as compatibility number for untested games
+        QString compatibility(QStringLiteral("99"));
+        if (it != compatibility_list.end())
+            compatibility = it->second.first;
+
+        emit EntryReady(
+            {
+                new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
+                                     entry.extdata_id),
+                new GameListItemCompat(compatibility),
+                new GameListItemRegion(smdh),
+                new GameListItem(
+                    QString::fromStdString(Loader::GetFileTypeString(entry.file_type))),
+                new GameListItemSize(FileUtil::GetSize(physical_name)),
+            },
+            parent_dir);
+    }
 }
 
 void GameListWorker::run() {
     stop_processing = false;
+    metadata_cache.Load();
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == QStringLiteral("INSTALLED")) {
             QString games_path =
@@ -163,6 +184,11 @@ void GameListWorker::run() {
         }
     }
 
+    // A cancelled scan hasn't looked up every file, whose entries would be dropped
+    if (!stop_processing) {
+        metadata_cache.Save();
+    }
+
     emit Finished(watch_list);
 }
 
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -14,6 +15,7 @@
 #include <QVector>
 #include "citra_qt/compatibility_list.h"
 #include "common/common_types.h"
+#include "core/loader/game_metadata_cache.h"
 
 class QStandardItem;
 
@@ -51,6 +53,10 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    /// Collects the files with supported extensions in a directory and adds its subdirectories to
+    /// the watch list.
+    void CollectGameFiles(const std::string& dir_path, unsigned int recursion,
+                          std::vector<std::string>& file_paths);
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir);
 
@@ -59,4 +65,7 @@ private:
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
+
+    /// The metadata of the listed files, so that only the files that changed are opened
+    Loader::GameMetadataCache metadata_cache;
 };
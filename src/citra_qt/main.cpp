@@ -152,7 +152,11 @@ static void InitializeLogging() {
 
     const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     FileUtil::CreateFullPath(log_dir);
-    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    if (Settings::values.binary_log.GetValue()) {
+        Log::AddBackend(std::make_unique<Log::BinaryFileBackend>(log_dir + BINARY_LOG_FILE));
+    } else {
+        Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -1695,13 +1699,17 @@ void GMainWindow::InstallCIA(QStringList filepaths) {
     progress_bar->setMaximum(INT_MAX);
 
     (void)QtConcurrent::run([&, filepaths] {
-        Service::AM::InstallStatus status;
         const auto cia_progress = [&](std::size_t written, std::size_t total) {
             emit UpdateProgress(written, total);
         };
+        std::vector<std::string> paths;
+        paths.reserve(filepaths.size());
         for (const auto& current_path : filepaths) {
-            status = Service::AM::InstallCIA(current_path.toStdString(), cia_progress);
-            emit CIAInstallReport(status, current_path);
+            paths.push_back(current_path.toStdString());
+        }
+        const auto statuses = Service::AM::InstallCIAs(paths, cia_progress);
+        for (std::size_t i = 0; i < statuses.size(); ++i) {
+            emit CIAInstallReport(statuses[i], filepaths[static_cast<int>(i)]);
         }
         emit CIAInstallFinished();
     });
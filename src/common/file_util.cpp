@@ -309,6 +309,16 @@ bool Rename(const std::string& srcFilename, const std::string& destFilename) {
     return false;
 }
 
+bool Replace(const std::string& srcFilename, const std::string& destFilename) {
+#if defined(_WIN32) || defined(ANDROID)
+    // Renaming does not replace an existing file
+    if (!Delete(destFilename)) {
+        return false;
+    }
+#endif
+    return Rename(srcFilename, destFilename);
+}
+
 bool Copy(const std::string& srcFilename, const std::string& destFilename) {
     LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
 #ifdef _WIN32
@@ -397,6 +407,26 @@ u64 GetSize(const std::string& filename) {
     return 0;
 }
 
+s64 GetModificationTime(const std::string& filename) {
+#ifdef ANDROID
+    // Modification times are not exposed through the storage access framework.
+    return 0;
+#else
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
+#else
+    if (stat(filename.c_str(), &buf) == 0)
+#endif
+    {
+        return static_cast<s64>(buf.st_mtime);
+    }
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+#endif
+}
+
 u64 GetSize(const int fd) {
     struct stat buf;
     if (fstat(fd, &buf) != 0) {
@@ -1137,6 +1167,19 @@ bool IOFile::Flush() {
     return m_good;
 }
 
+bool IOFile::Sync() {
+    if (!Flush() || 0 !=
+#ifdef _WIN32
+                        _commit(_fileno(m_file))
+#else
+                        fsync(fileno(m_file))
+#endif
+    )
+        m_good = false;
+
+    return m_good;
+}
+
 std::size_t IOFile::ReadImpl(void* data, std::size_t length, std::size_t data_size) {
     if (!IsOpen()) {
         m_good = false;
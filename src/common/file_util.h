@@ -105,6 +105,9 @@ private:
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(FILE* f);
 
+// Returns the last modification time of filename in seconds since the epoch, or 0 on failure
+[[nodiscard]] s64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -121,6 +124,11 @@ bool DeleteDir(const std::string& filename);
 // renames file srcFilename to destFilename, returns true on success
 bool Rename(const std::string& srcFilename, const std::string& destFilename);
 
+// Replaces destFilename with srcFilename, typically a complete temporary file written next to it,
+// returns true on success. Readers see either file whole, except on hosts that cannot rename over
+// an existing file, where destFilename is deleted first.
+bool Replace(const std::string& srcFilename, const std::string& destFilename);
+
 // copies file srcFilename to destFilename, returns true on success
 bool Copy(const std::string& srcFilename, const std::string& destFilename);
 
@@ -354,6 +362,8 @@ public:
     [[nodiscard]] u64 GetSize() const;
     bool Resize(u64 size);
     bool Flush();
+    // Flushes the file and waits until the storage device has its contents
+    bool Sync();
 
     // clear error state
     void Clear() {
@@ -0,0 +1,204 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#elif defined(__APPLE__)
+#include <string>
+#include <fmt/format.h>
+#endif
+#endif
+
+#include "common/assert.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+#if !defined(_WIN32) && !defined(MAP_NORESERVE)
+#define MAP_NORESERVE 0
+#endif
+
+namespace Common {
+
+namespace {
+
+#if !defined(_WIN32)
+/// Creates an anonymous shared memory object of the given size, returning -1 on failure.
+int CreateSharedMemory(std::size_t size) {
+    int fd = -1;
+#if defined(__linux__)
+    // Called through syscall so that this also works with libcs that do not wrap it, such as
+    // older Android versions
+    constexpr unsigned int MFD_CLOEXEC_FLAG = 1;
+    fd = static_cast<int>(syscall(SYS_memfd_create, "citra_memory", MFD_CLOEXEC_FLAG));
+#elif defined(__FreeBSD__)
+    fd = shm_open(SHM_ANON, O_RDWR | O_CREAT, 0600);
+#elif defined(__APPLE__)
+    const std::string name = fmt::format("/citra_memory_{}", getpid());
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd != -1) {
+        shm_unlink(name.c_str());
+    }
+#endif
+    if (fd == -1) {
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+#endif
+
+} // Anonymous namespace
+
+HostMemory::HostMemory(std::size_t size_) : size(size_) {
+#ifdef _WIN32
+    backing_base =
+        static_cast<u8*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+    fd = CreateSharedMemory(size);
+    if (fd != -1) {
+        void* pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (pointer != MAP_FAILED) {
+            backing_base = static_cast<u8*>(pointer);
+            return;
+        }
+        close(fd);
+        fd = -1;
+    }
+
+    LOG_WARNING(Common_Memory, "Shared memory is unavailable, fastmem will be disabled");
+    void* pointer =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    backing_base = pointer != MAP_FAILED ? static_cast<u8*>(pointer) : nullptr;
+#endif
+    ASSERT_MSG(backing_base, "Failed to allocate {} bytes of host memory", size);
+}
+
+HostMemory::~HostMemory() {
+#ifdef _WIN32
+    VirtualFree(backing_base, 0, MEM_RELEASE);
+#else
+    munmap(backing_base, size);
+    if (fd != -1) {
+        close(fd);
+    }
+#endif
+}
+
+bool HostMemory::MapFile(const std::string& path, u64 offset) {
+#ifdef _WIN32
+    return false;
+#else
+    if (offset % HostPageSize() != 0) {
+        return false;
+    }
+    const int file_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_fd == -1) {
+        return false;
+    }
+    // Accesses past the end of the file would raise SIGBUS
+    struct stat file_stat {};
+    if (fstat(file_fd, &file_stat) != 0 || static_cast<u64>(file_stat.st_size) < offset + size) {
+        close(file_fd);
+        return false;
+    }
+
+    void* pointer = mmap(backing_base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+                         file_fd, static_cast<off_t>(offset));
+    close(file_fd);
+    const bool mapped = pointer != MAP_FAILED;
+    if (!mapped) {
+        // The previous mapping may be gone, so replace it with zeroed memory
+        pointer = mmap(backing_base, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        ASSERT_MSG(pointer != MAP_FAILED, "Failed to restore {} bytes of host memory", size);
+    }
+    if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+    return mapped;
+#endif
+}
+
+std::size_t HostMemory::HostPageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+FastmemArena::FastmemArena(HostMemory& backing_, std::size_t size_)
+    : backing(backing_), size(size_) {
+#ifndef _WIN32
+    if (!backing.IsShareable()) {
+        return;
+    }
+    void* pointer = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                         -1, 0);
+    if (pointer == MAP_FAILED) {
+        LOG_WARNING(Common_Memory, "Failed to reserve {:#x} bytes for the fastmem arena", size);
+        return;
+    }
+    base = static_cast<u8*>(pointer);
+#endif
+}
+
+FastmemArena::~FastmemArena() {
+#ifndef _WIN32
+    if (base) {
+        munmap(base, size);
+    }
+#endif
+}
+
+bool FastmemArena::Map(std::size_t offset, const u8* backing_pointer, std::size_t length) {
+#ifdef _WIN32
+    return false;
+#else
+    if (!base || !backing.Contains(backing_pointer) ||
+        length > backing.Size() - (backing_pointer - backing.BackingBasePointer())) {
+        return false;
+    }
+    ASSERT(offset + length <= size);
+    const off_t backing_offset = static_cast<off_t>(backing_pointer - backing.BackingBasePointer());
+    void* pointer = mmap(base + offset, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                         backing.fd, backing_offset);
+    if (pointer == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Failed to map {:#x} bytes at arena offset {:#x}", length,
+                  offset);
+        Unmap(offset, length);
+        return false;
+    }
+    return true;
+#endif
+}
+
+void FastmemArena::Unmap(std::size_t offset, std::size_t length) {
+#ifndef _WIN32
+    if (!base) {
+        return;
+    }
+    ASSERT(offset + length <= size);
+    // Replacing the range with a fresh reservation drops any view of the backing memory
+    void* pointer = mmap(base + offset, length, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    ASSERT_MSG(pointer != MAP_FAILED, "Failed to unmap {:#x} bytes at arena offset {:#x}", length,
+               offset);
+#endif
+}
+
+} // namespace Common
@@ -0,0 +1,109 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Zero-initialized host memory that, where the host supports it, is backed by a shared memory
+ * object so that its pages can be mirrored at other addresses by a FastmemArena. On other hosts it
+ * is a plain allocation and IsShareable() returns false.
+ */
+class HostMemory {
+public:
+    explicit HostMemory(std::size_t size);
+    ~HostMemory();
+
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    u8* BackingBasePointer() {
+        return backing_base;
+    }
+
+    const u8* BackingBasePointer() const {
+        return backing_base;
+    }
+
+    std::size_t Size() const {
+        return size;
+    }
+
+    /// Returns true if pointer lies inside the backing memory.
+    bool Contains(const u8* pointer) const {
+        return pointer >= backing_base && pointer < backing_base + size;
+    }
+
+    /// Returns true if pages of this memory can be mapped into a FastmemArena.
+    bool IsShareable() const {
+        return fd != -1;
+    }
+
+    /**
+     * Replaces the contents of the memory with a copy-on-write view of the file, starting at
+     * offset, so that processes mapping the same file share the pages none of them wrote to. The
+     * memory is no longer shareable afterwards, as FastmemArenas would not see the private copies
+     * of written pages. Must be called before anything is written to the memory. Returns false if
+     * the host does not support this or the file is too small.
+     */
+    bool MapFile(const std::string& path, u64 offset);
+
+    /// Returns the page size of the host, which is the granularity of FastmemArena mappings.
+    static std::size_t HostPageSize();
+
+private:
+    friend class FastmemArena;
+
+    std::size_t size;
+    u8* backing_base = nullptr;
+    int fd = -1;
+};
+
+/**
+ * A reservation of host address space into which pages of a HostMemory are mirrored, so that an
+ * address inside the arena can be accessed with a single add to its base pointer. Anything not
+ * mapped faults on access.
+ */
+class FastmemArena {
+public:
+    FastmemArena(HostMemory& backing, std::size_t size);
+    ~FastmemArena();
+
+    FastmemArena(const FastmemArena&) = delete;
+    FastmemArena& operator=(const FastmemArena&) = delete;
+
+    /// Returns true if the address space was reserved.
+    bool IsValid() const {
+        return base != nullptr;
+    }
+
+    u8* BasePointer() {
+        return base;
+    }
+
+    const u8* BasePointer() const {
+        return base;
+    }
+
+    /**
+     * Mirrors length bytes of the backing memory starting at backing_pointer at offset in the
+     * arena. Returns false if the range is not inside the backing memory or could not be mapped.
+     */
+    bool Map(std::size_t offset, const u8* backing_pointer, std::size_t length);
+
+    /// Makes length bytes at offset in the arena inaccessible.
+    void Unmap(std::size_t offset, std::size_t length);
+
+private:
+    HostMemory& backing;
+    std::size_t size;
+    u8* base = nullptr;
+};
+
+} // namespace Common
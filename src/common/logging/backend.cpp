@@ -3,24 +3,29 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
 #include <thread>
 #include <vector>
+#include <fmt/args.h>
 #ifdef _WIN32
 #include <share.h>   // For _SH_DENYWR
 #include <windows.h> // For OutputDebugStringW
 #else
 #define _SH_DENYWR 0
 #endif
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
 #include "common/string_util.h"
-#include "common/threadsafe_queue.h"
 
 namespace Log {
 
@@ -28,8 +33,96 @@ Filter filter;
 void SetGlobalFilter(const Filter& f) {
     filter = f;
 }
+namespace {
+
+/// Layout of a record in a RecordBuffer, followed by the format string and the encoded arguments.
+struct RecordHeader {
+    u32 size; ///< Size of the record including this header, or of the padding
+    u32 format_size;
+    std::chrono::microseconds timestamp;
+    const char* filename;
+    const char* function;
+    unsigned int line_num;
+    Class log_class;
+    Level log_level;
+    u8 num_args;
+    bool is_padding; ///< Set if the rest of the buffer was skipped because a record did not fit
+};
+
+/**
+ * Ring buffer of the records logged by one thread, read by the logging thread. Records are kept
+ * contiguous: when one does not fit at the end of the buffer, the end is skipped with padding.
+ */
+class RecordBuffer {
+public:
+    static constexpr std::size_t capacity = 128 * 1024;
+
+    // The slack after the buffer holds the header of padding shorter than a header
+    RecordBuffer() : data(std::make_unique<u8[]>(capacity + sizeof(RecordHeader))) {}
+
+    /// Reserves size bytes for a record, or returns nullptr if the buffer is full. Writer only.
+    u8* Reserve(std::size_t size) {
+        const std::size_t offset = write_position % capacity;
+        const std::size_t padding = offset + size > capacity ? capacity - offset : 0;
+        if (write_position + padding + size - read_position.load(std::memory_order_acquire) >
+            capacity) {
+            return nullptr;
+        }
+        if (padding != 0) {
+            auto* header = new (data.get() + offset) RecordHeader{};
+            header->size = static_cast<u32>(padding);
+            header->is_padding = true;
+            write_position += padding;
+        }
+        reserved_size = size;
+        return data.get() + write_position % capacity;
+    }
+
+    /// Makes the reserved record visible to the reader. Writer only.
+    void Commit() {
+        write_position += reserved_size;
+        published_position.store(write_position, std::memory_order_seq_cst);
+    }
+
+    /// Returns the oldest unread record, or nullptr if there is none. Reader only.
+    const RecordHeader* Front() {
+        const u64 end = published_position.load(std::memory_order_seq_cst);
+        while (read_cursor != end) {
+            const auto* header =
+                reinterpret_cast<const RecordHeader*>(data.get() + read_cursor % capacity);
+            if (!header->is_padding) {
+                return header;
+            }
+            Pop(header);
+        }
+        return nullptr;
+    }
+
+    /// Discards a record returned by Front. Reader only.
+    void Pop(const RecordHeader* header) {
+        read_cursor += header->size;
+        read_position.store(read_cursor, std::memory_order_release);
+    }
+
+private:
+    std::unique_ptr<u8[]> data;
+
+    u64 write_position = 0;
+    std::size_t reserved_size = 0;
+    alignas(64) std::atomic<u64> published_position = 0;
+
+    alignas(64) u64 read_cursor = 0;
+    std::atomic<u64> read_position = 0;
+};
+
+} // Anonymous namespace
+
 /**
  * Static state as a singleton.
+ *
+ * Every thread that logs gets its own RecordBuffer. Call sites copy the format string and the
+ * arguments into it and formatting, if any backend needs it, happens on the logging thread, which
+ * merges the buffers by timestamp.
  */
 class Impl {
 public:
@@ -41,10 +134,65 @@ public:
     Impl(Impl const&) = delete;
     const Impl& operator=(Impl const&) = delete;
 
-    void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
-                   const char* function, std::string message) {
-        message_queue.Push(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+    u8* BeginRecord(Class log_class, Level log_level, const char* filename, unsigned int line_num,
+                    const char* function, const char* format, std::size_t num_args,
+                    std::size_t args_size) {
+        const std::size_t format_size = std::strlen(format);
+        const std::size_t size = Common::AlignUp(sizeof(RecordHeader) + format_size + args_size,
+                                                 alignof(RecordHeader));
+        if (size > MAX_RECORD_SIZE) {
+            return nullptr;
+        }
+
+        RecordBuffer& buffer = GetThreadBuffer();
+        u8* out = buffer.Reserve(size);
+        while (!out) {
+            // Wait for the logging thread to catch up instead of dropping the message
+            if (stop_requested.load(std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            WakeLoggingThread();
+            std::this_thread::yield();
+            out = buffer.Reserve(size);
+        }
+
+        using std::chrono::duration_cast;
+        using std::chrono::steady_clock;
+        auto* header = new (out) RecordHeader{};
+        header->size = static_cast<u32>(size);
+        header->format_size = static_cast<u32>(format_size);
+        header->timestamp =
+            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
+        header->filename = filename;
+        header->function = function;
+        header->line_num = line_num;
+        header->log_class = log_class;
+        header->log_level = log_level;
+        header->num_args = static_cast<u8>(num_args);
+        std::memcpy(out + sizeof(RecordHeader), format, format_size);
+        return out + sizeof(RecordHeader) + format_size;
+    }
+
+    void EndRecord() {
+        GetThreadBuffer().Commit();
+        if (logging_thread_idle.load(std::memory_order_seq_cst)) {
+            WakeLoggingThread();
+        }
+    }
+
+    void PushMessage(Class log_class, Level log_level, const char* filename,
+                     unsigned int line_num, const char* function, std::string message) {
+        // Messages formatted by the caller are stored as a record with a single argument
+        constexpr std::size_t MAX_MESSAGE_SIZE = MAX_RECORD_SIZE / 2;
+        if (message.size() > MAX_MESSAGE_SIZE) {
+            message.resize(MAX_MESSAGE_SIZE);
+        }
+        u8* out = BeginRecord(log_class, log_level, filename, line_num, function, "{}", 1,
+                              Detail::EncodedArgSize(message));
+        if (out) {
+            Detail::EncodeArg(out, message);
+            EndRecord();
+        }
     }
 
     void AddBackend(std::unique_ptr<Backend> backend) {
@@ -70,66 +218,220 @@ public:
     }
 
 private:
+    static constexpr std::size_t MAX_RECORD_SIZE = RecordBuffer::capacity / 4;
+
     Impl() {
         backend_thread = std::thread([&] {
-            Entry entry;
-            auto write_logs = [&](Entry& e) {
-                std::lock_guard lock{writing_mutex};
-                for (const auto& backend : backends) {
-                    backend->Write(e);
+            while (!stop_requested.load()) {
+                if (WriteRecords(std::chrono::microseconds::max()) == 0) {
+                    WaitForRecords();
                 }
-            };
-            while (true) {
-                entry = message_queue.PopWait();
-                if (entry.final_entry) {
-                    break;
-                }
-                write_logs(entry);
             }
 
-            // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a case
-            // where a system is repeatedly spamming logs even on close.
-            constexpr int MAX_LOGS_TO_WRITE = 100;
-            int logs_written = 0;
-            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(entry)) {
-                write_logs(entry);
-            }
+            // Write out what was logged before shutdown, but not whatever a system that keeps
+            // spamming logs adds after that.
+            WriteRecords(stop_time);
         });
     }
 
     ~Impl() {
-        Entry entry;
-        entry.final_entry = true;
-        message_queue.Push(entry);
+        stop_time = CurrentTime();
+        stop_requested.store(true);
+        WakeLoggingThread();
         backend_thread.join();
     }
 
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string message) const {
-        using std::chrono::duration_cast;
-        using std::chrono::steady_clock;
+    std::chrono::microseconds CurrentTime() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - time_origin);
+    }
 
-        Entry entry;
-        entry.timestamp =
-            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
-        entry.log_class = log_class;
-        entry.log_level = log_level;
-        entry.filename = filename;
-        entry.line_num = line_nr;
-        entry.function = function;
-        entry.message = std::move(message);
-
-        return entry;
+    RecordBuffer& GetThreadBuffer() {
+        thread_local const std::shared_ptr<RecordBuffer> buffer = [this] {
+            auto new_buffer = std::make_shared<RecordBuffer>();
+            std::scoped_lock lock{buffers_mutex};
+            buffers.push_back(new_buffer);
+            return new_buffer;
+        }();
+        return *buffer;
+    }
+
+    void WakeLoggingThread() {
+        { std::scoped_lock lock{wake_mutex}; }
+        wake_condition.notify_one();
+    }
+
+    /// Waits until a thread publishes a record. Logging thread only.
+    void WaitForRecords() {
+        std::unique_lock lock{wake_mutex};
+        logging_thread_idle.store(true, std::memory_order_seq_cst);
+        const bool has_records = std::any_of(active_buffers.begin(), active_buffers.end(),
+                                             [](const auto& buffer) { return buffer->Front(); });
+        if (!has_records && !stop_requested.load()) {
+            wake_condition.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        logging_thread_idle.store(false, std::memory_order_relaxed);
+    }
+
+    /// Writes every published record up to a timestamp, oldest first. Logging thread only.
+    std::size_t WriteRecords(std::chrono::microseconds until) {
+        active_buffers.clear();
+        {
+            std::scoped_lock lock{buffers_mutex};
+            // The buffers of threads that exited are only referenced here, drop them once read
+            std::erase_if(buffers, [](const auto& buffer) {
+                return buffer.use_count() == 1 && !buffer->Front();
+            });
+            active_buffers = buffers;
+        }
+
+        std::size_t records_written = 0;
+        while (true) {
+            RecordBuffer* oldest_buffer = nullptr;
+            const RecordHeader* oldest = nullptr;
+            for (const auto& buffer : active_buffers) {
+                const RecordHeader* header = buffer->Front();
+                if (header && (!oldest || header->timestamp < oldest->timestamp)) {
+                    oldest_buffer = buffer.get();
+                    oldest = header;
+                }
+            }
+            if (!oldest || oldest->timestamp > until) {
+                return records_written;
+            }
+            WriteRecord(*oldest);
+            oldest_buffer->Pop(oldest);
+            records_written++;
+        }
+    }
+
+    void WriteRecord(const RecordHeader& header) {
+        const u8* data = reinterpret_cast<const u8*>(&header) + sizeof(RecordHeader);
+        record.timestamp = header.timestamp;
+        record.log_class = header.log_class;
+        record.log_level = header.log_level;
+        record.filename = header.filename;
+        record.line_num = header.line_num;
+        record.function = header.function;
+        record.format = std::string_view(reinterpret_cast<const char*>(data), header.format_size);
+        data += header.format_size;
+        record.num_args = header.num_args;
+        for (std::size_t i = 0; i < record.num_args; i++) {
+            data = DecodeArg(data, record.args[i]);
+        }
+
+        std::lock_guard lock{writing_mutex};
+        std::optional<Entry> entry;
+        for (const auto& backend : backends) {
+            if (backend->IsBinary()) {
+                backend->WriteRecord(record);
+                continue;
+            }
+            if (!entry) {
+                entry = CreateEntry(record);
+            }
+            backend->Write(*entry);
+        }
     }
 
     std::mutex writing_mutex;
     std::thread backend_thread;
     std::vector<std::unique_ptr<Backend>> backends;
-    Common::MPSCQueue<Log::Entry> message_queue;
     Filter filter;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
+
+    std::mutex buffers_mutex;
+    std::vector<std::shared_ptr<RecordBuffer>> buffers;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_condition;
+    std::atomic<bool> logging_thread_idle = false;
+    std::atomic<bool> stop_requested = false;
+    std::chrono::microseconds stop_time{};
+
+    // Only used by the logging thread
+    std::vector<std::shared_ptr<RecordBuffer>> active_buffers;
+    Record record{};
 };
 
+const u8* DecodeArg(const u8* data, RecordArg& arg) {
+    arg.type = static_cast<ArgType>(data[0]);
+    const u8* value = data + 1;
+    switch (arg.type) {
+    case ArgType::String: {
+        u32 size;
+        std::memcpy(&size, value, sizeof(size));
+        arg.string = std::string_view(reinterpret_cast<const char*>(value + sizeof(size)), size);
+        return value + sizeof(size) + size;
+    }
+    case ArgType::Bool:
+        std::memcpy(&arg.b, value, sizeof(arg.b));
+        break;
+    case ArgType::Char:
+        std::memcpy(&arg.c, value, sizeof(arg.c));
+        break;
+    case ArgType::Float:
+        std::memcpy(&arg.f, value, sizeof(arg.f));
+        break;
+    case ArgType::Pointer:
+        std::memcpy(&arg.ptr, value, sizeof(arg.ptr));
+        break;
+    default:
+        std::memcpy(&arg.u, value, sizeof(arg.u));
+        break;
+    }
+    return value + sizeof(u64);
+}
+
+Entry CreateEntry(const Record& record) {
+    fmt::dynamic_format_arg_store<fmt::format_context> args;
+    for (std::size_t i = 0; i < record.num_args; i++) {
+        const RecordArg& arg = record.args[i];
+        switch (arg.type) {
+        case ArgType::Bool:
+            args.push_back(arg.b);
+            break;
+        case ArgType::Char:
+            args.push_back(arg.c);
+            break;
+        case ArgType::Signed:
+            args.push_back(arg.i);
+            break;
+        case ArgType::Unsigned:
+            args.push_back(arg.u);
+            break;
+        case ArgType::Float:
+            args.push_back(arg.f);
+            break;
+        case ArgType::Double:
+            args.push_back(arg.d);
+            break;
+        case ArgType::Pointer:
+            args.push_back(arg.ptr);
+            break;
+        case ArgType::String:
+            args.push_back(arg.string);
+            break;
+        }
+    }
+
+    Entry entry;
+    entry.timestamp = record.timestamp;
+    entry.log_class = record.log_class;
+    entry.log_level = record.log_level;
+    entry.filename = record.filename;
+    entry.line_num = record.line_num;
+    entry.function = record.function;
+    try {
+        entry.message = fmt::vformat(fmt::string_view(record.format.data(), record.format.size()),
+                                     args);
+    } catch (const fmt::format_error& e) {
+        entry.message =
+            fmt::format("Invalid log format string \"{}\": {}", record.format, e.what());
+    }
+    return entry;
+}
+
 void ConsoleBackend::Write(const Entry& entry) {
     PrintMessage(entry);
 }
@@ -168,6 +470,27 @@ void FileBackend::Write(const Entry& entry) {
     }
 }
 
+BinaryFileBackend::BinaryFileBackend(const std::string& filename) : writer(filename) {}
+
+void BinaryFileBackend::Write(const Entry& entry) {
+    Record record{};
+    record.timestamp = entry.timestamp;
+    record.log_class = entry.log_class;
+    record.log_level = entry.log_level;
+    record.filename = entry.filename;
+    record.line_num = entry.line_num;
+    record.function = entry.function.c_str();
+    record.format = "{}";
+    record.num_args = 1;
+    record.args[0].type = ArgType::String;
+    record.args[0].string = entry.message;
+    writer.Write(record);
+}
+
+void BinaryFileBackend::WriteRecord(const Record& record) {
+    writer.Write(record);
+}
+
 void DebuggerBackend::Write(const Entry& entry) {
 #ifdef _WIN32
     ::OutputDebugStringW(Common::UTF8ToUTF16W(FormatLogMessage(entry).append(1, '\n')).c_str());
@@ -299,7 +622,18 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
     auto& instance = Impl::Instance();
-    instance.PushEntry(log_class, log_level, filename, line_num, function,
-                       fmt::vformat(format, args));
+    instance.PushMessage(log_class, log_level, filename, line_num, function,
+                         fmt::vformat(format, args));
+}
+
+u8* BeginRecord(Class log_class, Level log_level, const char* filename, unsigned int line_num,
+                const char* function, const char* format, std::size_t num_args,
+                std::size_t args_size) {
+    return Impl::Instance().BeginRecord(log_class, log_level, filename, line_num, function, format,
+                                        num_args, args_size);
+}
+
+void EndRecord() {
+    Impl::Instance().EndRecord();
 }
 } // namespace Log
@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <memory>
 #include <string>
 #include <string_view>
 #include "common/file_util.h"
+#include "common/logging/binary_log.h"
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
 
@@ -35,6 +37,25 @@ struct Entry {
     Entry& operator=(const Entry& o) = default;
 };
 
+/**
+ * A log message whose arguments have not been formatted yet. String arguments and the format
+ * string reference memory owned by whoever produced the record.
+ */
+struct Record {
+    std::chrono::microseconds timestamp;
+    Class log_class;
+    Level log_level;
+    const char* filename;
+    unsigned int line_num;
+    const char* function;
+    std::string_view format;
+    std::size_t num_args;
+    std::array<RecordArg, max_record_args> args;
+};
+
+/// Formats the message of a record into a log entry.
+Entry CreateEntry(const Record& record);
+
 /**
  * Interface for logging backends. As loggers can be created and removed at runtime, this can be
  * used by a frontend for adding a custom logging backend as needed
@@ -48,6 +69,14 @@ public:
     virtual const char* GetName() const = 0;
     virtual void Write(const Entry& entry) = 0;
 
+    /// Returns true if the backend stores records without formatting them, see WriteRecord.
+    virtual bool IsBinary() const {
+        return false;
+    }
+
+    /// Writes a record before its message is formatted. Only called on binary backends.
+    virtual void WriteRecord(const Record& record) {}
+
 private:
     Filter filter;
 };
@@ -118,6 +147,33 @@ private:
     std::size_t bytes_written;
 };
 
+/**
+ * Backend that writes unformatted records to a file passed into the constructor, in the format
+ * described in binary_log.h. Use citra-log-decoder to turn the file into text.
+ */
+class BinaryFileBackend : public Backend {
+public:
+    explicit BinaryFileBackend(const std::string& filename);
+
+    static const char* Name() {
+        return "binary_file";
+    }
+
+    const char* GetName() const override {
+        return Name();
+    }
+
+    bool IsBinary() const override {
+        return true;
+    }
+
+    void Write(const Entry& entry) override;
+    void WriteRecord(const Record& record) override;
+
+private:
+    BinaryLogWriter writer;
+};
+
 /**
  * Backend that writes to Visual Studio's output window
  */
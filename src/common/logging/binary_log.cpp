@@ -0,0 +1,246 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#ifdef _WIN32
+#include <share.h> // For _SH_DENYWR
+#else
+#define _SH_DENYWR 0
+#endif
+#include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
+
+namespace Log {
+
+namespace {
+
+template <typename T>
+void Append(std::vector<u8>& buffer, const T& value) {
+    const std::size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+void AppendArg(std::vector<u8>& buffer, const RecordArg& arg) {
+    Append(buffer, static_cast<u8>(arg.type));
+    switch (arg.type) {
+    case ArgType::String:
+        Append(buffer, static_cast<u32>(arg.string.size()));
+        buffer.insert(buffer.end(), arg.string.begin(), arg.string.end());
+        return;
+    case ArgType::Bool:
+        Append(buffer, static_cast<u64>(arg.b));
+        return;
+    case ArgType::Char:
+        Append(buffer, static_cast<u64>(static_cast<u8>(arg.c)));
+        return;
+    case ArgType::Float: {
+        u64 value = 0;
+        std::memcpy(&value, &arg.f, sizeof(float));
+        Append(buffer, value);
+        return;
+    }
+    case ArgType::Pointer:
+        Append(buffer, static_cast<u64>(reinterpret_cast<std::uintptr_t>(arg.ptr)));
+        return;
+    default:
+        Append(buffer, arg.u);
+        return;
+    }
+}
+
+} // Anonymous namespace
+
+BinaryLogWriter::BinaryLogWriter(const std::string& filename) {
+    if (FileUtil::Exists(filename + ".old")) {
+        FileUtil::Delete(filename + ".old");
+    }
+    if (FileUtil::Exists(filename)) {
+        FileUtil::Rename(filename, filename + ".old");
+    }
+
+    file = FileUtil::IOFile(filename, "wb", _SH_DENYWR);
+    const BinaryLogHeader header{binary_log_magic, binary_log_version};
+    bytes_written += file.WriteObject(header);
+}
+
+void BinaryLogWriter::Write(const Record& record) {
+    // Same limit as the text log, in case something is spamming
+    constexpr std::size_t MAX_BYTES_WRITTEN = 50 * 1024L * 1024L;
+    if (!file.IsOpen() || bytes_written > MAX_BYTES_WRITTEN) {
+        return;
+    }
+
+    buffer.clear();
+    const u32 class_id = GetStringId(GetLogClassName(record.log_class));
+    const u32 filename_id = GetStringId(record.filename);
+    const u32 function_id = GetStringId(record.function);
+    const u32 format_id = GetStringId(record.format);
+
+    Append(buffer, BinaryLogChunk::Record);
+    Append(buffer, static_cast<s64>(record.timestamp.count()));
+    Append(buffer, class_id);
+    Append(buffer, static_cast<u8>(record.log_level));
+    Append(buffer, filename_id);
+    Append(buffer, static_cast<u32>(record.line_num));
+    Append(buffer, function_id);
+    Append(buffer, format_id);
+    Append(buffer, static_cast<u8>(record.num_args));
+    for (std::size_t i = 0; i < record.num_args; i++) {
+        AppendArg(buffer, record.args[i]);
+    }
+
+    bytes_written += file.WriteBytes(buffer.data(), buffer.size());
+    if (record.log_level >= Level::Error) {
+        file.Flush();
+    }
+}
+
+void BinaryLogWriter::Flush() {
+    file.Flush();
+}
+
+u32 BinaryLogWriter::GetStringId(std::string_view string) {
+    if (const auto it = string_ids.find(string); it != string_ids.end()) {
+        return it->second;
+    }
+
+    // Strings are written right before the record that first uses them
+    const u32 id = static_cast<u32>(string_ids.size());
+    string_ids.emplace(string, id);
+    Append(buffer, BinaryLogChunk::String);
+    Append(buffer, id);
+    Append(buffer, static_cast<u32>(string.size()));
+    buffer.insert(buffer.end(), string.begin(), string.end());
+    return id;
+}
+
+BinaryLogReader::BinaryLogReader(const std::string& filename) {
+    FileUtil::IOFile file(filename, "rb");
+    if (!file.IsOpen()) {
+        return;
+    }
+    data.resize(file.GetSize());
+    if (file.ReadBytes(data.data(), data.size()) != data.size()) {
+        return;
+    }
+
+    BinaryLogHeader header;
+    if (data.size() < sizeof(header)) {
+        return;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != binary_log_magic || header.version != binary_log_version) {
+        return;
+    }
+    offset = sizeof(header);
+    is_open = true;
+}
+
+bool BinaryLogReader::ReadString() {
+    u32 id, size;
+    if (data.size() - offset < sizeof(id) + sizeof(size)) {
+        return false;
+    }
+    std::memcpy(&id, data.data() + offset, sizeof(id));
+    std::memcpy(&size, data.data() + offset + sizeof(id), sizeof(size));
+    offset += sizeof(id) + sizeof(size);
+    if (id != strings.size() || data.size() - offset < size) {
+        return false;
+    }
+    strings.emplace_back(reinterpret_cast<const char*>(data.data() + offset), size);
+    offset += size;
+    return true;
+}
+
+bool BinaryLogReader::Read(Record& record) {
+    static const auto class_ids = [] {
+        std::unordered_map<std::string_view, Class> ids;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(Class::Count); i++) {
+            ids.emplace(GetLogClassName(static_cast<Class>(i)), static_cast<Class>(i));
+        }
+        return ids;
+    }();
+
+    const auto read = [this](auto& value) {
+        if (data.size() - offset < sizeof(value)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        return true;
+    };
+    const auto read_string = [this, &read](const std::string*& string) {
+        u32 id;
+        if (!read(id) || id >= strings.size()) {
+            return false;
+        }
+        string = &strings[id];
+        return true;
+    };
+
+    if (!is_open) {
+        return false;
+    }
+
+    BinaryLogChunk chunk;
+    while (read(chunk)) {
+        if (chunk == BinaryLogChunk::String) {
+            if (!ReadString()) {
+                return false;
+            }
+            continue;
+        }
+        if (chunk != BinaryLogChunk::Record) {
+            return false;
+        }
+
+        s64 timestamp;
+        u8 level, num_args;
+        u32 line_num;
+        const std::string *class_name, *filename, *function, *format;
+        if (!read(timestamp) || !read_string(class_name) || !read(level) ||
+            !read_string(filename) || !read(line_num) || !read_string(function) ||
+            !read_string(format) || !read(num_args) || num_args > max_record_args) {
+            return false;
+        }
+
+        const auto class_it = class_ids.find(*class_name);
+        record.timestamp = std::chrono::microseconds(timestamp);
+        record.log_class = class_it != class_ids.end() ? class_it->second : Class::Log;
+        record.log_level =
+            static_cast<Level>(std::min<u8>(level, static_cast<u8>(Level::Critical)));
+        record.filename = filename->c_str();
+        record.line_num = line_num;
+        record.function = function->c_str();
+        record.format = *format;
+        record.num_args = num_args;
+        for (std::size_t i = 0; i < num_args; i++) {
+            // Check that the argument fits in the file before decoding it
+            const std::size_t remaining = data.size() - offset;
+            if (remaining < 1 || data[offset] > static_cast<u8>(ArgType::String)) {
+                return false;
+            }
+            if (static_cast<ArgType>(data[offset]) == ArgType::String) {
+                u32 size;
+                if (remaining < 1 + sizeof(size)) {
+                    return false;
+                }
+                std::memcpy(&size, data.data() + offset + 1, sizeof(size));
+                if (remaining - 1 - sizeof(size) < size) {
+                    return false;
+                }
+            } else if (remaining < 1 + sizeof(u64)) {
+                return false;
+            }
+            offset = DecodeArg(data.data() + offset, record.args[i]) - data.data();
+        }
+        return true;
+    }
+    return false;
+}
+
+} // namespace Log
@@ -0,0 +1,101 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/swap.h"
+
+namespace Log {
+
+struct Record;
+
+/**
+ * Binary log files start with a BinaryLogHeader, followed by a stream of chunks that each start
+ * with a u8 BinaryLogChunk:
+ *  - String: u32 id, u32 size, then the string. Ids are assigned in order starting from 0.
+ *  - Record: s64 timestamp in microseconds, u32 class name id, u8 level, u32 filename id,
+ *    u32 line number, u32 function id, u32 format string id, u8 argument count, then the arguments
+ *    as encoded by Detail::EncodeArg.
+ * Every string is written once, before the first record that references it. All values are
+ * little-endian.
+ */
+struct BinaryLogHeader {
+    u32_le magic;
+    u32_le version;
+};
+
+enum class BinaryLogChunk : u8 {
+    String = 0,
+    Record = 1,
+};
+
+constexpr u32 binary_log_magic = 0x474F4C43; // "CLOG"
+constexpr u32 binary_log_version = 1;
+
+/// Writes records to a binary log file.
+class BinaryLogWriter {
+public:
+    explicit BinaryLogWriter(const std::string& filename);
+
+    bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    void Write(const Record& record);
+    void Flush();
+
+private:
+    u32 GetStringId(std::string_view string);
+
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view string) const {
+            return std::hash<std::string_view>{}(string);
+        }
+    };
+
+    FileUtil::IOFile file;
+    std::size_t bytes_written = 0;
+    std::vector<u8> buffer;
+    std::unordered_map<std::string, u32, StringHash, std::equal_to<>> string_ids;
+};
+
+/// Reads the records of a binary log file.
+class BinaryLogReader {
+public:
+    explicit BinaryLogReader(const std::string& filename);
+
+    /// Returns true if the file was opened and has a supported header.
+    bool IsOpen() const {
+        return is_open;
+    }
+
+    /**
+     * Reads the next record. Strings in the record remain valid until the next call. Returns false
+     * at the end of the file or if the rest of the file is corrupt.
+     */
+    bool Read(Record& record);
+
+    /// Returns true if every chunk of the file was read.
+    bool IsAtEnd() const {
+        return is_open && offset == data.size();
+    }
+
+private:
+    bool ReadString();
+
+    std::vector<u8> data;
+    std::size_t offset = 0;
+    bool is_open = false;
+    std::vector<std::string> strings;
+};
+
+} // namespace Log
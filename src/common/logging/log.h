@@ -8,6 +8,7 @@
 #include <array>
 #include "common/common_types.h"
 #include "common/logging/formatter.h"
+#include "common/logging/log_args.h"
 
 namespace Log {
 
@@ -163,12 +164,37 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
 
+/**
+ * Reserves a record on the calling thread's log buffer, to be formatted later on the logging
+ * thread. Returns where num_args arguments taking args_size bytes once encoded should be written,
+ * or nullptr if the record cannot be logged this way. On success, EndRecord must be called once
+ * the arguments are written.
+ */
+u8* BeginRecord(Class log_class, Level log_level, const char* filename, unsigned int line_num,
+                const char* function, const char* format, std::size_t num_args,
+                std::size_t args_size);
+
+/// Publishes the record reserved by the last call to BeginRecord on this thread.
+void EndRecord();
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
     if (!filter.CheckMessage(log_class, log_level))
         return;
 
+    // Copy the arguments and leave the formatting to the logging thread when possible
+    if constexpr ((Detail::IsDeferrable<Args>() && ...) && sizeof...(Args) <= max_record_args) {
+        const std::size_t args_size = (Detail::EncodedArgSize(args) + ... + 0);
+        u8* out = BeginRecord(log_class, log_level, filename, line_num, function, format,
+                              sizeof...(Args), args_size);
+        if (out) {
+            ((out = Detail::EncodeArg(out, args)), ...);
+            EndRecord();
+            return;
+        }
+    }
+
     FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
                       fmt::make_format_args(args...));
 }
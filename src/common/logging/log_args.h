@@ -0,0 +1,132 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "common/common_types.h"
+
+namespace Log {
+
+/// Type of an argument stored in a deferred log record.
+enum class ArgType : u8 {
+    Bool,
+    Char,
+    Signed,
+    Unsigned,
+    Float,
+    Double,
+    Pointer,
+    String,
+};
+
+/// Maximum number of arguments a deferred log record can hold.
+constexpr std::size_t max_record_args = 16;
+
+/// An argument of a deferred log record, decoded by DecodeArg.
+struct RecordArg {
+    ArgType type;
+    union {
+        bool b;
+        char c;
+        s64 i;
+        u64 u;
+        float f;
+        double d;
+        const void* ptr;
+    };
+    std::string_view string; ///< Only valid if type is ArgType::String
+};
+
+/**
+ * Decodes an argument written by Detail::EncodeArg. Strings are not copied, so arg references
+ * data. Returns a pointer past the encoded argument.
+ */
+const u8* DecodeArg(const u8* data, RecordArg& arg);
+
+namespace Detail {
+
+template <typename T>
+constexpr bool IsStringArg =
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*> || std::is_same_v<T, std::string> ||
+    std::is_same_v<T, std::string_view> ||
+    (std::is_array_v<T> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>);
+
+/**
+ * Returns true if values of type T can be copied into a log record and formatted later on the
+ * logging thread with the same result. Anything with a custom formatter is formatted immediately.
+ */
+template <typename T>
+constexpr bool IsDeferrable() {
+    using U = std::remove_cv_t<T>;
+    if constexpr (std::is_enum_v<U>) {
+        // Formatted as their underlying type, see formatter.h
+        return IsDeferrable<std::underlying_type_t<U>>();
+    } else if constexpr (IsStringArg<U>) {
+        return true;
+    } else if constexpr (std::is_integral_v<U>) {
+        return !std::is_same_v<U, wchar_t> && !std::is_same_v<U, char8_t> &&
+               !std::is_same_v<U, char16_t> && !std::is_same_v<U, char32_t>;
+    } else {
+        return std::is_same_v<U, float> || std::is_same_v<U, double> ||
+               std::is_same_v<U, void*> || std::is_same_v<U, const void*> ||
+               std::is_same_v<U, std::nullptr_t>;
+    }
+}
+
+template <typename T>
+std::size_t EncodedArgSize(const T& arg) {
+    if constexpr (IsStringArg<std::remove_cv_t<T>>) {
+        return 1 + sizeof(u32) + std::string_view(arg).size();
+    } else {
+        return 1 + sizeof(u64);
+    }
+}
+
+template <typename V>
+u8* EncodeValue(u8* out, ArgType type, V value) {
+    static_assert(sizeof(V) <= sizeof(u64));
+    out[0] = static_cast<u8>(type);
+    std::memcpy(out + 1, &value, sizeof(V));
+    return out + 1 + sizeof(u64);
+}
+
+/// Encodes a deferrable argument to out, returning a pointer past it.
+template <typename T>
+u8* EncodeArg(u8* out, const T& arg) {
+    using U = std::remove_cv_t<T>;
+    if constexpr (std::is_enum_v<U>) {
+        return EncodeArg(out, static_cast<std::underlying_type_t<U>>(arg));
+    } else if constexpr (IsStringArg<U>) {
+        const std::string_view string(arg);
+        const u32 size = static_cast<u32>(string.size());
+        out[0] = static_cast<u8>(ArgType::String);
+        std::memcpy(out + 1, &size, sizeof(u32));
+        std::memcpy(out + 1 + sizeof(u32), string.data(), size);
+        return out + 1 + sizeof(u32) + size;
+    } else if constexpr (std::is_same_v<U, bool>) {
+        return EncodeValue(out, ArgType::Bool, arg);
+    } else if constexpr (std::is_same_v<U, char>) {
+        return EncodeValue(out, ArgType::Char, arg);
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return EncodeValue(out, ArgType::Signed, static_cast<s64>(arg));
+    } else if constexpr (std::is_integral_v<U>) {
+        return EncodeValue(out, ArgType::Unsigned, static_cast<u64>(arg));
+    } else if constexpr (std::is_same_v<U, float>) {
+        return EncodeValue(out, ArgType::Float, arg);
+    } else if constexpr (std::is_same_v<U, double>) {
+        return EncodeValue(out, ArgType::Double, arg);
+    } else {
+        return EncodeValue(out, ArgType::Pointer, static_cast<const void*>(arg));
+    }
+}
+
+} // namespace Detail
+
+} // namespace Log
@@ -152,6 +152,7 @@ void LogSettings() {
     log_setting("Renderer_UseShaderJit", values.use_shader_jit.GetValue());
     log_setting("Renderer_UseResolutionFactor", values.resolution_factor.GetValue());
     log_setting("Renderer_FrameLimit", values.frame_limit.GetValue());
+    log_setting("Renderer_FramePacing", values.frame_pacing.GetValue());
     log_setting("Renderer_VSyncNew", values.use_vsync_new.GetValue());
     log_setting("Renderer_PostProcessingShader", values.pp_shader_name.GetValue());
     log_setting("Renderer_FilterMode", values.filter_mode.GetValue());
@@ -177,6 +178,7 @@ void LogSettings() {
     log_setting("Audio_InputType", values.input_type.GetValue());
     log_setting("Audio_InputDevice", values.input_device.GetValue());
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
+    log_setting("Audio_ParallelDspSources", values.parallel_dsp_sources.GetValue());
     using namespace Service::CAM;
     log_setting("Camera_OuterRightName", values.camera_name[OuterRightCamera]);
     log_setting("Camera_OuterRightConfig", values.camera_config[OuterRightCamera]);
@@ -199,6 +201,8 @@ void LogSettings() {
     log_setting("System_PluginLoaderAllowed", values.allow_plugin_loader.GetValue());
     log_setting("Debugging_UseGdbstub", values.use_gdbstub.GetValue());
     log_setting("Debugging_GdbstubPort", values.gdbstub_port.GetValue());
+    log_setting("Debugging_BootSnapshotFrame", values.boot_snapshot_frame.GetValue());
+    log_setting("Debugging_ExeFSCodeCacheSize", values.exefs_code_cache_size.GetValue());
 }
 
 bool IsConfiguringGlobal() {
@@ -243,6 +247,7 @@ void RestoreGlobalState(bool is_powered_on) {
     values.use_vsync_new.SetGlobal(true);
     values.resolution_factor.SetGlobal(true);
     values.frame_limit.SetGlobal(true);
+    values.frame_pacing.SetGlobal(true);
     values.texture_filter.SetGlobal(true);
     values.layout_option.SetGlobal(true);
     values.swap_screen.SetGlobal(true);
@@ -61,6 +61,12 @@ enum class MonoRenderOption : u32 {
     RightEye = 1,
 };
 
+/// How the frame limiter paces frames
+enum class FramePacing : u32 {
+    Default = 0,    ///< Sleeps after every frame
+    LowLatency = 1, ///< Sleeps before every frame, so that it ends right before it is due
+};
+
 enum class AudioEmulation : u32 {
     HLE = 0,
     LLE = 1,
@@ -443,6 +449,7 @@ struct Values {
     Setting<bool> use_shader_jit{true, "use_shader_jit"};
     SwitchableSetting<u32, true> resolution_factor{1, 0, 10, "resolution_factor"};
     SwitchableSetting<u16, true> frame_limit{100, 0, 1000, "frame_limit"};
+    SwitchableSetting<FramePacing> frame_pacing{FramePacing::Default, "frame_pacing"};
     SwitchableSetting<TextureFilter> texture_filter{TextureFilter::None, "texture_filter"};
 
     SwitchableSetting<LayoutOption> layout_option{LayoutOption::Default, "layout_option"};
@@ -487,6 +494,7 @@ struct Values {
     bool audio_muted;
     SwitchableSetting<AudioEmulation> audio_emulation{AudioEmulation::HLE, "audio_emulation"};
     SwitchableSetting<bool> enable_audio_stretching{true, "enable_audio_stretching"};
+    Setting<bool> parallel_dsp_sources{false, "parallel_dsp_sources"};
     SwitchableSetting<float, true> volume{1.f, 0.f, 1.f, "volume"};
     Setting<AudioCore::SinkType> output_type{AudioCore::SinkType::Auto, "output_type"};
     Setting<std::string> output_device{"auto", "output_device"};
@@ -503,9 +511,12 @@ struct Values {
     std::unordered_map<std::string, bool> lle_modules;
     Setting<bool> use_gdbstub{false, "use_gdbstub"};
     Setting<u16> gdbstub_port{24689, "gdbstub_port"};
+    Setting<u32> boot_snapshot_frame{0, "boot_snapshot_frame"};
+    Setting<u32> exefs_code_cache_size{0, "exefs_code_cache_size"};
 
     // Miscellaneous
     Setting<std::string> log_filter{"*:Info", "log_filter"};
+    Setting<bool> binary_log{false, "binary_log"};
 
     // Video Dumping
     std::string output_format;
@@ -0,0 +1,60 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Lock-free buffer holding the latest value written by a single producer for a single consumer.
+ * Neither side ever waits for the other: the producer writes to a buffer of its own and swaps it
+ * with the middle one, and the consumer swaps the middle buffer for its own when a newer value
+ * was published. Values published while the consumer does not read are skipped.
+ * @tparam T Value type
+ */
+template <typename T>
+class TripleBuffer {
+    static_assert(std::atomic<u32>::is_always_lock_free);
+
+public:
+    /// Returns the buffer the producer writes the next value to. It keeps what it held when it was
+    /// last returned by Read, so it has to be written entirely.
+    [[nodiscard]] T& WriteBuffer() {
+        return buffers[write_index];
+    }
+
+    /// Makes the write buffer the latest value. Only called by the producer.
+    void Publish() {
+        const u32 previous = middle.exchange(write_index | FRESH_BIT, std::memory_order_acq_rel);
+        write_index = previous & INDEX_MASK;
+    }
+
+    /// Returns the latest published value, which stays valid until the next call. Only called by
+    /// the consumer.
+    [[nodiscard]] const T& Read() {
+        if (middle.load(std::memory_order_relaxed) & FRESH_BIT) {
+            const u32 previous = middle.exchange(read_index, std::memory_order_acq_rel);
+            read_index = previous & INDEX_MASK;
+        }
+        return buffers[read_index];
+    }
+
+private:
+    static constexpr u32 INDEX_MASK = 3;
+    static constexpr u32 FRESH_BIT = 4;
+
+    std::array<T, 3> buffers{};
+
+    // The indices of either side are kept on separate cache lines, as they are written by
+    // different threads.
+    alignas(128) std::atomic<u32> middle{1};
+    alignas(128) u32 write_index = 0;
+    alignas(128) u32 read_index = 2;
+};
+
+} // namespace Common
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstdint>
 #include <cstring>
+#include <type_traits>
 #include <dynarmic/interface/A32/a32.h>
 #include <dynarmic/interface/optimization_flags.h>
 #include "common/assert.h"
@@ -362,6 +364,21 @@ void ARM_Dynarmic::ServeBreak() {
     GDBStub::SendTrap(thread, 5);
 }
 
+namespace {
+
+/// Dynarmic takes the fastmem base either as a pointer or, in newer versions, as an optional
+/// address where nullopt disables fastmem.
+template <typename T>
+void SetFastmemPointer(T& fastmem_pointer, u8* base) {
+    if constexpr (std::is_pointer_v<T>) {
+        fastmem_pointer = base;
+    } else if (base) {
+        fastmem_pointer = reinterpret_cast<std::uintptr_t>(base);
+    }
+}
+
+} // Anonymous namespace
+
 std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     Dynarmic::A32::UserConfig config;
     config.callbacks = cb.get();
@@ -369,6 +386,14 @@ std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     config.coprocessors[15] = std::make_shared<DynarmicCP15>(cp15_state);
     config.define_unpredictable_behaviour = true;
 
+    // Accesses to pages that are not regular memory fault in the arena. Dynarmic then falls back
+    // to the page table and callbacks, and recompiles the faulting block without fastmem. There is
+    // no page table before the first process is loaded.
+    if (current_page_table) {
+        SetFastmemPointer(config.fastmem_pointer, memory.GetFastmemPointer(*current_page_table));
+        config.recompile_on_fastmem_failure = true;
+    }
+
     // Multi-process state
     config.processor_id = GetID();
     config.global_monitor = &exclusive_monitor.monitor;
@@ -7,7 +7,6 @@
 #include <memory>
 #include "core/arm/dyncom/arm_dyncom.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
-#include "core/arm/dyncom/arm_dyncom_trans.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -87,12 +86,11 @@ void ARM_DynCom::Step() {
 }
 
 void ARM_DynCom::ClearInstructionCache() {
-    state->instruction_cache.clear();
-    trans_cache_buf_top = 0;
+    state->instruction_cache.Clear();
 }
 
-void ARM_DynCom::InvalidateCacheRange(u32, std::size_t) {
-    ClearInstructionCache();
+void ARM_DynCom::InvalidateCacheRange(u32 start_address, std::size_t length) {
+    state->instruction_cache.InvalidateRange(start_address, length);
 }
 
 void ARM_DynCom::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) {
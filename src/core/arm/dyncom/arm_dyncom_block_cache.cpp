@@ -0,0 +1,63 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <new>
+#include "common/assert.h"
+#include "core/arm/dyncom/arm_dyncom_block_cache.h"
+#include "core/arm/dyncom/arm_dyncom_trans.h"
+
+// The buffer is left uninitialized, so that the host only commits the parts that are used
+BlockCache::BlockCache() : pages(NUM_PAGES), buffer(new char[TRANS_CACHE_SIZE]) {}
+
+BlockCache::~BlockCache() = default;
+
+std::size_t BlockCache::BeginBlock() {
+    if (TRANS_CACHE_SIZE - top < MAX_BLOCK_SIZE) {
+        Clear();
+    }
+    const std::size_t offset = top;
+    new (Allocate(sizeof(BlockHeader))) BlockHeader{};
+    return offset;
+}
+
+void* BlockCache::Allocate(std::size_t size) {
+    const std::size_t start = top;
+    top += size;
+    ASSERT_MSG(top <= TRANS_CACHE_SIZE, "Translation cache is full!");
+    return &buffer[start];
+}
+
+void BlockCache::Insert(u32 pc, std::size_t offset) {
+    auto& page = pages[pc >> PAGE_BITS];
+    if (!page) {
+        page = std::make_unique<PageEntries>();
+        used_pages.push_back(pc >> PAGE_BITS);
+    }
+    (*page)[(pc & PAGE_MASK) >> 1] = static_cast<u32>(offset + 1);
+}
+
+void BlockCache::InvalidateRange(u32 start, std::size_t length) {
+    if (length == 0) {
+        return;
+    }
+    const std::size_t first_page = start >> PAGE_BITS;
+    const std::size_t last_page =
+        std::min<std::size_t>((start + length - 1) >> PAGE_BITS, NUM_PAGES - 1);
+    for (std::size_t page = first_page; page <= last_page; page++) {
+        if (pages[page]) {
+            pages[page]->fill(0);
+        }
+    }
+    generation++;
+}
+
+void BlockCache::Clear() {
+    for (const u32 page : used_pages) {
+        pages[page].reset();
+    }
+    used_pages.clear();
+    top = 0;
+    generation++;
+}
@@ -0,0 +1,112 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * Cache of the basic blocks translated by the dyncom interpreter.
+ *
+ * Blocks are found through a two-level direct-mapped table: the first level is indexed by guest
+ * page and the second by halfword within the page. Translation stops at the end of a page, so a
+ * block never spans two pages and invalidating a page only has to drop its own table.
+ *
+ * The instructions of a block are bump-allocated from a buffer, preceded by a BlockHeader. Memory
+ * of dropped blocks is only reclaimed when the buffer fills up and the whole cache is flushed.
+ */
+class BlockCache {
+public:
+    static constexpr std::size_t NOT_FOUND = ~std::size_t{0};
+
+    /// Data kept before the instructions of every block, used for block chaining.
+    struct BlockHeader {
+        /// A successor block, valid while its generation matches the one of the cache.
+        struct Link {
+            u32 pc;
+            u32 generation;
+            std::size_t offset;
+        };
+        std::array<Link, 2> links;
+        u32 next_link;
+    };
+
+    BlockCache();
+    ~BlockCache();
+
+    char* Buffer() {
+        return buffer.get();
+    }
+
+    /// The generation changes every time blocks are dropped, making links to them invalid.
+    u32 Generation() const {
+        return generation;
+    }
+
+    /// Returns the offset of the block starting at pc, or NOT_FOUND.
+    std::size_t Find(u32 pc) const {
+        const auto& page = pages[pc >> PAGE_BITS];
+        if (!page) {
+            return NOT_FOUND;
+        }
+        // Entries store the offset plus one, so that zero means no block
+        return static_cast<std::size_t>((*page)[(pc & PAGE_MASK) >> 1]) - 1;
+    }
+
+    /// Returns the offset of the block that the block at from last branched to at pc, if any.
+    std::size_t FindLink(std::size_t from, u32 pc) const {
+        const auto& header = *reinterpret_cast<const BlockHeader*>(&buffer[from]);
+        for (const auto& link : header.links) {
+            if (link.pc == pc && link.generation == generation) {
+                return link.offset;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    /// Remembers that the block at from branched to the block at to, which starts at pc.
+    void Link(std::size_t from, u32 pc, std::size_t to) {
+        auto& header = *reinterpret_cast<BlockHeader*>(&buffer[from]);
+        header.links[header.next_link] = {pc, generation, to};
+        header.next_link = (header.next_link + 1) % header.links.size();
+    }
+
+    /**
+     * Starts translating a block, flushing the cache first if the buffer could run out of space.
+     * Returns the offset of the new block.
+     */
+    std::size_t BeginBlock();
+
+    /// Allocates space for a translated instruction of the current block.
+    void* Allocate(std::size_t size);
+
+    /// Adds the block at offset, starting at pc, to the cache.
+    void Insert(u32 pc, std::size_t offset);
+
+    /// Drops the blocks of every page that overlaps [start, start + length).
+    void InvalidateRange(u32 start, std::size_t length);
+
+    /// Drops all blocks and reclaims the buffer.
+    void Clear();
+
+private:
+    static constexpr std::size_t PAGE_BITS = 12;
+    static constexpr u32 PAGE_MASK = (1 << PAGE_BITS) - 1;
+    static constexpr std::size_t NUM_PAGES = std::size_t{1} << (32 - PAGE_BITS);
+
+    /// Upper bound of the size of one translated block, which is at most a page of instructions.
+    static constexpr std::size_t MAX_BLOCK_SIZE = 512 * 1024;
+
+    using PageEntries = std::array<u32, (PAGE_MASK + 1) / 2>;
+
+    std::vector<std::unique_ptr<PageEntries>> pages;
+    std::vector<u32> used_pages;
+    std::unique_ptr<char[]> buffer;
+    std::size_t top = 0;
+    u32 generation = 1;
+};
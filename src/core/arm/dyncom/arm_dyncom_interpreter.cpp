@@ -9,6 +9,7 @@
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "core/arm/dyncom/arm_dyncom_block_cache.h"
 #include "core/arm/dyncom/arm_dyncom_dec.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/arm/dyncom/arm_dyncom_run.h"
@@ -808,7 +809,8 @@ enum { KEEP_GOING, FETCH_EXCEPTION };
 MICROPROFILE_DEFINE(DynCom_Decode, "DynCom", "Decode", MP_RGB(255, 64, 64));
 
 static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, const u32 phys_addr,
-                                                    ARM_INST_PTR& inst_base) {
+                                                    ARM_INST_PTR& inst_base,
+                                                    const void* const* labels) {
     u32 inst_size = 4;
     u32 inst = cpu->memory.Read32(phys_addr & 0xFFFFFFFC);
 
@@ -821,6 +823,9 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
 
         // We have translated the Thumb branch instruction in the Thumb decoder
         if (state == ThumbDecodeStatus::BRANCH) {
+            if (labels) {
+                inst_base->handler = labels[inst_base->idx];
+            }
             return inst_size;
         }
         inst = arm_inst;
@@ -835,11 +840,15 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
         CITRA_IGNORE_EXIT(-1);
     }
     inst_base = arm_instruction_trans[idx](inst, idx);
+    if (labels) {
+        inst_base->handler = labels[idx];
+    }
 
     return inst_size;
 }
 
-static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u32 addr) {
+static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u32 addr,
+                                     const void* const* labels) {
     MICROPROFILE_SCOPE(DynCom_Decode);
 
     // Decode instruction, get index
@@ -848,13 +857,14 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
     // Save start addr of basicblock in CreamCache
     ARM_INST_PTR inst_base = nullptr;
     TransExtData ret = TransExtData::NON_BRANCH;
-    bb_start = trans_cache_buf_top;
+    translation_cache = &cpu->instruction_cache;
+    bb_start = cpu->instruction_cache.BeginBlock();
 
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
     while (ret == TransExtData::NON_BRANCH) {
-        u32 inst_size = InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
+        u32 inst_size = InterpreterTranslateInstruction(cpu, phys_addr, inst_base, labels);
         phys_addr += inst_size;
 
         if ((phys_addr & 0xfff) == 0) {
@@ -863,27 +873,29 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
         ret = inst_base->br;
     };
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->instruction_cache.Insert(pc_start, bb_start);
 
     return KEEP_GOING;
 }
 
-static int InterpreterTranslateSingle(ARMul_State* cpu, std::size_t& bb_start, u32 addr) {
+static int InterpreterTranslateSingle(ARMul_State* cpu, std::size_t& bb_start, u32 addr,
+                                      const void* const* labels) {
     MICROPROFILE_SCOPE(DynCom_Decode);
 
     ARM_INST_PTR inst_base = nullptr;
-    bb_start = trans_cache_buf_top;
+    translation_cache = &cpu->instruction_cache;
+    bb_start = cpu->instruction_cache.BeginBlock();
 
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
-    InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
+    InterpreterTranslateInstruction(cpu, phys_addr, inst_base, labels);
 
     if (inst_base->br == TransExtData::NON_BRANCH) {
         inst_base->br = TransExtData::SINGLE_STEP;
     }
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->instruction_cache.Insert(pc_start, bb_start);
 
     return KEEP_GOING;
 }
@@ -965,15 +977,17 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     }
 #endif
 
-// GCC and Clang have a C++ extension to support a lookup table of labels. Otherwise, fallback to a
-// clunky switch statement.
+// GCC and Clang have a C++ extension to support a lookup table of labels, which lets every
+// translated instruction store the label of its handler (direct threading). Otherwise, fallback to
+// a clunky switch statement.
 #if defined __GNUC__ || (defined __clang__ && !defined _MSC_VER)
+#define DIRECT_THREADING
 #define GOTO_NEXT_INST                                                                             \
     GDB_BP_CHECK;                                                                                  \
     if (num_instrs >= cpu->NumInstrsToExecute)                                                     \
         goto END;                                                                                  \
     num_instrs++;                                                                                  \
-    goto* InstLabel[inst_base->idx]
+    goto* inst_base->handler
 #else
 #define GOTO_NEXT_INST                                                                             \
     GDB_BP_CHECK;                                                                                  \
@@ -1619,13 +1633,24 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                          &&DISPATCH,
                          &&INIT_INST_LENGTH,
                          &&END};
+#endif
+#ifdef DIRECT_THREADING
+    const void* const* const labels = InstLabel;
+#else
+    const void* const* const labels = nullptr;
 #endif
     arm_inst* inst_base;
     unsigned int addr;
     unsigned int num_instrs = 0;
 
+    BlockCache& cache = cpu->instruction_cache;
+    char* const trans_cache_buf = cache.Buffer();
     std::size_t ptr;
 
+    // The last block that was dispatched to, which is linked to the next one
+    std::size_t prev_block = BlockCache::NOT_FOUND;
+    u32 prev_generation = 0;
+
     LOAD_NZCVT;
 DISPATCH : {
     if (!cpu->NirqSig) {
@@ -1639,17 +1664,33 @@ DISPATCH : {
     else
         cpu->Reg[15] &= 0xfffffffc;
 
-    // Find the cached instruction cream, otherwise translate it...
-    auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-    if (itr != cpu->instruction_cache.end()) {
-        ptr = itr->second;
-    } else if (cpu->NumInstrsToExecute != 1) {
-        if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
-    } else {
-        if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+    // Follow the link of the previous block if it branched here before. Otherwise, find the cached
+    // instruction cream or translate it, and link the previous block to it. Links are only followed
+    // while no blocks were dropped since the previous block was dispatched to, as that may also
+    // have dropped the previous block.
+    if (prev_generation != cache.Generation()) {
+        prev_block = BlockCache::NOT_FOUND;
+    }
+    ptr = prev_block != BlockCache::NOT_FOUND ? cache.FindLink(prev_block, cpu->Reg[15])
+                                              : BlockCache::NOT_FOUND;
+    if (ptr == BlockCache::NOT_FOUND) {
+        ptr = cache.Find(cpu->Reg[15]);
+        if (ptr == BlockCache::NOT_FOUND) {
+            if (cpu->NumInstrsToExecute != 1) {
+                if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15], labels) == FETCH_EXCEPTION)
+                    goto END;
+            } else {
+                if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15], labels) == FETCH_EXCEPTION)
+                    goto END;
+            }
+        }
+        if (prev_block != BlockCache::NOT_FOUND && prev_generation == cache.Generation()) {
+            cache.Link(prev_block, cpu->Reg[15], ptr);
+        }
     }
+    prev_block = ptr;
+    prev_generation = cache.Generation();
+    ptr += sizeof(BlockCache::BlockHeader);
 
 #ifndef ANDROID
     // Find breakpoint if one exists within the block
@@ -1,19 +1,16 @@
 #include <cstdlib>
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "core/arm/dyncom/arm_dyncom_block_cache.h"
 #include "core/arm/dyncom/arm_dyncom_trans.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/arm/skyeye_common/armsupp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
 
-char trans_cache_buf[TRANS_CACHE_SIZE];
-size_t trans_cache_buf_top = 0;
+BlockCache* translation_cache = nullptr;
 
 static void* AllocBuffer(std::size_t size) {
-    std::size_t start = trans_cache_buf_top;
-    trans_cache_buf_top += size;
-    ASSERT_MSG(trans_cache_buf_top <= TRANS_CACHE_SIZE, "Translation cache is full!");
-    return static_cast<void*>(&trans_cache_buf[start]);
+    return translation_cache->Allocate(size);
 }
 
 #define glue(x, y) x##y
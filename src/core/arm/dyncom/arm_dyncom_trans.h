@@ -26,6 +26,7 @@ struct arm_inst {
     unsigned int idx;
     unsigned int cond;
     TransExtData br;
+    const void* handler; // Interpreter label of the instruction, when direct threading is used
     char component[0];
 };
 
@@ -494,5 +495,7 @@ extern const transop_fp_t arm_instruction_trans[];
 extern const std::size_t arm_instruction_trans_len;
 
 #define TRANS_CACHE_SIZE (64 * 1024 * 2000)
-extern char trans_cache_buf[TRANS_CACHE_SIZE];
-extern std::size_t trans_cache_buf_top;
+
+class BlockCache;
+/// Cache that the translation functions allocate instructions from, set before translating.
+extern BlockCache* translation_cache;
@@ -20,6 +20,7 @@
 #include <array>
 #include <unordered_map>
 #include "common/common_types.h"
+#include "core/arm/dyncom/arm_dyncom_block_cache.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 #include "core/gdbstub/gdbstub.h"
 
@@ -254,7 +255,7 @@ public:
 
     // TODO(bunnei): Move this cache to a better place - it should be per codeset (likely per
     // process for our purposes), not per ARMul_State (which tracks CPU core state).
-    std::unordered_map<u32, std::size_t> instruction_cache;
+    BlockCache instruction_cache;
 
 private:
     void ResetMPCoreCP15Registers();
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <memory>
 #include <stdexcept>
 #include <utility>
@@ -142,6 +143,38 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         break;
     }
 
+    if (boot_snapshot_load_pending) {
+        boot_snapshot_load_pending = false;
+        try {
+            if (LoadBootSnapshot()) {
+                LOG_INFO(Core, "Booted from the boot snapshot");
+                boot_snapshot_frame = 0;
+                return ResultStatus::Success;
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error loading the boot snapshot: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+    }
+    if (boot_snapshot_frame != 0 &&
+        static_cast<u32>(VideoCore::g_renderer->GetCurrentFrame()) >= boot_snapshot_frame) {
+        LOG_INFO(Core, "Saving the boot snapshot at frame {}", boot_snapshot_frame);
+        try {
+            SaveBootSnapshot();
+            LOG_INFO(Core, "Boot snapshot saved");
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error saving the boot snapshot: {}", e.what());
+        }
+        boot_snapshot_frame = 0;
+    }
+    if (boot_start_time && VideoCore::g_renderer->GetCurrentFrame() > 0) {
+        const auto boot_time = std::chrono::steady_clock::now() - *boot_start_time;
+        LOG_INFO(Core, "Booted to the first frame in {} ms",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(boot_time).count());
+        boot_start_time.reset();
+    }
+
     // All cores should have executed the same amount of ticks. If this is not the case an event was
     // scheduled with a cycles_into_future smaller then the current downcount.
     // So we have to get those cores to the same global time first
@@ -330,6 +363,15 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     m_filepath = filepath;
     self_delete_pending = false;
 
+    // Movies replay input from the boot, which a snapshot would skip
+    boot_snapshot_frame = 0;
+    boot_snapshot_load_pending = false;
+    if (title_id != 0 && Movie::GetInstance().GetPlayMode() == Movie::PlayMode::None) {
+        boot_snapshot_frame = Settings::values.boot_snapshot_frame.GetValue();
+        boot_snapshot_load_pending = boot_snapshot_frame != 0;
+    }
+    boot_start_time = std::chrono::steady_clock::now();
+
     // Reset counters and set time origin to current frame
     [[maybe_unused]] const PerfStats::Results result = GetAndResetPerfStats();
     perf_stats->BeginSystemFrame();
@@ -615,6 +657,13 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         auto n3ds_mode = this->app_loader->LoadKernelN3dsMode();
         [[maybe_unused]] const System::ResultStatus result = Init(
             *m_emu_window, m_secondary_window, *system_mode.first, *n3ds_mode.first, num_cores);
+
+        // The memory of a boot snapshot is not in the archive, and has to be in place before the
+        // CPU cores create their fastmem arenas
+        if (!boot_snapshot_path.empty() &&
+            !memory->LoadSnapshotMemory(boot_snapshot_path, boot_snapshot_memory_offset)) {
+            throw std::runtime_error("Could not load the memory of " + boot_snapshot_path);
+        }
     }
 
     // flush on save, don't flush on load
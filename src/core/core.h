@@ -5,8 +5,10 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <boost/serialization/version.hpp>
 #include "common/common_types.h"
@@ -321,6 +323,18 @@ public:
 
     void LoadState(u32 slot);
 
+    /**
+     * Saves a boot snapshot of the running title. Its memory is stored uncompressed, so that
+     * later boots can map it instead of reading it.
+     */
+    void SaveBootSnapshot() const;
+
+    /**
+     * Loads the boot snapshot of the running title, mapping its memory copy-on-write where the
+     * host supports it. Returns false if there is no up to date snapshot of the title.
+     */
+    bool LoadBootSnapshot();
+
     /// Self delete ncch
     bool SetSelfDelete(const std::string& file) {
         if (m_filepath == file) {
@@ -406,6 +420,15 @@ private:
     u64 title_id;
     bool self_delete_pending;
 
+    /// Frame at which a boot snapshot is saved, 0 once it is saved or loaded
+    u32 boot_snapshot_frame = 0;
+    bool boot_snapshot_load_pending = false;
+    /// Snapshot whose memory is loaded while deserializing
+    std::string boot_snapshot_path;
+    u64 boot_snapshot_memory_offset = 0;
+    /// Time Load was called at, until the first frame is presented
+    std::optional<std::chrono::steady_clock::time_point> boot_start_time;
+
     std::mutex signal_mutex;
     Signal current_signal;
     u32 signal_param;
@@ -187,6 +187,14 @@ public:
      */
     virtual u64 GetFreeBytes() const = 0;
 
+    /**
+     * Commit the changes made to the files of the archive, for archives that buffer them
+     * @return Result of the operation
+     */
+    virtual ResultCode Commit() const {
+        return RESULT_SUCCESS;
+    }
+
     u64 GetOpenDelayNs() {
         if (delay_generator != nullptr) {
             return delay_generator->GetOpenDelayNs();
@@ -13,6 +13,7 @@
 #include "core/file_sys/archive_extsavedata.h"
 #include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
+#include "core/file_sys/host_directory_cache.h"
 #include "core/file_sys/path_parser.h"
 #include "core/file_sys/savedata_archive.h"
 #include "core/hle/service/fs/archive.h"
@@ -126,7 +127,7 @@ public:
 
         const auto full_path = path_parser.BuildHostPath(mount_point);
 
-        switch (path_parser.GetHostStatus(mount_point)) {
+        switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
         case PathParser::InvalidMountPoint:
             LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
             return ERROR_FILE_NOT_FOUND;
@@ -11,6 +11,7 @@
 #include "core/file_sys/archive_sdmc.h"
 #include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
+#include "core/file_sys/host_directory_cache.h"
 #include "core/file_sys/path_parser.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -79,7 +80,7 @@ ResultVal<std::unique_ptr<FileBackend>> SDMCArchive::OpenFileBase(const Path& pa
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_NOT_FOUND;
@@ -125,7 +126,7 @@ ResultCode SDMCArchive::DeleteFile(const Path& path) const {
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_NOT_FOUND;
@@ -193,7 +194,7 @@ static ResultCode DeleteDirectoryHelper(const Path& path, const std::string& mou
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_NOT_FOUND;
@@ -236,7 +237,7 @@ ResultCode SDMCArchive::CreateFile(const FileSys::Path& path, u64 size) const {
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_NOT_FOUND;
@@ -281,7 +282,7 @@ ResultCode SDMCArchive::CreateDirectory(const Path& path) const {
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_NOT_FOUND;
@@ -345,7 +346,7 @@ ResultVal<std::unique_ptr<DirectoryBackend>> SDMCArchive::OpenDirectory(const Pa
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_NOT_FOUND;
@@ -361,7 +362,8 @@ ResultVal<std::unique_ptr<DirectoryBackend>> SDMCArchive::OpenDirectory(const Pa
         break; // Expected 'success' case
     }
 
-    auto directory = std::make_unique<DiskDirectory>(full_path);
+    auto directory =
+        std::make_unique<DiskDirectory>(HostDirectoryCache::GetInstance().GetDirectory(full_path));
     return MakeResult<std::unique_ptr<DirectoryBackend>>(std::move(directory));
 }
 
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <utility>
 #include "common/archives.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
@@ -62,6 +63,10 @@ DiskDirectory::DiskDirectory(const std::string& path) {
     children_iterator = directory.children.begin();
 }
 
+DiskDirectory::DiskDirectory(FileUtil::FSTEntry directory_) : directory{std::move(directory_)} {
+    children_iterator = directory.children.begin();
+}
+
 u32 DiskDirectory::Read(const u32 count, Entry* entries) {
     u32 entries_read = 0;
 
@@ -62,6 +62,7 @@ private:
 class DiskDirectory : public DirectoryBackend {
 public:
     explicit DiskDirectory(const std::string& path);
+    explicit DiskDirectory(FileUtil::FSTEntry directory_);
 
     ~DiskDirectory() override {
         Close();
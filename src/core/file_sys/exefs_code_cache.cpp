@@ -0,0 +1,171 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+#include "common/cityhash.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "core/file_sys/exefs_code_cache.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr u32 ExeFSCodeCacheMagic = 0x45444F43; // "CODE"
+// Increment this whenever the format or the decompression changes
+constexpr u32 ExeFSCodeCacheVersion = 1;
+
+struct ExeFSCodeCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le compressed_size;
+    u64_le code_size;
+    u64_le code_hash;
+    s64_le decompress_time_us; ///< How long decompressing the section took when it was cached
+};
+static_assert(sizeof(ExeFSCodeCacheHeader) == 0x28,
+              "Size of ExeFSCodeCacheHeader is not correct");
+
+} // Anonymous namespace
+
+ExeFSCodeCache::ExeFSCodeCache(u64 max_size_, std::string path_)
+    : max_size{max_size_}, path{std::move(path_)} {
+    if (path.empty()) {
+        path = FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "exefs_code" DIR_SEP;
+    }
+}
+
+std::string ExeFSCodeCache::GetCodePath(const u8* compressed, std::size_t size) const {
+    const auto hash = Common::CityHash128(reinterpret_cast<const char*>(compressed), size);
+    return fmt::format("{}{:016X}{:016X}.bin", path, Common::Uint128High64(hash),
+                       Common::Uint128Low64(hash));
+}
+
+bool ExeFSCodeCache::Load(const u8* compressed, std::size_t size, std::vector<u8>& code) const {
+    if (max_size == 0) {
+        return false;
+    }
+
+    const auto load_start = std::chrono::steady_clock::now();
+    const auto code_path = GetCodePath(compressed, size);
+    FileUtil::IOFile file(code_path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    ExeFSCodeCacheHeader header;
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != ExeFSCodeCacheMagic || header.version != ExeFSCodeCacheVersion ||
+        header.compressed_size != size ||
+        file.GetSize() != sizeof(header) + header.code_size) {
+        return false;
+    }
+
+    code.resize(header.code_size);
+    if (file.ReadBytes(code.data(), code.size()) != code.size() ||
+        Common::ComputeHash64(code.data(), code.size()) != header.code_hash) {
+        LOG_WARNING(Service_FS, "Cached .code {} is corrupted", code_path);
+        return false;
+    }
+
+    // Reading and hashing the section is not free, so only the difference is saved
+    const auto load_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - load_start);
+    LOG_INFO(Service_FS,
+             "Loaded decompressed .code from {} in {} ms, saving {} ms of decompression",
+             code_path, load_time.count() / 1000,
+             (header.decompress_time_us - load_time.count()) / 1000);
+    return true;
+}
+
+void ExeFSCodeCache::Store(const u8* compressed, std::size_t size, const std::vector<u8>& code,
+                           std::chrono::microseconds decompress_time) const {
+    if (max_size == 0) {
+        return;
+    }
+
+    const auto code_path = GetCodePath(compressed, size);
+    // Other instances may be storing the same section, so each one writes its own temporary file
+    const auto temp_path = fmt::format("{}.{:08X}.tmp", code_path, std::random_device{}());
+    if (!FileUtil::CreateFullPath(temp_path)) {
+        LOG_ERROR(Service_FS, "Could not create path {}", temp_path);
+        return;
+    }
+
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file) {
+            LOG_ERROR(Service_FS, "Could not open file {}", temp_path);
+            return;
+        }
+
+        ExeFSCodeCacheHeader header{};
+        header.magic = ExeFSCodeCacheMagic;
+        header.version = ExeFSCodeCacheVersion;
+        header.compressed_size = size;
+        header.code_size = code.size();
+        header.code_hash = Common::ComputeHash64(code.data(), code.size());
+        header.decompress_time_us = decompress_time.count();
+        if (file.WriteObject(header) != 1 ||
+            file.WriteBytes(code.data(), code.size()) != code.size()) {
+            LOG_ERROR(Service_FS, "Could not write cached .code {}", temp_path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+
+    if (!FileUtil::Replace(temp_path, code_path)) {
+        LOG_ERROR(Service_FS, "Could not rename {} to {}", temp_path, code_path);
+        FileUtil::Delete(temp_path);
+        return;
+    }
+    Trim();
+}
+
+void ExeFSCodeCache::Trim() const {
+    struct CachedFile {
+        s64 modification_time;
+        u64 size;
+        std::string path;
+    };
+    std::vector<CachedFile> files;
+    u64 total_size = 0;
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, path, [&](u64*, const std::string&, const std::string& virtual_name) {
+            // The temporary files of other instances are still being written
+            if (virtual_name.ends_with(".bin")) {
+                const auto file_path = path + virtual_name;
+                const u64 size = FileUtil::GetSize(file_path);
+                files.push_back({FileUtil::GetModificationTime(file_path), size, file_path});
+                total_size += size;
+            }
+            return true;
+        });
+    if (total_size <= max_size) {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(), [](const CachedFile& lhs, const CachedFile& rhs) {
+        return lhs.modification_time < rhs.modification_time;
+    });
+    for (const CachedFile& file : files) {
+        if (total_size <= max_size) {
+            break;
+        }
+        // Instances loading the file keep reading it until they close it
+        if (FileUtil::Delete(file.path)) {
+            total_size -= file.size;
+        }
+    }
+}
+
+} // namespace FileSys
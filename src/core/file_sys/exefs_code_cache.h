@@ -0,0 +1,57 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace FileSys {
+
+/**
+ * Cache of decompressed ExeFS .code sections in the cache directory, addressed by the hash of the
+ * compressed section. Decompressing the .code of a large title takes a noticeable part of its
+ * boot, and every emulator instance on a host booting the same title shares the cached file.
+ * The least recently stored sections are removed once the cached files exceed a size limit.
+ */
+class ExeFSCodeCache {
+public:
+    /**
+     * @param max_size the size limit of the cached files in bytes, 0 to disable the cache
+     * @param path the directory of the cached files, or empty for the one in the cache directory
+     */
+    explicit ExeFSCodeCache(u64 max_size, std::string path = {});
+
+    /**
+     * Gets the decompressed .code of a compressed section, if it was cached.
+     * @param compressed the decrypted compressed section
+     * @param size the size of the compressed section
+     * @param code the buffer to read the decompressed section into
+     * @returns whether the section was cached.
+     */
+    bool Load(const u8* compressed, std::size_t size, std::vector<u8>& code) const;
+
+    /**
+     * Caches the decompressed .code of a compressed section.
+     * @param compressed the decrypted compressed section
+     * @param size the size of the compressed section
+     * @param code the decompressed section
+     * @param decompress_time how long decompressing the section took, reported on later loads
+     */
+    void Store(const u8* compressed, std::size_t size, const std::vector<u8>& code,
+               std::chrono::microseconds decompress_time) const;
+
+private:
+    std::string GetCodePath(const u8* compressed, std::size_t size) const;
+
+    /// Removes the least recently stored sections until the cached files fit the size limit.
+    void Trim() const;
+
+    u64 max_size;
+    std::string path;
+};
+
+} // namespace FileSys
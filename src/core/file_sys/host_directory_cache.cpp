@@ -0,0 +1,247 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/logging/log.h"
+#include "core/file_sys/host_directory_cache.h"
+
+#if defined(__linux__) && !defined(ANDROID)
+#define HAVE_INOTIFY
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace FileSys {
+
+namespace {
+
+#ifdef HAVE_INOTIFY
+constexpr u32 WatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY |
+                          IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+HostDirectoryCache::EntryType GetHostEntryType(const std::string& path) {
+    if (!FileUtil::Exists(path)) {
+        return HostDirectoryCache::EntryType::NotFound;
+    }
+    return FileUtil::IsDirectory(path) ? HostDirectoryCache::EntryType::Directory
+                                       : HostDirectoryCache::EntryType::File;
+}
+
+FileUtil::FSTEntry ScanHostDirectory(const std::string& path) {
+    FileUtil::FSTEntry entry{};
+    entry.size = FileUtil::ScanDirectoryTree(path, entry);
+    entry.isDirectory = true;
+    return entry;
+}
+
+std::string NormalizePath(std::string path) {
+    while (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
+} // Anonymous namespace
+
+HostDirectoryCache::HostDirectoryCache() {
+#ifdef HAVE_INOTIFY
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) {
+        LOG_WARNING(Service_FS, "Could not initialize inotify, host directories are not cached");
+    }
+#endif
+}
+
+HostDirectoryCache::~HostDirectoryCache() {
+#ifdef HAVE_INOTIFY
+    if (inotify_fd >= 0) {
+        Clear();
+        close(inotify_fd);
+    }
+#endif
+}
+
+HostDirectoryCache& HostDirectoryCache::GetInstance() {
+    static HostDirectoryCache cache;
+    return cache;
+}
+
+bool HostDirectoryCache::IsEnabled() const {
+    return inotify_fd >= 0;
+}
+
+HostDirectoryCache::EntryType HostDirectoryCache::GetEntryType(const std::string& path) {
+    if (!IsEnabled()) {
+        return GetHostEntryType(path);
+    }
+
+    const auto normalized_path = NormalizePath(path);
+    const auto separator = normalized_path.rfind('/');
+    if (separator == std::string::npos || separator + 1 == normalized_path.size()) {
+        return GetHostEntryType(path); // Relative or root path, no parent to look it up in
+    }
+    const auto parent_path = separator == 0 ? "/" : normalized_path.substr(0, separator);
+    const auto name = normalized_path.substr(separator + 1);
+
+    std::scoped_lock lock{mutex};
+    ProcessEvents();
+    const Directory* parent = FindDirectory(parent_path);
+    if (parent == nullptr) {
+        return GetHostEntryType(path);
+    }
+    const auto itr = parent->children.find(name);
+    if (itr == parent->children.end()) {
+        return EntryType::NotFound;
+    }
+    return parent->entry.children[itr->second].isDirectory ? EntryType::Directory
+                                                           : EntryType::File;
+}
+
+FileUtil::FSTEntry HostDirectoryCache::GetDirectory(const std::string& path) {
+    if (!IsEnabled()) {
+        return ScanHostDirectory(path);
+    }
+
+    std::scoped_lock lock{mutex};
+    ProcessEvents();
+    const Directory* directory = FindDirectory(NormalizePath(path));
+    if (directory == nullptr) {
+        return ScanHostDirectory(path);
+    }
+    return directory->entry;
+}
+
+HostDirectoryCache::Stats HostDirectoryCache::GetStats() const {
+    std::scoped_lock lock{mutex};
+    return stats;
+}
+
+const HostDirectoryCache::Directory* HostDirectoryCache::FindDirectory(const std::string& path) {
+#ifdef HAVE_INOTIFY
+    if (const auto itr = directories.find(path); itr != directories.end()) {
+        ++stats.hits;
+        return &itr->second;
+    }
+
+    if (directories.size() >= MaxDirectories) {
+        Clear();
+    }
+
+    // Watch before scanning, so that no change made during the scan is missed. This fails if the
+    // path is not a directory.
+    const int watch = inotify_add_watch(inotify_fd, path.c_str(), WatchMask);
+    if (watch < 0) {
+        return nullptr;
+    }
+    ++stats.misses;
+
+    // The same directory may be cached under another path, which shares the watch
+    if (const auto itr = watched_paths.find(watch); itr != watched_paths.end()) {
+        directories.erase(itr->second);
+    }
+    watched_paths.insert_or_assign(watch, path);
+
+    Directory directory;
+    directory.entry = ScanHostDirectory(path);
+    directory.watch = watch;
+    for (std::size_t i = 0; i < directory.entry.children.size(); ++i) {
+        directory.children.emplace(directory.entry.children[i].virtualName, i);
+    }
+    return &directories.insert_or_assign(path, std::move(directory)).first->second;
+#else
+    return nullptr;
+#endif
+}
+
+void HostDirectoryCache::ProcessEvents() {
+#ifdef HAVE_INOTIFY
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        const ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return;
+        }
+
+        for (const char* ptr = buffer; ptr < buffer + length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                LOG_WARNING(Service_FS, "Too many host directory changes, emptying the cache");
+                Clear();
+                continue;
+            }
+            const auto itr = watched_paths.find(event->wd);
+            if (itr == watched_paths.end()) {
+                continue;
+            }
+
+            const std::string path = itr->second;
+            if (event->len > 0 && (event->mask & IN_ISDIR)) {
+                // The subdirectory was replaced, moved or deleted with everything under it
+                Invalidate(path + '/' + event->name);
+            } else if (event->len > 0 && (event->mask & IN_MODIFY)) {
+                // Writes only change the size of the file, so the directory is kept
+                if (UpdateFileSize(path, event->name)) {
+                    continue;
+                }
+            }
+            Invalidate(path);
+        }
+    }
+#endif
+}
+
+bool HostDirectoryCache::UpdateFileSize(const std::string& path, const std::string& name) {
+    const auto directory = directories.find(path);
+    if (directory == directories.end()) {
+        return false;
+    }
+    const auto child = directory->second.children.find(name);
+    if (child == directory->second.children.end()) {
+        return false;
+    }
+    auto& entry = directory->second.entry.children[child->second];
+    if (entry.isDirectory) {
+        return false;
+    }
+    entry.size = FileUtil::GetSize(path + '/' + name);
+    return true;
+}
+
+void HostDirectoryCache::Invalidate(const std::string& path) {
+#ifdef HAVE_INOTIFY
+    const auto drop = [this](std::map<std::string, Directory>::iterator itr) {
+        const auto watch_itr = watched_paths.find(itr->second.watch);
+        if (watch_itr != watched_paths.end() && watch_itr->second == itr->first) {
+            inotify_rm_watch(inotify_fd, itr->second.watch);
+            watched_paths.erase(watch_itr);
+        }
+        ++stats.invalidations;
+        return directories.erase(itr);
+    };
+
+    if (const auto itr = directories.find(path); itr != directories.end()) {
+        drop(itr);
+    }
+    const auto prefix = path + '/';
+    auto itr = directories.lower_bound(prefix);
+    while (itr != directories.end() && itr->first.starts_with(prefix)) {
+        itr = drop(itr);
+    }
+#endif
+}
+
+void HostDirectoryCache::Clear() {
+#ifdef HAVE_INOTIFY
+    for (const auto& [watch, path] : watched_paths) {
+        inotify_rm_watch(inotify_fd, watch);
+    }
+    stats.invalidations += directories.size();
+    watched_paths.clear();
+    directories.clear();
+#endif
+}
+
+} // namespace FileSys
@@ -0,0 +1,85 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace FileSys {
+
+/**
+ * Cache of the entries of host directories, for archives that look up their paths and list their
+ * directories on the host for each request. A cached directory is watched for changes with
+ * inotify, whose pending events are applied before every lookup: the kernel queues them before
+ * the changing call returns, so changes made by the emulator itself are never missed either.
+ *
+ * On hosts without inotify, every lookup goes to the host filesystem.
+ */
+class HostDirectoryCache {
+public:
+    enum class EntryType {
+        NotFound,
+        File,
+        Directory,
+    };
+
+    struct Stats {
+        u64 hits = 0;          ///< Lookups answered from a cached directory
+        u64 misses = 0;        ///< Directories scanned on the host
+        u64 invalidations = 0; ///< Cached directories dropped after a change
+    };
+
+    /// Maximum number of cached directories, the cache is emptied past it
+    static constexpr std::size_t MaxDirectories = 4096;
+
+    HostDirectoryCache();
+    ~HostDirectoryCache();
+
+    /// Gets the cache shared by the archives backed by the user directory.
+    static HostDirectoryCache& GetInstance();
+
+    /// Returns whether the host can watch directories, so that they are cached.
+    bool IsEnabled() const;
+
+    /**
+     * Gets the type of the entry at a host path.
+     * @param path the host path, with '/' separators
+     */
+    EntryType GetEntryType(const std::string& path);
+
+    /**
+     * Gets the entries of a host directory, as FileUtil::ScanDirectoryTree without recursion.
+     * @param path the host path of the directory, with '/' separators
+     */
+    FileUtil::FSTEntry GetDirectory(const std::string& path);
+
+    Stats GetStats() const;
+
+private:
+    struct Directory {
+        FileUtil::FSTEntry entry;
+        std::unordered_map<std::string, std::size_t> children; ///< Index of each child by name
+        int watch = -1;
+    };
+
+    const Directory* FindDirectory(const std::string& path);
+    void ProcessEvents();
+    /// Updates the size of a cached file after a write. Returns false if it is not cached.
+    bool UpdateFileSize(const std::string& path, const std::string& name);
+    void Invalidate(const std::string& path);
+    void Clear();
+
+    mutable std::mutex mutex;
+    std::map<std::string, Directory> directories;
+    std::unordered_map<int, std::string> watched_paths;
+    Stats stats;
+    int inotify_fd = -1;
+};
+
+} // namespace FileSys
@@ -4,11 +4,13 @@
 
 #include <algorithm>
 #include <cstring>
+#include <fmt/format.h>
 #include "common/alignment.h"
 #include "common/archives.h"
 #include "common/assert.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
@@ -54,6 +56,32 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+constexpr u32 LayeredFSIndexMagic = 0x58494C46; // "FLIX"
+// Increment this whenever the index format or the rebuilt layout changes
+constexpr u32 LayeredFSIndexVersion = 1;
+
+struct LayeredFSIndexHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le fingerprint;
+    u64_le metadata_size;
+    u64_le data_size;
+    u64_le file_count;
+};
+static_assert(sizeof(LayeredFSIndexHeader) == 0x28, "Size of LayeredFSIndexHeader is not correct");
+
+struct LayeredFSIndexEntry {
+    u64_le data_offset;
+    u64_le original_offset;
+    u64_le size;
+    u32_le type;
+    u32_le path_length;
+    u32_le replace_file_path_length;
+    INSERT_PADDING_WORDS(1);
+    // Followed by the path, the replacement file path and, for patched files, the patched data
+};
+static_assert(sizeof(LayeredFSIndexEntry) == 0x28, "Size of LayeredFSIndexEntry is not correct");
+
 LayeredFS::LayeredFS() = default;
 
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
@@ -68,6 +96,15 @@ void LayeredFS::Load() {
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
+    // Only a patched RomFS differs from the original, so only it is worth indexing
+    std::optional<u64> fingerprint;
+    if (load_relocations && (FileUtil::Exists(patch_path) || FileUtil::Exists(patch_ext_path))) {
+        fingerprint = ComputeIndexFingerprint();
+        if (fingerprint && LoadIndex(*fingerprint)) {
+            return;
+        }
+    }
+
     // TODO: is root always the first directory in table?
     root.parent = &root;
     LoadDirectory(root, 0);
@@ -78,6 +115,198 @@ void LayeredFS::Load() {
     }
 
     RebuildMetadata();
+
+    if (fingerprint) {
+        SaveIndex(*fingerprint);
+    }
+}
+
+// Appends "path:size:mtime" of every file below directory to entries. Returns false if the
+// modification time of a file is unavailable, as changes that keep the size can't be detected.
+static bool CollectPatchFileStates(const std::string& base_path, const std::string& directory,
+                                   std::vector<std::string>& entries) {
+    const FileUtil::DirectoryEntryCallable callback =
+        [&base_path, &entries]([[maybe_unused]] u64* num_entries_out, const std::string& parent,
+                               const std::string& virtual_name) {
+            const auto physical_name = parent + virtual_name;
+            if (FileUtil::IsDirectory(physical_name)) {
+                return CollectPatchFileStates(base_path, physical_name + DIR_SEP, entries);
+            }
+            const s64 modification_time = FileUtil::GetModificationTime(physical_name);
+            if (modification_time == 0) {
+                return false;
+            }
+            entries.push_back(fmt::format("{}:{}:{}", physical_name.substr(base_path.size()),
+                                          FileUtil::GetSize(physical_name), modification_time));
+            return true;
+        };
+    return FileUtil::ForeachDirectoryEntry(nullptr, directory, callback);
+}
+
+std::optional<u64> LayeredFS::ComputeIndexFingerprint() {
+    // The original metadata is read in one go, which is much cheaper than walking it
+    std::vector<u8> original_metadata(header.file_data_offset);
+    romfs->ReadFile(0, original_metadata.size(), original_metadata.data());
+    u64 fingerprint = Common::ComputeHash64(original_metadata.data(), original_metadata.size());
+    fingerprint = Common::HashCombine(fingerprint, romfs->GetSize());
+
+    for (std::string path : {patch_path, patch_ext_path}) {
+        if (path.empty() || !FileUtil::Exists(path)) {
+            fingerprint = Common::HashCombine(fingerprint, 0);
+            continue;
+        }
+        if (path.back() != '/' && path.back() != '\\') {
+            path += DIR_SEP;
+        }
+
+        std::vector<std::string> entries;
+        if (!CollectPatchFileStates(path, path, entries)) {
+            LOG_INFO(Service_FS, "Modification times unavailable, not using the LayeredFS index");
+            return std::nullopt;
+        }
+        // Directory enumeration order is not guaranteed to be stable
+        std::sort(entries.begin(), entries.end());
+        for (const auto& entry : entries) {
+            fingerprint =
+                Common::HashCombine(fingerprint, Common::ComputeHash64(entry.data(), entry.size()));
+        }
+    }
+    return fingerprint;
+}
+
+std::string LayeredFS::GetIndexPath() const {
+    return fmt::format("{}layeredfs{}{:016X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), DIR_SEP,
+                       Common::ComputeHash64(patch_path.data(), patch_path.size()));
+}
+
+bool LayeredFS::LoadIndex(u64 fingerprint) {
+    const auto index_path = GetIndexPath();
+    FileUtil::IOFile file(index_path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    LayeredFSIndexHeader index_header;
+    if (file.ReadBytes(&index_header, sizeof(index_header)) != sizeof(index_header) ||
+        index_header.magic != LayeredFSIndexMagic ||
+        index_header.version != LayeredFSIndexVersion ||
+        index_header.fingerprint != fingerprint ||
+        index_header.metadata_size < sizeof(RomFSHeader)) {
+        return false;
+    }
+
+    std::vector<u8> index_metadata(index_header.metadata_size);
+    if (file.ReadBytes(index_metadata.data(), index_metadata.size()) != index_metadata.size()) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<File>> files;
+    std::vector<std::pair<u64, File*>> offsets;
+    files.reserve(index_header.file_count);
+    offsets.reserve(index_header.file_count);
+    for (u64 i = 0; i < index_header.file_count; ++i) {
+        LayeredFSIndexEntry entry;
+        if (file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry) || entry.type > 2 ||
+            entry.data_offset + entry.size > index_header.data_size ||
+            (!offsets.empty() && entry.data_offset <= offsets.back().first)) {
+            LOG_WARNING(Service_FS, "LayeredFS index {} is corrupted", index_path);
+            return false;
+        }
+
+        auto indexed_file = std::make_unique<File>();
+        indexed_file->path.resize(entry.path_length);
+        indexed_file->relocation.replace_file_path.resize(entry.replace_file_path_length);
+        indexed_file->relocation.type = entry.type;
+        indexed_file->relocation.original_offset = entry.original_offset;
+        indexed_file->relocation.size = entry.size;
+        if (entry.type == 2) {
+            indexed_file->relocation.patched_file.resize(entry.size);
+        }
+        auto& relocation = indexed_file->relocation;
+        if (file.ReadBytes(indexed_file->path.data(), indexed_file->path.size()) !=
+                indexed_file->path.size() ||
+            file.ReadBytes(relocation.replace_file_path.data(),
+                           relocation.replace_file_path.size()) !=
+                relocation.replace_file_path.size() ||
+            file.ReadBytes(relocation.patched_file.data(), relocation.patched_file.size()) !=
+                relocation.patched_file.size()) {
+            LOG_WARNING(Service_FS, "LayeredFS index {} is corrupted", index_path);
+            return false;
+        }
+
+        offsets.emplace_back(entry.data_offset, indexed_file.get());
+        files.emplace_back(std::move(indexed_file));
+    }
+
+    metadata = std::move(index_metadata);
+    current_data_offset = index_header.data_size;
+    indexed_files = std::move(files);
+    data_offset_index = std::move(offsets);
+
+    LOG_INFO(Service_FS, "LayeredFS loaded {} files from index {}", indexed_files.size(),
+             index_path);
+    return true;
+}
+
+void LayeredFS::SaveIndex(u64 fingerprint) const {
+    const auto index_path = GetIndexPath();
+    const auto temp_path = index_path + ".tmp";
+    if (!FileUtil::CreateFullPath(temp_path)) {
+        LOG_ERROR(Service_FS, "Could not create path {}", temp_path);
+        return;
+    }
+
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file) {
+            LOG_ERROR(Service_FS, "Could not open file {}", temp_path);
+            return;
+        }
+
+        LayeredFSIndexHeader index_header{};
+        index_header.magic = LayeredFSIndexMagic;
+        index_header.version = LayeredFSIndexVersion;
+        index_header.fingerprint = fingerprint;
+        index_header.metadata_size = metadata.size();
+        index_header.data_size = current_data_offset;
+        index_header.file_count = data_offset_index.size();
+
+        bool success = file.WriteObject(index_header) == 1 &&
+                       file.WriteBytes(metadata.data(), metadata.size()) == metadata.size();
+        for (const auto& [data_offset, indexed_file] : data_offset_index) {
+            if (!success) {
+                break;
+            }
+            const auto& relocation = indexed_file->relocation;
+            LayeredFSIndexEntry entry{};
+            entry.data_offset = data_offset;
+            entry.original_offset = relocation.original_offset;
+            entry.size = relocation.size;
+            entry.type = relocation.type;
+            entry.path_length = static_cast<u32>(indexed_file->path.size());
+            entry.replace_file_path_length = static_cast<u32>(relocation.replace_file_path.size());
+            success = file.WriteObject(entry) == 1 &&
+                      file.WriteString(indexed_file->path) == indexed_file->path.size() &&
+                      file.WriteString(relocation.replace_file_path) ==
+                          relocation.replace_file_path.size() &&
+                      file.WriteBytes(relocation.patched_file.data(),
+                                      relocation.patched_file.size()) ==
+                          relocation.patched_file.size();
+        }
+
+        if (!success) {
+            LOG_ERROR(Service_FS, "Could not write LayeredFS index {}", temp_path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+
+    if (!FileUtil::Replace(temp_path, index_path)) {
+        LOG_ERROR(Service_FS, "Could not rename {} to {}", temp_path, index_path);
+        FileUtil::Delete(temp_path);
+    }
 }
 
 LayeredFS::~LayeredFS() = default;
@@ -402,7 +631,8 @@ void LayeredFS::BuildFiles() {
         metadata.file_data_length = file->relocation.size;
         current_data_offset += Common::AlignUp(metadata.file_data_length, 16);
         if (metadata.file_data_length != 0) {
-            data_offset_map.emplace(metadata.file_data_offset, file);
+            // Data offsets are assigned in increasing order, so the index stays sorted
+            data_offset_index.emplace_back(metadata.file_data_offset, file);
         }
 
         const auto bucket =
@@ -502,7 +732,10 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
     }
 
     // Read files
-    auto current = (--data_offset_map.upper_bound(offset));
+    auto current = std::upper_bound(
+        data_offset_index.begin(), data_offset_index.end(), offset,
+        [](std::size_t value, const std::pair<u64, File*>& entry) { return value < entry.first; });
+    --current;
     while (read_size < length) {
         const auto relative_offset = offset - current->first;
         std::size_t to_read{};
@@ -547,14 +780,13 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
     return read_size;
 }
 
-bool LayeredFS::ExtractDirectory(Directory& current, const std::string& target_path) {
+bool LayeredFS::ExtractDirectory(Directory& current, const std::string& target_path,
+                                 std::vector<u8>& buffer) {
     if (!FileUtil::CreateFullPath(target_path + current.path)) {
         LOG_ERROR(Service_FS, "Could not create path {}", target_path + current.path);
         return false;
     }
 
-    constexpr std::size_t BufferSize = 0x10000;
-    std::array<u8, BufferSize> buffer;
     for (const auto& file : current.files) {
         // Extract file
         const auto path = target_path + file->path;
@@ -586,7 +818,7 @@ bool LayeredFS::ExtractDirectory(Directory& current, const std::string& target_p
     }
 
     for (const auto& directory : current.directories) {
-        if (!ExtractDirectory(*directory, target_path)) {
+        if (!ExtractDirectory(*directory, target_path, buffer)) {
             return false;
         }
     }
@@ -600,7 +832,9 @@ bool LayeredFS::DumpRomFS(const std::string& target_path) {
         path.erase(path.size() - 1, 1);
     }
 
-    return ExtractDirectory(root, path);
+    // Large reads of an encrypted RomFS are decrypted on several threads
+    std::vector<u8> buffer(0x1000000);
+    return ExtractDirectory(root, path, buffer);
 }
 
 } // namespace FileSys
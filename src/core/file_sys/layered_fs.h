@@ -4,8 +4,8 @@
 
 #pragma once
 
-#include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -41,6 +41,11 @@ static_assert(sizeof(RomFSHeader) == 0x28, "Size of RomFSHeader is not correct")
  * patch_ext_path: Path for RomFS extensions. Files present in this path:
  *  - When with an extension of ".stub", remove the corresponding file in the RomFS.
  *  - When with an extension of ".ips" or ".bps", patch the file in the RomFS.
+ *
+ * As rebuilding the RomFS walks the whole original metadata and both patch directories, the
+ * rebuilt layout is stored in an index file in the cache directory. The index is keyed on the
+ * original RomFS metadata and the path, size and modification time of every patch file, so any
+ * change to either causes a rebuild.
  */
 class LayeredFS : public RomFSReader {
 public:
@@ -93,11 +98,25 @@ private:
     void BuildFiles();
 
     // Recursively extract a directory and all its contents to target_path
-    // target_path should be without trailing '/'.
-    bool ExtractDirectory(Directory& current, const std::string& target_path);
+    // target_path should be without trailing '/'. buffer is used to copy the files.
+    bool ExtractDirectory(Directory& current, const std::string& target_path,
+                          std::vector<u8>& buffer);
 
     void RebuildMetadata();
 
+    // Fingerprint of the original RomFS metadata and the current state of the patch directories,
+    // or nullopt if changes to the patch directories can't be detected on this host
+    std::optional<u64> ComputeIndexFingerprint();
+
+    std::string GetIndexPath() const;
+
+    // Restores the rebuilt metadata and file data layout from the on-disk index.
+    // Returns false if the index is missing, outdated or invalid.
+    bool LoadIndex(u64 fingerprint);
+
+    // Writes the rebuilt metadata and file data layout to the on-disk index
+    void SaveIndex(u64 fingerprint) const;
+
     void Load();
 
     std::shared_ptr<RomFSReader> romfs;
@@ -109,8 +128,11 @@ private:
     Directory root;
     std::unordered_map<std::string, File*> file_path_map;
     std::unordered_map<std::string, Directory*> directory_path_map;
-    std::map<u64, File*> data_offset_map; // assigned data offset -> file
-    std::vector<u8> metadata;             // Includes header, hash table and metadata
+    std::vector<std::pair<u64, File*>> data_offset_index; // (assigned data offset, file) sorted
+    std::vector<u8> metadata; // Includes header, hash table and metadata
+
+    // Files restored from the index. The directory tree is not populated in this case.
+    std::vector<std::unique_ptr<File>> indexed_files;
 
     // Used for rebuilding header
     std::vector<u32_le> directory_hash_table;
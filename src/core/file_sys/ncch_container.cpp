@@ -2,18 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <cstring>
 #include <memory>
-#include <cryptopp/aes.h>
-#include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/core.h"
+#include "core/file_sys/exefs_code_cache.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/ncch_container.h"
 #include "core/file_sys/patch.h"
 #include "core/file_sys/seed_db.h"
+#include "core/hw/aes/ctr.h"
 #include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
 
@@ -211,6 +213,7 @@ Loader::ResultStatus NCCHContainer::Load() {
             } else {
                 using namespace HW::AES;
                 InitKeys();
+                auto key_slots_lock = LockKeySlots();
                 std::array<u8, 16> key_y_primary, key_y_secondary;
 
                 std::copy(ncch_header.signature, ncch_header.signature + key_y_primary.size(),
@@ -351,10 +354,9 @@ Loader::ResultStatus NCCHContainer::Load() {
                         LOG_ERROR(Service_FS, "Failed to decrypt");
                         return Loader::ResultStatus::ErrorEncrypted;
                     }
-                    CryptoPP::byte* data = reinterpret_cast<CryptoPP::byte*>(&exheader_header);
-                    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption(
-                        primary_key.data(), primary_key.size(), exheader_ctr.data())
-                        .ProcessData(data, data, sizeof(exheader_header));
+                    HW::AES::DecryptCTR(primary_key, exheader_ctr, 0,
+                                        reinterpret_cast<u8*>(&exheader_header),
+                                        sizeof(exheader_header));
                 }
             }
 
@@ -423,10 +425,8 @@ Loader::ResultStatus NCCHContainer::Load() {
                 return Loader::ResultStatus::Error;
 
             if (is_encrypted) {
-                CryptoPP::byte* data = reinterpret_cast<CryptoPP::byte*>(&exefs_header);
-                CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption(primary_key.data(),
-                                                              primary_key.size(), exefs_ctr.data())
-                    .ProcessData(data, data, sizeof(exefs_header));
+                HW::AES::DecryptCTR(primary_key, exefs_ctr, 0, reinterpret_cast<u8*>(&exefs_header),
+                                    sizeof(exefs_header));
             }
 
             exefs_file = FileUtil::IOFile(filepath, "rb");
@@ -535,9 +535,7 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 key = secondary_key;
             }
 
-            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key.data(), key.size(),
-                                                              exefs_ctr.data());
-            dec.Seek(section.offset + sizeof(ExeFs_Header));
+            const u64 crypto_offset = section.offset + sizeof(ExeFs_Header);
 
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
@@ -552,22 +550,33 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                     return Loader::ResultStatus::Error;
 
                 if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                    HW::AES::DecryptCTR(key, exefs_ctr, crypto_offset, &temp_buffer[0],
+                                        section.size);
                 }
 
+                const ExeFSCodeCache code_cache{
+                    u64{Settings::values.exefs_code_cache_size.GetValue()} * 1024 * 1024};
+                if (code_cache.Load(&temp_buffer[0], section.size, buffer))
+                    return Loader::ResultStatus::Success;
+
                 // Decompress .code section...
+                const auto decompress_start = std::chrono::steady_clock::now();
                 u32 decompressed_size = LZSS_GetDecompressedSize(&temp_buffer[0], section.size);
                 buffer.resize(decompressed_size);
                 if (!LZSS_Decompress(&temp_buffer[0], section.size, buffer.data(),
                                      decompressed_size))
                     return Loader::ResultStatus::ErrorInvalidFormat;
+                code_cache.Store(&temp_buffer[0], section.size, buffer,
+                                 std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - decompress_start));
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
                 if (exefs_file.ReadBytes(buffer.data(), section.size) != section.size)
                     return Loader::ResultStatus::Error;
                 if (is_encrypted) {
-                    dec.ProcessData(buffer.data(), buffer.data(), section.size);
+                    HW::AES::DecryptCTR(key, exefs_ctr, crypto_offset, buffer.data(),
+                                        section.size);
                 }
             }
 
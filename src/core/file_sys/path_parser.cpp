@@ -6,6 +6,7 @@
 #include <set>
 #include "common/file_util.h"
 #include "common/string_util.h"
+#include "core/file_sys/host_directory_cache.h"
 #include "core/file_sys/path_parser.h"
 
 namespace FileSys {
@@ -57,9 +58,20 @@ PathParser::PathParser(const Path& path) {
     is_root = level == 0;
 }
 
-PathParser::HostStatus PathParser::GetHostStatus(std::string_view mount_point) const {
+PathParser::HostStatus PathParser::GetHostStatus(std::string_view mount_point,
+                                                 HostDirectoryCache* directory_cache) const {
+    using EntryType = HostDirectoryCache::EntryType;
+    const auto get_entry_type = [directory_cache](const std::string& path) {
+        if (directory_cache) {
+            return directory_cache->GetEntryType(path);
+        }
+        if (!FileUtil::Exists(path))
+            return EntryType::NotFound;
+        return FileUtil::IsDirectory(path) ? EntryType::Directory : EntryType::File;
+    };
+
     std::string path{mount_point};
-    if (!FileUtil::IsDirectory(path))
+    if (get_entry_type(path) != EntryType::Directory)
         return InvalidMountPoint;
     if (path_sequence.empty()) {
         return DirectoryFound;
@@ -70,19 +82,23 @@ PathParser::HostStatus PathParser::GetHostStatus(std::string_view mount_point) c
             path += '/';
         path += *iter;
 
-        if (!FileUtil::Exists(path))
+        const auto entry_type = get_entry_type(path);
+        if (entry_type == EntryType::NotFound)
             return PathNotFound;
-        if (FileUtil::IsDirectory(path))
+        if (entry_type == EntryType::Directory)
             continue;
         return FileInPath;
     }
 
     path += "/" + path_sequence.back();
-    if (!FileUtil::Exists(path))
+    switch (get_entry_type(path)) {
+    case EntryType::NotFound:
         return NotFound;
-    if (FileUtil::IsDirectory(path))
+    case EntryType::Directory:
         return DirectoryFound;
-    return FileFound;
+    default:
+        return FileFound;
+    }
 }
 
 std::string PathParser::BuildHostPath(std::string_view mount_point) const {
@@ -10,6 +10,8 @@
 
 namespace FileSys {
 
+class HostDirectoryCache;
+
 /**
  * A helper class parsing and verifying a string-type Path.
  * Every archives with a sub file system should use this class to parse the path argument and check
@@ -46,8 +48,13 @@ public:
         NotFound        // "/a/b/c" when "a/b/" exists but "c" doesn't exist
     };
 
-    /// Checks the status of the specified file / directory by the Path on the host file system.
-    HostStatus GetHostStatus(std::string_view mount_point) const;
+    /**
+     * Checks the status of the specified file / directory by the Path on the host file system.
+     * @param mount_point the host path the Path is relative to
+     * @param directory_cache the cache to look up the host paths in, if any
+     */
+    HostStatus GetHostStatus(std::string_view mount_point,
+                             HostDirectoryCache* directory_cache = nullptr) const;
 
     /// Builds a full path on the host file system.
     std::string BuildHostPath(std::string_view mount_point) const;
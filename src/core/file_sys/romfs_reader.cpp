@@ -1,8 +1,7 @@
 #include <algorithm>
-#include <cryptopp/aes.h>
-#include <cryptopp/modes.h>
 #include "common/archives.h"
 #include "core/file_sys/romfs_reader.h"
+#include "core/hw/aes/ctr.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::DirectRomFSReader)
 
@@ -15,9 +14,7 @@ std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length,
     std::size_t read_length = std::min(length, static_cast<std::size_t>(data_size) - offset);
     read_length = file.ReadBytes(buffer, read_length);
     if (is_encrypted) {
-        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-        d.Seek(crypto_offset + offset);
-        d.ProcessData(buffer, buffer, read_length);
+        HW::AES::DecryptCTR(key, ctr, crypto_offset + offset, buffer, read_length);
     }
     return read_length;
 }
@@ -6,8 +6,10 @@
 #include "common/file_util.h"
 #include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
+#include "core/file_sys/host_directory_cache.h"
 #include "core/file_sys/path_parser.h"
 #include "core/file_sys/savedata_archive.h"
+#include "core/file_sys/write_behind_file.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // FileSys namespace
@@ -38,6 +40,10 @@ public:
     SERIALIZE_DELAY_GENERATOR
 };
 
+SaveDataArchive::SaveDataArchive(const std::string& mount_point_) : mount_point(mount_point_) {
+    WriteBehindFile::RemoveTempFiles(mount_point);
+}
+
 ResultVal<std::unique_ptr<FileBackend>> SaveDataArchive::OpenFile(const Path& path,
                                                                   const Mode& mode) const {
     LOG_DEBUG(Service_FS, "called path={} mode={:01X}", path.DebugStr(), mode.hex);
@@ -61,7 +67,7 @@ ResultVal<std::unique_ptr<FileBackend>> SaveDataArchive::OpenFile(const Path& pa
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_FILE_NOT_FOUND;
@@ -86,15 +92,16 @@ ResultVal<std::unique_ptr<FileBackend>> SaveDataArchive::OpenFile(const Path& pa
         break; // Expected 'success' case
     }
 
-    FileUtil::IOFile file(full_path, mode.write_flag ? "r+b" : "rb");
-    if (!file.IsOpen()) {
+    if (!FileUtil::IOFile(full_path, mode.write_flag ? "r+b" : "rb").IsOpen()) {
         LOG_CRITICAL(Service_FS, "(unreachable) Unknown error opening {}", full_path);
         return ERROR_FILE_NOT_FOUND;
     }
 
     std::unique_ptr<DelayGenerator> delay_generator = std::make_unique<SaveDataDelayGenerator>();
-    auto disk_file = std::make_unique<DiskFile>(std::move(file), mode, std::move(delay_generator));
-    return MakeResult<std::unique_ptr<FileBackend>>(std::move(disk_file));
+    // The free space is a fixed amount, so it bounds each file rather than all of them
+    auto file = std::make_unique<WriteBehindFile>(full_path, mount_point, GetFreeBytes(), mode,
+                                                  std::move(delay_generator));
+    return MakeResult<std::unique_ptr<FileBackend>>(std::move(file));
 }
 
 ResultCode SaveDataArchive::DeleteFile(const Path& path) const {
@@ -107,7 +114,7 @@ ResultCode SaveDataArchive::DeleteFile(const Path& path) const {
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_FILE_NOT_FOUND;
@@ -123,6 +130,7 @@ ResultCode SaveDataArchive::DeleteFile(const Path& path) const {
         break; // Expected 'success' case
     }
 
+    WriteBehindFile::DiscardAll(full_path);
     if (FileUtil::Delete(full_path)) {
         return RESULT_SUCCESS;
     }
@@ -150,7 +158,9 @@ ResultCode SaveDataArchive::RenameFile(const Path& src_path, const Path& dest_pa
     const auto src_path_full = path_parser_src.BuildHostPath(mount_point);
     const auto dest_path_full = path_parser_dest.BuildHostPath(mount_point);
 
+    WriteBehindFile::FlushAll(src_path_full);
     if (FileUtil::Rename(src_path_full, dest_path_full)) {
+        WriteBehindFile::RenameAll(src_path_full, dest_path_full);
         return RESULT_SUCCESS;
     }
 
@@ -175,7 +185,7 @@ static ResultCode DeleteDirectoryHelper(const Path& path, const std::string& mou
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_PATH_NOT_FOUND;
@@ -204,8 +214,10 @@ ResultCode SaveDataArchive::DeleteDirectory(const Path& path) const {
 }
 
 ResultCode SaveDataArchive::DeleteDirectoryRecursively(const Path& path) const {
-    return DeleteDirectoryHelper(
-        path, mount_point, [](const std::string& p) { return FileUtil::DeleteDirRecursively(p); });
+    return DeleteDirectoryHelper(path, mount_point, [](const std::string& p) {
+        WriteBehindFile::DiscardAll(p);
+        return FileUtil::DeleteDirRecursively(p);
+    });
 }
 
 ResultCode SaveDataArchive::CreateFile(const FileSys::Path& path, u64 size) const {
@@ -218,7 +230,7 @@ ResultCode SaveDataArchive::CreateFile(const FileSys::Path& path, u64 size) cons
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_FILE_NOT_FOUND;
@@ -263,7 +275,7 @@ ResultCode SaveDataArchive::CreateDirectory(const Path& path) const {
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_FILE_NOT_FOUND;
@@ -309,7 +321,9 @@ ResultCode SaveDataArchive::RenameDirectory(const Path& src_path, const Path& de
     const auto src_path_full = path_parser_src.BuildHostPath(mount_point);
     const auto dest_path_full = path_parser_dest.BuildHostPath(mount_point);
 
+    WriteBehindFile::FlushAll(src_path_full);
     if (FileUtil::Rename(src_path_full, dest_path_full)) {
+        WriteBehindFile::RenameAll(src_path_full, dest_path_full);
         return RESULT_SUCCESS;
     }
 
@@ -330,7 +344,7 @@ ResultVal<std::unique_ptr<DirectoryBackend>> SaveDataArchive::OpenDirectory(
 
     const auto full_path = path_parser.BuildHostPath(mount_point);
 
-    switch (path_parser.GetHostStatus(mount_point)) {
+    switch (path_parser.GetHostStatus(mount_point, &HostDirectoryCache::GetInstance())) {
     case PathParser::InvalidMountPoint:
         LOG_CRITICAL(Service_FS, "(unreachable) Invalid mount point {}", mount_point);
         return ERROR_FILE_NOT_FOUND;
@@ -346,7 +360,10 @@ ResultVal<std::unique_ptr<DirectoryBackend>> SaveDataArchive::OpenDirectory(
         break; // Expected 'success' case
     }
 
-    auto directory = std::make_unique<DiskDirectory>(full_path);
+    // The listed file sizes come from the host files
+    WriteBehindFile::FlushAll(full_path);
+    auto directory =
+        std::make_unique<DiskDirectory>(HostDirectoryCache::GetInstance().GetDirectory(full_path));
     return MakeResult<std::unique_ptr<DirectoryBackend>>(std::move(directory));
 }
 
@@ -355,6 +372,11 @@ u64 SaveDataArchive::GetFreeBytes() const {
     return 1024 * 1024 * 32;
 }
 
+ResultCode SaveDataArchive::Commit() const {
+    WriteBehindFile::FlushAll(mount_point);
+    return RESULT_SUCCESS;
+}
+
 } // namespace FileSys
 
 SERIALIZE_EXPORT_IMPL(FileSys::SaveDataArchive)
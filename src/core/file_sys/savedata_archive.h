@@ -18,7 +18,7 @@ namespace FileSys {
 /// Archive backend for general save data archive type (SaveData and SystemSaveData)
 class SaveDataArchive : public ArchiveBackend {
 public:
-    explicit SaveDataArchive(const std::string& mount_point_) : mount_point(mount_point_) {}
+    explicit SaveDataArchive(const std::string& mount_point_);
 
     std::string GetName() const override {
         return "SaveDataArchive: " + mount_point;
@@ -35,6 +35,7 @@ public:
     ResultCode RenameDirectory(const Path& src_path, const Path& dest_path) const override;
     ResultVal<std::unique_ptr<DirectoryBackend>> OpenDirectory(const Path& path) const override;
     u64 GetFreeBytes() const override;
+    ResultCode Commit() const override;
 
 protected:
     std::string mount_point;
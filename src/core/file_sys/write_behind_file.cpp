@@ -0,0 +1,428 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <fmt/format.h>
+#include "common/archives.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/file_sys/errors.h"
+#include "core/file_sys/write_behind_file.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// FileSys namespace
+
+namespace FileSys {
+
+namespace {
+
+bool IsAtOrUnder(const std::string& path, const std::string& parent) {
+    if (parent.empty() || !path.starts_with(parent)) {
+        return false;
+    }
+    return path.size() == parent.size() || parent.back() == '/' || path[parent.size()] == '/';
+}
+
+/// Gets the directory of the temporary files of an archive, next to its mount point.
+std::string GetTempDirectory(std::string mount_point) {
+    while (!mount_point.empty() && mount_point.back() == '/') {
+        mount_point.pop_back();
+    }
+    return mount_point + ".tmp" DIR_SEP;
+}
+
+} // Anonymous namespace
+
+struct WriteBehindFile::Contents : std::enable_shared_from_this<Contents> {
+    Contents(std::string path_, std::string temp_directory_)
+        : path{std::move(path_)}, temp_directory{std::move(temp_directory_)} {}
+
+    ~Contents() {
+        WriteBack();
+
+        auto& registry = GetRegistry();
+        std::scoped_lock lock{registry.mutex};
+        const auto itr = registry.contents.find(path);
+        if (itr != registry.contents.end() && itr->second.expired()) {
+            registry.contents.erase(itr);
+        }
+    }
+
+    /// Gets the contents of a host file, shared with its other open files.
+    static std::shared_ptr<Contents> Open(const std::string& path,
+                                          const std::string& temp_directory) {
+        auto& registry = GetRegistry();
+        std::scoped_lock lock{registry.mutex};
+        auto& entry = registry.contents[path];
+        auto contents = entry.lock();
+        if (!contents) {
+            contents = std::make_shared<Contents>(path, temp_directory);
+            entry = contents;
+        }
+        return contents;
+    }
+
+    /// Removes the temporary files of an archive, unless some of its files are open.
+    static void RemoveTempFiles(const std::string& mount_point) {
+        auto& registry = GetRegistry();
+        std::scoped_lock lock{registry.mutex};
+        // Expired contents are still registered while they are written back on destruction
+        for (const auto& [file_path, entry] : registry.contents) {
+            if (IsAtOrUnder(file_path, mount_point)) {
+                return;
+            }
+        }
+        const auto temp_directory = GetTempDirectory(mount_point);
+        if (FileUtil::Exists(temp_directory)) {
+            LOG_WARNING(Service_FS, "Removing the files of interrupted write backs in {}",
+                        temp_directory);
+            FileUtil::DeleteDirRecursively(temp_directory);
+        }
+    }
+
+    /// Gets the contents of the open files at or under a host path.
+    static std::vector<std::shared_ptr<Contents>> FindAll(const std::string& path) {
+        std::vector<std::shared_ptr<Contents>> found;
+        auto& registry = GetRegistry();
+        std::scoped_lock lock{registry.mutex};
+        for (const auto& [file_path, entry] : registry.contents) {
+            if (IsAtOrUnder(file_path, path)) {
+                if (auto contents = entry.lock()) {
+                    found.push_back(std::move(contents));
+                }
+            }
+        }
+        return found;
+    }
+
+    /// Moves the contents to another host path, or detaches them from the host file if empty.
+    /// Called with the mutex of the contents held.
+    void Move(std::string new_path) {
+        auto& registry = GetRegistry();
+        std::scoped_lock lock{registry.mutex};
+        registry.contents.erase(path);
+        path = std::move(new_path);
+        if (!path.empty()) {
+            registry.contents.insert_or_assign(path, weak_from_this());
+        }
+    }
+
+    /**
+     * Reads the host file if it was not read yet. Returns false if it could not be read, in which
+     * case the contents must not be changed, as writing them back would replace the file.
+     */
+    bool Load() {
+        if (is_loaded || path.empty()) {
+            is_loaded = true;
+            return true;
+        }
+
+        FileUtil::IOFile file(path, "rb");
+        if (!file) {
+            LOG_ERROR(Service_FS, "Could not open file {}", path);
+            return false;
+        }
+        std::vector<u8> file_data(file.GetSize());
+        if (file.ReadBytes(file_data.data(), file_data.size()) != file_data.size()) {
+            LOG_ERROR(Service_FS, "Could not read file {}", path);
+            return false;
+        }
+        data = std::move(file_data);
+        is_loaded = true;
+        return true;
+    }
+
+    void MarkDirty() {
+        if (is_dirty) {
+            return;
+        }
+        is_dirty = true;
+        dirty_since = std::chrono::steady_clock::now();
+        ScheduleWriteBack(dirty_since + FlushInterval);
+    }
+
+    void WriteBack() {
+        if (!is_dirty || path.empty()) {
+            return;
+        }
+
+        // Write to a temporary file first so that an interrupted write never leaves a partial file.
+        // Its contents must be on the disk before it replaces the file, or a crash may still lose
+        // both.
+        const auto temp_path = fmt::format("{}{:016X}", temp_directory,
+                                           Common::ComputeHash64(path.data(), path.size()));
+        if (!FileUtil::CreateFullPath(temp_path)) {
+            LOG_ERROR(Service_FS, "Could not create path {}", temp_path);
+            return;
+        }
+        {
+            FileUtil::IOFile file(temp_path, "wb");
+            if (!file || file.WriteBytes(data.data(), data.size()) != data.size() ||
+                !file.Sync()) {
+                LOG_ERROR(Service_FS, "Could not write file {}", temp_path);
+                file.Close();
+                FileUtil::Delete(temp_path);
+                return;
+            }
+        }
+        if (!FileUtil::Replace(temp_path, path)) {
+            LOG_ERROR(Service_FS, "Could not rename {} to {}", temp_path, path);
+            FileUtil::Delete(temp_path);
+            return;
+        }
+        is_dirty = false;
+    }
+
+    /// Mutex for the members below, as the flush thread writes the contents back
+    std::mutex mutex;
+    std::string path; ///< Empty once the host file was deleted
+    std::string temp_directory;
+    std::vector<u8> data;
+    bool is_loaded = false;
+    bool is_dirty = false;
+    std::chrono::steady_clock::time_point dirty_since;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Open files by host path, and the thread that writes back the files that stayed dirty for
+     * FlushInterval, so that the last changes before a game goes idle are not only in memory.
+     * The registry mutex is never locked before the mutex of some contents.
+     */
+    struct Registry {
+        ~Registry() {
+            {
+                std::scoped_lock lock{mutex};
+                stop_requested = true;
+            }
+            write_backs_changed.notify_one();
+            if (flush_thread.joinable()) {
+                flush_thread.join();
+            }
+        }
+
+        void FlushLoop() {
+            Common::SetCurrentThreadName("WriteBehindFile");
+            std::unique_lock lock{mutex};
+            while (!stop_requested) {
+                if (write_backs.empty()) {
+                    write_backs_changed.wait(lock);
+                    continue;
+                }
+                const auto next = std::min_element(
+                    write_backs.begin(), write_backs.end(),
+                    [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+                if (const auto time = next->first; Clock::now() < time) {
+                    write_backs_changed.wait_until(lock, time);
+                    continue;
+                }
+                std::weak_ptr<Contents> weak_contents = std::move(next->second);
+                write_backs.erase(next);
+
+                // The contents may have been written back and changed again meanwhile, in which
+                // case they have a later write back of their own. They are released before
+                // locking again, as destroying them locks the registry.
+                lock.unlock();
+                if (const auto contents = weak_contents.lock()) {
+                    std::scoped_lock contents_lock{contents->mutex};
+                    if (contents->is_dirty &&
+                        Clock::now() - contents->dirty_since >= FlushInterval) {
+                        contents->WriteBack();
+                    }
+                }
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex;
+        std::unordered_map<std::string, std::weak_ptr<Contents>> contents;
+        std::vector<std::pair<Clock::time_point, std::weak_ptr<Contents>>> write_backs;
+        std::condition_variable write_backs_changed;
+        bool stop_requested = false;
+        std::thread flush_thread; ///< Started by the first write back
+    };
+
+    static Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    void ScheduleWriteBack(Clock::time_point time) {
+        auto& registry = GetRegistry();
+        {
+            std::scoped_lock lock{registry.mutex};
+            registry.write_backs.emplace_back(time, weak_from_this());
+            if (!registry.flush_thread.joinable()) {
+                registry.flush_thread = std::thread{[&registry] { registry.FlushLoop(); }};
+            }
+        }
+        registry.write_backs_changed.notify_one();
+    }
+
+};
+
+WriteBehindFile::WriteBehindFile(const std::string& path, const std::string& mount_point,
+                                 u64 max_size_, const Mode& mode_,
+                                 std::unique_ptr<DelayGenerator> delay_generator_)
+    : max_size{max_size_}, contents{Contents::Open(path, GetTempDirectory(mount_point))} {
+    delay_generator = std::move(delay_generator_);
+    mode.hex = mode_.hex;
+}
+
+WriteBehindFile::~WriteBehindFile() = default;
+
+ResultVal<std::size_t> WriteBehindFile::Read(const u64 offset, const std::size_t length,
+                                             u8* buffer) const {
+    if (!mode.read_flag)
+        return ERROR_INVALID_OPEN_FLAGS;
+
+    std::scoped_lock lock{contents->mutex};
+    if (!contents->Load()) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+    if (offset >= contents->data.size()) {
+        return MakeResult<std::size_t>(0);
+    }
+    const auto read =
+        static_cast<std::size_t>(std::min<u64>(length, contents->data.size() - offset));
+    std::memcpy(buffer, contents->data.data() + offset, read);
+    return MakeResult<std::size_t>(read);
+}
+
+ResultVal<std::size_t> WriteBehindFile::Write(const u64 offset, const std::size_t length,
+                                              const bool flush, const u8* buffer) {
+    if (!mode.write_flag)
+        return ERROR_INVALID_OPEN_FLAGS;
+    if (length == 0)
+        return MakeResult<std::size_t>(0);
+
+    // The flush flag is not a commit, so it does not force a write back
+    std::scoped_lock lock{contents->mutex};
+    if (!contents->Load()) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+    if (offset > contents->data.size() || length > contents->data.size() - offset) {
+        // The offset comes from the guest, and the contents are only in memory
+        if (offset > max_size || length > max_size - offset) {
+            LOG_ERROR(Service_FS, "Write of {} bytes at {} exceeds the size limit of {}", length,
+                      offset, contents->path);
+            return ERROR_INSUFFICIENT_SPACE;
+        }
+        contents->data.resize(offset + length);
+    }
+    std::memcpy(contents->data.data() + offset, buffer, length);
+    contents->MarkDirty();
+    return MakeResult<std::size_t>(length);
+}
+
+u64 WriteBehindFile::GetSize() const {
+    std::scoped_lock lock{contents->mutex};
+    if (!contents->is_loaded && !contents->path.empty()) {
+        return FileUtil::GetSize(contents->path);
+    }
+    return contents->data.size();
+}
+
+bool WriteBehindFile::SetSize(const u64 size) const {
+    std::scoped_lock lock{contents->mutex};
+    if (!contents->Load()) {
+        return false;
+    }
+    if (size > max_size && size > contents->data.size()) {
+        LOG_ERROR(Service_FS, "Size {} exceeds the size limit of {}", size, contents->path);
+        return false;
+    }
+    contents->data.resize(size);
+    contents->MarkDirty();
+    return true;
+}
+
+bool WriteBehindFile::Close() const {
+    std::scoped_lock lock{contents->mutex};
+    contents->WriteBack();
+    return true;
+}
+
+void WriteBehindFile::Flush() const {
+    std::scoped_lock lock{contents->mutex};
+    contents->WriteBack();
+}
+
+void WriteBehindFile::FlushAll(const std::string& path) {
+    for (const auto& contents : Contents::FindAll(path)) {
+        std::scoped_lock lock{contents->mutex};
+        contents->WriteBack();
+    }
+}
+
+void WriteBehindFile::DiscardAll(const std::string& path) {
+    for (const auto& contents : Contents::FindAll(path)) {
+        std::scoped_lock lock{contents->mutex};
+        contents->is_dirty = false;
+        contents->Move({});
+    }
+}
+
+void WriteBehindFile::RemoveTempFiles(const std::string& mount_point) {
+    Contents::RemoveTempFiles(mount_point);
+}
+
+void WriteBehindFile::RenameAll(const std::string& src_path, const std::string& dest_path) {
+    for (const auto& contents : Contents::FindAll(src_path)) {
+        std::scoped_lock lock{contents->mutex};
+        contents->Move(dest_path + contents->path.substr(src_path.size()));
+    }
+}
+
+template <class Archive>
+void WriteBehindFile::save(Archive& ar, const unsigned int) const {
+    ar << boost::serialization::base_object<FileBackend>(*this);
+    ar << mode.hex;
+    ar << max_size;
+    std::scoped_lock lock{contents->mutex};
+    ar << contents->path;
+    ar << contents->temp_directory;
+    ar << contents->data;
+    ar << contents->is_loaded;
+    ar << contents->is_dirty;
+}
+
+template <class Archive>
+void WriteBehindFile::load(Archive& ar, const unsigned int) {
+    ar >> boost::serialization::base_object<FileBackend>(*this);
+    ar >> mode.hex;
+    ar >> max_size;
+    std::string path;
+    ar >> path;
+    std::string temp_directory;
+    ar >> temp_directory;
+    contents = path.empty() ? std::make_shared<Contents>(path, temp_directory)
+                            : Contents::Open(path, temp_directory);
+    std::scoped_lock lock{contents->mutex};
+    ar >> contents->data;
+    ar >> contents->is_loaded;
+    bool is_dirty;
+    ar >> is_dirty;
+    contents->is_dirty = false;
+    if (is_dirty) {
+        contents->MarkDirty();
+    }
+}
+
+} // namespace FileSys
+
+SERIALIZE_EXPORT_IMPL(FileSys::WriteBehindFile)
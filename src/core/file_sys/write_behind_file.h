@@ -0,0 +1,90 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/split_member.hpp>
+#include "common/common_types.h"
+#include "core/file_sys/archive_backend.h"
+#include "core/file_sys/file_backend.h"
+#include "core/hle/result.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// FileSys namespace
+
+namespace FileSys {
+
+/**
+ * Host file whose contents are kept in memory while it is open. Games write their save data in
+ * many small chunks, each of which would otherwise be a write to the host file, so writes are
+ * only applied to the memory and the whole file is written back when it is flushed or closed, when
+ * its archive is committed, or once FlushInterval has passed since the first unwritten change.
+ *
+ * The file is written back to a temporary file that then replaces it, so the host file is always
+ * either the old or the new contents. The temporary files are kept next to the mount point of the
+ * archive rather than in it, where the guest would see them. All the open files of a host path
+ * share their contents.
+ */
+class WriteBehindFile final : public FileBackend {
+public:
+    static constexpr std::chrono::seconds FlushInterval{2};
+
+    /**
+     * @param path the host path of the file
+     * @param mount_point the host path of the archive of the file
+     * @param max_size the size the file may not grow past, as its contents are kept in memory
+     */
+    WriteBehindFile(const std::string& path, const std::string& mount_point, u64 max_size,
+                    const Mode& mode, std::unique_ptr<DelayGenerator> delay_generator_);
+    ~WriteBehindFile() override;
+
+    ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
+    ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
+                                 const u8* buffer) override;
+    u64 GetSize() const override;
+    bool SetSize(u64 size) const override;
+    bool Close() const override;
+    void Flush() const override;
+
+    /// Writes back the changes of the open files at or under a host path.
+    static void FlushAll(const std::string& path);
+
+    /// Drops the changes of the open files at or under a host path, which is being deleted.
+    static void DiscardAll(const std::string& path);
+
+    /// Moves the open files at or under a host path, which was renamed, to the new path.
+    static void RenameAll(const std::string& src_path, const std::string& dest_path);
+
+    /**
+     * Removes the temporary files that an interrupted write back left for the archive at a mount
+     * point. Nothing is removed while files of the archive are open, which may be written back.
+     */
+    static void RemoveTempFiles(const std::string& mount_point);
+
+private:
+    struct Contents;
+
+    WriteBehindFile() = default;
+
+    template <class Archive>
+    void save(Archive& ar, const unsigned int) const;
+    template <class Archive>
+    void load(Archive& ar, const unsigned int);
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+    friend class boost::serialization::access;
+
+    Mode mode;
+    u64 max_size;
+    std::shared_ptr<Contents> contents;
+};
+
+} // namespace FileSys
+
+BOOST_CLASS_EXPORT_KEY(FileSys::WriteBehindFile)
@@ -0,0 +1,73 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <mutex>
+#include "core/frontend/hid_input.h"
+
+namespace Input {
+
+namespace {
+std::mutex source_mutex;
+std::shared_ptr<HIDSnapshotSource> snapshot_source;
+} // Anonymous namespace
+
+void HIDDevices::Load() {
+    const auto& profile = Settings::values.current_input_profile;
+    std::transform(profile.buttons.begin() + Settings::NativeButton::BUTTON_HID_BEGIN,
+                   profile.buttons.begin() + Settings::NativeButton::BUTTON_HID_END,
+                   buttons.begin(), CreateDevice<ButtonDevice>);
+    circle_pad = CreateDevice<AnalogDevice>(profile.analogs[Settings::NativeAnalog::CirclePad]);
+    motion_device = CreateDevice<MotionDevice>(profile.motion_device);
+    touch_device = CreateDevice<TouchDevice>(profile.touch_device);
+    if (profile.use_touch_from_button) {
+        touch_btn_device = CreateDevice<TouchDevice>("engine:touch_from_button");
+    } else {
+        touch_btn_device.reset();
+    }
+}
+
+HIDSnapshot HIDDevices::Sample() const {
+    HIDSnapshot snapshot;
+    if (!circle_pad) {
+        return snapshot;
+    }
+
+    for (std::size_t i = 0; i < buttons.size(); i++) {
+        snapshot.buttons |= static_cast<u32>(buttons[i]->GetStatus()) << i;
+    }
+    std::tie(snapshot.circle_pad_x, snapshot.circle_pad_y) = circle_pad->GetStatus();
+    std::tie(snapshot.touch_x, snapshot.touch_y, snapshot.touch_pressed) =
+        touch_device->GetStatus();
+    if (!snapshot.touch_pressed && touch_btn_device) {
+        std::tie(snapshot.touch_x, snapshot.touch_y, snapshot.touch_pressed) =
+            touch_btn_device->GetStatus();
+    }
+    std::tie(snapshot.accel, snapshot.gyro) = motion_device->GetStatus();
+    snapshot.sample_time = std::chrono::steady_clock::now();
+    return snapshot;
+}
+
+void HIDDevices::SampleMotion(HIDSnapshot& snapshot) const {
+    if (motion_device) {
+        std::tie(snapshot.accel, snapshot.gyro) = motion_device->GetStatus();
+    }
+}
+
+void RegisterHIDSnapshotSource(std::shared_ptr<HIDSnapshotSource> source) {
+    std::scoped_lock lock{source_mutex};
+    snapshot_source = std::move(source);
+}
+
+void UnregisterHIDSnapshotSource() {
+    std::scoped_lock lock{source_mutex};
+    snapshot_source.reset();
+}
+
+std::shared_ptr<HIDSnapshotSource> GetHIDSnapshotSource() {
+    std::scoped_lock lock{source_mutex};
+    return snapshot_source;
+}
+
+} // namespace Input
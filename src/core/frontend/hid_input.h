@@ -0,0 +1,90 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include "common/common_types.h"
+#include "common/settings.h"
+#include "common/vector_math.h"
+#include "core/frontend/input.h"
+
+namespace Input {
+
+/// The status of every input device read by the HID module, sampled at one point in time.
+struct HIDSnapshot {
+    /// Pressed buttons, bit i being Settings::NativeButton::BUTTON_HID_BEGIN + i
+    u32 buttons = 0;
+    float circle_pad_x = 0.0f;
+    float circle_pad_y = 0.0f;
+    float touch_x = 0.0f;
+    float touch_y = 0.0f;
+    bool touch_pressed = false;
+    Common::Vec3<float> accel{};
+    Common::Vec3<float> gyro{};
+    /// Time the devices were read at
+    std::chrono::steady_clock::time_point sample_time{};
+
+    [[nodiscard]] bool IsPressed(int button) const {
+        return (buttons >> (button - Settings::NativeButton::BUTTON_HID_BEGIN)) & 1;
+    }
+};
+
+/// The input devices of the current input profile that the HID module reads.
+class HIDDevices {
+public:
+    /// Creates the devices from the current input profile.
+    void Load();
+
+    /// Reads the status of every device. Devices are not loaded until Load is called.
+    [[nodiscard]] HIDSnapshot Sample() const;
+
+    /// Reads only the motion device into the accel and gyro of the snapshot.
+    void SampleMotion(HIDSnapshot& snapshot) const;
+
+private:
+    std::array<std::unique_ptr<ButtonDevice>, Settings::NativeButton::NUM_BUTTONS_HID> buttons;
+    std::unique_ptr<AnalogDevice> circle_pad;
+    std::unique_ptr<MotionDevice> motion_device;
+    std::unique_ptr<TouchDevice> touch_device;
+    std::unique_ptr<TouchDevice> touch_btn_device;
+};
+
+/**
+ * A source of HID snapshots that samples the devices away from the emulation thread, so that the
+ * HID module only has to read the latest snapshot on each update instead of every device.
+ */
+class HIDSnapshotSource {
+public:
+    virtual ~HIDSnapshotSource() = default;
+
+    /// Returns the latest snapshot. Only called by the emulation thread.
+    [[nodiscard]] virtual const HIDSnapshot& Read() = 0;
+
+    /// Creates the devices again from the current input profile before sampling them next.
+    virtual void ReloadDevices() = 0;
+
+    /// Starts sampling for an emulation session. Sampling goes on until every session that
+    /// started it has stopped it.
+    virtual void Start() = 0;
+
+    /// Stops sampling for an emulation session started with Start.
+    virtual void Stop() = 0;
+};
+
+/**
+ * Registers the snapshot source read by the HID module, replacing any previous one. Without a
+ * source, the HID module reads the devices itself.
+ */
+void RegisterHIDSnapshotSource(std::shared_ptr<HIDSnapshotSource> source);
+
+/// Unregisters the snapshot source, if any.
+void UnregisterHIDSnapshotSource();
+
+/// Returns the registered snapshot source, or nullptr if there is none.
+[[nodiscard]] std::shared_ptr<HIDSnapshotSource> GetHIDSnapshotSource();
+
+} // namespace Input
@@ -5,6 +5,9 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <deque>
+#include <future>
+#include <thread>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <fmt/format.h>
@@ -44,6 +47,12 @@ constexpr u8 VARIATION_SYSTEM = 0x02;
 constexpr u32 TID_HIGH_UPDATE = 0x0004000E;
 constexpr u32 TID_HIGH_DLC = 0x0004008C;
 
+// Size of the chunks content data is split into when installing a CIA from a host file. Must be
+// a multiple of the AES block size so that each chunk can be decrypted independently.
+constexpr std::size_t CIA_INSTALL_CHUNK_SIZE = 0x100000;
+// Maximum number of chunks held in memory at once, bounding the install to 16 MiB of buffers.
+constexpr std::size_t CIA_INSTALL_MAX_CHUNKS_IN_FLIGHT = 16;
+
 struct TitleInfo {
     u64_le tid;
     u64_le size;
@@ -186,9 +195,7 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
 
             if ((tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
                 if (decryption_state->content.size() <= i) {
-                    // TODO: There is probably no correct error to return here. What error should be
-                    // returned?
-                    return FileSys::ERROR_INSUFFICIENT_SPACE;
+                    return ERROR_TITLE_KEY_UNAVAILABLE;
                 }
                 decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
             }
@@ -206,6 +213,137 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
     return MakeResult(length);
 }
 
+ResultCode CIAFile::WriteContentDataFromFile(
+    FileUtil::IOFile& source, Common::ThreadWorker& workers, std::size_t max_chunks_in_flight,
+    const std::function<ProgressCallback>& update_callback) {
+    struct Chunk {
+        std::size_t content_index;
+        std::vector<u8> data;
+        std::future<void> decrypted;
+    };
+
+    const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+    const std::size_t content_count = tmd.GetContentCount();
+    const auto title_key = container.GetTicket().GetTitleKey();
+
+    u64 total_size = 0;
+    for (std::size_t i = 0; i < content_count; i++) {
+        total_size += container.GetContentSize(static_cast<u16>(i));
+    }
+
+    std::deque<Chunk> in_flight;
+    FileUtil::IOFile output;
+    std::size_t output_index = content_count;
+    u64 total_written = 0;
+
+    // Waits for the oldest chunk to be decrypted and appends it to its content file.
+    const auto write_front = [&]() -> ResultCode {
+        Chunk& chunk = in_flight.front();
+        chunk.decrypted.wait();
+
+        if (output_index != chunk.content_index) {
+            output_index = chunk.content_index;
+            output = FileUtil::IOFile(
+                GetTitleContentPath(media_type, tmd.GetTitleID(), output_index, is_update), "wb");
+        }
+        if (!output.IsOpen() ||
+            output.WriteBytes(chunk.data.data(), chunk.data.size()) != chunk.data.size()) {
+            return FileSys::ERROR_INSUFFICIENT_SPACE;
+        }
+
+        content_written[chunk.content_index] += chunk.data.size();
+        total_written += chunk.data.size();
+        in_flight.pop_front();
+
+        if (update_callback) {
+            update_callback(total_written, total_size);
+        }
+        return RESULT_SUCCESS;
+    };
+
+    // On error, make sure no worker is still referencing a chunk before they are destroyed.
+    const auto drain = [&] {
+        for (auto& chunk : in_flight) {
+            chunk.decrypted.wait();
+        }
+    };
+
+    for (std::size_t i = 0; i < content_count; i++) {
+        const u64 content_offset = container.GetContentOffset(static_cast<u16>(i));
+        const u64 content_size = container.GetContentSize(static_cast<u16>(i));
+        const bool encrypted =
+            (tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0;
+        if (encrypted && !title_key) {
+            LOG_ERROR(Service_AM, "Can't decrypt content {} without the title key", i);
+            drain();
+            return ERROR_TITLE_KEY_UNAVAILABLE;
+        }
+
+        if (content_size == 0) {
+            // Still create the (empty) content file.
+            FileUtil::IOFile empty_file(
+                GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update), "wb");
+            continue;
+        }
+
+        if (!source.Seek(content_offset, SEEK_SET)) {
+            drain();
+            return FileSys::ERROR_INSUFFICIENT_SPACE;
+        }
+
+        // AES-CBC decryption of a chunk only depends on the key and the last ciphertext block
+        // of the previous chunk, so chunks can be decrypted out of order.
+        std::array<u8, CryptoPP::AES::BLOCKSIZE> iv = tmd.GetContentCTRByIndex(i);
+        for (u64 read = 0; read < content_size;) {
+            if (in_flight.size() >= max_chunks_in_flight) {
+                if (const auto result = write_front(); result.IsError()) {
+                    drain();
+                    return result;
+                }
+            }
+
+            const auto length = static_cast<std::size_t>(
+                std::min<u64>(CIA_INSTALL_CHUNK_SIZE, content_size - read));
+            Chunk& chunk = in_flight.emplace_back();
+            chunk.content_index = i;
+            chunk.data.resize(length);
+            if (source.ReadBytes(chunk.data.data(), length) != length) {
+                LOG_ERROR(Service_AM, "Failed to read content {} at offset {:x}", i, read);
+                in_flight.pop_back();
+                drain();
+                return FileSys::ERROR_INSUFFICIENT_SPACE;
+            }
+            read += length;
+
+            if (!encrypted) {
+                std::promise<void> ready;
+                ready.set_value();
+                chunk.decrypted = ready.get_future();
+                continue;
+            }
+
+            auto task = std::make_shared<std::packaged_task<void()>>(
+                [&key = *title_key, iv, data = &chunk.data] {
+                    CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption aes;
+                    aes.SetKeyWithIV(key.data(), key.size(), iv.data());
+                    aes.ProcessData(data->data(), data->data(), data->size());
+                });
+            chunk.decrypted = task->get_future();
+            std::memcpy(iv.data(), chunk.data.data() + length - iv.size(), iv.size());
+            workers.QueueWork([task] { (*task)(); });
+        }
+    }
+
+    while (!in_flight.empty()) {
+        if (const auto result = write_front(); result.IsError()) {
+            drain();
+            return result;
+        }
+    }
+
+    return RESULT_SUCCESS;
+}
+
 ResultVal<std::size_t> CIAFile::Write(u64 offset, std::size_t length, bool flush,
                                       const u8* buffer) {
     written += length;
@@ -342,8 +480,8 @@ bool CIAFile::Close() const {
 
 void CIAFile::Flush() const {}
 
-InstallStatus InstallCIA(const std::string& path,
-                         std::function<ProgressCallback>&& update_callback) {
+static InstallStatus InstallCIAImpl(const std::string& path, Common::ThreadWorker& workers,
+                                    const std::function<ProgressCallback>& update_callback) {
     LOG_INFO(Service_AM, "Installing {}...", path);
 
     if (!FileUtil::Exists(path)) {
@@ -371,22 +509,41 @@ InstallStatus InstallCIA(const std::string& path,
         if (!file.IsOpen())
             return InstallStatus::ErrorFailedToOpenFile;
 
-        std::array<u8, 0x10000> buffer;
-        std::size_t total_bytes_read = 0;
-        while (total_bytes_read != file.GetSize()) {
-            std::size_t bytes_read = file.ReadBytes(buffer.data(), buffer.size());
-            auto result = installFile.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                            static_cast<u8*>(buffer.data()));
+        // Everything before the content data (header, certificates, ticket and TMD) is small, so
+        // it is passed through the regular CIAFile write path in one go.
+        const u64 file_size = file.GetSize();
+        const u64 content_offset = container.GetContentOffset();
+        std::vector<u8> buffer(static_cast<std::size_t>(content_offset));
+        if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
+            LOG_ERROR(Service_AM, "Failed to read CIA header of {}", path);
+            return InstallStatus::ErrorAborted;
+        }
+        auto result = installFile.Write(0, buffer.size(), true, buffer.data());
+        if (result.Failed()) {
+            LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
+                      result.Code().raw);
+            return InstallStatus::ErrorAborted;
+        }
+        if (update_callback)
+            update_callback(content_offset, file_size);
 
+        const auto content_progress = [&](std::size_t written, std::size_t) {
             if (update_callback)
-                update_callback(total_bytes_read, file.GetSize());
-            if (result.Failed()) {
-                LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
-                          result.Code().raw);
-                return InstallStatus::ErrorAborted;
-            }
-            total_bytes_read += bytes_read;
+                update_callback(content_offset + written, file_size);
+        };
+        const auto content_result = installFile.WriteContentDataFromFile(
+            file, workers, CIA_INSTALL_MAX_CHUNKS_IN_FLIGHT, content_progress);
+        if (content_result == ERROR_TITLE_KEY_UNAVAILABLE) {
+            LOG_ERROR(Service_AM, "File {} is encrypted! Aborting...", path);
+            return InstallStatus::ErrorEncrypted;
         }
+        if (content_result.IsError()) {
+            LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
+                      content_result.raw);
+            return InstallStatus::ErrorAborted;
+        }
+        if (update_callback)
+            update_callback(file_size, file_size);
         installFile.Close();
 
         LOG_INFO(Service_AM, "Installed {} successfully.", path);
@@ -428,6 +585,39 @@ InstallStatus InstallCIA(const std::string& path,
     return InstallStatus::ErrorInvalid;
 }
 
+static std::size_t GetNumInstallWorkers() {
+    return std::max(std::thread::hardware_concurrency(), 2U) - 1;
+}
+
+InstallStatus InstallCIA(const std::string& path,
+                         std::function<ProgressCallback>&& update_callback) {
+    Common::ThreadWorker workers(GetNumInstallWorkers(), "CIA install");
+    return InstallCIAImpl(path, workers, update_callback);
+}
+
+std::vector<InstallStatus> InstallCIAs(const std::vector<std::string>& paths,
+                                       std::function<ProgressCallback>&& update_callback) {
+    Common::ThreadWorker workers(GetNumInstallWorkers(), "CIA install");
+
+    std::size_t total_size = 0;
+    for (const auto& path : paths) {
+        total_size += FileUtil::GetSize(path);
+    }
+
+    std::vector<InstallStatus> results;
+    results.reserve(paths.size());
+    std::size_t installed_size = 0;
+    for (const auto& path : paths) {
+        const auto file_progress = [&](std::size_t written, std::size_t) {
+            if (update_callback)
+                update_callback(installed_size + written, total_size);
+        };
+        results.push_back(InstallCIAImpl(path, workers, file_progress));
+        installed_size += FileUtil::GetSize(path);
+    }
+    return results;
+}
+
 InstallStatus InstallFromNus(u64 title_id, int version) {
 #ifdef ENABLE_WEB_SERVICE
     LOG_DEBUG(Service_AM, "Downloading {:X}", title_id);
@@ -15,6 +15,7 @@
 #include "common/common_types.h"
 #include "common/construct.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/file_sys/cia_container.h"
 #include "core/file_sys/file_backend.h"
 #include "core/global.h"
@@ -26,6 +27,10 @@ namespace Core {
 class System;
 }
 
+namespace FileUtil {
+class IOFile;
+}
+
 namespace Service::FS {
 enum class MediaType : u32;
 }
@@ -43,6 +48,11 @@ enum {
 };
 } // namespace ErrCodes
 
+/// Returned when installing encrypted contents whose title key is not available.
+constexpr ResultCode ERROR_TITLE_KEY_UNAVAILABLE(ErrorDescription::NotAuthorized, ErrorModule::AM,
+                                                 ErrorSummary::InvalidState,
+                                                 ErrorLevel::Permanent);
+
 enum class CIAInstallState : u32 {
     InstallStarted,
     HeaderLoaded,
@@ -77,6 +87,22 @@ public:
     ResultCode WriteTicket();
     ResultCode WriteTitleMetadata();
     ResultVal<std::size_t> WriteContentData(u64 offset, std::size_t length, const u8* buffer);
+
+    /**
+     * Installs the content data of the CIA directly from a host file. Reading, decryption and
+     * writing are pipelined: chunks are read ahead on the calling thread, decrypted in parallel
+     * on the given workers and written back in order on the calling thread, keeping at most
+     * `max_chunks_in_flight` chunks in memory. The header, ticket and TMD must have been
+     * written beforehand.
+     * @param source host file containing the CIA
+     * @param workers thread pool used for decryption
+     * @param max_chunks_in_flight maximum number of chunks buffered at once
+     * @param update_callback called on the calling thread with the number of content bytes
+     * installed so far and the total content size
+     */
+    ResultCode WriteContentDataFromFile(FileUtil::IOFile& source, Common::ThreadWorker& workers,
+                                        std::size_t max_chunks_in_flight,
+                                        const std::function<ProgressCallback>& update_callback);
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
                                  const u8* buffer) override;
     u64 GetSize() const override;
@@ -111,6 +137,16 @@ private:
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback = nullptr);
 
+/**
+ * Installs several CIA files, sharing one decryption thread pool between them.
+ * @param paths file paths of the CIA files to install
+ * @param update_callback callback function called during filesystem write, receives the bytes
+ * written and total bytes across all files
+ * @returns the install status of each file, in the same order as paths
+ */
+std::vector<InstallStatus> InstallCIAs(const std::vector<std::string>& paths,
+                                       std::function<ProgressCallback>&& update_callback = nullptr);
+
 /**
  * Downloads and installs title form the Nintendo Update Service.
  * @param title_id the title_id to download
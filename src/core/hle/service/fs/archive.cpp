@@ -25,6 +25,7 @@
 #include "core/file_sys/directory_backend.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/file_backend.h"
+#include "core/file_sys/write_behind_file.h"
 #include "core/hle/result.h"
 #include "core/hle/service/fs/archive.h"
 
@@ -209,6 +210,14 @@ ResultVal<u64> ArchiveManager::GetFreeBytesInArchive(ArchiveHandle archive_handl
     return MakeResult(archive->GetFreeBytes());
 }
 
+ResultCode ArchiveManager::CommitArchive(ArchiveHandle archive_handle) {
+    const ArchiveBackend* archive = GetArchive(archive_handle);
+    if (archive == nullptr) {
+        return FileSys::ERR_INVALID_ARCHIVE_HANDLE;
+    }
+    return archive->Commit();
+}
+
 ResultCode ArchiveManager::FormatArchive(ArchiveIdCode id_code,
                                          const FileSys::ArchiveFormatInfo& format_info,
                                          const FileSys::Path& path, u64 program_id) {
@@ -286,6 +295,7 @@ ResultCode ArchiveManager::DeleteSystemSaveData(u32 high, u32 low) {
     const std::string& nand_directory = FileUtil::GetUserPath(FileUtil::UserPath::NANDDir);
     const std::string base_path = FileSys::GetSystemSaveDataContainerPath(nand_directory);
     const std::string systemsavedata_path = FileSys::GetSystemSaveDataPath(base_path, path);
+    FileSys::WriteBehindFile::DiscardAll(systemsavedata_path);
     if (!FileUtil::DeleteDirRecursively(systemsavedata_path)) {
         return ResultCode(-1); // TODO(Subv): Find the right error code
     }
@@ -185,6 +185,13 @@ public:
      */
     ResultVal<u64> GetFreeBytesInArchive(ArchiveHandle archive_handle);
 
+    /**
+     * Commits the changes made to the files of an Archive
+     * @param archive_handle Handle to an open Archive object
+     * @return Whether the changes were committed
+     */
+    ResultCode CommitArchive(ArchiveHandle archive_handle);
+
     /**
      * Erases the contents of the physical folder that contains the archive
      * identified by the specified id code and path
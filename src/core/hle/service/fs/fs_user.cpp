@@ -337,6 +337,32 @@ void FS_USER::OpenArchive(Kernel::HLERequestContext& ctx) {
     }
 }
 
+void FS_USER::ControlArchive(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx, 0x80D, 5, 4);
+    const auto archive_handle = rp.PopRaw<ArchiveHandle>();
+    const auto action = rp.Pop<u32>();
+    const auto input_size = rp.Pop<u32>();
+    const auto output_size = rp.Pop<u32>();
+    auto& input_buffer = rp.PopMappedBuffer();
+    auto& output_buffer = rp.PopMappedBuffer();
+
+    LOG_DEBUG(Service_FS, "called, action={} input_size={} output_size={}", action, input_size,
+              output_size);
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 4);
+    switch (action) {
+    case 0: // Commit save data
+        rb.Push(archives.CommitArchive(archive_handle));
+        break;
+    default:
+        LOG_WARNING(Service_FS, "(STUBBED) called, action={}", action);
+        rb.Push(RESULT_SUCCESS);
+        break;
+    }
+    rb.PushMappedBuffer(input_buffer);
+    rb.PushMappedBuffer(output_buffer);
+}
+
 void FS_USER::CloseArchive(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x80E, 2, 0);
     const auto archive_handle = rp.PopRaw<ArchiveHandle>();
@@ -905,7 +931,7 @@ FS_USER::FS_USER(Core::System& system)
         {IPC::MakeHeader(0x080A, 9, 4), &FS_USER::RenameDirectory, "RenameDirectory"},
         {IPC::MakeHeader(0x080B, 4, 2), &FS_USER::OpenDirectory, "OpenDirectory"},
         {IPC::MakeHeader(0x080C, 3, 2), &FS_USER::OpenArchive, "OpenArchive"},
-        {IPC::MakeHeader(0x080D, 5, 4), nullptr, "ControlArchive"},
+        {IPC::MakeHeader(0x080D, 5, 4), &FS_USER::ControlArchive, "ControlArchive"},
         {IPC::MakeHeader(0x080E, 2, 0), &FS_USER::CloseArchive, "CloseArchive"},
         {IPC::MakeHeader(0x080F, 6, 0), &FS_USER::FormatThisUserSaveData, "FormatThisUserSaveData"},
         {IPC::MakeHeader(0x0810, 8, 0), &FS_USER::CreateLegacySystemSaveData, "CreateLegacySystemSaveData"},
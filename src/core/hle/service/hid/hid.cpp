@@ -87,49 +87,69 @@ DirectionState GetStickDirectionState(s16 circle_pad_x, s16 circle_pad_y) {
 }
 
 void Module::LoadInputDevices() {
-    std::transform(Settings::values.current_input_profile.buttons.begin() +
-                       Settings::NativeButton::BUTTON_HID_BEGIN,
-                   Settings::values.current_input_profile.buttons.begin() +
-                       Settings::NativeButton::BUTTON_HID_END,
-                   buttons.begin(), Input::CreateDevice<Input::ButtonDevice>);
-    circle_pad = Input::CreateDevice<Input::AnalogDevice>(
-        Settings::values.current_input_profile.analogs[Settings::NativeAnalog::CirclePad]);
-    motion_device = Input::CreateDevice<Input::MotionDevice>(
-        Settings::values.current_input_profile.motion_device);
-    touch_device = Input::CreateDevice<Input::TouchDevice>(
-        Settings::values.current_input_profile.touch_device);
-    if (Settings::values.current_input_profile.use_touch_from_button) {
-        touch_btn_device = Input::CreateDevice<Input::TouchDevice>("engine:touch_from_button");
+    // The source samples for as long as the module of an emulation session reads it
+    auto source = Input::GetHIDSnapshotSource();
+    if (source != snapshot_source) {
+        if (snapshot_source) {
+            snapshot_source->Stop();
+        }
+        snapshot_source = std::move(source);
+        if (snapshot_source) {
+            snapshot_source->Start();
+        }
+    }
+    if (snapshot_source) {
+        snapshot_source->ReloadDevices();
     } else {
-        touch_btn_device.reset();
+        devices.Load();
     }
 }
 
-void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
-    SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
+const Input::HIDSnapshot& Module::ReadInputs() {
+    if (is_device_reload_pending.exchange(false)) {
+        LoadInputDevices();
+    }
+    if (snapshot_source) {
+        return snapshot_source->Read();
+    }
+    polled_inputs = devices.Sample();
+    return polled_inputs;
+}
 
-    if (is_device_reload_pending.exchange(false))
+const Input::HIDSnapshot& Module::ReadMotion() {
+    if (is_device_reload_pending.exchange(false)) {
         LoadInputDevices();
+    }
+    if (snapshot_source) {
+        return snapshot_source->Read();
+    }
+    devices.SampleMotion(polled_inputs);
+    return polled_inputs;
+}
+
+void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
+    SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
+    const Input::HIDSnapshot& inputs = ReadInputs();
 
     using namespace Settings::NativeButton;
-    state.a.Assign(buttons[A - BUTTON_HID_BEGIN]->GetStatus());
-    state.b.Assign(buttons[B - BUTTON_HID_BEGIN]->GetStatus());
-    state.x.Assign(buttons[X - BUTTON_HID_BEGIN]->GetStatus());
-    state.y.Assign(buttons[Y - BUTTON_HID_BEGIN]->GetStatus());
-    state.right.Assign(buttons[Right - BUTTON_HID_BEGIN]->GetStatus());
-    state.left.Assign(buttons[Left - BUTTON_HID_BEGIN]->GetStatus());
-    state.up.Assign(buttons[Up - BUTTON_HID_BEGIN]->GetStatus());
-    state.down.Assign(buttons[Down - BUTTON_HID_BEGIN]->GetStatus());
-    state.l.Assign(buttons[L - BUTTON_HID_BEGIN]->GetStatus());
-    state.r.Assign(buttons[R - BUTTON_HID_BEGIN]->GetStatus());
-    state.start.Assign(buttons[Start - BUTTON_HID_BEGIN]->GetStatus());
-    state.select.Assign(buttons[Select - BUTTON_HID_BEGIN]->GetStatus());
-    state.debug.Assign(buttons[Debug - BUTTON_HID_BEGIN]->GetStatus());
-    state.gpio14.Assign(buttons[Gpio14 - BUTTON_HID_BEGIN]->GetStatus());
+    state.a.Assign(inputs.IsPressed(A));
+    state.b.Assign(inputs.IsPressed(B));
+    state.x.Assign(inputs.IsPressed(X));
+    state.y.Assign(inputs.IsPressed(Y));
+    state.right.Assign(inputs.IsPressed(Right));
+    state.left.Assign(inputs.IsPressed(Left));
+    state.up.Assign(inputs.IsPressed(Up));
+    state.down.Assign(inputs.IsPressed(Down));
+    state.l.Assign(inputs.IsPressed(L));
+    state.r.Assign(inputs.IsPressed(R));
+    state.start.Assign(inputs.IsPressed(Start));
+    state.select.Assign(inputs.IsPressed(Select));
+    state.debug.Assign(inputs.IsPressed(Debug));
+    state.gpio14.Assign(inputs.IsPressed(Gpio14));
 
     // Get current circle pad position and update circle pad direction
-    float circle_pad_x_f, circle_pad_y_f;
-    std::tie(circle_pad_x_f, circle_pad_y_f) = circle_pad->GetStatus();
+    const float circle_pad_x_f = inputs.circle_pad_x;
+    const float circle_pad_y_f = inputs.circle_pad_y;
 
     // xperia64: 0x9A seems to be the calibrated limit of the circle pad
     // Verified by using Input Redirector with very large-value digital inputs
@@ -190,15 +210,9 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
 
     // Get the current touch entry
     TouchDataEntry& touch_entry = mem->touch.entries[mem->touch.index];
-    bool pressed = false;
-    float x, y;
-    std::tie(x, y, pressed) = touch_device->GetStatus();
-    if (!pressed && touch_btn_device) {
-        std::tie(x, y, pressed) = touch_btn_device->GetStatus();
-    }
-    touch_entry.x = static_cast<u16>(x * Core::kScreenBottomWidth);
-    touch_entry.y = static_cast<u16>(y * Core::kScreenBottomHeight);
-    touch_entry.valid.Assign(pressed ? 1 : 0);
+    touch_entry.x = static_cast<u16>(inputs.touch_x * Core::kScreenBottomWidth);
+    touch_entry.y = static_cast<u16>(inputs.touch_y * Core::kScreenBottomHeight);
+    touch_entry.valid.Assign(inputs.touch_pressed ? 1 : 0);
 
     Core::Movie::GetInstance().HandleTouchStatus(touch_entry);
 
@@ -232,8 +246,7 @@ void Module::UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_la
     mem->accelerometer.index = next_accelerometer_index;
     next_accelerometer_index = (next_accelerometer_index + 1) % mem->accelerometer.entries.size();
 
-    Common::Vec3<float> accel;
-    std::tie(accel, std::ignore) = motion_device->GetStatus();
+    Common::Vec3<float> accel = ReadMotion().accel;
     accel *= accelerometer_coef;
     // TODO(wwylele): do a time stretch like the one in UpdateGyroscopeCallback
     // The time stretch formula should be like
@@ -279,8 +292,7 @@ void Module::UpdateGyroscopeCallback(std::uintptr_t user_data, s64 cycles_late)
 
     GyroscopeDataEntry& gyroscope_entry = mem->gyroscope.entries[mem->gyroscope.index];
 
-    Common::Vec3<float> gyro;
-    std::tie(std::ignore, gyro) = motion_device->GetStatus();
+    Common::Vec3<float> gyro = ReadMotion().gyro;
     double stretch = system.perf_stats->GetLastFrameTimeScale();
     gyro *= gyroscope_coef * static_cast<float>(stretch);
     gyroscope_entry.x = static_cast<s16>(gyro.x);
@@ -455,6 +467,12 @@ Module::Module(Core::System& system) : system(system) {
     timing.ScheduleEvent(pad_update_ticks, pad_update_event);
 }
 
+Module::~Module() {
+    if (snapshot_source) {
+        snapshot_source->Stop();
+    }
+}
+
 void Module::ReloadInputDevices() {
     is_device_reload_pending.store(true);
 }
@@ -15,7 +15,7 @@
 #include "common/common_types.h"
 #include "common/settings.h"
 #include "core/core_timing.h"
-#include "core/frontend/input.h"
+#include "core/frontend/hid_input.h"
 #include "core/hle/service/service.h"
 
 namespace Core {
@@ -202,6 +202,7 @@ DirectionState GetStickDirectionState(s16 circle_pad_x, s16 circle_pad_y);
 class Module final {
 public:
     explicit Module(Core::System& system);
+    ~Module();
 
     class Interface : public ServiceFramework<Interface> {
     public:
@@ -307,6 +308,13 @@ public:
 
 private:
     void LoadInputDevices();
+
+    /// Returns the latest status of the input devices, from the snapshot source if there is one.
+    const Input::HIDSnapshot& ReadInputs();
+
+    /// As ReadInputs, but only the motion status is up to date when the devices are polled.
+    const Input::HIDSnapshot& ReadMotion();
+
     void UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateGyroscopeCallback(std::uintptr_t user_data, s64 cycles_late);
@@ -348,12 +356,10 @@ private:
     Core::TimingEventType* gyroscope_update_event;
 
     std::atomic<bool> is_device_reload_pending{true};
-    std::array<std::unique_ptr<Input::ButtonDevice>, Settings::NativeButton::NUM_BUTTONS_HID>
-        buttons;
-    std::unique_ptr<Input::AnalogDevice> circle_pad;
-    std::unique_ptr<Input::MotionDevice> motion_device;
-    std::unique_ptr<Input::TouchDevice> touch_device;
-    std::unique_ptr<Input::TouchDevice> touch_btn_device;
+    std::shared_ptr<Input::HIDSnapshotSource> snapshot_source;
+    // Used when no snapshot source is registered
+    Input::HIDDevices devices;
+    Input::HIDSnapshot polled_inputs;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
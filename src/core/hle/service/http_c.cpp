@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
 #include <unordered_map>
 #include <cryptopp/aes.h>
@@ -9,9 +10,11 @@
 #include "common/archives.h"
 #include "common/assert.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/file_sys/archive_ncch.h"
 #include "core/file_sys/file_backend.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/kernel/event.h"
 #include "core/hle/kernel/ipc.h"
 #include "core/hle/romfs.h"
 #include "core/hle/service/fs/archive.h"
@@ -19,7 +22,9 @@
 #include "core/hw/aes/key.h"
 
 SERIALIZE_EXPORT_IMPL(Service::HTTP::HTTP_C)
+SERIALIZE_EXPORT_IMPL(Service::HTTP::HTTP_C::ReceiveDataCallback)
 SERIALIZE_EXPORT_IMPL(Service::HTTP::SessionData)
+SERVICE_CONSTRUCT_IMPL(Service::HTTP::HTTP_C)
 
 namespace Service::HTTP {
 
@@ -28,7 +33,9 @@ enum {
     InvalidRequestState = 22,
     TooManyContexts = 26,
     InvalidRequestMethod = 32,
+    BufferTooSmall = 43,
     ContextNotFound = 100,
+    Timeout = 105,
 
     /// This error is returned in multiple situations: when trying to initialize an
     /// already-initialized session, or when using the wrong context handle in a context-bound
@@ -54,28 +61,82 @@ const ResultCode ERROR_WRONG_CERT_HANDLE = // 0xD8A0A0C9
     ResultCode(201, ErrorModule::HTTP, ErrorSummary::InvalidState, ErrorLevel::Permanent);
 const ResultCode ERROR_CERT_ALREADY_SET = // 0xD8A0A03D
     ResultCode(61, ErrorModule::HTTP, ErrorSummary::InvalidState, ErrorLevel::Permanent);
+const ResultCode ERROR_CONTEXT_NOT_FOUND = // 0xD8A0A064
+    ResultCode(ErrCodes::ContextNotFound, ErrorModule::HTTP, ErrorSummary::InvalidState,
+               ErrorLevel::Permanent);
+const ResultCode ERROR_INVALID_REQUEST_STATE = // 0xD8A0A016
+    ResultCode(ErrCodes::InvalidRequestState, ErrorModule::HTTP, ErrorSummary::InvalidState,
+               ErrorLevel::Permanent);
+const ResultCode ERROR_BUFFER_SMALL = // 0xD840A02B
+    ResultCode(ErrCodes::BufferTooSmall, ErrorModule::HTTP, ErrorSummary::WouldBlock,
+               ErrorLevel::Permanent);
+const ResultCode ERROR_TIMEOUT = // 0xD820A069
+    ResultCode(ErrCodes::Timeout, ErrorModule::HTTP, ErrorSummary::NothingHappened,
+               ErrorLevel::Permanent);
 
-void Context::MakeRequest() {
-    ASSERT(state == RequestState::NotStarted);
+/// Interval, in milliseconds, at which the guest threads waiting in ReceiveData are woken up when
+/// their data arrived
+constexpr int ReceiveDataInterval = 1;
 
-#ifdef ENABLE_WEB_SERVICE
-    std::unique_ptr<httplib::Client> client = std::make_unique<httplib::Client>(url.c_str());
-    SSL_CTX* ctx = client->ssl_context();
-    if (ctx) {
-        if (auto client_cert = ssl_config.client_cert_ctx.lock()) {
-            SSL_CTX_use_certificate_ASN1(ctx, static_cast<int>(client_cert->certificate.size()),
-                                         client_cert->certificate.data());
-            SSL_CTX_use_PrivateKey_ASN1(EVP_PKEY_RSA, ctx, client_cert->private_key.data(),
-                                        static_cast<long>(client_cert->private_key.size()));
-        }
+Context::~Context() {
+    cancelled = true;
+    // A request that no worker started yet is dropped, rather than waiting for a worker
+    if (request_claimed && request_claimed->exchange(true)) {
+        request_future.wait();
+    }
+}
 
-        // TODO(B3N30): Check for SSLOptions-Bits and set the verify method accordingly
-        // https://www.3dbrew.org/wiki/SSL_Services#SSLOpt
-        // Hack: Since for now RootCerts are not implemented we set the VerifyMode to None.
-        SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
+bool Context::IsFinished() const {
+    return state == RequestState::ReadyToDownloadContent || state == RequestState::TimedOut;
+}
+
+bool Context::CanReceive(u32 buffer_size) {
+    if (IsFinished()) {
+        return true;
+    }
+    std::scoped_lock lock{body_mutex};
+    return body.size() - current_copied_data >= buffer_size;
+}
+
+std::pair<std::size_t, bool> Context::Receive(Kernel::MappedBuffer& buffer, u32 buffer_size) {
+    // Checked before taking the body, so that no data arrives after the check
+    const bool finished = IsFinished();
+    std::scoped_lock lock{body_mutex};
+    const std::size_t remaining_data = body.size() - current_copied_data;
+    const std::size_t size = std::min<std::size_t>(remaining_data, buffer_size);
+    buffer.Write(body.data() + current_copied_data, 0, size);
+    current_copied_data += size;
+    // Drop the copied data once it makes up half of the body, so that only what the guest did not
+    // receive yet is kept, without moving the rest after every call
+    if (current_copied_data >= body.size() - current_copied_data) {
+        body.erase(body.begin(), body.begin() + current_copied_data);
+        current_copied_data = 0;
     }
+    return {size, !finished || remaining_data > buffer_size};
+}
+
+void Context::MakeRequest(RequestQueue& queue) {
+    ASSERT(state == RequestState::InProgress);
 
-    state = RequestState::InProgress;
+    if (cancelled) {
+        state = RequestState::TimedOut;
+        return;
+    }
+
+#ifdef ENABLE_WEB_SERVICE
+    // Split the URL into the origin the client connects to and the path it requests
+    const std::size_t scheme_end = url.find("://");
+    const std::size_t path_start =
+        url.find('/', scheme_end == std::string::npos ? 0 : scheme_end + 3);
+    const std::string origin = url.substr(0, path_start);
+    const std::string path = path_start == std::string::npos ? "/" : url.substr(path_start);
+
+    // Clients with a client certificate are only reused for the same certificate
+    std::string key = origin;
+    if (auto client_cert = ssl_config.client_cert_ctx.lock()) {
+        key += fmt::format("#{}", client_cert->handle);
+    }
+    std::unique_ptr<httplib::Client> client = queue.AcquireClient(key, origin, *this);
 
     static const std::unordered_map<RequestMethod, std::string> request_method_strings{
         {RequestMethod::Get, "GET"},       {RequestMethod::Post, "POST"},
@@ -87,13 +148,19 @@ void Context::MakeRequest() {
     httplib::Request request;
     httplib::Error error;
     request.method = request_method_strings.at(method);
-    request.path = url;
+    request.path = path;
     // TODO(B3N30): Add post data body
     request.progress = [this](u64 current, u64 total) -> bool {
         // TODO(B3N30): Is there a state that shows response header are available
         current_download_size_bytes = current;
         total_download_size_bytes = total;
-        return true;
+        return !cancelled;
+    };
+    // The body is made available to ReceiveData as it arrives, rather than once it is complete
+    request.content_receiver = [this](const char* data, std::size_t data_length, u64, u64) {
+        std::scoped_lock lock{body_mutex};
+        body.insert(body.end(), data, data + data_length);
+        return !cancelled;
     };
 
     for (const auto& header : headers) {
@@ -105,6 +172,7 @@ void Context::MakeRequest() {
         state = RequestState::TimedOut;
     } else {
         LOG_DEBUG(Service_HTTP, "Request successful");
+        queue.ReleaseClient(key, std::move(client));
         // TODO(B3N30): Verify this state on HW
         state = RequestState::ReadyToDownloadContent;
     }
@@ -114,6 +182,68 @@ void Context::MakeRequest() {
 #endif
 }
 
+RequestQueue::RequestQueue() : workers{NumWorkers, "HTTP:C"} {}
+
+RequestQueue::~RequestQueue() = default;
+
+void RequestQueue::Queue(Context& context) {
+    // The request is started for the guest once queued, even while all workers are busy
+    context.state = RequestState::InProgress;
+    context.request_claimed = std::make_shared<std::atomic<bool>>(false);
+    std::packaged_task<void()> task{
+        [this, &context, claimed = context.request_claimed] {
+            // The context is gone if it claimed the request first
+            if (!claimed->exchange(true)) {
+                context.MakeRequest(*this);
+            }
+        }};
+    context.request_future = task.get_future();
+    workers.QueueWork(std::move(task));
+}
+
+#ifdef ENABLE_WEB_SERVICE
+std::unique_ptr<httplib::Client> RequestQueue::AcquireClient(const std::string& key,
+                                                             const std::string& origin,
+                                                             const Context& context) {
+    {
+        std::scoped_lock lock{clients_mutex};
+        auto& idle = idle_clients[key];
+        if (!idle.empty()) {
+            auto client = std::move(idle.back());
+            idle.pop_back();
+            return client;
+        }
+    }
+
+    auto client = std::make_unique<httplib::Client>(origin);
+    client->set_keep_alive(true);
+    SSL_CTX* ctx = client->ssl_context();
+    if (ctx) {
+        if (auto client_cert = context.ssl_config.client_cert_ctx.lock()) {
+            SSL_CTX_use_certificate_ASN1(ctx, static_cast<int>(client_cert->certificate.size()),
+                                         client_cert->certificate.data());
+            SSL_CTX_use_PrivateKey_ASN1(EVP_PKEY_RSA, ctx, client_cert->private_key.data(),
+                                        static_cast<long>(client_cert->private_key.size()));
+        }
+
+        // TODO(B3N30): Check for SSLOptions-Bits and set the verify method accordingly
+        // https://www.3dbrew.org/wiki/SSL_Services#SSLOpt
+        // Hack: Since for now RootCerts are not implemented we set the VerifyMode to None.
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
+    }
+    return client;
+}
+
+void RequestQueue::ReleaseClient(const std::string& key, std::unique_ptr<httplib::Client> client) {
+    std::scoped_lock lock{clients_mutex};
+    auto& idle = idle_clients[key];
+    // There are never more connections in use at once than workers
+    if (idle.size() < NumWorkers) {
+        idle.push_back(std::move(client));
+    }
+}
+#endif
+
 void HTTP_C::Initialize(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x1, 1, 4);
     const u32 shmem_size = rp.Pop<u32>();
@@ -223,10 +353,7 @@ void HTTP_C::BeginRequest(Kernel::HLERequestContext& ctx) {
     // trying to enqueue any more will either fail (BeginRequestAsync), or block (BeginRequest)
     // Note that you only can have 8 Contexts at a time. So this difference shouldn't matter
     // Then there are 3? worker threads that pop the requests from the queue and send them
-    // For now make every request async in it's own thread.
-
-    itr->second.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second));
+    request_queue.Queue(itr->second);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -276,15 +403,148 @@ void HTTP_C::BeginRequestAsync(Kernel::HLERequestContext& ctx) {
     // trying to enqueue any more will either fail (BeginRequestAsync), or block (BeginRequest)
     // Note that you only can have 8 Contexts at a time. So this difference shouldn't matter
     // Then there are 3? worker threads that pop the requests from the queue and send them
-    // For now make every request async in it's own thread.
-
-    itr->second.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second));
+    request_queue.Queue(itr->second);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
 }
 
+class HTTP_C::ReceiveDataCallback final : public Kernel::HLERequestContext::WakeupCallback {
+public:
+    ReceiveDataCallback(HTTP_C* http_, u16 command_id_, u32 receive_id_,
+                        Context::Handle context_handle_, u32 buffer_size_,
+                        Kernel::MappedBuffer buffer_)
+        : http{http_}, command_id{command_id_}, receive_id{receive_id_},
+          context_handle{context_handle_}, buffer_size{buffer_size_}, buffer{std::move(buffer_)} {}
+
+    void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) override {
+        if (!http) {
+            // Contexts are not kept in save states, see HTTP_C::serialize
+            IPC::RequestBuilder rb(ctx, command_id, 1, 2);
+            rb.Push(ERROR_CONTEXT_NOT_FOUND);
+            rb.PushMappedBuffer(*buffer);
+            return;
+        }
+        const bool timed_out = reason == Kernel::ThreadWakeupReason::Timeout;
+        if (timed_out) {
+            std::erase_if(http->pending_receives, [this](const PendingReceive& pending) {
+                return pending.receive_id == receive_id;
+            });
+        }
+        http->WriteReceivedData(ctx, command_id, context_handle, buffer_size, *buffer, timed_out);
+    }
+
+private:
+    HTTP_C* http = nullptr;
+    u16 command_id;
+    u32 receive_id;
+    Context::Handle context_handle;
+    u32 buffer_size;
+    boost::optional<Kernel::MappedBuffer> buffer; ///< Only empty while loading a save state
+
+    ReceiveDataCallback() = default;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<Kernel::HLERequestContext::WakeupCallback>(*this);
+        ar& command_id;
+        ar& buffer;
+    }
+    friend class boost::serialization::access;
+};
+
+void HTTP_C::ReceiveData(Kernel::HLERequestContext& ctx) {
+    ReceiveDataImpl(ctx, false);
+}
+
+void HTTP_C::ReceiveDataTimeout(Kernel::HLERequestContext& ctx) {
+    ReceiveDataImpl(ctx, true);
+}
+
+void HTTP_C::ReceiveDataImpl(Kernel::HLERequestContext& ctx, bool timeout) {
+    const u16 command_id = timeout ? 0xC : 0xB;
+    IPC::RequestParser rp(ctx, command_id, timeout ? 4 : 2, 2);
+    const Context::Handle context_handle = rp.Pop<u32>();
+    const u32 buffer_size = rp.Pop<u32>();
+    const u64 timeout_nanos = timeout ? rp.Pop<u64>() : 0;
+    Kernel::MappedBuffer& buffer = rp.PopMappedBuffer();
+
+    LOG_DEBUG(Service_HTTP, "called, context_handle={}, buffer_size={}, timeout={}",
+              context_handle, buffer_size, timeout_nanos);
+
+    auto itr = contexts.find(context_handle);
+    if (itr == contexts.end()) {
+        LOG_ERROR(Service_HTTP, "called, context {} not found", context_handle);
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+        rb.Push(ERROR_CONTEXT_NOT_FOUND);
+        rb.PushMappedBuffer(buffer);
+        return;
+    }
+
+    if (itr->second.state == RequestState::NotStarted) {
+        LOG_ERROR(Service_HTTP, "Tried to receive data of a request that was not started");
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+        rb.Push(ERROR_INVALID_REQUEST_STATE);
+        rb.PushMappedBuffer(buffer);
+        return;
+    }
+
+    if (itr->second.CanReceive(buffer_size) || (timeout && timeout_nanos == 0)) {
+        WriteReceivedData(ctx, command_id, context_handle, buffer_size, buffer, timeout);
+        return;
+    }
+
+    // Wait for more of the body to arrive, rather than blocking until the request finished
+    const u32 receive_id = next_receive_id++;
+    auto event = ctx.SleepClientThread(
+        "http_c::ReceiveData", std::chrono::nanoseconds(static_cast<s64>(timeout_nanos)),
+        std::make_shared<ReceiveDataCallback>(this, command_id, receive_id, context_handle,
+                                              buffer_size, buffer));
+    pending_receives.push_back({receive_id, context_handle, buffer_size, std::move(event)});
+    if (pending_receives.size() == 1) {
+        system.CoreTiming().ScheduleEvent(msToCycles(ReceiveDataInterval), receive_event);
+    }
+}
+
+void HTTP_C::WriteReceivedData(Kernel::HLERequestContext& ctx, u16 command_id,
+                               Context::Handle context_handle, u32 buffer_size,
+                               Kernel::MappedBuffer& buffer, bool timed_out) {
+    IPC::RequestBuilder rb(ctx, command_id, 1, 2);
+    auto itr = contexts.find(context_handle);
+    if (itr == contexts.end()) {
+        // The context was closed while waiting
+        rb.Push(ERROR_CONTEXT_NOT_FOUND);
+        rb.PushMappedBuffer(buffer);
+        return;
+    }
+
+    const auto [size, has_more_data] = itr->second.Receive(buffer, buffer_size);
+    if (timed_out && size < buffer_size && has_more_data) {
+        rb.Push(ERROR_TIMEOUT);
+    } else if (has_more_data) {
+        rb.Push(ERROR_BUFFER_SMALL);
+    } else {
+        rb.Push(RESULT_SUCCESS);
+    }
+    rb.PushMappedBuffer(buffer);
+}
+
+void HTTP_C::WakeReceivers(s64 cycles_late) {
+    std::erase_if(pending_receives, [this](const PendingReceive& pending) {
+        auto itr = contexts.find(pending.context_handle);
+        if (itr != contexts.end() && !itr->second.CanReceive(pending.buffer_size)) {
+            return false;
+        }
+        pending.event->Signal();
+        return true;
+    });
+    if (!pending_receives.empty()) {
+        system.CoreTiming().ScheduleEvent(msToCycles(ReceiveDataInterval) - cycles_late,
+                                          receive_event);
+    }
+}
+
 void HTTP_C::CreateContext(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x2, 2, 2);
     const u32 url_size = rp.Pop<u32>();
@@ -390,7 +650,7 @@ void HTTP_C::CloseContext(Kernel::HLERequestContext& ctx) {
     // TODO(Subv): What happens if you try to close a context that's currently being used?
     // TODO(Subv): Make sure that only the session that created the context can close it.
 
-    // Note that this will block if a request is still in progress
+    // Note that this will block until the request in progress is aborted
     contexts.erase(itr);
     session_data->num_http_contexts--;
 
@@ -867,7 +1127,7 @@ void HTTP_C::DecryptClCertA() {
     ClCertA.init = true;
 }
 
-HTTP_C::HTTP_C() : ServiceFramework("http:C", 32) {
+HTTP_C::HTTP_C(Core::System& system) : ServiceFramework("http:C", 32), system(system) {
     static const FunctionInfo functions[] = {
         // clang-format off
         {IPC::MakeHeader(0x0001, 1, 4), &HTTP_C::Initialize, "Initialize"},
@@ -880,8 +1140,8 @@ HTTP_C::HTTP_C() : ServiceFramework("http:C", 32) {
         {IPC::MakeHeader(0x0008, 1, 2), &HTTP_C::InitializeConnectionSession, "InitializeConnectionSession"},
         {IPC::MakeHeader(0x0009, 1, 0), &HTTP_C::BeginRequest, "BeginRequest"},
         {IPC::MakeHeader(0x000A, 1, 0), &HTTP_C::BeginRequestAsync, "BeginRequestAsync"},
-        {IPC::MakeHeader(0x000B, 2, 2), nullptr, "ReceiveData"},
-        {IPC::MakeHeader(0x000C, 4, 2), nullptr, "ReceiveDataTimeout"},
+        {IPC::MakeHeader(0x000B, 2, 2), &HTTP_C::ReceiveData, "ReceiveData"},
+        {IPC::MakeHeader(0x000C, 4, 2), &HTTP_C::ReceiveDataTimeout, "ReceiveDataTimeout"},
         {IPC::MakeHeader(0x000D, 5, 6), nullptr, "SetProxy"},
         {IPC::MakeHeader(0x000E, 1, 0), nullptr, "SetProxyDefault"},
         {IPC::MakeHeader(0x000F, 3, 4), nullptr, "SetBasicAuthorization"},
@@ -930,11 +1190,17 @@ HTTP_C::HTTP_C() : ServiceFramework("http:C", 32) {
     };
     RegisterHandlers(functions);
 
+    receive_event = system.CoreTiming().RegisterEvent(
+        "HTTP_C::ReceiveData",
+        [this](std::uintptr_t, s64 cycles_late) { WakeReceivers(cycles_late); });
+
     DecryptClCertA();
 }
 
+HTTP_C::~HTTP_C() = default;
+
 void InstallInterfaces(Core::System& system) {
     auto& service_manager = system.ServiceManager();
-    std::make_shared<HTTP_C>()->InstallAsService(service_manager);
+    std::make_shared<HTTP_C>(system)->InstallAsService(service_manager);
 }
 } // namespace Service::HTTP
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -23,11 +25,17 @@
 #endif
 #include <httplib.h>
 #endif
+#include "common/thread_worker.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/service/service.h"
 
 namespace Core {
 class System;
+struct TimingEventType;
+} // namespace Core
+
+namespace Kernel {
+class Event;
 }
 
 namespace Service::HTTP {
@@ -112,16 +120,34 @@ private:
     friend class boost::serialization::access;
 };
 
+class RequestQueue;
+
 /// Represents an HTTP context.
 class Context final {
 public:
     using Handle = u32;
 
     Context() = default;
+    ~Context();
     Context(const Context&) = delete;
     Context& operator=(const Context&) = delete;
 
-    void MakeRequest();
+    void MakeRequest(RequestQueue& queue);
+
+    /// Returns whether the request was sent and its response fully received, or failed.
+    bool IsFinished() const;
+
+    /**
+     * Returns whether ReceiveData can return right away, because the response body received so
+     * far fills the buffer of the guest, or the request finished.
+     */
+    bool CanReceive(u32 buffer_size);
+
+    /**
+     * Copies the response body received so far, past what was already copied, to the buffer.
+     * @returns The number of bytes copied, and whether more data remains or is still to come.
+     */
+    std::pair<std::size_t, bool> Receive(Kernel::MappedBuffer& buffer, u32 buffer_size);
 
     struct Proxy {
         std::string url;
@@ -211,11 +237,62 @@ public:
     std::vector<PostData> post_data;
 
     std::future<void> request_future;
+    /// Set by whichever comes first of a worker starting the request and the context being
+    /// destroyed, so that the context only waits for requests that were started
+    std::shared_ptr<std::atomic<bool>> request_claimed;
+    /// Set when the context is closed, to abort the request
+    std::atomic<bool> cancelled = false;
     std::atomic<u64> current_download_size_bytes;
     std::atomic<u64> total_download_size_bytes;
 #ifdef ENABLE_WEB_SERVICE
     httplib::Response response;
 #endif
+
+    /// Response body, appended to by the request as it arrives. The data already copied to the
+    /// guest is dropped as it receives more.
+    std::mutex body_mutex;
+    std::vector<u8> body;
+    /// Number of bytes at the front of the body that were already copied to the guest
+    std::size_t current_copied_data = 0;
+};
+
+/**
+ * Sends the requests of HTTP contexts on a fixed pool of worker threads, like the HTTP module
+ * does. The connections of finished requests are kept open, so that the next requests to the same
+ * host do not have to connect and negotiate TLS again.
+ */
+class RequestQueue {
+public:
+    /// Number of requests sent at the same time
+    static constexpr std::size_t NumWorkers = 3;
+
+    RequestQueue();
+    ~RequestQueue();
+
+    /**
+     * Queues the request of a context, which is in progress from then on. The context waits for
+     * the request when it is destroyed.
+     */
+    void Queue(Context& context);
+
+private:
+    friend class Context;
+
+#ifdef ENABLE_WEB_SERVICE
+    /// Takes an idle client connected to the origin of a context, or creates one.
+    std::unique_ptr<httplib::Client> AcquireClient(const std::string& key,
+                                                   const std::string& origin,
+                                                   const Context& context);
+
+    /// Keeps the client of a finished request open for the next request to its origin.
+    void ReleaseClient(const std::string& key, std::unique_ptr<httplib::Client> client);
+
+    std::mutex clients_mutex;
+    /// Idle clients of each origin and client certificate
+    std::unordered_map<std::string, std::vector<std::unique_ptr<httplib::Client>>> idle_clients;
+#endif
+
+    Common::ThreadWorker workers;
 };
 
 struct SessionData : public Kernel::SessionRequestHandler::SessionDataBase {
@@ -250,7 +327,10 @@ private:
 
 class HTTP_C final : public ServiceFramework<HTTP_C, SessionData> {
 public:
-    HTTP_C();
+    explicit HTTP_C(Core::System& system);
+    ~HTTP_C();
+
+    class ReceiveDataCallback;
 
 private:
     /**
@@ -317,6 +397,41 @@ private:
      */
     void BeginRequestAsync(Kernel::HLERequestContext& ctx);
 
+    /**
+     * HTTP_C::ReceiveData service function
+     *  Inputs:
+     * 1 : Context handle
+     * 2 : Buffer size
+     * 3 : (OutSize<<4) | 12
+     * 4 : Output data pointer
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void ReceiveData(Kernel::HLERequestContext& ctx);
+
+    /**
+     * HTTP_C::ReceiveDataTimeout service function
+     *  Inputs:
+     * 1 : Context handle
+     * 2 : Buffer size
+     * 3-4 : u64 nanoseconds delay
+     * 5 : (OutSize<<4) | 12
+     * 6 : Output data pointer
+     *  Outputs:
+     *      1 : Result of function, 0 on success, otherwise error code
+     */
+    void ReceiveDataTimeout(Kernel::HLERequestContext& ctx);
+
+    void ReceiveDataImpl(Kernel::HLERequestContext& ctx, bool timeout);
+
+    /// Writes the response of ReceiveData, with the data received so far.
+    void WriteReceivedData(Kernel::HLERequestContext& ctx, u16 command_id,
+                           Context::Handle context_handle, u32 buffer_size,
+                           Kernel::MappedBuffer& buffer, bool timed_out);
+
+    /// Wakes up the guest threads waiting in ReceiveData whose data arrived
+    void WakeReceivers(s64 cycles_late);
+
     /**
      * HTTP_C::AddRequestHeader service function
      *  Inputs:
@@ -410,6 +525,8 @@ private:
 
     void DecryptClCertA();
 
+    Core::System& system;
+
     std::shared_ptr<Kernel::SharedMemory> shared_memory = nullptr;
 
     /// The next number to use when a new HTTP session is initalized.
@@ -421,9 +538,23 @@ private:
     /// The next handle number to use when a new ClientCert context is created.
     ClientCertContext::Handle client_certs_counter = 0;
 
+    /// Sends the requests of the contexts, which are destroyed before it
+    RequestQueue request_queue;
+
     /// Global list of HTTP contexts currently opened.
     std::unordered_map<Context::Handle, Context> contexts;
 
+    /// Guest threads waiting in ReceiveData for more of the response body
+    struct PendingReceive {
+        u32 receive_id;
+        Context::Handle context_handle;
+        u32 buffer_size;
+        std::shared_ptr<Kernel::Event> event;
+    };
+    std::vector<PendingReceive> pending_receives;
+    u32 next_receive_id = 0;
+    Core::TimingEventType* receive_event;
+
     /// Global list of  ClientCert contexts currently opened.
     std::unordered_map<ClientCertContext::Handle, std::shared_ptr<ClientCertContext>> client_certs;
 
@@ -457,4 +588,6 @@ void InstallInterfaces(Core::System& system);
 } // namespace Service::HTTP
 
 BOOST_CLASS_EXPORT_KEY(Service::HTTP::HTTP_C)
+BOOST_CLASS_EXPORT_KEY(Service::HTTP::HTTP_C::ReceiveDataCallback)
 BOOST_CLASS_EXPORT_KEY(Service::HTTP::SessionData)
+SERVICE_CONSTRUCT(Service::HTTP::HTTP_C)
@@ -48,6 +48,11 @@ const std::array<CROHelper::HeaderField, 4> CROHelper::FIX_BARRIERS{{
     Fix3Barrier,
 }};
 
+CROHelper::CROHelper(VAddr cro_address, Kernel::Process& process, Core::System& system,
+                     ExportSymbolIndex* export_index)
+    : module_address(cro_address), process(process), memory(system.Memory()), system(&system),
+      export_index(export_index) {}
+
 VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
     u32 segment_num = GetField(SegmentNum);
 
@@ -55,7 +60,7 @@ VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
         return 0;
 
     SegmentEntry entry;
-    GetEntry(system.Memory(), segment_tag.segment_index, entry);
+    GetEntry(memory, segment_tag.segment_index, entry);
 
     if (segment_tag.offset_into_segment >= entry.size)
         return 0;
@@ -71,12 +76,12 @@ ResultCode CROHelper::ApplyRelocation(VAddr target_address, RelocationType reloc
         break;
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
-        system.Memory().Write32(target_address, symbol_address + addend);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        memory.Write32(target_address, symbol_address + addend);
+        system->InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::RelativeAddress:
-        system.Memory().Write32(target_address, symbol_address + addend - target_future_address);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        memory.Write32(target_address, symbol_address + addend - target_future_address);
+        system->InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -98,8 +103,8 @@ ResultCode CROHelper::ClearRelocation(VAddr target_address, RelocationType reloc
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
     case RelocationType::RelativeAddress:
-        system.Memory().Write32(target_address, 0);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        memory.Write32(target_address, 0);
+        system->InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -121,7 +126,7 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
     VAddr relocation_address = batch;
     while (true) {
         RelocationEntry relocation;
-        system.Memory().ReadBlock(process, relocation_address, &relocation,
+        memory.ReadBlock(process, relocation_address, &relocation,
                                   sizeof(RelocationEntry));
 
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
@@ -143,25 +148,54 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
     }
 
     RelocationEntry relocation;
-    system.Memory().ReadBlock(process, batch, &relocation, sizeof(RelocationEntry));
+    memory.ReadBlock(process, batch, &relocation, sizeof(RelocationEntry));
     relocation.is_batch_resolved = reset ? 0 : 1;
-    system.Memory().WriteBlock(process, batch, &relocation, sizeof(RelocationEntry));
+    memory.WriteBlock(process, batch, &relocation, sizeof(RelocationEntry));
     return RESULT_SUCCESS;
 }
 
 VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
+    if (!export_index)
+        return WalkExportTree(name);
+
+    const ExportSymbolIndex::Symbols* symbols = export_index->Find(module_address);
+    if (!symbols)
+        symbols = &IndexExportNamedSymbols();
+
+    auto itr = symbols->find(name);
+    return itr != symbols->end() ? itr->second : 0;
+}
+
+const ExportSymbolIndex::Symbols& CROHelper::IndexExportNamedSymbols() const {
+    // Only names the export tree leads to are indexed, so that lookups find the same symbols
+    ExportSymbolIndex::Symbols symbols;
+    u32 export_strings_size = GetField(ExportStringsSize);
+    u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
+    for (u32 i = 0; i < export_named_symbol_num; ++i) {
+        ExportNamedSymbolEntry entry;
+        GetEntry(memory, i, entry);
+        std::string symbol_name =
+            memory.ReadCString(entry.name_offset, export_strings_size);
+        u32 symbol_address = WalkExportTree(symbol_name);
+        if (symbol_address != 0)
+            symbols.emplace(std::move(symbol_name), symbol_address);
+    }
+    return export_index->Add(module_address, std::move(symbols));
+}
+
+VAddr CROHelper::WalkExportTree(const std::string& name) const {
     if (!GetField(ExportTreeNum))
         return 0;
 
     std::size_t len = name.size();
     ExportTreeEntry entry;
-    GetEntry(system.Memory(), 0, entry);
+    GetEntry(memory, 0, entry);
     ExportTreeEntry::Child next;
     next.raw = entry.left.raw;
     u32 found_id;
 
     while (true) {
-        GetEntry(system.Memory(), next.next_index, entry);
+        GetEntry(memory, next.next_index, entry);
 
         if (next.is_end) {
             found_id = entry.export_table_index;
@@ -187,9 +221,9 @@ VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
 
     u32 export_strings_size = GetField(ExportStringsSize);
     ExportNamedSymbolEntry symbol_entry;
-    GetEntry(system.Memory(), found_id, symbol_entry);
+    GetEntry(memory, found_id, symbol_entry);
 
-    if (system.Memory().ReadCString(symbol_entry.name_offset, export_strings_size) != name)
+    if (memory.ReadCString(symbol_entry.name_offset, export_strings_size) != name)
         return 0;
 
     return SegmentTagToAddress(symbol_entry.symbol_position);
@@ -280,7 +314,7 @@ ResultVal<VAddr> CROHelper::RebaseSegmentTable(u32 cro_size, VAddr data_segment_
     u32 segment_num = GetField(SegmentNum);
     for (u32 i = 0; i < segment_num; ++i) {
         SegmentEntry segment;
-        GetEntry(system.Memory(), i, segment);
+        GetEntry(memory, i, segment);
         if (segment.type == SegmentType::Data) {
             if (segment.size != 0) {
                 if (segment.size > data_segment_size)
@@ -299,7 +333,7 @@ ResultVal<VAddr> CROHelper::RebaseSegmentTable(u32 cro_size, VAddr data_segment_
             if (segment.offset > module_address + cro_size)
                 return CROFormatError(0x19);
         }
-        SetEntry(system.Memory(), i, segment);
+        SetEntry(memory, i, segment);
     }
     return MakeResult<u32>(prev_data_segment + module_address);
 }
@@ -311,7 +345,7 @@ ResultCode CROHelper::RebaseExportNamedSymbolTable() {
     u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
     for (u32 i = 0; i < export_named_symbol_num; ++i) {
         ExportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset += module_address;
@@ -321,7 +355,7 @@ ResultCode CROHelper::RebaseExportNamedSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -330,7 +364,7 @@ ResultCode CROHelper::VerifyExportTreeTable() const {
     u32 tree_num = GetField(ExportTreeNum);
     for (u32 i = 0; i < tree_num; ++i) {
         ExportTreeEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.left.next_index >= tree_num || entry.right.next_index >= tree_num) {
             return CROFormatError(0x11);
@@ -354,7 +388,7 @@ ResultCode CROHelper::RebaseImportModuleTable() {
     u32 module_num = GetField(ImportModuleNum);
     for (u32 i = 0; i < module_num; ++i) {
         ImportModuleEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset += module_address;
@@ -380,7 +414,7 @@ ResultCode CROHelper::RebaseImportModuleTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -396,7 +430,7 @@ ResultCode CROHelper::RebaseImportNamedSymbolTable() {
     u32 num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset += module_address;
@@ -414,7 +448,7 @@ ResultCode CROHelper::RebaseImportNamedSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -428,7 +462,7 @@ ResultCode CROHelper::RebaseImportIndexedSymbolTable() {
     u32 num = GetField(ImportIndexedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportIndexedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset += module_address;
@@ -438,7 +472,7 @@ ResultCode CROHelper::RebaseImportIndexedSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -452,7 +486,7 @@ ResultCode CROHelper::RebaseImportAnonymousSymbolTable() {
     u32 num = GetField(ImportAnonymousSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset += module_address;
@@ -462,7 +496,7 @@ ResultCode CROHelper::RebaseImportAnonymousSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -477,14 +511,14 @@ ResultCode CROHelper::ResetExternalRelocations() {
     ExternalRelocationEntry relocation;
 
     // Verifies that the last relocation is the end of a batch
-    GetEntry(system.Memory(), external_relocation_num - 1, relocation);
+    GetEntry(memory, external_relocation_num - 1, relocation);
     if (!relocation.is_batch_end) {
         return CROFormatError(0x12);
     }
 
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
 
         if (relocation_target == 0) {
@@ -501,7 +535,7 @@ ResultCode CROHelper::ResetExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(system.Memory(), i, relocation);
+            SetEntry(memory, i, relocation);
         }
 
         // if current is an end, then the next is a beginning
@@ -517,7 +551,7 @@ ResultCode CROHelper::ClearExternalRelocations() {
 
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
 
         if (relocation_target == 0) {
@@ -533,7 +567,7 @@ ResultCode CROHelper::ClearExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(system.Memory(), i, relocation);
+            SetEntry(memory, i, relocation);
         }
 
         // if current is an end, then the next is a beginning
@@ -549,13 +583,13 @@ ResultCode CROHelper::ApplyStaticAnonymousSymbolToCRS(VAddr crs_address) {
         static_relocation_table_offset +
         GetField(StaticRelocationNum) * sizeof(StaticRelocationEntry);
 
-    CROHelper crs(crs_address, process, system);
+    CROHelper crs(crs_address, process, *system);
     u32 offset_export_num = GetField(StaticAnonymousSymbolNum);
     LOG_INFO(Service_LDR, "CRO \"{}\" exports {} static anonymous symbols", ModuleName(),
              offset_export_num);
     for (u32 i = 0; i < offset_export_num; ++i) {
         StaticAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         u32 batch_address = entry.relocation_batch_offset + module_address;
 
         if (batch_address < static_relocation_table_offset ||
@@ -580,7 +614,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
     u32 internal_relocation_num = GetField(InternalRelocationNum);
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr target_addressB = SegmentTagToAddress(relocation.target_position);
         if (target_addressB == 0) {
             return CROFormatError(0x15);
@@ -588,7 +622,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
 
         VAddr target_address;
         SegmentEntry target_segment;
-        GetEntry(system.Memory(), relocation.target_position.segment_index, target_segment);
+        GetEntry(memory, relocation.target_position.segment_index, target_segment);
 
         if (target_segment.type == SegmentType::Data) {
             // If the relocation is to the .data segment, we need to relocate it in the old buffer
@@ -603,7 +637,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
         }
 
         SegmentEntry symbol_segment;
-        GetEntry(system.Memory(), relocation.symbol_segment, symbol_segment);
+        GetEntry(memory, relocation.symbol_segment, symbol_segment);
         LOG_TRACE(Service_LDR, "Internally relocates 0x{:08X} with 0x{:08X}", target_address,
                   symbol_segment.offset);
         ResultCode result = ApplyRelocation(target_address, relocation.type, relocation.addend,
@@ -620,7 +654,7 @@ ResultCode CROHelper::ClearInternalRelocations() {
     u32 internal_relocation_num = GetField(InternalRelocationNum);
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr target_address = SegmentTagToAddress(relocation.target_position);
 
         if (target_address == 0) {
@@ -640,13 +674,13 @@ void CROHelper::UnrebaseImportAnonymousSymbolTable() {
     u32 num = GetField(ImportAnonymousSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -654,13 +688,13 @@ void CROHelper::UnrebaseImportIndexedSymbolTable() {
     u32 num = GetField(ImportIndexedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportIndexedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -668,7 +702,7 @@ void CROHelper::UnrebaseImportNamedSymbolTable() {
     u32 num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset -= module_address;
@@ -678,7 +712,7 @@ void CROHelper::UnrebaseImportNamedSymbolTable() {
             entry.relocation_batch_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -686,7 +720,7 @@ void CROHelper::UnrebaseImportModuleTable() {
     u32 module_num = GetField(ImportModuleNum);
     for (u32 i = 0; i < module_num; ++i) {
         ImportModuleEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset -= module_address;
@@ -700,7 +734,7 @@ void CROHelper::UnrebaseImportModuleTable() {
             entry.import_anonymous_symbol_table_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -708,13 +742,13 @@ void CROHelper::UnrebaseExportNamedSymbolTable() {
     u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
     for (u32 i = 0; i < export_named_symbol_num; ++i) {
         ExportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -722,7 +756,7 @@ void CROHelper::UnrebaseSegmentTable() {
     u32 segment_num = GetField(SegmentNum);
     for (u32 i = 0; i < segment_num; ++i) {
         SegmentEntry segment;
-        GetEntry(system.Memory(), i, segment);
+        GetEntry(memory, i, segment);
 
         if (segment.type == SegmentType::BSS) {
             segment.offset = 0;
@@ -730,7 +764,7 @@ void CROHelper::UnrebaseSegmentTable() {
             segment.offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, segment);
+        SetEntry(memory, i, segment);
     }
 }
 
@@ -752,17 +786,18 @@ ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
+            std::string symbol_name =
+                memory.ReadCString(entry.name_offset, import_strings_size);
             ResultCode result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        system.Memory().ReadCString(entry.name_offset, import_strings_size);
+                process, *system, export_index, crs_address,
+                [&](CROHelper source) -> ResultVal<bool> {
                     u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
 
                     if (symbol_address != 0) {
@@ -795,10 +830,10 @@ ResultCode CROHelper::ResetImportNamedSymbol() {
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
         ResultCode result = ApplyRelocationBatch(relocation_addr, unresolved_symbol, true);
@@ -816,10 +851,10 @@ ResultCode CROHelper::ResetImportIndexedSymbol() {
     u32 import_num = GetField(ImportIndexedSymbolNum);
     for (u32 i = 0; i < import_num; ++i) {
         ImportIndexedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
         ResultCode result = ApplyRelocationBatch(relocation_addr, unresolved_symbol, true);
@@ -837,10 +872,10 @@ ResultCode CROHelper::ResetImportAnonymousSymbol() {
     u32 import_num = GetField(ImportAnonymousSymbolNum);
     for (u32 i = 0; i < import_num; ++i) {
         ImportAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
         ResultCode result = ApplyRelocationBatch(relocation_addr, unresolved_symbol, true);
@@ -858,20 +893,20 @@ ResultCode CROHelper::ApplyModuleImport(VAddr crs_address) {
     u32 import_module_num = GetField(ImportModuleNum);
     for (u32 i = 0; i < import_module_num; ++i) {
         ImportModuleEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         std::string want_cro_name =
-            system.Memory().ReadCString(entry.name_offset, import_strings_size);
+            memory.ReadCString(entry.name_offset, import_strings_size);
 
         ResultCode result = ForEachAutoLinkCRO(
-            process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+            process, *system, export_index, crs_address, [&](CROHelper source) -> ResultVal<bool> {
                 if (want_cro_name == source.ModuleName()) {
                     LOG_INFO(Service_LDR, "CRO \"{}\" imports {} indexed symbols from \"{}\"",
                              ModuleName(), entry.import_indexed_symbol_num, source.ModuleName());
                     for (u32 j = 0; j < entry.import_indexed_symbol_num; ++j) {
                         ImportIndexedSymbolEntry im;
-                        entry.GetImportIndexedSymbolEntry(process, system.Memory(), j, im);
+                        entry.GetImportIndexedSymbolEntry(process, memory, j, im);
                         ExportIndexedSymbolEntry ex;
-                        source.GetEntry(system.Memory(), im.index, ex);
+                        source.GetEntry(memory, im.index, ex);
                         u32 symbol_address = source.SegmentTagToAddress(ex.symbol_position);
                         LOG_TRACE(Service_LDR, "    Imports 0x{:08X}", symbol_address);
                         ResultCode result =
@@ -886,7 +921,7 @@ ResultCode CROHelper::ApplyModuleImport(VAddr crs_address) {
                              ModuleName(), entry.import_anonymous_symbol_num, source.ModuleName());
                     for (u32 j = 0; j < entry.import_anonymous_symbol_num; ++j) {
                         ImportAnonymousSymbolEntry im;
-                        entry.GetImportAnonymousSymbolEntry(process, system.Memory(), j, im);
+                        entry.GetImportAnonymousSymbolEntry(process, memory, j, im);
                         u32 symbol_address = source.SegmentTagToAddress(im.symbol_position);
                         LOG_TRACE(Service_LDR, "    Imports 0x{:08X}", symbol_address);
                         ResultCode result =
@@ -915,15 +950,15 @@ ResultCode CROHelper::ApplyExportNamedSymbol(CROHelper target) {
     u32 target_symbol_import_num = target.GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < target_symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
             std::string symbol_name =
-                system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
+                memory.ReadCString(entry.name_offset, target_import_strings_size);
             u32 symbol_address = FindExportNamedSymbol(symbol_name);
             if (symbol_address != 0) {
                 LOG_TRACE(Service_LDR, "    exports symbol \"{}\"", symbol_name);
@@ -946,15 +981,15 @@ ResultCode CROHelper::ResetExportNamedSymbol(CROHelper target) {
     u32 target_symbol_import_num = target.GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < target_symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
         if (relocation_entry.is_batch_resolved) {
             std::string symbol_name =
-                system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
+                memory.ReadCString(entry.name_offset, target_import_strings_size);
             u32 symbol_address = FindExportNamedSymbol(symbol_name);
             if (symbol_address != 0) {
                 LOG_TRACE(Service_LDR, "    unexports symbol \"{}\"", symbol_name);
@@ -976,9 +1011,9 @@ ResultCode CROHelper::ApplyModuleExport(CROHelper target) {
     u32 target_import_module_num = target.GetField(ImportModuleNum);
     for (u32 i = 0; i < target_import_module_num; ++i) {
         ImportModuleEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
 
-        if (system.Memory().ReadCString(entry.name_offset, target_import_string_size) !=
+        if (memory.ReadCString(entry.name_offset, target_import_string_size) !=
             module_name)
             continue;
 
@@ -986,9 +1021,9 @@ ResultCode CROHelper::ApplyModuleExport(CROHelper target) {
                  entry.import_indexed_symbol_num, target.ModuleName());
         for (u32 j = 0; j < entry.import_indexed_symbol_num; ++j) {
             ImportIndexedSymbolEntry im;
-            entry.GetImportIndexedSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportIndexedSymbolEntry(process, memory, j, im);
             ExportIndexedSymbolEntry ex;
-            GetEntry(system.Memory(), im.index, ex);
+            GetEntry(memory, im.index, ex);
             u32 symbol_address = SegmentTagToAddress(ex.symbol_position);
             LOG_TRACE(Service_LDR, "    exports symbol 0x{:08X}", symbol_address);
             ResultCode result =
@@ -1003,7 +1038,7 @@ ResultCode CROHelper::ApplyModuleExport(CROHelper target) {
                  entry.import_anonymous_symbol_num, target.ModuleName());
         for (u32 j = 0; j < entry.import_anonymous_symbol_num; ++j) {
             ImportAnonymousSymbolEntry im;
-            entry.GetImportAnonymousSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportAnonymousSymbolEntry(process, memory, j, im);
             u32 symbol_address = SegmentTagToAddress(im.symbol_position);
             LOG_TRACE(Service_LDR, "    exports symbol 0x{:08X}", symbol_address);
             ResultCode result =
@@ -1026,9 +1061,9 @@ ResultCode CROHelper::ResetModuleExport(CROHelper target) {
     u32 target_import_module_num = target.GetField(ImportModuleNum);
     for (u32 i = 0; i < target_import_module_num; ++i) {
         ImportModuleEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
 
-        if (system.Memory().ReadCString(entry.name_offset, target_import_string_size) !=
+        if (memory.ReadCString(entry.name_offset, target_import_string_size) !=
             module_name)
             continue;
 
@@ -1036,7 +1071,7 @@ ResultCode CROHelper::ResetModuleExport(CROHelper target) {
                   target.ModuleName());
         for (u32 j = 0; j < entry.import_indexed_symbol_num; ++j) {
             ImportIndexedSymbolEntry im;
-            entry.GetImportIndexedSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportIndexedSymbolEntry(process, memory, j, im);
             ResultCode result =
                 target.ApplyRelocationBatch(im.relocation_batch_offset, unresolved_symbol, true);
             if (result.IsError()) {
@@ -1049,7 +1084,7 @@ ResultCode CROHelper::ResetModuleExport(CROHelper target) {
                   target.ModuleName());
         for (u32 j = 0; j < entry.import_anonymous_symbol_num; ++j) {
             ImportAnonymousSymbolEntry im;
-            entry.GetImportAnonymousSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportAnonymousSymbolEntry(process, memory, j, im);
             ResultCode result =
                 target.ApplyRelocationBatch(im.relocation_batch_offset, unresolved_symbol, true);
             if (result.IsError()) {
@@ -1067,16 +1102,17 @@ ResultCode CROHelper::ApplyExitRelocations(VAddr crs_address) {
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
-        if (system.Memory().ReadCString(entry.name_offset, import_strings_size) ==
+        if (memory.ReadCString(entry.name_offset, import_strings_size) ==
             "__aeabi_atexit") {
             ResultCode result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+                process, *system, export_index, crs_address,
+                [&](CROHelper source) -> ResultVal<bool> {
                     u32 symbol_address = source.FindExportNamedSymbol("nnroAeabiAtexit_");
 
                     if (symbol_address != 0) {
@@ -1131,7 +1167,7 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
         return result;
     }
 
-    result = VerifyStringTableLength(system.Memory(), GetField(ModuleNameOffset),
+    result = VerifyStringTableLength(memory, GetField(ModuleNameOffset),
                                      GetField(ModuleNameSize));
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error verifying module name {:08X}", result.raw);
@@ -1161,7 +1197,7 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
         return result;
     }
 
-    result = VerifyStringTableLength(system.Memory(), GetField(ExportStringsOffset),
+    result = VerifyStringTableLength(memory, GetField(ExportStringsOffset),
                                      GetField(ExportStringsSize));
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error verifying export strings {:08X}", result.raw);
@@ -1198,7 +1234,7 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
         return result;
     }
 
-    result = VerifyStringTableLength(system.Memory(), GetField(ImportStringsOffset),
+    result = VerifyStringTableLength(memory, GetField(ImportStringsOffset),
                                      GetField(ImportStringsSize));
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error verifying import strings {:08X}", result.raw);
@@ -1272,11 +1308,11 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
             // so we do the same
             if (GetField(SegmentNum) >= 2) { // means we have .data segment
                 SegmentEntry entry;
-                GetEntry(system.Memory(), 2, entry);
+                GetEntry(memory, 2, entry);
                 ASSERT(entry.type == SegmentType::Data);
                 data_segment_address = entry.offset;
                 entry.offset = GetField(DataOffset);
-                SetEntry(system.Memory(), 2, entry);
+                SetEntry(memory, 2, entry);
             }
         }
         SCOPE_EXIT({
@@ -1284,9 +1320,9 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
             if (link_on_load_bug_fix) {
                 if (GetField(SegmentNum) >= 2) {
                     SegmentEntry entry;
-                    GetEntry(system.Memory(), 2, entry);
+                    GetEntry(memory, 2, entry);
                     entry.offset = data_segment_address;
-                    SetEntry(system.Memory(), 2, entry);
+                    SetEntry(memory, 2, entry);
                 }
             }
         });
@@ -1307,7 +1343,7 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
     }
 
     // Exports symbols to other modules
-    result = ForEachAutoLinkCRO(process, system, crs_address,
+    result = ForEachAutoLinkCRO(process, *system, export_index, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     ResultCode result = ApplyExportNamedSymbol(target);
                                     if (result.IsError())
@@ -1352,7 +1388,7 @@ ResultCode CROHelper::Unlink(VAddr crs_address) {
 
     // Resets all symbols in other modules imported from this module
     // Note: the RO service seems only searching in auto-link modules
-    result = ForEachAutoLinkCRO(process, system, crs_address,
+    result = ForEachAutoLinkCRO(process, *system, export_index, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     ResultCode result = ResetExportNamedSymbol(target);
                                     if (result.IsError())
@@ -1393,13 +1429,13 @@ void CROHelper::InitCRS() {
 }
 
 void CROHelper::Register(VAddr crs_address, bool auto_link) {
-    CROHelper crs(crs_address, process, system);
-    CROHelper head(auto_link ? crs.NextModule() : crs.PreviousModule(), process, system);
+    CROHelper crs(crs_address, process, memory);
+    CROHelper head(auto_link ? crs.NextModule() : crs.PreviousModule(), process, memory);
 
     if (head.module_address) {
         // there are already CROs registered
         // register as the new tail
-        CROHelper tail(head.PreviousModule(), process, system);
+        CROHelper tail(head.PreviousModule(), process, memory);
 
         // link with the old tail
         ASSERT(tail.NextModule() == 0);
@@ -1425,11 +1461,11 @@ void CROHelper::Register(VAddr crs_address, bool auto_link) {
 }
 
 void CROHelper::Unregister(VAddr crs_address) {
-    CROHelper crs(crs_address, process, system);
-    CROHelper next_head(crs.NextModule(), process, system);
-    CROHelper previous_head(crs.PreviousModule(), process, system);
-    CROHelper next(NextModule(), process, system);
-    CROHelper previous(PreviousModule(), process, system);
+    CROHelper crs(crs_address, process, memory);
+    CROHelper next_head(crs.NextModule(), process, memory);
+    CROHelper previous_head(crs.PreviousModule(), process, memory);
+    CROHelper next(NextModule(), process, memory);
+    CROHelper previous(PreviousModule(), process, memory);
 
     if (module_address == next_head.module_address ||
         module_address == previous_head.module_address) {
@@ -1523,7 +1559,7 @@ std::tuple<VAddr, u32> CROHelper::GetExecutablePages() const {
     u32 segment_num = GetField(SegmentNum);
     for (u32 i = 0; i < segment_num; ++i) {
         SegmentEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         if (entry.type == SegmentType::Code && entry.size != 0) {
             VAddr begin = Common::AlignDown(entry.offset, Memory::CITRA_PAGE_SIZE);
             VAddr end = Common::AlignUp(entry.offset + entry.size, Memory::CITRA_PAGE_SIZE);
@@ -9,6 +9,7 @@
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
+#include "core/hle/service/ldr_ro/export_symbol_index.h"
 #include "core/memory.h"
 
 namespace Kernel {
@@ -33,11 +34,20 @@ static constexpr u32 CRO_HASH_SIZE = 0x80;
 class CROHelper final {
 public:
     // TODO (wwylele): pass in the process handle for memory access
-    explicit CROHelper(VAddr cro_address, Kernel::Process& process, Core::System& system)
-        : module_address(cro_address), process(process), system(system) {}
+    explicit CROHelper(VAddr cro_address, Kernel::Process& process, Core::System& system,
+                       ExportSymbolIndex* export_index = nullptr);
+
+    /**
+     * Creates a helper that only reads and links the module in memory, such as to look up its
+     * symbols. It can't apply relocations, which need to invalidate the caches of the CPUs.
+     */
+    explicit CROHelper(VAddr cro_address, Kernel::Process& process, Memory::MemorySystem& memory,
+                       ExportSymbolIndex* export_index = nullptr)
+        : module_address(cro_address), process(process), memory(memory),
+          export_index(export_index) {}
 
     std::string ModuleName() const {
-        return system.Memory().ReadCString(GetField(ModuleNameOffset), GetField(ModuleNameSize));
+        return memory.ReadCString(GetField(ModuleNameOffset), GetField(ModuleNameSize));
     }
 
     u32 GetFileSize() const {
@@ -134,6 +144,28 @@ public:
 
     bool IsLoaded() const;
 
+    /**
+     * Indexes the exported named symbols of this module, replacing the ones indexed before.
+     * @returns the indexed symbols.
+     * @note the module must have been created with an index.
+     */
+    const ExportSymbolIndex::Symbols& IndexExportNamedSymbols() const;
+
+    /**
+     * Finds an exported named symbol in this module, in the index if there is one. The symbols
+     * of the module are indexed on the first lookup.
+     * @param name the name of the symbol to find
+     * @return VAddr the virtual address of the symbol; 0 if not found.
+     */
+    VAddr FindExportNamedSymbol(const std::string& name) const;
+
+    /**
+     * Finds an exported named symbol in the export tree of this module.
+     * @param name the name of the symbol to find
+     * @return VAddr the virtual address of the symbol; 0 if not found.
+     */
+    VAddr WalkExportTree(const std::string& name) const;
+
     /**
      * Gets the page address and size of the code segment.
      * @returns a tuple of (address, size); (0, 0) if the code segment doesn't exist.
@@ -143,7 +175,10 @@ public:
 private:
     const VAddr module_address; ///< the virtual address of this module
     Kernel::Process& process;   ///< the owner process of this module
-    Core::System& system;
+    Memory::MemorySystem& memory;
+    Core::System* system = nullptr; ///< null if the helper can't apply relocations
+    /// The index of the named symbols the modules of the process export, if any
+    ExportSymbolIndex* export_index;
 
     /**
      * Each item in this enum represents a u32 field in the header begin from address+0x80,
@@ -401,11 +436,11 @@ private:
     }
 
     u32 GetField(HeaderField field) const {
-        return system.Memory().Read32(Field(field));
+        return memory.Read32(Field(field));
     }
 
     void SetField(HeaderField field, u32 value) {
-        system.Memory().Write32(Field(field), value);
+        memory.Write32(Field(field), value);
     }
 
     /**
@@ -462,6 +497,7 @@ private:
     /**
      * A helper function iterating over all registered auto-link modules, including the static
      * module.
+     * @param export_index the index of exported named symbols the modules use, if any
      * @param crs_address the virtual address of the static module
      * @param func a function object to operate on a module. It accepts one parameter
      *        CROHelper and returns ResultVal<bool>. It should return true to continue the
@@ -473,10 +509,11 @@ private:
      */
     template <typename FunctionObject>
     static ResultCode ForEachAutoLinkCRO(Kernel::Process& process, Core::System& system,
-                                         VAddr crs_address, FunctionObject func) {
+                                         ExportSymbolIndex* export_index, VAddr crs_address,
+                                         FunctionObject func) {
         VAddr current = crs_address;
         while (current != 0) {
-            CROHelper cro(current, process, system);
+            CROHelper cro(current, process, system, export_index);
             CASCADE_RESULT(bool next, func(cro));
             if (!next)
                 break;
@@ -516,13 +553,6 @@ private:
      */
     ResultCode ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool reset = false);
 
-    /**
-     * Finds an exported named symbol in this module.
-     * @param name the name of the symbol to find
-     * @return VAddr the virtual address of the symbol; 0 if not found.
-     */
-    VAddr FindExportNamedSymbol(const std::string& name) const;
-
     /**
      * Rebases offsets in module header according to module address.
      * @param cro_size the size of the CRO file
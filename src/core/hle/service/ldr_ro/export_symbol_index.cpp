@@ -0,0 +1,27 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "core/hle/service/ldr_ro/export_symbol_index.h"
+
+namespace Service::LDR {
+
+const ExportSymbolIndex::Symbols* ExportSymbolIndex::Find(VAddr module_address) const {
+    const auto itr = modules.find(module_address);
+    return itr != modules.end() ? &itr->second : nullptr;
+}
+
+const ExportSymbolIndex::Symbols& ExportSymbolIndex::Add(VAddr module_address, Symbols symbols) {
+    return modules.insert_or_assign(module_address, std::move(symbols)).first->second;
+}
+
+void ExportSymbolIndex::Remove(VAddr module_address) {
+    modules.erase(module_address);
+}
+
+void ExportSymbolIndex::Clear() {
+    modules.clear();
+}
+
+} // namespace Service::LDR
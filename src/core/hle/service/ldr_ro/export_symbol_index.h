@@ -0,0 +1,48 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "common/common_types.h"
+
+namespace Service::LDR {
+
+/**
+ * Host-side index of the named symbols exported by the loaded modules of a process, by module.
+ * Linking looks up every named import of a module in each auto-link module, which otherwise
+ * walks the export tree of the module in guest memory every time.
+ */
+class ExportSymbolIndex final {
+public:
+    /// Address of each exported named symbol, by name
+    using Symbols = std::unordered_map<std::string, VAddr>;
+
+    /**
+     * Gets the indexed symbols of a module.
+     * @param module_address the virtual address of the module
+     * @returns the symbols of the module, or nullptr if it isn't indexed.
+     */
+    const Symbols* Find(VAddr module_address) const;
+
+    /**
+     * Indexes the symbols of a module, replacing the ones it had.
+     * @param module_address the virtual address of the module
+     * @param symbols the exported named symbols of the module
+     * @returns the indexed symbols.
+     */
+    const Symbols& Add(VAddr module_address, Symbols symbols);
+
+    /// Drops the symbols of a module, which has been unloaded or whose exports have changed
+    void Remove(VAddr module_address);
+
+    /// Drops the symbols of all modules
+    void Clear();
+
+private:
+    std::unordered_map<VAddr, Symbols> modules;
+};
+
+} // namespace Service::LDR
@@ -127,7 +127,7 @@ void RO::Initialize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    CROHelper crs(crs_address, *process, system);
+    CROHelper crs(crs_address, *process, system, &slot->export_index);
     crs.InitCRS();
 
     result = crs.Rebase(0, crs_size, 0, 0, 0, 0, true);
@@ -137,6 +137,7 @@ void RO::Initialize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    crs.IndexExportNamedSymbols();
     slot->loaded_crs = crs_address;
 
     rb.Push(RESULT_SUCCESS);
@@ -261,7 +262,7 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
         return;
     }
 
-    CROHelper cro(cro_address, *process, system);
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
 
     result = cro.VerifyHash(cro_size, crr_address);
     if (result.IsError()) {
@@ -284,6 +285,9 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
         return;
     }
 
+    // A module that failed to load at this address may have been indexed while linking
+    slot->export_index.Remove(cro_address);
+
     result = cro.Link(slot->loaded_crs, link_on_load_bug_fix);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error linking CRO {:08X}", result.raw);
@@ -298,6 +302,9 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
 
     u32 fix_size = cro.Fix(fix_level);
 
+    // Fixing may drop the export tables the module was indexed with while linking
+    cro.IndexExportNamedSymbols();
+
     if (fix_size != cro_size) {
         result = process->Unmap(cro_address + fix_size, cro_buffer_ptr + fix_size,
                                 cro_size - fix_size, Kernel::VMAPermission::ReadWrite, true);
@@ -343,11 +350,10 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}, zero={}, cro_buffer_ptr=0x{:08X}",
               cro_address, zero, cro_buffer_ptr);
 
-    CROHelper cro(cro_address, *process, system);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
     ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -391,6 +397,7 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
     }
 
     cro.Unrebase(false);
+    slot->export_index.Remove(cro_address);
 
     result = process->Unmap(cro_address, cro_buffer_ptr, fixed_size,
                             Kernel::VMAPermission::ReadWrite, true);
@@ -410,11 +417,10 @@ void RO::LinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}", cro_address);
 
-    CROHelper cro(cro_address, *process, system);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
     ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -450,11 +456,10 @@ void RO::UnlinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}", cro_address);
 
-    CROHelper cro(cro_address, *process, system);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
     ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -510,6 +515,7 @@ void RO::Shutdown(Kernel::HLERequestContext& ctx) {
         LOG_ERROR(Service_LDR, "Error unmapping CRS {:08X}", result.raw);
     }
 
+    slot->export_index.Clear();
     slot->loaded_crs = 0;
     rb.Push(result);
 }
@@ -0,0 +1,135 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "core/hle/service/soc_operations.h"
+
+#ifdef _WIN32
+#define ERRNO(x) WSA##x
+#define GET_ERRNO WSAGetLastError()
+#define poll(x, y, z) WSAPoll(x, y, z)
+#else
+#include <cerrno>
+#define ERRNO(x) x
+#define GET_ERRNO errno
+#endif
+
+namespace Service::SOC {
+
+static bool WouldBlock(int error) {
+    return error == ERRNO(EAGAIN) || error == ERRNO(EWOULDBLOCK);
+}
+
+void SocketOperation::Abort() {
+    ret = SOCKET_ERROR_VALUE;
+    error = ERRNO(EBADF);
+}
+
+bool SocketOperation::SetResult(s32 result) {
+    ret = result;
+    error = result == SOCKET_ERROR_VALUE ? GET_ERRNO : 0;
+    return result != SOCKET_ERROR_VALUE || !WouldBlock(error);
+}
+
+RecvOperation::RecvOperation(u16 command_id_, SocketFd socket_fd_, u32 len, u32 flags_,
+                             u32 addr_len)
+    : command_id{command_id_}, socket_fd{socket_fd_}, flags{flags_}, output_buff(len),
+      addr_buff(addr_len) {}
+
+bool RecvOperation::TryComplete() {
+    auto* const data = reinterpret_cast<char*>(output_buff.data());
+    const auto len = static_cast<int>(output_buff.size());
+    if (addr_buff.empty()) {
+        return SetResult(static_cast<s32>(::recvfrom(socket_fd, data, len, flags, NULL, 0)));
+    }
+    // Only get src adr if input adr available
+    src_addr_len = sizeof(src_addr);
+    return SetResult(
+        static_cast<s32>(::recvfrom(socket_fd, data, len, flags, &src_addr, &src_addr_len)));
+}
+
+SendOperation::SendOperation(u16 command_id_, SocketFd socket_fd_, std::vector<u8> data_,
+                             u32 flags_, std::optional<sockaddr> dest_addr_, bool send_all_)
+    : command_id{command_id_}, socket_fd{socket_fd_}, data{std::move(data_)}, flags{flags_},
+      dest_addr{dest_addr_}, send_all{send_all_} {}
+
+bool SendOperation::TryComplete() {
+    const sockaddr* const dest = dest_addr ? &*dest_addr : nullptr;
+    const socklen_t dest_len = dest_addr ? sizeof(sockaddr) : 0;
+    do {
+        const auto result = static_cast<s32>(
+            ::sendto(socket_fd, reinterpret_cast<const char*>(data.data() + sent),
+                     static_cast<int>(data.size() - sent), flags, dest, dest_len));
+        if (result == SOCKET_ERROR_VALUE) {
+            if (sent == 0) {
+                return SetResult(result);
+            }
+            // A blocking send only returns once all the data has been sent
+            if (send_all && WouldBlock(GET_ERRNO)) {
+                return false;
+            }
+            break;
+        }
+        sent += result;
+    } while (send_all && sent < data.size());
+    ret = static_cast<s32>(sent);
+    error = 0;
+    return true;
+}
+
+AcceptOperation::AcceptOperation(SocketFd socket_fd_) : socket_fd{socket_fd_} {}
+
+bool AcceptOperation::TryComplete() {
+    socklen_t addr_len = sizeof(addr);
+    accepted_fd = static_cast<SocketFd>(::accept(socket_fd, &addr, &addr_len));
+    return SetResult(static_cast<s32>(accepted_fd) == SOCKET_ERROR_VALUE ? SOCKET_ERROR_VALUE : 0);
+}
+
+ConnectOperation::ConnectOperation(SocketFd socket_fd_) : socket_fd{socket_fd_} {}
+
+bool ConnectOperation::Start(const sockaddr& addr) {
+    SetResult(::connect(socket_fd, &addr, sizeof(addr)));
+    return ret == SOCKET_ERROR_VALUE && (error == ERRNO(EINPROGRESS) || WouldBlock(error));
+}
+
+bool ConnectOperation::TryComplete() {
+    // The socket is writable once the connection is established or failed
+    int socket_error = 0;
+    socklen_t len = sizeof(socket_error);
+    if (::getsockopt(socket_fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&socket_error),
+                     &len) == SOCKET_ERROR_VALUE) {
+        socket_error = GET_ERRNO;
+    }
+    ret = socket_error == 0 ? 0 : SOCKET_ERROR_VALUE;
+    error = socket_error;
+    return true;
+}
+
+PollOperation::PollOperation(std::vector<pollfd> platform_pollfd_,
+                             std::vector<u8> has_libctru_bug_)
+    : platform_pollfd{std::move(platform_pollfd_)}, has_libctru_bug{std::move(has_libctru_bug_)} {}
+
+std::vector<SocketReactor::Wait> PollOperation::GetWaits() const {
+    std::vector<SocketReactor::Wait> waits;
+    for (const pollfd& fd : platform_pollfd) {
+        u32 events = 0;
+        if (fd.events & (POLLIN | POLLRDNORM | POLLRDBAND | POLLPRI)) {
+            events |= SocketReactor::Readable;
+        }
+        if (fd.events & (POLLOUT | POLLWRNORM | POLLWRBAND)) {
+            events |= SocketReactor::Writable;
+        }
+        if (events != 0) {
+            waits.push_back({static_cast<SocketFd>(fd.fd), events});
+        }
+    }
+    return waits;
+}
+
+bool PollOperation::TryComplete() {
+    const s32 result = ::poll(platform_pollfd.data(), static_cast<u32>(platform_pollfd.size()), 0);
+    return SetResult(result) && ret != 0;
+}
+
+} // namespace Service::SOC
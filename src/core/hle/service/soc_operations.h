@@ -0,0 +1,165 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+#include "common/common_types.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/service/soc_reactor.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+namespace Kernel {
+class Event;
+}
+
+namespace Service::SOC {
+
+class SOC_U;
+
+constexpr s32 SOCKET_ERROR_VALUE = -1;
+
+/**
+ * A call on sockets that a guest thread blocks on. The host sockets are non-blocking, so the call
+ * is attempted again on the reactor whenever its sockets are ready, until it would no longer
+ * block. The host calls are made here, SOC:U writes their results in the response of the request.
+ */
+class SocketOperation : public SocketReactor::Operation {
+public:
+    /// Writes the response of the request, once the operation completed or timed out.
+    virtual void WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) = 0;
+
+    void Abort() override;
+
+    /// Returns the result of the host call, SOCKET_ERROR_VALUE if it failed.
+    s32 GetReturn() const {
+        return ret;
+    }
+
+    /// Returns the host error of a failed call, 0 otherwise.
+    int GetError() const {
+        return error;
+    }
+
+    /// Event that wakes up the guest thread waiting on the operation
+    std::shared_ptr<Kernel::Event> event;
+
+protected:
+    /// Stores the result of a host call, returning whether the operation completed.
+    bool SetResult(s32 result);
+
+    /// Returns the result for the guest, which is the translated error if the operation failed.
+    s32 GetResult() const;
+
+    s32 ret = 0;
+    int error = 0;
+};
+
+/// RecvFrom and RecvFromOther
+class RecvOperation final : public SocketOperation {
+public:
+    RecvOperation(u16 command_id, SocketFd socket_fd, u32 len, u32 flags, u32 addr_len);
+
+    bool TryComplete() override;
+    void WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) override;
+
+    /// Returns the received data, the size of the buffer until the operation completed.
+    const std::vector<u8>& GetData() const {
+        return output_buff;
+    }
+
+    /// Buffer of RecvFromOther, which the data is written to rather than to a static buffer
+    std::optional<Kernel::MappedBuffer> buffer;
+
+private:
+    u16 command_id;
+    SocketFd socket_fd;
+    u32 flags;
+    std::vector<u8> output_buff;
+    std::vector<u8> addr_buff;
+    sockaddr src_addr{};
+    socklen_t src_addr_len = 0;
+};
+
+/// SendTo and SendToOther
+class SendOperation final : public SocketOperation {
+public:
+    SendOperation(u16 command_id, SocketFd socket_fd, std::vector<u8> data, u32 flags,
+                  std::optional<sockaddr> dest_addr, bool send_all);
+
+    bool TryComplete() override;
+    void WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) override;
+
+private:
+    u16 command_id;
+    SocketFd socket_fd;
+    std::vector<u8> data;
+    std::size_t sent = 0;
+    u32 flags;
+    std::optional<sockaddr> dest_addr;
+    bool send_all;
+};
+
+class AcceptOperation final : public SocketOperation {
+public:
+    explicit AcceptOperation(SocketFd socket_fd);
+
+    bool TryComplete() override;
+    void WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) override;
+
+    /// Returns the accepted socket, once the operation completed successfully.
+    SocketFd GetAcceptedSocket() const {
+        return accepted_fd;
+    }
+
+private:
+    SocketFd socket_fd;
+    SocketFd accepted_fd{};
+    sockaddr addr{};
+};
+
+class ConnectOperation final : public SocketOperation {
+public:
+    explicit ConnectOperation(SocketFd socket_fd);
+
+    /// Starts connecting, returning whether the connection is still in progress.
+    bool Start(const sockaddr& addr);
+
+    bool TryComplete() override;
+    void WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) override;
+
+private:
+    SocketFd socket_fd;
+};
+
+class PollOperation final : public SocketOperation {
+public:
+    PollOperation(std::vector<pollfd> platform_pollfd, std::vector<u8> has_libctru_bug);
+
+    /// Returns the sockets to wait for, with the events the guest polls for.
+    std::vector<SocketReactor::Wait> GetWaits() const;
+
+    bool TryComplete() override;
+    void WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) override;
+
+    /// Returns the polled sockets, with the events they were ready for once polled.
+    const std::vector<pollfd>& GetPollFds() const {
+        return platform_pollfd;
+    }
+
+private:
+    std::vector<pollfd> platform_pollfd;
+    std::vector<u8> has_libctru_bug;
+};
+
+} // namespace Service::SOC
@@ -0,0 +1,272 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/hle/service/soc_reactor.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#define poll(x, y, z) WSAPoll(x, y, z)
+#elif defined(__linux__)
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#else
+#include <poll.h>
+#endif
+
+namespace Service::SOC {
+
+#ifndef __linux__
+/// Interval at which the waited sockets are updated, for operations submitted during a wait
+constexpr int PollInterval = 10;
+#endif
+
+SocketReactor::SocketReactor() {
+#ifdef __linux__
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ASSERT_MSG(epoll_fd != -1 && wakeup_fd != -1, "Could not create the socket reactor");
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeup_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &event);
+#endif
+    thread = std::jthread([this](std::stop_token stop_token) { ReactorLoop(stop_token); });
+}
+
+SocketReactor::~SocketReactor() {
+    thread.request_stop();
+#ifdef __linux__
+    const u64 value = 1;
+    [[maybe_unused]] const auto written = write(wakeup_fd, &value, sizeof(value));
+#endif
+    thread.join();
+#ifdef __linux__
+    close(wakeup_fd);
+    close(epoll_fd);
+#endif
+}
+
+void SocketReactor::Submit(std::shared_ptr<Operation> operation, std::vector<Wait> waits) {
+    {
+        std::scoped_lock lock{mutex};
+        Operation* const key = operation.get();
+        for (const auto& wait : waits) {
+            waiters[wait.fd].push_back(key);
+        }
+        auto& entry = pending[key];
+        entry.operation = std::move(operation);
+        entry.waits = std::move(waits);
+        for (const auto& wait : entry.waits) {
+            UpdateInterest(wait.fd);
+        }
+    }
+#ifndef __linux__
+    waiters_changed.notify_one();
+#endif
+}
+
+bool SocketReactor::Cancel(const std::shared_ptr<Operation>& operation) {
+    std::scoped_lock lock{mutex};
+    if (pending.contains(operation.get())) {
+        RemovePending(operation.get());
+        return false;
+    }
+    const auto it = std::find(completed.begin(), completed.end(), operation);
+    if (it == completed.end()) {
+        return false;
+    }
+    completed.erase(it);
+    return true;
+}
+
+void SocketReactor::AbortSocket(SocketFd fd) {
+    std::scoped_lock lock{mutex};
+    const auto it = waiters.find(fd);
+    if (it == waiters.end()) {
+        return;
+    }
+    const std::vector<Operation*> operations = it->second;
+    for (Operation* operation : operations) {
+        auto entry = pending.find(operation);
+        if (entry == pending.end()) {
+            continue;
+        }
+        operation->Abort();
+        completed.push_back(std::move(entry->second.operation));
+        RemovePending(operation);
+    }
+}
+
+std::vector<std::shared_ptr<SocketReactor::Operation>> SocketReactor::TakeCompleted() {
+    std::scoped_lock lock{mutex};
+    return std::exchange(completed, {});
+}
+
+bool SocketReactor::HasOperations() const {
+    std::scoped_lock lock{mutex};
+    return !pending.empty() || !completed.empty();
+}
+
+void SocketReactor::ReactorLoop(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("SocketReactor");
+
+#ifdef __linux__
+    std::array<epoll_event, 64> events;
+    while (!stop_token.stop_requested()) {
+        const int num_events =
+            epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+        if (num_events == -1 && errno != EINTR) {
+            LOG_ERROR(Service_SOC, "epoll_wait failed: {}", errno);
+            break;
+        }
+        for (int i = 0; i < num_events; i++) {
+            const epoll_event& event = events[i];
+            if (event.data.fd == wakeup_fd) {
+                u64 value;
+                [[maybe_unused]] const auto read_size = read(wakeup_fd, &value, sizeof(value));
+                continue;
+            }
+            u32 ready = 0;
+            if (event.events & EPOLLIN) {
+                ready |= Readable;
+            }
+            if (event.events & EPOLLOUT) {
+                ready |= Writable;
+            }
+            // Errors complete every operation on the socket, which then fails
+            if (event.events & (EPOLLERR | EPOLLHUP)) {
+                ready |= Readable | Writable;
+            }
+            HandleReady(event.data.fd, ready);
+        }
+    }
+#else
+    std::vector<pollfd> fds;
+    while (!stop_token.stop_requested()) {
+        {
+            std::unique_lock lock{mutex};
+            Common::CondvarWait(waiters_changed, lock, stop_token,
+                                [this] { return !waiters.empty(); });
+            fds.clear();
+            for (const auto& [fd, operations] : waiters) {
+                u32 events = 0;
+                for (Operation* operation : operations) {
+                    for (const auto& wait : pending[operation].waits) {
+                        events |= wait.fd == fd ? wait.events : 0;
+                    }
+                }
+                pollfd& entry = fds.emplace_back();
+                entry.fd = fd;
+                entry.events = ((events & Readable) ? POLLIN : 0) |
+                               ((events & Writable) ? POLLOUT : 0);
+                entry.revents = 0;
+            }
+        }
+        if (fds.empty()) {
+            continue;
+        }
+        if (poll(fds.data(), static_cast<unsigned long>(fds.size()), PollInterval) <= 0) {
+            continue;
+        }
+        for (const pollfd& entry : fds) {
+            u32 ready = 0;
+            if (entry.revents & POLLIN) {
+                ready |= Readable;
+            }
+            if (entry.revents & POLLOUT) {
+                ready |= Writable;
+            }
+            if (entry.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                ready |= Readable | Writable;
+            }
+            if (ready != 0) {
+                HandleReady(static_cast<SocketFd>(entry.fd), ready);
+            }
+        }
+    }
+#endif
+}
+
+void SocketReactor::HandleReady(SocketFd fd, u32 events) {
+    std::scoped_lock lock{mutex};
+    const auto it = waiters.find(fd);
+    if (it == waiters.end()) {
+        return;
+    }
+    const std::vector<Operation*> operations = it->second;
+    for (Operation* operation : operations) {
+        auto entry = pending.find(operation);
+        if (entry == pending.end()) {
+            continue;
+        }
+        const auto& waits = entry->second.waits;
+        const bool is_ready = std::any_of(waits.begin(), waits.end(), [&](const Wait& wait) {
+            return wait.fd == fd && (wait.events & events) != 0;
+        });
+        if (!is_ready || !operation->TryComplete()) {
+            continue;
+        }
+        completed.push_back(std::move(entry->second.operation));
+        RemovePending(operation);
+    }
+    if (waiters.contains(fd)) {
+        // Waits for the socket again, for the operations that would still block
+        UpdateInterest(fd);
+    }
+}
+
+void SocketReactor::RemovePending(Operation* operation) {
+    const auto entry = pending.find(operation);
+    const std::vector<Wait> waits = std::move(entry->second.waits);
+    pending.erase(entry);
+    for (const auto& wait : waits) {
+        const auto it = waiters.find(wait.fd);
+        if (it == waiters.end()) {
+            continue;
+        }
+        std::erase(it->second, operation);
+        UpdateInterest(wait.fd);
+    }
+}
+
+void SocketReactor::UpdateInterest(SocketFd fd) {
+    const auto it = waiters.find(fd);
+    if (it == waiters.end()) {
+        return;
+    }
+    if (it->second.empty()) {
+#ifdef __linux__
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+        waiters.erase(it);
+        return;
+    }
+#ifdef __linux__
+    u32 events = 0;
+    for (Operation* operation : it->second) {
+        for (const auto& wait : pending[operation].waits) {
+            events |= wait.fd == fd ? wait.events : 0;
+        }
+    }
+    // The socket is waited for once, then again by the next update if operations still wait on
+    // it, so that a socket that stays ready does not wake the reactor over and over
+    epoll_event event{};
+    event.events = EPOLLONESHOT | ((events & Readable) ? EPOLLIN : 0u) |
+                   ((events & Writable) ? EPOLLOUT : 0u);
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) == -1 && errno == ENOENT) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+#endif
+}
+
+} // namespace Service::SOC
@@ -0,0 +1,124 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+
+namespace Service::SOC {
+
+#ifdef _WIN32
+using SocketFd = unsigned long long;
+#else
+using SocketFd = int;
+#endif // _WIN32
+
+/**
+ * Performs the socket operations that guest threads block on. The host sockets are non-blocking,
+ * so when an operation on a socket the guest considers blocking can not complete right away, it
+ * is submitted here instead of blocking the emulation thread. A thread of the reactor waits for
+ * the sockets to become ready, epoll on Linux and poll elsewhere, and completes the operation as
+ * soon as it no longer blocks. The emulation thread takes the completed operations to wake the
+ * guest threads that wait on them.
+ */
+class SocketReactor {
+public:
+    /// Readiness of a socket that an operation waits for
+    enum Events : u32 {
+        Readable = 1 << 0,
+        Writable = 1 << 1,
+    };
+
+    struct Wait {
+        SocketFd fd;
+        u32 events;
+    };
+
+    /// An operation that a guest thread waits on.
+    class Operation {
+    public:
+        virtual ~Operation() = default;
+
+        /**
+         * Attempts the operation without blocking. Called on the reactor thread once a socket of
+         * the operation is ready, or with an error.
+         * @returns Whether the operation completed, successfully or not, rather than would block.
+         */
+        virtual bool TryComplete() = 0;
+
+        /**
+         * Completes the operation with an error, because a socket it waits on is being closed.
+         */
+        virtual void Abort() = 0;
+    };
+
+    SocketReactor();
+    ~SocketReactor();
+
+    /**
+     * Waits for any of the sockets to become ready and completes the operation then.
+     */
+    void Submit(std::shared_ptr<Operation> operation, std::vector<Wait> waits);
+
+    /**
+     * Stops waiting for an operation, after a timeout.
+     * @returns Whether the operation completed before it was cancelled.
+     */
+    bool Cancel(const std::shared_ptr<Operation>& operation);
+
+    /**
+     * Aborts the operations that wait on a socket, which must be done before closing it.
+     */
+    void AbortSocket(SocketFd fd);
+
+    /**
+     * Takes the operations that completed since the last call, in the order they completed in.
+     */
+    std::vector<std::shared_ptr<Operation>> TakeCompleted();
+
+    /**
+     * Returns whether there are operations that were submitted but not taken yet.
+     */
+    bool HasOperations() const;
+
+private:
+    struct Pending {
+        std::shared_ptr<Operation> operation;
+        std::vector<Wait> waits;
+    };
+
+    void ReactorLoop(std::stop_token stop_token);
+
+    /// Completes the operations that wait on a socket for the events it is ready for.
+    void HandleReady(SocketFd fd, u32 events);
+
+    /// Removes a pending operation from the sockets it waits on. mutex must be held.
+    void RemovePending(Operation* operation);
+
+    /// Updates the events the host waits for on a socket. mutex must be held.
+    void UpdateInterest(SocketFd fd);
+
+    mutable std::mutex mutex;
+    std::unordered_map<Operation*, Pending> pending;
+    /// Operations waiting on each socket
+    std::unordered_map<SocketFd, std::vector<Operation*>> waiters;
+    std::vector<std::shared_ptr<Operation>> completed;
+
+#ifdef __linux__
+    int epoll_fd = -1;
+    int wakeup_fd = -1; ///< eventfd that interrupts the wait of the reactor thread
+#else
+    std::condition_variable_any waiters_changed;
+#endif
+
+    std::jthread thread;
+};
+
+} // namespace Service::SOC
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <optional>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -15,9 +16,12 @@
 #include "common/scope_exit.h"
 #include "common/swap.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/kernel/event.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/result.h"
+#include "core/hle/service/soc_operations.h"
 #include "core/hle/service/soc_u.h"
 
 #ifdef _WIN32
@@ -64,10 +68,13 @@
 #define MSGCUSTOM_HANDLE_DONTWAIT 0x80000000
 
 SERIALIZE_EXPORT_IMPL(Service::SOC::SOC_U)
+SERIALIZE_EXPORT_IMPL(Service::SOC::SOC_U::SocketCallback)
+SERVICE_CONSTRUCT_IMPL(Service::SOC::SOC_U)
 
 namespace Service::SOC {
 
-const s32 SOCKET_ERROR_VALUE = -1;
+/// Interval, in microseconds, at which the guest threads of completed socket operations are woken
+constexpr int ReactorInterval = 500;
 
 static u32 SocketProtocolToPlatform(u32 protocol) {
     switch (protocol) {
@@ -375,36 +382,24 @@ bool SOC_U::GetSocketBlocking(const SocketHolder& socket_holder) {
     return socket_holder.blocking;
 }
 u32 SOC_U::SetSocketBlocking(SocketHolder& socket_holder, bool blocking) {
-    u32 posix_ret = 0;
-#ifdef _WIN32
-    unsigned long nonblocking = (blocking) ? 0 : 1;
-    int ret = ioctlsocket(socket_holder.socket_fd, FIONBIO, &nonblocking);
-    if (ret == SOCKET_ERROR_VALUE) {
-        posix_ret = TranslateError(GET_ERRNO);
-        return posix_ret;
-    }
+    // The host socket is always non-blocking, operations that would block a blocking socket wait
+    // for it on the reactor instead
     socket_holder.blocking = blocking;
-#else
-    int flags = ::fcntl(socket_holder.socket_fd, F_GETFL, 0);
-    if (flags == SOCKET_ERROR_VALUE) {
-        posix_ret = TranslateError(GET_ERRNO);
-        return posix_ret;
-    }
+    return 0;
+}
 
-    flags &= ~O_NONBLOCK;
-    if (!blocking) { // O_NONBLOCK
-        flags |= O_NONBLOCK;
+static void SetHostSocketNonBlocking(SocketFd socket_fd) {
+#ifdef _WIN32
+    unsigned long nonblocking = 1;
+    if (ioctlsocket(socket_fd, FIONBIO, &nonblocking) == SOCKET_ERROR_VALUE) {
+        LOG_ERROR(Service_SOC, "Could not make socket non-blocking: {}", GET_ERRNO);
     }
-
-    socket_holder.blocking = blocking;
-
-    const int ret = ::fcntl(socket_holder.socket_fd, F_SETFL, flags);
-    if (ret == SOCKET_ERROR_VALUE) {
-        posix_ret = TranslateError(GET_ERRNO);
-        return posix_ret;
+#else
+    const int flags = ::fcntl(socket_fd, F_GETFL, 0);
+    if (flags == SOCKET_ERROR_VALUE || ::fcntl(socket_fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        LOG_ERROR(Service_SOC, "Could not make socket non-blocking: {}", GET_ERRNO);
     }
 #endif
-    return posix_ret;
 }
 
 static u32 SendRecvFlagsToPlatform(u32 flags) {
@@ -701,22 +696,168 @@ static u32 NameInfoFlagsToPlatform(u32 flags) {
 
 static_assert(sizeof(CTRAddrInfo) == 0x130, "Size of CTRAddrInfo is not correct");
 
-void SOC_U::PreTimerAdjust() {
-    adjust_value_last = std::chrono::steady_clock::now();
+s32 SocketOperation::GetResult() const {
+    return ret == SOCKET_ERROR_VALUE ? TranslateError(error) : ret;
+}
+
+void RecvOperation::WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) {
+    const s32 total_received = ret == SOCKET_ERROR_VALUE ? 0 : ret;
+    if (ret >= 0 && src_addr_len > 0) {
+        const CTRSockAddr ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
+        std::memcpy(addr_buff.data(), &ctr_src_addr,
+                    std::min(addr_buff.size(), sizeof(ctr_src_addr)));
+    }
+    if (buffer) {
+        buffer->Write(output_buff.data(), 0, total_received);
+
+        IPC::RequestBuilder rb(ctx, command_id, 2, 4);
+        rb.Push(RESULT_SUCCESS);
+        rb.Push(GetResult());
+        rb.PushStaticBuffer(std::move(addr_buff), 0);
+        rb.PushMappedBuffer(*buffer);
+        return;
+    }
+
+    // Write only the data we received to avoid overwriting parts of the buffer with zeros
+    output_buff.resize(total_received);
+
+    IPC::RequestBuilder rb(ctx, command_id, 3, 4);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push(GetResult());
+    rb.Push(total_received);
+    rb.PushStaticBuffer(std::move(output_buff), 0);
+    rb.PushStaticBuffer(std::move(addr_buff), 1);
+}
+
+void SendOperation::WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) {
+    IPC::RequestBuilder rb(ctx, command_id, 2, 0);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push(GetResult());
+}
+
+void AcceptOperation::WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) {
+    s32 result = GetResult();
+    std::vector<u8> ctr_addr_buf(sizeof(CTRSockAddr));
+    if (ret != SOCKET_ERROR_VALUE) {
+        SetHostSocketNonBlocking(accepted_fd);
+        const u32 socket_id = socu.GetNextSocketID();
+        socu.open_sockets[socket_id] = {accepted_fd, true};
+        result = static_cast<s32>(socket_id);
+
+        const CTRSockAddr ctr_addr = CTRSockAddr::FromPlatform(addr);
+        std::memcpy(ctr_addr_buf.data(), &ctr_addr, sizeof(ctr_addr));
+    }
+
+    IPC::RequestBuilder rb(ctx, 0x04, 2, 2);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push(result);
+    rb.PushStaticBuffer(std::move(ctr_addr_buf), 0);
+}
+
+void ConnectOperation::WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) {
+    IPC::RequestBuilder rb(ctx, 0x06, 2, 0);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push(GetResult());
+}
+
+void PollOperation::WriteResponse(SOC_U& socu, Kernel::HLERequestContext& ctx) {
+    if (ret == SOCKET_ERROR_VALUE) {
+        LOG_ERROR(Service_SOC, "Socket error: {}", error);
+    }
+
+    // Now update the output 3ds_pollfd structure
+    const std::size_t nfds = platform_pollfd.size();
+    std::vector<CTRPollFD> ctr_fds(nfds);
+    for (std::size_t i = 0; i < nfds; i++) {
+        ctr_fds[i] = CTRPollFD::FromPlatform(socu, platform_pollfd[i], has_libctru_bug[i]);
+    }
+    std::vector<u8> output_fds(nfds * sizeof(CTRPollFD));
+    std::memcpy(output_fds.data(), ctr_fds.data(), nfds * sizeof(CTRPollFD));
+
+    IPC::RequestBuilder rb(ctx, 0x14, 2, 2);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push(GetResult());
+    rb.PushStaticBuffer(std::move(output_fds), 0);
 }
 
-void SOC_U::PostTimerAdjust(Kernel::HLERequestContext& ctx, const std::string& caller_method) {
-    std::chrono::time_point<std::chrono::steady_clock> new_timer = std::chrono::steady_clock::now();
-    ASSERT(new_timer >= adjust_value_last);
-    ctx.SleepClientThread(
-        fmt::format("soc_u::{}", caller_method),
-        std::chrono::duration_cast<std::chrono::nanoseconds>(new_timer - adjust_value_last),
-        nullptr);
+class SOC_U::SocketCallback final : public Kernel::HLERequestContext::WakeupCallback {
+public:
+    SocketCallback(u16 command_id_, std::shared_ptr<SOC_U> socu_,
+                   std::shared_ptr<SocketOperation> operation_)
+        : command_id{command_id_}, socu{std::move(socu_)}, operation{std::move(operation_)} {}
+
+    void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) override {
+        if (!operation) {
+            // The operation does not survive save states, the guest sees an interrupted call
+            IPC::RequestBuilder rb(ctx, command_id, 2, 0);
+            rb.Push(RESULT_SUCCESS);
+            rb.Push(TranslateError(ERRNO(EINTR)));
+            return;
+        }
+        if (reason == Kernel::ThreadWakeupReason::Timeout && !socu->reactor->Cancel(operation)) {
+            // Only Poll has a timeout, and its sockets are polled one last time then
+            operation->TryComplete();
+        }
+        operation->WriteResponse(*socu, ctx);
+    }
+
+private:
+    u16 command_id;
+    std::shared_ptr<SOC_U> socu;
+    std::shared_ptr<SocketOperation> operation;
+
+    SocketCallback() = default;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<Kernel::HLERequestContext::WakeupCallback>(*this);
+        ar& command_id;
+    }
+    friend class boost::serialization::access;
+};
+
+void SOC_U::WaitForSocket(Kernel::HLERequestContext& ctx, u16 command_id,
+                          std::shared_ptr<SocketOperation> operation,
+                          std::vector<SocketReactor::Wait> waits,
+                          std::chrono::nanoseconds timeout) {
+    if (!reactor) {
+        reactor = std::make_unique<SocketReactor>();
+    }
+    operation->event = ctx.SleepClientThread(
+        fmt::format("soc_u::0x{:02X}", command_id), timeout,
+        std::make_shared<SocketCallback>(
+            command_id, std::static_pointer_cast<SOC_U>(shared_from_this()), operation));
+    reactor->Submit(std::move(operation), std::move(waits));
+
+    if (!is_reactor_event_scheduled) {
+        is_reactor_event_scheduled = true;
+        system.CoreTiming().ScheduleEvent(usToCycles(ReactorInterval), reactor_event);
+    }
+}
+
+void SOC_U::WakeCompletedOperations(s64 cycles_late) {
+    is_reactor_event_scheduled = false;
+    if (!reactor) {
+        return;
+    }
+    for (const auto& operation : reactor->TakeCompleted()) {
+        static_cast<SocketOperation&>(*operation).event->Signal();
+    }
+    if (reactor->HasOperations()) {
+        is_reactor_event_scheduled = true;
+        system.CoreTiming().ScheduleEvent(usToCycles(ReactorInterval) - cycles_late,
+                                          reactor_event);
+    }
 }
 
 void SOC_U::CleanupSockets() {
-    for (const auto& sock : open_sockets)
+    for (const auto& sock : open_sockets) {
+        if (reactor) {
+            reactor->AbortSocket(sock.second.socket_fd);
+        }
         closesocket(sock.second.socket_fd);
+    }
     open_sockets.clear();
 }
 
@@ -753,6 +894,7 @@ void SOC_U::Socket(Kernel::HLERequestContext& ctx) {
 
     if ((s64)ret != SOCKET_ERROR_VALUE) {
         open_sockets[socketHandle] = {static_cast<decltype(SocketHolder::socket_fd)>(ret), true};
+        SetHostSocketNonBlocking(static_cast<SocketFd>(ret));
 #if _WIN32
         // Disable UDP connection reset
         int new_behavior = 0;
@@ -855,9 +997,6 @@ void SOC_U::Listen(Kernel::HLERequestContext& ctx) {
 }
 
 void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
     IPC::RequestParser rp(ctx, 0x04, 2, 2);
     const auto socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -869,29 +1008,14 @@ void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
     }
     [[maybe_unused]] const auto max_addr_len = static_cast<socklen_t>(rp.Pop<u32>());
     rp.PopPID();
-    sockaddr addr;
-    socklen_t addr_len = sizeof(addr);
-    u32 ret = static_cast<u32>(::accept(fd_info->second.socket_fd, &addr, &addr_len));
 
-    if (static_cast<s32>(ret) != SOCKET_ERROR_VALUE) {
-        u32 socketID = GetNextSocketID();
-        open_sockets[socketID] = {static_cast<decltype(SocketHolder::socket_fd)>(ret), true};
-        ret = socketID;
-    }
-
-    CTRSockAddr ctr_addr;
-    std::vector<u8> ctr_addr_buf(sizeof(ctr_addr));
-    if (static_cast<s32>(ret) == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(GET_ERRNO);
-    } else {
-        ctr_addr = CTRSockAddr::FromPlatform(addr);
-        std::memcpy(ctr_addr_buf.data(), &ctr_addr, sizeof(ctr_addr));
+    const auto socket_fd = fd_info->second.socket_fd;
+    auto operation = std::make_shared<AcceptOperation>(socket_fd);
+    if (operation->TryComplete() || !GetSocketBlocking(fd_info->second)) {
+        operation->WriteResponse(*this, ctx);
+        return;
     }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
-    rb.PushStaticBuffer(std::move(ctr_addr_buf), 0);
+    WaitForSocket(ctx, 0x04, std::move(operation), {{socket_fd, SocketReactor::Readable}});
 }
 
 void SOC_U::GetHostId(Kernel::HLERequestContext& ctx) {
@@ -922,6 +1046,9 @@ void SOC_U::Close(Kernel::HLERequestContext& ctx) {
 
     s32 ret = 0;
 
+    if (reactor) {
+        reactor->AbortSocket(fd_info->second.socket_fd);
+    }
     ret = closesocket(fd_info->second.socket_fd);
 
     open_sockets.erase(socket_handle);
@@ -948,16 +1075,6 @@ void SOC_U::SendToOther(Kernel::HLERequestContext& ctx) {
     u32 flags = SendRecvFlagsToPlatform(rp.Pop<u32>());
     bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
     flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(fd_info->second);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
     const u32 addr_len = rp.Pop<u32>();
     rp.PopPID();
     const auto dest_addr_buffer = rp.PopStaticBuffer();
@@ -967,33 +1084,22 @@ void SOC_U::SendToOther(Kernel::HLERequestContext& ctx) {
     input_mapped_buff.Read(input_buff.data(), 0,
                            std::min(input_mapped_buff.GetSize(), static_cast<size_t>(len)));
 
-    s32 ret = -1;
+    std::optional<sockaddr> dest_addr;
     if (addr_len > 0) {
         CTRSockAddr ctr_dest_addr;
         std::memcpy(&ctr_dest_addr, dest_addr_buffer.data(), sizeof(ctr_dest_addr));
-        sockaddr dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
-        ret = ::sendto(fd_info->second.socket_fd, reinterpret_cast<const char*>(input_buff.data()),
-                       len, flags, &dest_addr, sizeof(dest_addr));
-    } else {
-        ret = ::sendto(fd_info->second.socket_fd, reinterpret_cast<const char*>(input_buff.data()),
-                       len, flags, nullptr, 0);
+        dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
     }
 
-    const auto send_error = (ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-
-#ifdef _WIN32
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, true);
-    }
-#endif
-
-    if (ret == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(send_error);
+    const auto socket_fd = fd_info->second.socket_fd;
+    const bool blocking = GetSocketBlocking(fd_info->second) && !dont_wait;
+    auto operation = std::make_shared<SendOperation>(0x09, socket_fd, std::move(input_buff), flags,
+                                                     dest_addr, blocking);
+    if (operation->TryComplete() || !blocking) {
+        operation->WriteResponse(*this, ctx);
+        return;
     }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
+    WaitForSocket(ctx, 0x09, std::move(operation), {{socket_fd, SocketReactor::Writable}});
 }
 
 void SOC_U::SendTo(Kernel::HLERequestContext& ctx) {
@@ -1010,47 +1116,28 @@ void SOC_U::SendTo(Kernel::HLERequestContext& ctx) {
     u32 flags = SendRecvFlagsToPlatform(rp.Pop<u32>());
     bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
     flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(fd_info->second);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
     u32 addr_len = rp.Pop<u32>();
     rp.PopPID();
     auto input_buff = rp.PopStaticBuffer();
     auto dest_addr_buff = rp.PopStaticBuffer();
+    input_buff.resize(len);
 
-    s32 ret = -1;
+    std::optional<sockaddr> dest_addr;
     if (addr_len > 0) {
         CTRSockAddr ctr_dest_addr;
         std::memcpy(&ctr_dest_addr, dest_addr_buff.data(), sizeof(ctr_dest_addr));
-        sockaddr dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
-        ret = ::sendto(fd_info->second.socket_fd, reinterpret_cast<const char*>(input_buff.data()),
-                       len, flags, &dest_addr, sizeof(dest_addr));
-    } else {
-        ret = ::sendto(fd_info->second.socket_fd, reinterpret_cast<const char*>(input_buff.data()),
-                       len, flags, nullptr, 0);
+        dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
     }
 
-    auto send_error = (ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-
-#ifdef _WIN32
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, true);
+    const auto socket_fd = fd_info->second.socket_fd;
+    const bool blocking = GetSocketBlocking(fd_info->second) && !dont_wait;
+    auto operation = std::make_shared<SendOperation>(0x0A, socket_fd, std::move(input_buff), flags,
+                                                     dest_addr, blocking);
+    if (operation->TryComplete() || !blocking) {
+        operation->WriteResponse(*this, ctx);
+        return;
     }
-#endif
-
-    if (ret == SOCKET_ERROR_VALUE)
-        ret = TranslateError(send_error);
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
+    WaitForSocket(ctx, 0x0A, std::move(operation), {{socket_fd, SocketReactor::Writable}});
 }
 
 void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
@@ -1067,69 +1154,21 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
     u32 flags = SendRecvFlagsToPlatform(rp.Pop<u32>());
     bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
     flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(fd_info->second);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
     u32 addr_len = rp.Pop<u32>();
     rp.PopPID();
     auto& buffer = rp.PopMappedBuffer();
 
-    CTRSockAddr ctr_src_addr;
-    std::vector<u8> output_buff(len);
-    std::vector<u8> addr_buff(addr_len);
-    sockaddr src_addr;
-    socklen_t src_addr_len = sizeof(src_addr);
-
-    s32 ret = -1;
-    if (GetSocketBlocking(fd_info->second) && !dont_wait) {
-        PreTimerAdjust();
-    }
-
-    if (addr_len > 0) {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, &src_addr, &src_addr_len);
-        if (ret >= 0 && src_addr_len > 0) {
-            ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-            std::memcpy(addr_buff.data(), &ctr_src_addr, addr_len);
-        }
-    } else {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, NULL, 0);
-        addr_buff.resize(0);
-    }
-    int recv_error = (ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-    if (GetSocketBlocking(fd_info->second) && !dont_wait) {
-        PostTimerAdjust(ctx, "RecvFromOther");
-    }
-#ifdef _WIN32
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, true);
-    }
-#endif
-    if (ret == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(recv_error);
-    } else {
-        buffer.Write(output_buff.data(), 0, ret);
+    const auto socket_fd = fd_info->second.socket_fd;
+    auto operation = std::make_shared<RecvOperation>(0x07, socket_fd, len, flags, addr_len);
+    operation->buffer = buffer;
+    if (operation->TryComplete() || dont_wait || !GetSocketBlocking(fd_info->second)) {
+        operation->WriteResponse(*this, ctx);
+        return;
     }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 4);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
-    rb.PushStaticBuffer(std::move(addr_buff), 0);
-    rb.PushMappedBuffer(buffer);
+    WaitForSocket(ctx, 0x07, std::move(operation), {{socket_fd, SocketReactor::Readable}});
 }
 
 void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
     IPC::RequestParser rp(ctx, 0x08, 4, 2);
     u32 socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -1143,66 +1182,16 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
     u32 flags = SendRecvFlagsToPlatform(rp.Pop<u32>());
     bool dont_wait = (flags & MSGCUSTOM_HANDLE_DONTWAIT) != 0;
     flags &= ~MSGCUSTOM_HANDLE_DONTWAIT;
-#ifdef _WIN32
-    bool was_blocking = GetSocketBlocking(fd_info->second);
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, false);
-    }
-#else
-    if (dont_wait) {
-        flags |= MSG_DONTWAIT;
-    }
-#endif // _WIN32
     u32 addr_len = rp.Pop<u32>();
     rp.PopPID();
 
-    CTRSockAddr ctr_src_addr;
-    std::vector<u8> output_buff(len);
-    std::vector<u8> addr_buff(addr_len);
-    sockaddr src_addr;
-    socklen_t src_addr_len = sizeof(src_addr);
-
-    s32 ret = -1;
-    if (GetSocketBlocking(fd_info->second) && !dont_wait) {
-        PreTimerAdjust();
-    }
-    if (addr_len > 0) {
-        // Only get src adr if input adr available
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, &src_addr, &src_addr_len);
-        if (ret >= 0 && src_addr_len > 0) {
-            ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-            std::memcpy(addr_buff.data(), &ctr_src_addr, addr_len);
-        }
-    } else {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, NULL, 0);
-        addr_buff.resize(0);
-    }
-    int recv_error = (ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-    if (GetSocketBlocking(fd_info->second) && !dont_wait) {
-        PostTimerAdjust(ctx, "RecvFrom");
-    }
-#ifdef _WIN32
-    if (dont_wait && was_blocking) {
-        SetSocketBlocking(fd_info->second, true);
-    }
-#endif
-    s32 total_received = ret;
-    if (ret == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(recv_error);
-        total_received = 0;
+    const auto socket_fd = fd_info->second.socket_fd;
+    auto operation = std::make_shared<RecvOperation>(0x08, socket_fd, len, flags, addr_len);
+    if (operation->TryComplete() || dont_wait || !GetSocketBlocking(fd_info->second)) {
+        operation->WriteResponse(*this, ctx);
+        return;
     }
-
-    // Write only the data we received to avoid overwriting parts of the buffer with zeros
-    output_buff.resize(total_received);
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(3, 4);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
-    rb.Push(total_received);
-    rb.PushStaticBuffer(std::move(output_buff), 0);
-    rb.PushStaticBuffer(std::move(addr_buff), 1);
+    WaitForSocket(ctx, 0x08, std::move(operation), {{socket_fd, SocketReactor::Readable}});
 }
 
 void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
@@ -1224,33 +1213,16 @@ void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
         platform_pollfd[i] = CTRPollFD::ToPlatform(*this, ctr_fds[i], has_libctru_bug[i]);
     }
 
-    if (timeout) {
-        PreTimerAdjust();
-    }
-    s32 ret = ::poll(platform_pollfd.data(), nfds, timeout);
-    if (timeout) {
-        PostTimerAdjust(ctx, "Poll");
-    }
-
-    // Now update the output 3ds_pollfd structure
-    for (u32 i = 0; i < nfds; i++) {
-        ctr_fds[i] = CTRPollFD::FromPlatform(*this, platform_pollfd[i], has_libctru_bug[i]);
-    }
-
-    std::vector<u8> output_fds(nfds * sizeof(CTRPollFD));
-    std::memcpy(output_fds.data(), ctr_fds.data(), nfds * sizeof(CTRPollFD));
-
-    if (ret == SOCKET_ERROR_VALUE) {
-        int err = GET_ERRNO;
-        LOG_ERROR(Service_SOC, "Socket error: {}", err);
-
-        ret = TranslateError(GET_ERRNO);
+    auto operation =
+        std::make_shared<PollOperation>(std::move(platform_pollfd), std::move(has_libctru_bug));
+    if (operation->TryComplete() || timeout == 0) {
+        operation->WriteResponse(*this, ctx);
+        return;
     }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
-    rb.PushStaticBuffer(std::move(output_fds), 0);
+    // A negative timeout waits until a socket is ready
+    auto waits = operation->GetWaits();
+    WaitForSocket(ctx, 0x14, std::move(operation), std::move(waits),
+                  std::chrono::milliseconds(std::max(timeout, 0)));
 }
 
 void SOC_U::GetSockName(Kernel::HLERequestContext& ctx) {
@@ -1380,9 +1352,6 @@ void SOC_U::GetPeerName(Kernel::HLERequestContext& ctx) {
 }
 
 void SOC_U::Connect(Kernel::HLERequestContext& ctx) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
     IPC::RequestParser rp(ctx, 0x06, 2, 4);
     const auto socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -1400,19 +1369,13 @@ void SOC_U::Connect(Kernel::HLERequestContext& ctx) {
     std::memcpy(&ctr_input_addr, input_addr_buf.data(), sizeof(ctr_input_addr));
 
     sockaddr input_addr = CTRSockAddr::ToPlatform(ctr_input_addr);
-    if (GetSocketBlocking(fd_info->second)) {
-        PreTimerAdjust();
-    }
-    s32 ret = ::connect(fd_info->second.socket_fd, &input_addr, sizeof(input_addr));
-    if (GetSocketBlocking(fd_info->second)) {
-        PostTimerAdjust(ctx, "Connect");
+    const auto socket_fd = fd_info->second.socket_fd;
+    auto operation = std::make_shared<ConnectOperation>(socket_fd);
+    if (!operation->Start(input_addr) || !GetSocketBlocking(fd_info->second)) {
+        operation->WriteResponse(*this, ctx);
+        return;
     }
-    if (ret != 0)
-        ret = TranslateError(GET_ERRNO);
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
+    WaitForSocket(ctx, 0x06, std::move(operation), {{socket_fd, SocketReactor::Writable}});
 }
 
 void SOC_U::InitializeSockets(Kernel::HLERequestContext& ctx) {
@@ -1673,7 +1636,7 @@ void SOC_U::GetNameInfoImpl(Kernel::HLERequestContext& ctx) {
     rb.PushStaticBuffer(std::move(serv), 1);
 }
 
-SOC_U::SOC_U() : ServiceFramework("soc:U") {
+SOC_U::SOC_U(Core::System& system) : ServiceFramework("soc:U"), system(system) {
     static const FunctionInfo functions[] = {
         // clang-format off
         {IPC::MakeHeader(0x0001, 1, 4), &SOC_U::InitializeSockets, "InitializeSockets"},
@@ -1714,6 +1677,10 @@ SOC_U::SOC_U() : ServiceFramework("soc:U") {
 
     RegisterHandlers(functions);
 
+    reactor_event = system.CoreTiming().RegisterEvent(
+        "SOC_U::Reactor",
+        [this](std::uintptr_t, s64 cycles_late) { WakeCompletedOperations(cycles_late); });
+
 #ifdef _WIN32
     WSADATA data;
     WSAStartup(MAKEWORD(2, 2), &data);
@@ -1722,6 +1689,7 @@ SOC_U::SOC_U() : ServiceFramework("soc:U") {
 
 SOC_U::~SOC_U() {
     CleanupSockets();
+    reactor.reset();
 #ifdef _WIN32
     WSACleanup();
 #endif
@@ -1851,7 +1819,7 @@ std::shared_ptr<SOC_U> GetService(Core::System& system) {
 
 void InstallInterfaces(Core::System& system) {
     auto& service_manager = system.ServiceManager();
-    std::make_shared<SOC_U>()->InstallAsService(service_manager);
+    std::make_shared<SOC_U>(system)->InstallAsService(service_manager);
 }
 
 } // namespace Service::SOC
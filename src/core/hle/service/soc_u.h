@@ -4,26 +4,27 @@
 
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <boost/serialization/unordered_map.hpp>
 #include "core/hle/result.h"
 #include "core/hle/service/service.h"
+#include "core/hle/service/soc_reactor.h"
 
 namespace Core {
 class System;
-}
+struct TimingEventType;
+} // namespace Core
 
 namespace Service::SOC {
 
+class SocketOperation;
+
 /// Holds information about a particular socket
 struct SocketHolder {
-#ifdef _WIN32
-    using SOCKET = unsigned long long;
-    SOCKET socket_fd; ///< The socket descriptor
-#else
-    int socket_fd; ///< The socket descriptor
-#endif // _WIN32
+    SocketFd socket_fd; ///< The socket descriptor
 
     bool blocking = true; ///< Whether the socket is blocking or not.
 
@@ -38,9 +39,11 @@ private:
 
 class SOC_U final : public ServiceFramework<SOC_U> {
 public:
-    SOC_U();
+    explicit SOC_U(Core::System& system);
     ~SOC_U();
 
+    class SocketCallback;
+
     struct InterfaceInfo {
         u32 address;
         u32 netmask;
@@ -129,16 +132,32 @@ private:
         return next_socket_id++;
     }
 
-    // System timer adjust
-    std::chrono::time_point<std::chrono::steady_clock> adjust_value_last;
-    void PreTimerAdjust();
-    void PostTimerAdjust(Kernel::HLERequestContext& ctx, const std::string& caller_method);
+    /**
+     * Puts the guest thread to sleep until the operation completes on the reactor, which writes
+     * the response of the request then.
+     * @param timeout Time after which the thread is woken up anyway, none if zero.
+     */
+    void WaitForSocket(Kernel::HLERequestContext& ctx, u16 command_id,
+                       std::shared_ptr<SocketOperation> operation,
+                       std::vector<SocketReactor::Wait> waits,
+                       std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0));
+
+    /// Wakes up the guest threads of the operations the reactor completed
+    void WakeCompletedOperations(s64 cycles_late);
+
+    Core::System& system;
+
+    /// Waits on the sockets for blocking operations, created by the first one
+    std::unique_ptr<SocketReactor> reactor;
+    Core::TimingEventType* reactor_event;
+    bool is_reactor_event_scheduled = false;
 
     /// Close all open sockets
     void CleanupSockets();
 
     /// Holds info about the currently open sockets
     friend struct CTRPollFD;
+    friend class AcceptOperation;
     std::unordered_map<u32, SocketHolder> open_sockets;
 
     /// Cache interface info for the current session
@@ -163,3 +182,5 @@ void InstallInterfaces(Core::System& system);
 } // namespace Service::SOC
 
 BOOST_CLASS_EXPORT_KEY(Service::SOC::SOC_U)
+BOOST_CLASS_EXPORT_KEY(Service::SOC::SOC_U::SocketCallback)
+SERVICE_CONSTRUCT(Service::SOC::SOC_U)
@@ -0,0 +1,64 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/thread_worker.h"
+#include "core/hw/aes/ctr.h"
+
+namespace HW::AES {
+
+namespace {
+
+// Crypto++ uses AES-NI or the ARMv8 crypto extensions when the host has them, which decrypt a
+// chunk of this size in well under a millisecond, so smaller data isn't worth handing over.
+constexpr std::size_t ParallelChunkSize = 1024 * 1024;
+
+Common::ThreadWorker& GetWorkers() {
+    static Common::ThreadWorker workers(std::max(1U, std::thread::hardware_concurrency()),
+                                        "AES-CTR");
+    return workers;
+}
+
+void DecryptChunk(const AESKey& key, const AESIV& ctr, u64 offset, u8* data, std::size_t size) {
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
+    d.Seek(offset);
+    d.ProcessData(data, data, size);
+}
+
+} // Anonymous namespace
+
+void DecryptCTR(const AESKey& key, const AESIV& ctr, u64 offset, u8* data, std::size_t size) {
+    if (size == 0) {
+        return; // Crypto++ does not like zero size buffer
+    }
+    if (size <= ParallelChunkSize) {
+        DecryptChunk(key, ctr, offset, data, size);
+        return;
+    }
+
+    // This thread decrypts the first chunk while the workers decrypt the others
+    auto& workers = GetWorkers();
+    std::vector<std::future<void>> chunks;
+    chunks.reserve(size / ParallelChunkSize);
+    for (std::size_t chunk_offset = ParallelChunkSize; chunk_offset < size;
+         chunk_offset += ParallelChunkSize) {
+        const std::size_t chunk_size = std::min(ParallelChunkSize, size - chunk_offset);
+        std::packaged_task<void()> task([&key, &ctr, offset, data, chunk_offset, chunk_size] {
+            DecryptChunk(key, ctr, offset + chunk_offset, data + chunk_offset, chunk_size);
+        });
+        chunks.push_back(task.get_future());
+        workers.QueueWork(std::move(task));
+    }
+    DecryptChunk(key, ctr, offset, data, ParallelChunkSize);
+    for (auto& chunk : chunks) {
+        chunk.wait();
+    }
+}
+
+} // namespace HW::AES
@@ -0,0 +1,25 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+#include "core/hw/aes/key.h"
+
+namespace HW::AES {
+
+/**
+ * Decrypts the given data in place using AES-CTR algorithm, which encrypts it as well. Large data
+ * is split in chunks that are decrypted on worker threads, as the counter of any block can be
+ * computed from its offset.
+ * @param key The key to use for decryption
+ * @param ctr The counter of the first block of the stream the data is in
+ * @param offset The offset of the data in the stream
+ * @param data The data to decrypt
+ * @param size The size of the data
+ */
+void DecryptCTR(const AESKey& key, const AESIV& ctr, u64 offset, u8* data, std::size_t size);
+
+} // namespace HW::AES
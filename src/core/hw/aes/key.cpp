@@ -100,6 +100,7 @@ struct KeySlot {
 };
 
 std::array<KeySlot, KeySlotID::MaxKeySlotID> key_slots;
+std::mutex key_slots_mutex;
 std::array<std::optional<AESKey>, MaxCommonKeySlot> common_key_y_slots;
 std::array<std::optional<AESKey>, NumDlpNfcKeyYs> dlp_nfc_key_y_slots;
 std::array<NfcSecret, NumNfcSecrets> nfc_secrets;
@@ -549,6 +550,9 @@ void LoadPresetKeys() {
 } // namespace
 
 void InitKeys(bool force) {
+    // Titles may be loaded on several threads at once, which must not see the keys half loaded
+    static std::mutex init_mutex;
+    std::scoped_lock lock{init_mutex};
     static bool initialized = false;
     if (initialized && !force)
         return;
@@ -561,6 +565,10 @@ void InitKeys(bool force) {
     LoadPresetKeys();
 }
 
+std::unique_lock<std::mutex> LockKeySlots() {
+    return std::unique_lock{key_slots_mutex};
+}
+
 void SetKeyX(std::size_t slot_id, const AESKey& key) {
     key_slots.at(slot_id).SetKeyX(key);
 }
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cstddef>
+#include <mutex>
 #include <vector>
 #include "common/common_types.h"
 
@@ -71,6 +72,12 @@ using AESIV = std::array<u8, AES_BLOCK_SIZE>;
 
 void InitKeys(bool force = false);
 
+/**
+ * Locks the key slots. The normal key of a slot is generated from the keys last set to it, so
+ * threads that set keys and then read the normal keys they generate must hold this.
+ */
+std::unique_lock<std::mutex> LockKeySlots();
+
 void SetGeneratorConstant(const AESKey& key);
 void SetKeyX(std::size_t slot_id, const AESKey& key);
 void SetKeyY(std::size_t slot_id, const AESKey& key);
@@ -0,0 +1,253 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include "common/common_funcs.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
+#include "core/loader/game_metadata_cache.h"
+
+namespace Loader {
+
+namespace {
+
+constexpr u32 GameMetadataCacheMagic = 0x4D444D47; // "GMDM"
+// Increment this whenever the format or the metadata read from the files changes
+constexpr u32 GameMetadataCacheVersion = 1;
+
+/// Reading the metadata is mostly waiting for the storage, which may be on the network
+constexpr unsigned MinReadWorkers = 8;
+
+struct GameMetadataCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le entry_count;
+    u64_le entries_size; ///< Uncompressed size of the entries, which follow compressed
+};
+static_assert(sizeof(GameMetadataCacheHeader) == 0x18,
+              "Size of GameMetadataCacheHeader is not correct");
+
+struct GameMetadataCacheEntry {
+    u64_le size;
+    s64_le modification_time;
+    u64_le program_id;
+    u64_le extdata_id;
+    u32_le file_type;
+    u8 is_executable;
+    INSERT_PADDING_BYTES(3);
+    u32_le path_length;
+    u32_le smdh_size;
+    // Followed by the path and the SMDH
+};
+static_assert(sizeof(GameMetadataCacheEntry) == 0x30,
+              "Size of GameMetadataCacheEntry is not correct");
+
+GameMetadata ReadGameMetadata(const std::string& file_path) {
+    GameMetadata metadata;
+    std::unique_ptr<AppLoader> loader = GetLoader(file_path);
+    if (!loader) {
+        return metadata;
+    }
+
+    metadata.file_type = loader->GetFileType();
+    bool executable = false;
+    const auto result = loader->IsExecutable(executable);
+    metadata.is_executable = executable || result == ResultStatus::ErrorEncrypted;
+    loader->ReadProgramId(metadata.program_id);
+    loader->ReadExtdataId(metadata.extdata_id);
+    loader->ReadIcon(metadata.smdh);
+    return metadata;
+}
+
+} // Anonymous namespace
+
+GameMetadataCache::GameMetadataCache(std::string path_) : path{std::move(path_)} {
+    if (path.empty()) {
+        path = FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "game_list" DIR_SEP
+               "metadata.bin";
+    }
+}
+
+GameMetadataCache::~GameMetadataCache() = default;
+
+void GameMetadataCache::Load() {
+    FileUtil::IOFile file(path, "rb");
+    if (!file) {
+        return;
+    }
+
+    GameMetadataCacheHeader header;
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != GameMetadataCacheMagic || header.version != GameMetadataCacheVersion) {
+        return;
+    }
+
+    std::vector<u8> compressed(file.GetSize() - sizeof(header));
+    if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        return;
+    }
+    const std::vector<u8> data = Common::Compression::DecompressDataZSTD(compressed);
+    if (data.size() != header.entries_size) {
+        LOG_WARNING(Loader, "Game metadata cache {} is corrupted", path);
+        return;
+    }
+
+    std::unordered_map<std::string, Entry> loaded_entries;
+    std::size_t offset = 0;
+    for (u64 i = 0; i < header.entry_count; ++i) {
+        GameMetadataCacheEntry entry;
+        if (data.size() - offset < sizeof(entry)) {
+            LOG_WARNING(Loader, "Game metadata cache {} is corrupted", path);
+            return;
+        }
+        std::memcpy(&entry, data.data() + offset, sizeof(entry));
+        offset += sizeof(entry);
+        if (entry.file_type > static_cast<u32>(FileType::THREEDSX) ||
+            data.size() - offset < static_cast<u64>(entry.path_length) + entry.smdh_size) {
+            LOG_WARNING(Loader, "Game metadata cache {} is corrupted", path);
+            return;
+        }
+
+        std::string file_path(reinterpret_cast<const char*>(data.data() + offset),
+                              entry.path_length);
+        offset += entry.path_length;
+
+        GameMetadata metadata;
+        metadata.file_type = static_cast<FileType>(static_cast<u32>(entry.file_type));
+        metadata.is_executable = entry.is_executable != 0;
+        metadata.program_id = entry.program_id;
+        metadata.extdata_id = entry.extdata_id;
+        metadata.smdh.assign(data.begin() + offset, data.begin() + offset + entry.smdh_size);
+        offset += entry.smdh_size;
+
+        loaded_entries.insert_or_assign(
+            std::move(file_path), Entry{entry.size, entry.modification_time, std::move(metadata),
+                                        false});
+    }
+
+    std::scoped_lock lock{mutex};
+    loaded_entries.merge(entries);
+    entries = std::move(loaded_entries);
+    LOG_INFO(Loader, "Loaded {} entries from game metadata cache {}", header.entry_count, path);
+}
+
+void GameMetadataCache::Save() {
+    std::vector<u8> data;
+    u64 entry_count = 0;
+    {
+        std::scoped_lock lock{mutex};
+        // Entries of files that are no longer listed are dropped
+        const auto num_removed =
+            std::erase_if(entries, [](const auto& item) { return !item.second.is_used; });
+        if (!is_dirty && num_removed == 0) {
+            return;
+        }
+        is_dirty = false;
+
+        for (const auto& [file_path, cached] : entries) {
+            const auto& metadata = cached.metadata;
+            GameMetadataCacheEntry entry{};
+            entry.size = cached.size;
+            entry.modification_time = cached.modification_time;
+            entry.program_id = metadata.program_id;
+            entry.extdata_id = metadata.extdata_id;
+            entry.file_type = static_cast<u32>(metadata.file_type);
+            entry.is_executable = metadata.is_executable ? 1 : 0;
+            entry.path_length = static_cast<u32>(file_path.size());
+            entry.smdh_size = static_cast<u32>(metadata.smdh.size());
+
+            const auto* entry_bytes = reinterpret_cast<const u8*>(&entry);
+            data.insert(data.end(), entry_bytes, entry_bytes + sizeof(entry));
+            data.insert(data.end(), file_path.begin(), file_path.end());
+            data.insert(data.end(), metadata.smdh.begin(), metadata.smdh.end());
+        }
+        entry_count = entries.size();
+    }
+
+    const auto temp_path = path + ".tmp";
+    if (!FileUtil::CreateFullPath(temp_path)) {
+        LOG_ERROR(Loader, "Could not create path {}", temp_path);
+        return;
+    }
+
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file) {
+            LOG_ERROR(Loader, "Could not open file {}", temp_path);
+            return;
+        }
+
+        GameMetadataCacheHeader header{};
+        header.magic = GameMetadataCacheMagic;
+        header.version = GameMetadataCacheVersion;
+        header.entry_count = entry_count;
+        header.entries_size = data.size();
+        const std::vector<u8> compressed =
+            Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+        if (file.WriteObject(header) != 1 ||
+            file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            LOG_ERROR(Loader, "Could not write game metadata cache {}", temp_path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+
+    if (!FileUtil::Replace(temp_path, path)) {
+        LOG_ERROR(Loader, "Could not rename {} to {}", temp_path, path);
+        FileUtil::Delete(temp_path);
+    }
+}
+
+GameMetadata GameMetadataCache::Get(const std::string& file_path) {
+    const u64 size = FileUtil::GetSize(file_path);
+    const s64 modification_time = FileUtil::GetModificationTime(file_path);
+    {
+        std::scoped_lock lock{mutex};
+        const auto itr = entries.find(file_path);
+        if (itr != entries.end() && itr->second.size == size &&
+            itr->second.modification_time == modification_time) {
+            itr->second.is_used = true;
+            return itr->second.metadata;
+        }
+    }
+
+    GameMetadata metadata = ReadGameMetadata(file_path);
+
+    std::scoped_lock lock{mutex};
+    entries.insert_or_assign(file_path, Entry{size, modification_time, metadata, true});
+    is_dirty = true;
+    return metadata;
+}
+
+std::vector<GameMetadata> GameMetadataCache::Get(const std::vector<std::string>& file_paths,
+                                                 const std::atomic_bool& stop) {
+    std::vector<GameMetadata> metadata(file_paths.size());
+    if (file_paths.empty()) {
+        return metadata;
+    }
+
+    const std::size_t num_workers =
+        std::min<std::size_t>(std::max(MinReadWorkers, std::thread::hardware_concurrency()),
+                              file_paths.size());
+    Common::ThreadWorker workers(num_workers, "GameMetadata");
+    for (std::size_t i = 0; i < file_paths.size(); ++i) {
+        workers.QueueWork([this, &file_paths, &metadata, &stop, i] {
+            if (!stop) {
+                metadata[i] = Get(file_paths[i]);
+            }
+        });
+    }
+    workers.WaitForRequests();
+    return metadata;
+}
+
+} // namespace Loader
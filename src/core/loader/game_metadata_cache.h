@@ -0,0 +1,77 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "core/loader/loader.h"
+
+namespace Loader {
+
+/// The metadata of a file that game lists show
+struct GameMetadata {
+    FileType file_type = FileType::Error; ///< Error if no loader supports the file
+    bool is_executable = false; ///< Whether the file is executable, or encrypted so unknown
+    u64 program_id = 0;
+    u64 extdata_id = 0;
+    std::vector<u8> smdh; ///< The icon of the file, empty if it has none
+};
+
+/**
+ * Persistent cache of the metadata of the files in game lists, by path. Reading the metadata of a
+ * file opens it and may decrypt its ExeFS, so a file is only read again when its size or
+ * modification time changes.
+ */
+class GameMetadataCache {
+public:
+    /**
+     * @param path the path of the cache file, or empty for the one in the cache directory
+     */
+    explicit GameMetadataCache(std::string path = {});
+    ~GameMetadataCache();
+
+    /// Loads the cache file, replacing the cached entries of the files it has.
+    void Load();
+
+    /// Writes the entries used since the cache was created to the cache file, if any changed.
+    void Save();
+
+    /**
+     * Gets the metadata of a file, reading it if it changed since it was cached.
+     * @param file_path the path of the file
+     * @returns the metadata, with file type Error if the file can't be loaded.
+     */
+    GameMetadata Get(const std::string& file_path);
+
+    /**
+     * Gets the metadata of files, reading the ones that changed since they were cached on worker
+     * threads.
+     * @param file_paths the paths of the files
+     * @param stop set to stop reading; the files not read yet have file type Error then
+     * @returns the metadata of each file, in the order of the paths.
+     */
+    std::vector<GameMetadata> Get(const std::vector<std::string>& file_paths,
+                                  const std::atomic_bool& stop);
+
+private:
+    struct Entry {
+        u64 size;
+        s64 modification_time;
+        GameMetadata metadata;
+        bool is_used; ///< Whether the entry was looked up, the others aren't saved
+    };
+
+    std::string path;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    bool is_dirty = false;
+};
+
+} // namespace Loader
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <boost/serialization/array.hpp>
@@ -11,6 +12,7 @@
 #include "common/assert.h"
 #include "common/atomic_ops.h"
 #include "common/common_types.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "common/swap.h"
@@ -33,10 +35,17 @@ SERIALIZE_EXPORT_IMPL(Memory::MemorySystem::BackingMemImpl<Memory::Region::N3DS>
 
 namespace Memory {
 
+/// Size of the fastmem arenas. One page past the end of the address space stays unmapped so that
+/// accesses which wrap around the end of it still fault.
+constexpr std::size_t FASTMEM_ARENA_SIZE = (std::size_t{1} << 32) + CITRA_PAGE_SIZE;
+
 void PageTable::Clear() {
     pointers.raw.fill(nullptr);
     pointers.refs.fill(MemoryRef());
     attributes.fill(PageType::Unmapped);
+    if (fastmem_arena) {
+        fastmem_arena->Unmap(0, FASTMEM_ARENA_SIZE);
+    }
 }
 
 class RasterizerCacheMarker {
@@ -89,11 +98,18 @@ private:
 
 class MemorySystem::Impl {
 public:
-    // Visual Studio would try to allocate these on compile time if they are std::array, which would
-    // exceed the memory limit.
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
+    // FCRAM, VRAM and the N3DS extra RAM share one host allocation, so that the fastmem arenas of
+    // the page tables can mirror any of them.
+    Common::HostMemory host_memory{Memory::FCRAM_N3DS_SIZE + Memory::VRAM_SIZE +
+                                   Memory::N3DS_EXTRA_RAM_SIZE};
+    u8* const fcram = host_memory.BackingBasePointer();
+    u8* const vram = fcram + Memory::FCRAM_N3DS_SIZE;
+    u8* const n3ds_extra_ram = vram + Memory::VRAM_SIZE;
+
+    // Arenas are reserved per page table, so they need a 64-bit host whose pages are no larger
+    // than the emulated ones.
+    const bool fastmem_supported = sizeof(void*) == 8 && host_memory.IsShareable() &&
+                                   Common::HostMemory::HostPageSize() == CITRA_PAGE_SIZE;
 
     std::shared_ptr<PageTable> current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
@@ -101,6 +117,9 @@ public:
 
     AudioCore::DspInterface* dsp = nullptr;
 
+    // Boot snapshots store FCRAM, VRAM and the N3DS extra RAM outside of the archive
+    bool external_memory = false;
+
     std::shared_ptr<BackingMem> fcram_mem;
     std::shared_ptr<BackingMem> vram_mem;
     std::shared_ptr<BackingMem> n3ds_extra_ram_mem;
@@ -111,13 +130,13 @@ public:
     const u8* GetPtr(Region r) const {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -126,13 +145,13 @@ public:
     u8* GetPtr(Region r) {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -167,10 +186,81 @@ public:
         return nullptr; // Should never happen
     }
 
+    /// Returns true if the page is regular memory that fastmem arenas mirror.
+    bool IsFastmemPage(const PageTable& page_table, std::size_t page_index) const {
+        return host_memory.Contains(page_table.GetPointerArray()[page_index]);
+    }
+
+    /**
+     * Gets the fastmem arena of the page table, creating it and mirroring all of its pages if
+     * needed. Returns nullptr if fastmem is unavailable.
+     */
+    Common::FastmemArena* GetFastmemArena(PageTable& page_table) {
+        if (!fastmem_supported) {
+            return nullptr;
+        }
+        if (!page_table.fastmem_arena) {
+            page_table.fastmem_arena =
+                std::make_unique<Common::FastmemArena>(host_memory, FASTMEM_ARENA_SIZE);
+            SyncFastmemPages(page_table, 0, PAGE_TABLE_NUM_ENTRIES);
+        }
+        return page_table.fastmem_arena->IsValid() ? page_table.fastmem_arena.get() : nullptr;
+    }
+
+    /// Updates the fastmem arena of the page table, if any, after pages in [base, end) changed.
+    void SyncFastmemPages(PageTable& page_table, std::size_t base, std::size_t end) {
+        if (!page_table.fastmem_arena || !page_table.fastmem_arena->IsValid()) {
+            return;
+        }
+        auto& arena = *page_table.fastmem_arena;
+        const auto& pointers = page_table.GetPointerArray();
+
+        // Map and unmap runs of pages at once, as every call is a system call
+        while (base != end) {
+            std::size_t run_end = base + 1;
+            if (IsFastmemPage(page_table, base)) {
+                while (run_end != end && IsFastmemPage(page_table, run_end) &&
+                       pointers[run_end] == pointers[run_end - 1] + CITRA_PAGE_SIZE) {
+                    run_end++;
+                }
+                arena.Map(base * CITRA_PAGE_SIZE, pointers[base],
+                          (run_end - base) * CITRA_PAGE_SIZE);
+            } else {
+                while (run_end != end && !IsFastmemPage(page_table, run_end)) {
+                    run_end++;
+                }
+                arena.Unmap(base * CITRA_PAGE_SIZE, (run_end - base) * CITRA_PAGE_SIZE);
+            }
+            base = run_end;
+        }
+    }
+
+    /**
+     * Returns a pointer to [vaddr, vaddr + size) in the fastmem arena of the page table if every
+     * page of the range is mirrored there, so that it can be accessed with a single copy.
+     */
+    u8* GetFastmemRange(const PageTable& page_table, VAddr vaddr, std::size_t size) const {
+        if (!page_table.fastmem_arena || !page_table.fastmem_arena->IsValid() || size == 0 ||
+            size > (std::size_t{1} << 32) - vaddr) {
+            return nullptr;
+        }
+        const std::size_t last_page = (vaddr + size - 1) >> CITRA_PAGE_BITS;
+        for (std::size_t page = vaddr >> CITRA_PAGE_BITS; page <= last_page; page++) {
+            if (!IsFastmemPage(page_table, page)) {
+                return nullptr;
+            }
+        }
+        return page_table.fastmem_arena->BasePointer() + vaddr;
+    }
+
     template <bool UNSAFE>
     void ReadBlockImpl(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
                        const std::size_t size) {
         auto& page_table = *process.vm_manager.page_table;
+        if (const u8* src_ptr = GetFastmemRange(page_table, src_addr, size)) {
+            std::memcpy(dest_buffer, src_ptr, size);
+            return;
+        }
 
         std::size_t remaining_size = size;
         std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
@@ -227,6 +317,11 @@ public:
     void WriteBlockImpl(const Kernel::Process& process, const VAddr dest_addr,
                         const void* src_buffer, const std::size_t size) {
         auto& page_table = *process.vm_manager.page_table;
+        if (u8* dest_ptr = GetFastmemRange(page_table, dest_addr, size)) {
+            std::memcpy(dest_ptr, src_buffer, size);
+            return;
+        }
+
         std::size_t remaining_size = size;
         std::size_t page_index = dest_addr >> CITRA_PAGE_BITS;
         std::size_t page_offset = dest_addr & CITRA_PAGE_MASK;
@@ -302,11 +397,13 @@ private:
     void serialize(Archive& ar, const unsigned int file_version) {
         bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
         ar& save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+        if (!external_memory) {
+            ar& boost::serialization::make_binary_object(vram, Memory::VRAM_SIZE);
+            ar& boost::serialization::make_binary_object(
+                fcram, save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
+            ar& boost::serialization::make_binary_object(
+                n3ds_extra_ram, save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+        }
         ar& cache_marker;
         ar& page_table_list;
         // dsp is set from Core::System at startup
@@ -356,7 +453,13 @@ MemorySystem::~MemorySystem() = default;
 
 template <class Archive>
 void MemorySystem::serialize(Archive& ar, const unsigned int file_version) {
+    if (file_version >= 1) {
+        ar& impl->external_memory;
+    }
     ar&* impl.get();
+    if (Archive::is_loading::value) {
+        impl->external_memory = false;
+    }
 }
 
 SERIALIZE_IMPL(MemorySystem)
@@ -377,7 +480,8 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
     RasterizerFlushVirtualRegion(base << CITRA_PAGE_BITS, size * CITRA_PAGE_SIZE,
                                  FlushMode::FlushAndInvalidate);
 
-    u32 end = base + size;
+    const u32 first = base;
+    const u32 end = base + size;
     while (base != end) {
         ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
 
@@ -394,6 +498,9 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
         if (memory != nullptr && memory.GetSize() > CITRA_PAGE_SIZE)
             memory += CITRA_PAGE_SIZE;
     }
+
+    // Arenas are only created on demand, with all of their pages
+    impl->SyncFastmemPages(page_table, first, end);
 }
 
 void MemorySystem::MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, MemoryRef target) {
@@ -434,6 +541,39 @@ void MemorySystem::UnregisterPageTable(std::shared_ptr<PageTable> page_table) {
     }
 }
 
+u8* MemorySystem::GetFastmemPointer(PageTable& page_table) {
+    Common::FastmemArena* arena = impl->GetFastmemArena(page_table);
+    return arena ? arena->BasePointer() : nullptr;
+}
+
+std::span<const u8> MemorySystem::GetSnapshotMemory() const {
+    const auto& host_memory = impl->host_memory;
+    return {host_memory.BackingBasePointer(), host_memory.Size()};
+}
+
+bool MemorySystem::LoadSnapshotMemory(const std::string& path, u64 offset) {
+    // Arenas created so far would keep mirroring the memory that gets replaced
+    const auto has_arena = [](const std::shared_ptr<PageTable>& page_table) {
+        return page_table->fastmem_arena != nullptr;
+    };
+    ASSERT_MSG(std::none_of(impl->page_table_list.begin(), impl->page_table_list.end(), has_arena),
+               "Snapshot memory loaded after fastmem arenas were created");
+    auto& host_memory = impl->host_memory;
+    if (host_memory.MapFile(path, offset)) {
+        return true;
+    }
+
+    LOG_INFO(HW_Memory, "Mapping {} is not supported, reading it instead", path);
+    FileUtil::IOFile file(path, "rb");
+    return file.Seek(static_cast<s64>(offset), SEEK_SET) &&
+           file.ReadBytes(host_memory.BackingBasePointer(), host_memory.Size()) ==
+               host_memory.Size();
+}
+
+void MemorySystem::SetSnapshotMemoryExcluded(bool excluded) {
+    impl->external_memory = excluded;
+}
+
 template <typename T>
 T ReadMMIO(MMIORegionPointer mmio_handler, VAddr addr);
 
@@ -725,10 +865,12 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
 
     u32 num_pages = ((start + size - 1) >> CITRA_PAGE_BITS) - (start >> CITRA_PAGE_BITS) + 1;
     PAddr paddr = start;
+    std::vector<u32> changed_pages;
 
     for (unsigned i = 0; i < num_pages; ++i, paddr += CITRA_PAGE_SIZE) {
         for (VAddr vaddr : PhysicalToVirtualAddressForRasterizer(paddr)) {
             impl->cache_marker.Mark(vaddr, cached);
+            changed_pages.push_back(vaddr >> CITRA_PAGE_BITS);
             for (auto page_table : impl->page_table_list) {
                 PageType& page_type = page_table->attributes[vaddr >> CITRA_PAGE_BITS];
 
@@ -766,6 +908,21 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
             }
         }
     }
+
+    // Cached pages must fault in the fastmem arenas, so update them one run of pages at a time
+    std::sort(changed_pages.begin(), changed_pages.end());
+    for (std::size_t run_start = 0; run_start < changed_pages.size();) {
+        std::size_t run_end = run_start + 1;
+        while (run_end < changed_pages.size() &&
+               changed_pages[run_end] == changed_pages[run_end - 1] + 1) {
+            run_end++;
+        }
+        for (auto& page_table : impl->page_table_list) {
+            impl->SyncFastmemPages(*page_table, changed_pages[run_start],
+                                   changed_pages[run_end - 1] + 1);
+        }
+        run_start = run_end;
+    }
 }
 
 void RasterizerFlushRegion(PAddr start, u32 size) {
@@ -975,54 +1132,84 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
                              const Kernel::Process& src_process, VAddr dest_addr, VAddr src_addr,
                              std::size_t size) {
     auto& page_table = *src_process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
-    std::size_t page_offset = src_addr & CITRA_PAGE_MASK;
+    const u8* src_ptr = impl->GetFastmemRange(page_table, src_addr, size);
+    u8* dest_ptr = impl->GetFastmemRange(*dest_process.vm_manager.page_table, dest_addr, size);
+    if (src_ptr && dest_ptr) {
+        // The ranges may overlap when copying within a process
+        std::memmove(dest_ptr, src_ptr, size);
+        return;
+    }
 
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr =
-            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
+    // Overlapping ranges are copied one source page at a time through a buffer, starting from the
+    // end when copying upwards, so that no source page is overwritten before it is copied.
+    const bool overlaps = &dest_process == &src_process && dest_addr < src_addr + size &&
+                          src_addr < dest_addr + size;
+    std::vector<u8> buffer;
 
+    const auto copy_page = [&](VAddr current_vaddr, VAddr current_dest, std::size_t copy_amount) {
+        const std::size_t page_index = current_vaddr >> CITRA_PAGE_BITS;
         switch (page_table.attributes[page_index]) {
         case PageType::Unmapped: {
             LOG_ERROR(HW_Memory,
                       "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
                       "0x{:08X}",
                       current_vaddr, src_addr, size, Core::GetRunningCore().GetPC());
-            ZeroBlock(dest_process, dest_addr, copy_amount);
+            ZeroBlock(dest_process, current_dest, copy_amount);
             break;
         }
         case PageType::Memory: {
             DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
+            const u8* src_ptr =
+                page_table.pointers[page_index] + (current_vaddr & CITRA_PAGE_MASK);
+            if (overlaps) {
+                buffer.assign(src_ptr, src_ptr + copy_amount);
+                src_ptr = buffer.data();
+            }
+            WriteBlock(dest_process, current_dest, src_ptr, copy_amount);
             break;
         }
         case PageType::Special: {
             MMIORegionPointer handler = impl->GetMMIOHandler(page_table, current_vaddr);
             DEBUG_ASSERT(handler);
-            std::vector<u8> buffer(copy_amount);
+            buffer.resize(copy_amount);
             handler->ReadBlock(current_vaddr, buffer.data(), buffer.size());
-            WriteBlock(dest_process, dest_addr, buffer.data(), buffer.size());
+            WriteBlock(dest_process, current_dest, buffer.data(), buffer.size());
             break;
         }
         case PageType::RasterizerCachedMemory: {
             RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
                                          FlushMode::Flush);
-            WriteBlock(dest_process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
+            const u8* src_ptr = GetPointerForRasterizerCache(current_vaddr);
+            if (overlaps) {
+                buffer.assign(src_ptr, src_ptr + copy_amount);
+                src_ptr = buffer.data();
+            }
+            WriteBlock(dest_process, current_dest, src_ptr, copy_amount);
             break;
         }
         default:
             UNREACHABLE();
         }
+    };
 
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
+    if (overlaps && dest_addr > src_addr) {
+        for (std::size_t offset = size; offset > 0;) {
+            const std::size_t page_start = (src_addr + offset - 1) & ~std::size_t{CITRA_PAGE_MASK};
+            const std::size_t copy_offset = std::max<std::size_t>(page_start, src_addr) - src_addr;
+            copy_page(static_cast<VAddr>(src_addr + copy_offset),
+                      static_cast<VAddr>(dest_addr + copy_offset), offset - copy_offset);
+            offset = copy_offset;
+        }
+        return;
+    }
+
+    for (std::size_t offset = 0; offset < size;) {
+        const std::size_t copy_amount =
+            std::min<std::size_t>(CITRA_PAGE_SIZE - ((src_addr + offset) & CITRA_PAGE_MASK),
+                                  size - offset);
+        copy_page(static_cast<VAddr>(src_addr + offset), static_cast<VAddr>(dest_addr + offset),
+                  copy_amount);
+        offset += copy_amount;
     }
 }
 
@@ -1067,18 +1254,18 @@ void WriteMMIO<u64>(MMIORegionPointer mmio_handler, VAddr addr, const u64 data)
 }
 
 u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+    ASSERT(pointer >= impl->fcram && pointer <= impl->fcram + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram);
 }
 
 u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
@@ -5,10 +5,14 @@
 #pragma once
 #include <array>
 #include <cstddef>
+#include <memory>
+#include <span>
 #include <string>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include "common/common_types.h"
+#include "common/host_memory.h"
 #include "common/memory_ref.h"
 #include "core/mmio.h"
 
@@ -118,10 +122,21 @@ struct PageTable {
      */
     std::array<PageType, PAGE_TABLE_NUM_ENTRIES> attributes;
 
+    /**
+     * Host mirror of the address space, in which every page of type `Memory` backed by emulated
+     * RAM is mapped at its virtual address. Created on demand by MemorySystem and rebuilt from the
+     * arrays above, so it is not serialized.
+     */
+    std::unique_ptr<Common::FastmemArena> fastmem_arena;
+
     std::array<u8*, PAGE_TABLE_NUM_ENTRIES>& GetPointerArray() {
         return pointers.raw;
     }
 
+    const std::array<u8*, PAGE_TABLE_NUM_ENTRIES>& GetPointerArray() const {
+        return pointers.raw;
+    }
+
     void Clear();
 
 private:
@@ -133,6 +148,10 @@ private:
         for (std::size_t i = 0; i < PAGE_TABLE_NUM_ENTRIES; i++) {
             pointers.raw[i] = pointers.refs[i].GetPtr();
         }
+        if (Archive::is_loading::value) {
+            // The arena is recreated from the loaded pages when it is next needed
+            fastmem_arena.reset();
+        }
     }
     friend class boost::serialization::access;
 };
@@ -605,6 +624,25 @@ public:
     /// Unregisters page table for rasterizer cache marking
     void UnregisterPageTable(std::shared_ptr<PageTable> page_table);
 
+    /**
+     * Gets the base of the fastmem arena of the page table, creating it if needed. Returns nullptr
+     * if the host does not support fastmem.
+     */
+    u8* GetFastmemPointer(PageTable& page_table);
+
+    /// Returns FCRAM, VRAM and the N3DS extra RAM, which are contiguous in this order.
+    std::span<const u8> GetSnapshotMemory() const;
+
+    /**
+     * Loads the memory returned by GetSnapshotMemory from a boot snapshot stored at offset in the
+     * file, mapping it copy-on-write where the host supports it. Fastmem is unavailable for
+     * mapped memory. Must be called before the memory is used. Returns false on failure.
+     */
+    bool LoadSnapshotMemory(const std::string& path, u64 offset);
+
+    /// Leaves the memory returned by GetSnapshotMemory out of save states while set.
+    void SetSnapshotMemoryExcluded(bool excluded);
+
     void SetDSP(AudioCore::DspInterface& dsp);
 
 private:
@@ -645,3 +683,4 @@ BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::FCRA
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::VRAM>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::DSP>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::N3DS>)
+BOOST_CLASS_VERSION(Memory::MemorySystem, 1)
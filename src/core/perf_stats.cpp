@@ -18,6 +18,7 @@
 
 using namespace std::chrono_literals;
 using DoubleSecs = std::chrono::duration<double, std::chrono::seconds::period>;
+using DoubleMs = std::chrono::duration<double, std::milli>;
 using std::chrono::duration_cast;
 using std::chrono::microseconds;
 
@@ -44,6 +45,16 @@ PerfStats::~PerfStats() {
         fmt::format("{}/{:%F-%H-%M}_{:016X}.csv", path, *std::localtime(&t), title_id);
     FileUtil::IOFile file(filename, "w");
     file.WriteString(stream.str());
+
+    std::string histogram = "bucket_start_ms,frames\n";
+    for (std::size_t i = 0; i < frametime_histogram.size(); i++) {
+        const auto bucket_start = DoubleMs(HistogramBucketWidth * i).count();
+        histogram += fmt::format("{},{}\n", bucket_start, frametime_histogram[i]);
+    }
+    const std::string histogram_filename =
+        fmt::format("{}/{:%F-%H-%M}_{:016X}_histogram.csv", path, *std::localtime(&t), title_id);
+    FileUtil::IOFile histogram_file(histogram_filename, "w");
+    histogram_file.WriteString(histogram);
 }
 
 void PerfStats::BeginSystemFrame() {
@@ -58,8 +69,13 @@ void PerfStats::EndSystemFrame() {
     auto frame_end = Clock::now();
     const auto frame_time = frame_end - frame_begin;
     if (current_index < perf_history.size()) {
-        perf_history[current_index++] =
-            std::chrono::duration<double, std::milli>(frame_time).count();
+        perf_history[current_index++] = DoubleMs(frame_time).count();
+    }
+    recent_frametimes[total_frames % recent_frametimes.size()] = frame_time;
+    total_frames++;
+    if (total_frames > IgnoreFrames) {
+        const auto bucket = static_cast<std::size_t>(frame_time / HistogramBucketWidth);
+        frametime_histogram[std::min(bucket, frametime_histogram.size() - 1)]++;
     }
     accumulated_frametime += frame_time;
     system_frames += 1;
@@ -119,6 +135,27 @@ double PerfStats::GetLastFrameTimeScale() const {
     return duration_cast<DoubleSecs>(previous_frame_length).count() / FRAME_LENGTH;
 }
 
+PerfStats::Clock::duration PerfStats::PredictFrametime() const {
+    std::lock_guard lock{object_mutex};
+
+    if (total_frames < IgnoreFrames + recent_frametimes.size()) {
+        return Clock::duration::zero();
+    }
+
+    // A frame that takes longer than predicted ends late, so the prediction is the longest of the
+    // recent frametimes once the few longest ones are left out as outliers
+    auto recent = recent_frametimes;
+    const auto prediction = recent.begin() + recent.size() * 9 / 10;
+    std::nth_element(recent.begin(), prediction, recent.end());
+    return *prediction;
+}
+
+PerfStats::FrametimeHistogram PerfStats::GetFrametimeHistogram() const {
+    std::lock_guard lock{object_mutex};
+
+    return frametime_histogram;
+}
+
 void FrameLimiter::WaitOnce() {
     if (frame_advancing_enabled) {
         // Frame advancing is enabled: wait on event instead of doing framelimiting
@@ -127,7 +164,8 @@ void FrameLimiter::WaitOnce() {
     }
 }
 
-void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
+void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us,
+                                   Clock::duration predicted_frametime) {
     if (frame_advancing_enabled) {
         // Frame advancing is enabled: wait on event instead of doing framelimiting
         frame_advance_event.Wait();
@@ -142,6 +180,11 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
         return;
     }
 
+    if (Settings::values.frame_pacing.GetValue() == Settings::FramePacing::LowLatency) {
+        DoLowLatencyPacing(current_system_time_us, predicted_frametime, sleep_scale, now);
+        return;
+    }
+
     // Max lag caused by slow frames. Shouldn't be more than the length of a frame at the current
     // speed percent or it will clamp too much and prevent this from properly limiting to that
     // percent. High values means it'll take longer after a slow frame to recover and start limiting
@@ -165,6 +208,36 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     previous_walltime = now;
 }
 
+void FrameLimiter::DoLowLatencyPacing(microseconds current_system_time_us,
+                                      Clock::duration predicted_frametime, double sleep_scale,
+                                      Clock::time_point now) {
+    // Margin for the frames that take longer than predicted, and for oversleeping
+    constexpr auto margin = 1ms;
+
+    // The next frame is due when the emulated time of the last one has passed in walltime. After
+    // slow frames, or when pacing just started, the deadlines start over instead of catching up.
+    const auto frame_length = duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::chrono::microseconds::period>(
+            (current_system_time_us - previous_system_time_us) / sleep_scale));
+    const auto max_lag_time = duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::chrono::microseconds::period>(25ms / sleep_scale));
+    if (now - frame_deadline > max_lag_time || frame_deadline - now > frame_length) {
+        frame_deadline = now;
+    }
+    frame_deadline += frame_length;
+
+    // Input is read while the frame is emulated, so starting it as late as possible gets the
+    // newest input on screen the soonest
+    const auto frame_start = frame_deadline - predicted_frametime - margin;
+    if (frame_start > now) {
+        std::this_thread::sleep_until(frame_start);
+        now = Clock::now();
+    }
+
+    previous_system_time_us = current_system_time_us;
+    previous_walltime = now;
+}
+
 bool FrameLimiter::IsFrameAdvancing() const {
     return frame_advancing_enabled;
 }
@@ -25,6 +25,11 @@ public:
 
     using Clock = std::chrono::high_resolution_clock;
 
+    /// Width of a bucket of the frametime histogram
+    static constexpr std::chrono::microseconds HistogramBucketWidth{500};
+    /// Number of frames per frametime bucket. The last bucket also counts all longer frames.
+    using FrametimeHistogram = std::array<u32, 100>;
+
     struct Results {
         /// System FPS (LCD VBlanks) in Hz
         double system_fps;
@@ -53,6 +58,15 @@ public:
      */
     double GetLastFrameTimeScale() const;
 
+    /**
+     * Predicts the frametime of the next system frame from the recent ones, erring on the long
+     * side. Returns zero until enough frames were emulated.
+     */
+    Clock::duration PredictFrametime() const;
+
+    /// Returns the histogram of the frametimes of all system frames so far.
+    FrametimeHistogram GetFrametimeHistogram() const;
+
 private:
     mutable std::mutex object_mutex;
 
@@ -63,6 +77,12 @@ private:
     /// Stores an hour of historical frametime data useful for processing and tracking performance
     /// regressions with code changes.
     std::array<double, 216000> perf_history{};
+    /// Frametimes of all frames, in buckets of HistogramBucketWidth
+    FrametimeHistogram frametime_histogram{};
+    /// Frametimes of the most recent frames, used for prediction
+    std::array<Clock::duration, 30> recent_frametimes{};
+    /// Number of system frames ended so far
+    u64 total_frames = 0;
 
     /// Point when the cumulative counters were reset
     Clock::time_point reset_point = Clock::now();
@@ -88,7 +108,13 @@ class FrameLimiter {
 public:
     using Clock = std::chrono::high_resolution_clock;
 
-    void DoFrameLimiting(std::chrono::microseconds current_system_time_us);
+    /**
+     * Limits the speed of emulation after a frame ended.
+     * @param predicted_frametime The time the next frame is expected to take, used to delay its
+     *                            start with low latency frame pacing.
+     */
+    void DoFrameLimiting(std::chrono::microseconds current_system_time_us,
+                         Clock::duration predicted_frametime = Clock::duration::zero());
 
     bool IsFrameAdvancing() const;
     /**
@@ -101,6 +127,11 @@ public:
     void WaitOnce();
 
 private:
+    /// Delays the start of the next frame so that it ends right before it is due.
+    void DoLowLatencyPacing(std::chrono::microseconds current_system_time_us,
+                            Clock::duration predicted_frametime, double sleep_scale,
+                            Clock::time_point now);
+
     /// Emulated system time (in microseconds) at the last limiter invocation
     std::chrono::microseconds previous_system_time_us{0};
     /// Walltime at the last limiter invocation
@@ -109,6 +140,9 @@ private:
     /// Accumulated difference between walltime and emulated time
     std::chrono::microseconds frame_limiting_delta_err{0};
 
+    /// Walltime the frame that just ended was due at, with low latency pacing
+    Clock::time_point frame_deadline{};
+
     /// Whether to use frame advancing (i.e. frame by frame)
     std::atomic_bool frame_advancing_enabled;
 
@@ -2,11 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <cryptopp/hex.h>
+#include "common/alignment.h"
 #include "common/archives.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/scope_exit.h"
 #include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/movie.h"
@@ -29,6 +32,41 @@ static_assert(sizeof(CSTHeader) == 256, "CSTHeader should be 256 bytes");
 
 constexpr std::array<u8, 4> header_magic_bytes{{'C', 'S', 'T', 0x1B}};
 
+#pragma pack(push, 1)
+struct BootSnapshotHeader {
+    std::array<u8, 4> filetype;  /// Unique Identifier to check the file type (always "CBS"0x1B)
+    u32_le frame;                /// Frame of the title the snapshot was saved at
+    u64_le program_id;           /// ID of the ROM being executed. Also called title_id
+    std::array<u8, 20> revision; /// Git hash of the revision this snapshot was created with
+    u64_le state_size;           /// Size of the compressed save state following the header
+    u64_le memory_offset;        /// Offset of the uncompressed emulated memory in the file
+    u64_le memory_size;          /// Size of the uncompressed emulated memory
+
+    std::array<u8, 196> reserved{}; /// Make heading 256 bytes so it has consistent size
+};
+static_assert(sizeof(BootSnapshotHeader) == 256, "BootSnapshotHeader should be 256 bytes");
+#pragma pack(pop)
+
+constexpr std::array<u8, 4> boot_snapshot_magic_bytes{{'C', 'B', 'S', 0x1B}};
+
+/// Alignment of the memory in boot snapshots, a multiple of the allocation granularity of all
+/// hosts so that it can be mapped
+constexpr u64 BootSnapshotMemoryAlignment = 0x10000;
+
+static std::array<u8, 20> GetRevisionBytes() {
+    std::string rev_bytes;
+    CryptoPP::StringSource ss(Common::g_scm_rev, true,
+                              new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
+    std::array<u8, 20> revision{};
+    std::memcpy(revision.data(), rev_bytes.data(), std::min(rev_bytes.size(), revision.size()));
+    return revision;
+}
+
+static std::string GetBootSnapshotPath(u64 program_id) {
+    return fmt::format("{}boot/{:016X}.snap",
+                       FileUtil::GetUserPath(FileUtil::UserPath::StatesDir), program_id);
+}
+
 static std::string GetSaveStatePath(u64 program_id, u32 slot) {
     const u64 movie_id = Movie::GetInstance().GetCurrentMovieID();
     if (movie_id) {
@@ -123,10 +161,7 @@ void System::SaveState(u32 slot) const {
     CSTHeader header{};
     header.filetype = header_magic_bytes;
     header.program_id = title_id;
-    std::string rev_bytes;
-    CryptoPP::StringSource ss(Common::g_scm_rev, true,
-                              new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
-    std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(header.revision));
+    header.revision = GetRevisionBytes();
     header.time = std::chrono::duration_cast<std::chrono::seconds>(
                       std::chrono::system_clock::now().time_since_epoch())
                       .count();
@@ -175,6 +210,124 @@ void System::LoadState(u32 slot) {
     // Deserialize
     iarchive ia{sstream};
     ia&* this;
+
+    // Boot snapshots must be saved from a boot, not from a loaded state
+    boot_snapshot_frame = 0;
+}
+
+void System::SaveBootSnapshot() const {
+    std::ostringstream sstream{std::ios_base::binary};
+    {
+        // The memory is stored uncompressed after the state, so that it can be mapped
+        memory->SetSnapshotMemoryExcluded(true);
+        SCOPE_EXIT({ memory->SetSnapshotMemoryExcluded(false); });
+        oarchive oa{sstream};
+        oa&* this;
+    }
+
+    const std::string& str{sstream.str()};
+    const auto buffer = Common::Compression::CompressDataZSTDDefault(
+        reinterpret_cast<const u8*>(str.data()), str.size());
+    const std::span<const u8> snapshot_memory = memory->GetSnapshotMemory();
+
+    BootSnapshotHeader header{};
+    header.filetype = boot_snapshot_magic_bytes;
+    header.frame = boot_snapshot_frame;
+    header.program_id = title_id;
+    header.revision = GetRevisionBytes();
+    header.state_size = buffer.size();
+    header.memory_offset =
+        Common::AlignUp(sizeof(header) + buffer.size(), BootSnapshotMemoryAlignment);
+    header.memory_size = snapshot_memory.size();
+
+    // Written under a temporary name, as other instances may be booting from the snapshot
+    const auto path = GetBootSnapshotPath(title_id);
+    const auto temp_path = path + ".tmp";
+    if (!FileUtil::CreateFullPath(path)) {
+        throw std::runtime_error("Could not create path " + path);
+    }
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file) {
+            throw std::runtime_error("Could not open file " + temp_path);
+        }
+        if (file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
+            file.WriteBytes(buffer.data(), buffer.size()) != buffer.size()) {
+            throw std::runtime_error("Could not write to file " + temp_path);
+        }
+
+        // Blocks of zeros are left as holes, which most of the memory is right after boot
+        const u64 memory_size = snapshot_memory.size();
+        for (u64 offset = 0; offset < memory_size; offset += BootSnapshotMemoryAlignment) {
+            const auto block = snapshot_memory.subspan(
+                offset, std::min<u64>(BootSnapshotMemoryAlignment, memory_size - offset));
+            if (std::all_of(block.begin(), block.end(), [](u8 value) { return value == 0; })) {
+                continue;
+            }
+            if (!file.Seek(static_cast<s64>(header.memory_offset + offset), SEEK_SET) ||
+                file.WriteBytes(block.data(), block.size()) != block.size()) {
+                throw std::runtime_error("Could not write to file " + temp_path);
+            }
+        }
+        if (!file.Resize(header.memory_offset + header.memory_size)) {
+            throw std::runtime_error("Could not write to file " + temp_path);
+        }
+    }
+    if (!FileUtil::Replace(temp_path, path)) {
+        throw std::runtime_error("Could not rename file " + temp_path);
+    }
+}
+
+bool System::LoadBootSnapshot() {
+    const auto path = GetBootSnapshotPath(title_id);
+    if (!FileUtil::Exists(path)) {
+        return false;
+    }
+    if (Network::GetRoomMember().lock()->IsConnected()) {
+        LOG_INFO(Core, "Not booting from {} while connected to multiplayer", path);
+        return false;
+    }
+
+    FileUtil::IOFile file(path, "rb");
+    BootSnapshotHeader header;
+    if (!file || file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+        LOG_ERROR(Core, "Could not read from file {}", path);
+        return false;
+    }
+    if (header.filetype != boot_snapshot_magic_bytes || header.program_id != title_id ||
+        header.memory_size != memory->GetSnapshotMemory().size() ||
+        header.memory_offset % BootSnapshotMemoryAlignment != 0 ||
+        header.memory_offset < sizeof(header) + header.state_size ||
+        file.GetSize() < header.memory_offset + header.memory_size) {
+        LOG_WARNING(Core, "Invalid boot snapshot file {}", path);
+        return false;
+    }
+    // Unlike save states, snapshots are taken again rather than loaded by other revisions
+    if (header.revision != GetRevisionBytes() || header.frame != boot_snapshot_frame) {
+        LOG_INFO(Core, "Boot snapshot file {} is out of date", path);
+        return false;
+    }
+
+    std::vector<u8> buffer(header.state_size);
+    if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
+        throw std::runtime_error("Could not read from file at " + path);
+    }
+    file.Close();
+    std::vector<u8> decompressed = Common::Compression::DecompressDataZSTD(buffer);
+    buffer.clear();
+    std::istringstream sstream{
+        std::string{reinterpret_cast<char*>(decompressed.data()), decompressed.size()},
+        std::ios_base::binary};
+    decompressed.clear();
+
+    // The memory is loaded by serialize, right after the new memory system is created
+    boot_snapshot_path = path;
+    boot_snapshot_memory_offset = header.memory_offset;
+    SCOPE_EXIT({ boot_snapshot_path.clear(); });
+
+    iarchive ia{sstream};
+    ia&* this;
+    return true;
 }
 
 } // namespace Core
@@ -2,12 +2,15 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 #include <cryptopp/base64.h>
 
 #ifdef _WIN32
@@ -29,9 +32,12 @@
 #include "network/network.h"
 #include "network/network_settings.h"
 #include "network/room.h"
+#include "network/room_server.h"
 #include "network/verify_user.h"
 
 #ifdef ENABLE_WEB_SERVICE
+#include <httplib.h>
+#include <json.hpp>
 #include "web_service/verify_user_jwt.h"
 #endif
 
@@ -57,6 +63,9 @@ static void PrintHelp(const char* argv0) {
                  "--ban-list-file     The file for storing the room ban list\n"
                  "--log-file          The file for storing the room log\n"
                  "--enable-citra-mods Allow Citra Community Moderators to moderate on your room\n"
+                 "--rooms-file        A file describing more rooms to host\n"
+                 "--worker-threads    The number of threads servicing the rooms\n"
+                 "--stats-port        The local port serving the statistics of the rooms\n"
                  "-h, --help          Display this help and exit\n"
                  "-v, --version       Output version information and exit\n";
 }
@@ -149,6 +158,179 @@ static void SaveBanList(const Network::Room::BanList& ban_list, const std::strin
     file.flush();
 }
 
+/// The settings of a hosted room.
+struct RoomConfig {
+    std::string name;
+    std::string description;
+    u16 port = Network::DefaultRoomPort;
+    u32 max_members = 16;
+    std::string password;
+    std::string preferred_game;
+    u64 preferred_game_id = 0;
+};
+
+/**
+ * Loads the rooms of a rooms file. Each room starts with its name in brackets, followed by its
+ * settings, one `key=value` pair per line:
+ *
+ * [Room name]
+ * description=The room description
+ * port=24873
+ * max_members=16
+ * password=
+ * preferred_game=Game name
+ * preferred_game_id=0004000000000000
+ */
+static std::vector<RoomConfig> LoadRoomsFile(const std::string& path) {
+    std::ifstream file;
+    OpenFStream(file, path, std::ios_base::in);
+    if (!file) {
+        std::cout << "Could not open rooms file!\n\n";
+        return {};
+    }
+
+    std::vector<RoomConfig> rooms;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = Common::StripSpaces(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') {
+            continue;
+        }
+        if (line.front() == '[' && line.back() == ']') {
+            rooms.emplace_back().name = line.substr(1, line.size() - 2);
+            continue;
+        }
+        const std::size_t separator = line.find('=');
+        if (rooms.empty() || separator == std::string::npos) {
+            std::cout << "Ignoring line of rooms file: " << line << "\n";
+            continue;
+        }
+        const std::string key = Common::StripSpaces(line.substr(0, separator));
+        const std::string value = Common::StripSpaces(line.substr(separator + 1));
+        auto& room = rooms.back();
+        if (key == "description") {
+            room.description = value;
+        } else if (key == "port") {
+            room.port = static_cast<u16>(std::strtoul(value.c_str(), nullptr, 0));
+        } else if (key == "max_members") {
+            room.max_members = std::strtoul(value.c_str(), nullptr, 0);
+        } else if (key == "password") {
+            room.password = value;
+        } else if (key == "preferred_game") {
+            room.preferred_game = value;
+        } else if (key == "preferred_game_id") {
+            room.preferred_game_id = std::strtoull(value.c_str(), nullptr, 16);
+        } else {
+            std::cout << "Ignoring unknown setting of room " << room.name << ": " << key << "\n";
+        }
+    }
+    return rooms;
+}
+
+static bool ValidateRoomConfig(const RoomConfig& room) {
+    if (room.name.empty()) {
+        std::cout << "room name is empty!\n\n";
+        return false;
+    }
+    if (room.preferred_game.empty()) {
+        std::cout << "preferred game of room " << room.name << " is empty!\n\n";
+        return false;
+    }
+    if (room.preferred_game_id == 0) {
+        std::cout << "preferred-game-id of room " << room.name
+                  << " not set!\nThis should get set to allow users to find your room.\n\n";
+    }
+    if (room.max_members > Network::MaxConcurrentConnections || room.max_members < 2) {
+        std::cout << "max_members of room " << room.name << " needs to be in the range 2 - "
+                  << Network::MaxConcurrentConnections << "!\n\n";
+        return false;
+    }
+    return true;
+}
+
+/// Merges the ban lists of the rooms, which all start from the ban list file.
+static Network::Room::BanList MergeBanLists(
+    const std::vector<std::shared_ptr<Network::Room>>& rooms) {
+    Network::Room::BanList ban_list;
+    std::set<std::string> usernames;
+    std::set<std::string> ips;
+    for (const auto& room : rooms) {
+        const auto [username_ban_list, ip_ban_list] = room->GetBanList();
+        for (const auto& username : username_ban_list) {
+            if (usernames.insert(username).second) {
+                ban_list.first.push_back(username);
+            }
+        }
+        for (const auto& ip : ip_ban_list) {
+            if (ips.insert(ip).second) {
+                ban_list.second.push_back(ip);
+            }
+        }
+    }
+    return ban_list;
+}
+
+#ifdef ENABLE_WEB_SERVICE
+/// Serves the statistics of the rooms as JSON on localhost, at /stats.
+class StatsServer {
+public:
+    StatsServer(const Network::RoomServer& room_server, u16 port) {
+        server.Get("/stats", [&room_server](const httplib::Request&, httplib::Response& response) {
+            nlohmann::json json;
+            json["worker_threads"] = room_server.GetNumWorkers();
+            auto& rooms = json["rooms"];
+            rooms = nlohmann::json::array();
+            for (const auto& room : room_server.GetRooms()) {
+                const auto& information = room->GetRoomInformation();
+                const auto statistics = room->GetStatistics();
+                rooms.push_back({
+                    {"name", information.name},
+                    {"port", information.port},
+                    {"members", statistics.num_members},
+                    {"member_slots", information.member_slots},
+                    {"packets_received", statistics.packets_received},
+                    {"bytes_received", statistics.bytes_received},
+                    {"packets_sent", statistics.packets_sent},
+                    {"bytes_sent", statistics.bytes_sent},
+                    {"mean_round_trip_time_ms", statistics.mean_round_trip_time},
+                    {"max_round_trip_time_ms", statistics.max_round_trip_time},
+                    {"service_time_us", statistics.service_time},
+                    {"max_event_time_us", statistics.max_event_time},
+                });
+            }
+            response.set_content(json.dump(), "application/json");
+        });
+        if (!server.bind_to_port("127.0.0.1", port)) {
+            std::cout << "Could not serve the statistics on port " << port << "!\n\n";
+            return;
+        }
+        thread = std::thread([this] { server.listen_after_bind(); });
+    }
+
+    ~StatsServer() {
+        if (thread.joinable()) {
+            server.stop();
+            thread.join();
+        }
+    }
+
+private:
+    httplib::Server server;
+    std::thread thread;
+};
+#endif
+
+static std::unique_ptr<Network::VerifyUser::Backend> CreateVerifyBackend(bool announce) {
+    if (announce) {
+#ifdef ENABLE_WEB_SERVICE
+        return std::make_unique<WebService::VerifyUserJWT>(NetSettings::values.web_api_url);
+#else
+        return std::make_unique<Network::VerifyUser::NullBackend>();
+#endif
+    }
+    return std::make_unique<Network::VerifyUser::NullBackend>();
+}
+
 static void InitializeLogging(const std::string& log_file) {
     Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
 
@@ -175,10 +357,13 @@ int main(int argc, char** argv) {
     std::string token;
     std::string web_api_url;
     std::string ban_list_file;
+    std::string rooms_file;
     std::string log_file = "citra-room.log";
     u64 preferred_game_id = 0;
     u16 port = Network::DefaultRoomPort;
     u32 max_members = 16;
+    u32 worker_threads = 0;
+    u16 stats_port = 0;
     bool enable_citra_mods = false;
 
     static struct option long_options[] = {
@@ -195,13 +380,17 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-citra-mods", no_argument, 0, 'e'},
+        {"rooms-file", required_argument, 0, 'r'},
+        {"worker-threads", required_argument, 0, 'k'},
+        {"stats-port", required_argument, 0, 's'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "n:d:p:m:w:g:u:t:a:i:l:hv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "n:d:p:m:w:g:u:t:a:i:l:r:k:s:hv", long_options,
+                              &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'n':
@@ -243,6 +432,15 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_citra_mods = true;
                 break;
+            case 'r':
+                rooms_file.assign(optarg);
+                break;
+            case 'k':
+                worker_threads = strtoul(optarg, &endarg, 0);
+                break;
+            case 's':
+                stats_port = static_cast<u16>(strtoul(optarg, &endarg, 0));
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -253,30 +451,34 @@ int main(int argc, char** argv) {
         }
     }
 
-    if (room_name.empty()) {
-        std::cout << "room name is empty!\n\n";
-        PrintHelp(argv[0]);
-        return -1;
+    // The room of the command line comes first, followed by the rooms of the rooms file
+    std::vector<RoomConfig> room_configs;
+    if (!room_name.empty() || rooms_file.empty()) {
+        room_configs.push_back({room_name, room_description, port, max_members, password,
+                                preferred_game, preferred_game_id});
     }
-    if (preferred_game.empty()) {
-        std::cout << "preferred game is empty!\n\n";
-        PrintHelp(argv[0]);
-        return -1;
-    }
-    if (preferred_game_id == 0) {
-        std::cout << "preferred-game-id not set!\nThis should get set to allow users to find your "
-                     "room.\nSet with --preferred-game-id id\n\n";
+    if (!rooms_file.empty()) {
+        const auto file_rooms = LoadRoomsFile(rooms_file);
+        if (file_rooms.empty()) {
+            std::cout << "rooms file does not describe any room!\n\n";
+            return -1;
+        }
+        room_configs.insert(room_configs.end(), file_rooms.begin(), file_rooms.end());
     }
-    if (max_members > Network::MaxConcurrentConnections || max_members < 2) {
-        std::cout << "max_members needs to be in the range 2 - "
-                  << Network::MaxConcurrentConnections << "!\n\n";
-        PrintHelp(argv[0]);
-        return -1;
+    std::set<u16> ports;
+    for (const auto& config : room_configs) {
+        if (!ValidateRoomConfig(config)) {
+            PrintHelp(argv[0]);
+            return -1;
+        }
+        if (!ports.insert(config.port).second) {
+            std::cout << "port " << config.port << " is used by more than one room!\n\n";
+            return -1;
+        }
     }
-    if (port > 65535) {
-        std::cout << "port needs to be in the range 0 - 65535!\n\n";
-        PrintHelp(argv[0]);
-        return -1;
+    if (worker_threads == 0) {
+        worker_threads = std::clamp<u32>(std::thread::hardware_concurrency(), 1,
+                                         static_cast<u32>(room_configs.size()));
     }
     if (ban_list_file.empty()) {
         std::cout << "Ban list file not set!\nThis should get set to load and save room ban "
@@ -318,34 +520,56 @@ int main(int argc, char** argv) {
         ban_list = LoadBanList(ban_list_file);
     }
 
-    std::unique_ptr<Network::VerifyUser::Backend> verify_backend;
+#ifndef ENABLE_WEB_SERVICE
     if (announce) {
-#ifdef ENABLE_WEB_SERVICE
-        verify_backend =
-            std::make_unique<WebService::VerifyUserJWT>(NetSettings::values.web_api_url);
-#else
         std::cout
             << "Citra Web Services is not available with this build: validation is disabled.\n\n";
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
-#endif
-    } else {
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
     }
+    if (stats_port != 0) {
+        std::cout << "The statistics can not be served by this build.\n\n";
+    }
+#endif
 
     Network::Init();
-    if (std::shared_ptr<Network::Room> room = Network::GetRoom().lock()) {
-        if (!room->Create(room_name, room_description, "", port, password, max_members, username,
-                          preferred_game, preferred_game_id, std::move(verify_backend), ban_list,
-                          enable_citra_mods)) {
-            std::cout << "Failed to create room: \n\n";
-            return -1;
+    {
+        // The rooms are serviced by the workers of the room server rather than a thread each
+        std::vector<std::shared_ptr<Network::Room>> rooms;
+        for (const auto& config : room_configs) {
+            auto room = std::make_shared<Network::Room>(Network::Room::ServiceMode::External);
+            if (!room->Create(config.name, config.description, "", config.port, config.password,
+                              config.max_members, username, config.preferred_game,
+                              config.preferred_game_id, CreateVerifyBackend(announce), ban_list,
+                              enable_citra_mods)) {
+                std::cout << "Failed to create room " << config.name << "!\n\n";
+                for (const auto& created_room : rooms) {
+                    created_room->Destroy();
+                }
+                Network::Shutdown();
+                return -1;
+            }
+            rooms.push_back(std::move(room));
         }
-        std::cout << "Room is open. Close with Q+Enter...\n\n";
-        auto announce_session = std::make_unique<Network::AnnounceMultiplayerSession>();
-        if (announce) {
-            announce_session->Start();
+
+        Network::RoomServer room_server(worker_threads);
+        std::vector<std::unique_ptr<Network::AnnounceMultiplayerSession>> announce_sessions;
+        for (const auto& room : rooms) {
+            room_server.AddRoom(room);
+            auto& announce_session = announce_sessions.emplace_back(
+                std::make_unique<Network::AnnounceMultiplayerSession>(room));
+            if (announce) {
+                announce_session->Start();
+            }
+        }
+#ifdef ENABLE_WEB_SERVICE
+        std::unique_ptr<StatsServer> stats_server;
+        if (stats_port != 0) {
+            stats_server = std::make_unique<StatsServer>(room_server, stats_port);
         }
-        while (room->GetState() == Network::Room::State::Open) {
+#endif
+
+        std::cout << rooms.size() << (rooms.size() == 1 ? " room is" : " rooms are") << " open on "
+                  << room_server.GetNumWorkers() << " threads. Close with Q+Enter...\n\n";
+        while (true) {
             std::string in;
             std::cin >> in;
             if (in.size() > 0) {
@@ -353,15 +577,24 @@ int main(int argc, char** argv) {
             }
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
-        if (announce) {
-            announce_session->Stop();
+
+#ifdef ENABLE_WEB_SERVICE
+        stats_server.reset();
+#endif
+        for (const auto& announce_session : announce_sessions) {
+            if (announce) {
+                announce_session->Stop();
+            }
         }
-        announce_session.reset();
+        announce_sessions.clear();
         // Save the ban list
         if (!ban_list_file.empty()) {
-            SaveBanList(room->GetBanList(), ban_list_file);
+            SaveBanList(MergeBanLists(rooms), ban_list_file);
+        }
+        for (const auto& room : rooms) {
+            room_server.RemoveRoom(room);
+            room->Destroy();
         }
-        room->Destroy();
     }
     Network::Shutdown();
     detached_tasks.WaitForAllTasks();
@@ -0,0 +1,66 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <thread>
+#include "common/thread.h"
+#include "input_common/hid_sampler.h"
+
+namespace InputCommon {
+
+HIDSampler::HIDSampler(std::chrono::microseconds interval_) : interval{interval_} {}
+
+HIDSampler::~HIDSampler() = default;
+
+const Input::HIDSnapshot& HIDSampler::Read() {
+    return snapshots.Read();
+}
+
+void HIDSampler::ReloadDevices() {
+    is_device_reload_pending.store(true);
+}
+
+void HIDSampler::Start() {
+    std::scoped_lock lock{mutex};
+    if (num_sessions++ == 0) {
+        // The devices of the thread are created from the profile of the new session
+        is_device_reload_pending.store(true);
+        sample_thread = std::jthread([this](std::stop_token token) { SampleThread(token); });
+    }
+}
+
+void HIDSampler::Stop() {
+    std::scoped_lock lock{mutex};
+    if (num_sessions == 0 || --num_sessions != 0) {
+        return;
+    }
+    sample_thread.request_stop();
+    sample_thread.join();
+
+    // With the thread gone this is the only writer, so the next session does not start from the
+    // inputs the last one ended with
+    snapshots.WriteBuffer() = {};
+    snapshots.Publish();
+}
+
+void HIDSampler::SampleThread(std::stop_token token) {
+    Common::SetCurrentThreadName("HIDSampler");
+
+    // The devices are only touched by this thread, which also destroys them
+    Input::HIDDevices devices;
+    auto next_sample = std::chrono::steady_clock::now();
+    while (!token.stop_requested()) {
+        if (is_device_reload_pending.exchange(false)) {
+            devices.Load();
+        }
+        snapshots.WriteBuffer() = devices.Sample();
+        snapshots.Publish();
+
+        // Samples that were missed, while the host was busy, are skipped rather than caught up on
+        next_sample = std::max(next_sample + interval, std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(next_sample);
+    }
+}
+
+} // namespace InputCommon
@@ -0,0 +1,50 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include "common/polyfill_thread.h"
+#include "common/triple_buffer.h"
+#include "core/frontend/hid_input.h"
+
+namespace InputCommon {
+
+/**
+ * Samples the input devices of the HID module on a thread of its own and publishes every sample
+ * through a lock-free buffer, so that the emulation thread reads a single snapshot per HID update
+ * instead of calling into every device, which may lock.
+ */
+class HIDSampler final : public Input::HIDSnapshotSource {
+public:
+    /// About four samples per update of the pad state of the HID module
+    static constexpr std::chrono::microseconds DEFAULT_INTERVAL{1000};
+
+    explicit HIDSampler(std::chrono::microseconds interval = DEFAULT_INTERVAL);
+    ~HIDSampler() override;
+
+    const Input::HIDSnapshot& Read() override;
+
+    void ReloadDevices() override;
+
+    /// Starts the sampling thread with the first emulation session.
+    void Start() override;
+
+    /// Stops the sampling thread with the last emulation session, leaving an empty snapshot.
+    void Stop() override;
+
+private:
+    void SampleThread(std::stop_token token);
+
+    std::chrono::microseconds interval;
+    std::mutex mutex; ///< Held while starting or stopping the sampling thread
+    u32 num_sessions = 0;
+    std::atomic_bool is_device_reload_pending{true};
+    Common::TripleBuffer<Input::HIDSnapshot> snapshots;
+    std::jthread sample_thread;
+};
+
+} // namespace InputCommon
@@ -10,6 +10,7 @@
 #include "input_common/gcadapter/gc_adapter.h"
 #include "input_common/gcadapter/gc_poller.h"
 #endif
+#include "input_common/hid_sampler.h"
 #include "input_common/keyboard.h"
 #include "input_common/main.h"
 #include "input_common/motion_emu.h"
@@ -29,6 +30,7 @@ static std::shared_ptr<Keyboard> keyboard;
 static std::shared_ptr<MotionEmu> motion_emu;
 static std::unique_ptr<CemuhookUDP::State> udp;
 static std::unique_ptr<SDL::State> sdl;
+static std::shared_ptr<HIDSampler> hid_sampler;
 
 void Init() {
 #ifdef ENABLE_GCADAPTER
@@ -50,9 +52,14 @@ void Init() {
     sdl = SDL::Init();
 
     udp = CemuhookUDP::Init();
+
+    hid_sampler = std::make_shared<HIDSampler>();
+    Input::RegisterHIDSnapshotSource(hid_sampler);
 }
 
 void Shutdown() {
+    Input::UnregisterHIDSnapshotSource();
+    hid_sampler.reset();
 #ifdef ENABLE_GCADAPTER
     Input::UnregisterFactory<Input::ButtonDevice>("gcpad");
     Input::UnregisterFactory<Input::AnalogDevice>("gcpad");
@@ -0,0 +1,34 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <fmt/format.h>
+#include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
+#include "common/logging/text_formatter.h"
+
+/// Converts a log written by Log::BinaryFileBackend to the text format of Log::FileBackend.
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fmt::print(stderr, "Usage: {} <binary log file>\n", argv[0]);
+        return 1;
+    }
+
+    Log::BinaryLogReader reader(argv[1]);
+    if (!reader.IsOpen()) {
+        fmt::print(stderr, "{} is not a supported binary log file\n", argv[1]);
+        return 1;
+    }
+
+    Log::Record record{};
+    while (reader.Read(record)) {
+        fmt::print("{}\n", Log::FormatLogMessage(Log::CreateEntry(record)));
+    }
+
+    if (!reader.IsAtEnd()) {
+        fmt::print(stderr, "{} is truncated or corrupt\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -20,7 +20,15 @@ namespace Network {
 // Time between room is announced to web_service
 static constexpr std::chrono::seconds announce_time_interval(15);
 
-AnnounceMultiplayerSession::AnnounceMultiplayerSession() {
+AnnounceMultiplayerSession::AnnounceMultiplayerSession()
+    : AnnounceMultiplayerSession([] { return Network::GetRoom().lock(); }) {}
+
+AnnounceMultiplayerSession::AnnounceMultiplayerSession(std::weak_ptr<Room> room)
+    : AnnounceMultiplayerSession([room = std::move(room)] { return room.lock(); }) {}
+
+AnnounceMultiplayerSession::AnnounceMultiplayerSession(
+    std::function<std::shared_ptr<Room>()> get_room_)
+    : get_room{std::move(get_room_)} {
 #ifdef ENABLE_WEB_SERVICE
     backend = std::make_unique<WebService::RoomJson>(NetSettings::values.web_api_url,
                                                      NetSettings::values.citra_username,
@@ -31,7 +39,7 @@ AnnounceMultiplayerSession::AnnounceMultiplayerSession() {
 }
 
 Common::WebResult AnnounceMultiplayerSession::Register() {
-    std::shared_ptr<Network::Room> room = Network::GetRoom().lock();
+    std::shared_ptr<Network::Room> room = get_room();
     if (!room) {
         return Common::WebResult{Common::WebResult::Code::LibError, "Network is not initialized"};
     }
@@ -120,7 +128,7 @@ void AnnounceMultiplayerSession::AnnounceMultiplayerLoop() {
     std::future<Common::WebResult> future;
     while (!shutdown_event.WaitUntil(update_time)) {
         update_time += announce_time_interval;
-        std::shared_ptr<Network::Room> room = Network::GetRoom().lock();
+        std::shared_ptr<Network::Room> room = get_room();
         if (!room) {
             break;
         }
@@ -26,7 +26,10 @@ class Room;
 class AnnounceMultiplayerSession : NonCopyable {
 public:
     using CallbackHandle = std::shared_ptr<std::function<void(const Common::WebResult&)>>;
+    /// Announces the room of Network::GetRoom.
     AnnounceMultiplayerSession();
+    /// Announces a room of a RoomServer.
+    explicit AnnounceMultiplayerSession(std::weak_ptr<Room> room);
     ~AnnounceMultiplayerSession();
 
     /**
@@ -77,6 +80,8 @@ public:
     void UpdateCredentials();
 
 private:
+    explicit AnnounceMultiplayerSession(std::function<std::shared_ptr<Room>()> get_room);
+
     Common::Event shutdown_event;
     std::mutex callback_mutex;
     std::set<CallbackHandle> error_callbacks;
@@ -87,6 +92,8 @@ private:
 
     std::atomic_bool registered = false; ///< Whether the room has been registered
 
+    std::function<std::shared_ptr<Room>()> get_room; ///< Returns the announced room
+
     void UpdateBackendData(std::shared_ptr<Network::Room> room);
     void AnnounceMultiplayerLoop();
 };
@@ -4,11 +4,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <mutex>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -47,16 +50,41 @@ public:
     mutable std::mutex member_mutex; ///< Mutex for locking the members list
     /// This should be a std::shared_mutex as soon as C++17 is supported
 
+    struct MacAddressHash {
+        std::size_t operator()(const MacAddress& address) const {
+            u64 value = 0;
+            std::memcpy(&value, address.data(), address.size());
+            return std::hash<u64>{}(value);
+        }
+    };
+    /// Peers of the members by their MAC address, to route unicast Wi-Fi packets. Guarded by
+    /// member_mutex, like members.
+    std::unordered_map<MacAddress, ENetPeer*, MacAddressHash> peers_by_mac;
+
     UsernameBanList username_ban_list; ///< List of banned usernames
     IPBanList ip_ban_list;             ///< List of banned IP addresses
     mutable std::mutex ban_list_mutex; ///< Mutex for the ban lists
 
-    RoomImpl()
-        : NintendoOUI{0x00, 0x1F, 0x32, 0x00, 0x00, 0x00}, random_gen(std::random_device()()) {}
+    explicit RoomImpl(ServiceMode service_mode_)
+        : NintendoOUI{0x00, 0x1F, 0x32, 0x00, 0x00, 0x00}, random_gen(std::random_device()()),
+          service_mode{service_mode_} {}
+
+    const ServiceMode service_mode;
 
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> room_thread;
 
+    // Counters of Statistics, written only by the thread servicing the room
+    std::atomic<u64> packets_received{0};
+    std::atomic<u64> bytes_received{0};
+    std::atomic<u64> packets_sent{0};
+    std::atomic<u64> bytes_sent{0};
+    std::atomic<u32> mean_round_trip_time{0};
+    std::atomic<u32> max_round_trip_time{0};
+    std::atomic<u64> service_time{0};
+    std::atomic<u64> max_event_time{0};
+    std::chrono::steady_clock::time_point next_round_trip_update{};
+
     /// Verification backend of the room
     std::unique_ptr<VerifyUser::Backend> verify_backend;
 
@@ -64,6 +92,23 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /**
+     * Handles the received events, waiting for the first one for up to timeout milliseconds, and
+     * updates the counters of the room.
+     */
+    void ServiceEvents(u32 timeout);
+
+    /**
+     * Dispatches a received event to the handler of its type.
+     */
+    void HandleEvent(const ENetEvent* event);
+
+    /**
+     * Moves the traffic counters of the ENet host to the counters of the room, and updates the
+     * round trip times of the members about once per second.
+     */
+    void UpdateStatistics();
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -222,11 +267,18 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Relays this packet to its destination member, or to all members except the sender if it is
+     * a broadcast. The received packet is sent as it is, keeping the reliability it was sent with.
      * @param event The ENet event containing the data
      */
     void HandleWifiPacket(const ENetEvent* event);
 
+    /**
+     * Removes a member from the members list and the MAC address routes. member_mutex must be
+     * held.
+     */
+    void EraseMember(MemberList::iterator member);
+
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
      * @param event The ENet event that was received.
@@ -249,47 +301,7 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
-        ENetEvent event;
-        if (enet_host_service(server, &event, 16) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
-        }
+        ServiceEvents(16);
     }
     // Close the connection to all members:
     SendCloseMessage();
@@ -299,6 +311,108 @@ void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
 
+void Room::RoomImpl::ServiceEvents(u32 timeout) {
+    ENetEvent event;
+    int result = enet_host_service(server, &event, timeout);
+    const bool has_events = result > 0;
+    while (result > 0) {
+        const auto start = std::chrono::steady_clock::now();
+        HandleEvent(&event);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const u64 event_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        service_time.fetch_add(event_time, std::memory_order_relaxed);
+        if (event_time > max_event_time.load(std::memory_order_relaxed)) {
+            max_event_time.store(event_time, std::memory_order_relaxed);
+        }
+        result = enet_host_check_events(server, &event);
+    }
+    if (has_events) {
+        // Send the relayed packets of all the handled events at once
+        enet_host_flush(server);
+    }
+    UpdateStatistics();
+}
+
+void Room::RoomImpl::HandleEvent(const ENetEvent* event) {
+    switch (event->type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event->packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(event);
+            break;
+        case IdSetGameInfo:
+            HandleGameNamePacket(event);
+            break;
+        case IdWifiPacket:
+            HandleWifiPacket(event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(event);
+            break;
+        }
+        // Relayed packets are freed by ENet once they have been sent to every destination
+        if (event->packet->referenceCount == 0) {
+            enet_packet_destroy(event->packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event->peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+}
+
+void Room::RoomImpl::UpdateStatistics() {
+    // The host counters are 32-bit, so they are moved to the counters of the room before they
+    // can wrap around.
+    packets_received.fetch_add(server->totalReceivedPackets, std::memory_order_relaxed);
+    bytes_received.fetch_add(server->totalReceivedData, std::memory_order_relaxed);
+    packets_sent.fetch_add(server->totalSentPackets, std::memory_order_relaxed);
+    bytes_sent.fetch_add(server->totalSentData, std::memory_order_relaxed);
+    server->totalReceivedPackets = 0;
+    server->totalReceivedData = 0;
+    server->totalSentPackets = 0;
+    server->totalSentData = 0;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_round_trip_update) {
+        return;
+    }
+    next_round_trip_update = now + std::chrono::seconds(1);
+
+    u64 total_round_trip_time = 0;
+    u32 max_round_trip = 0;
+    std::size_t num_members;
+    {
+        std::lock_guard lock(member_mutex);
+        for (const auto& member : members) {
+            total_round_trip_time += member.peer->roundTripTime;
+            max_round_trip = std::max<u32>(max_round_trip, member.peer->roundTripTime);
+        }
+        num_members = members.size();
+    }
+    mean_round_trip_time.store(
+        num_members == 0 ? 0 : static_cast<u32>(total_round_trip_time / num_members),
+        std::memory_order_relaxed);
+    max_round_trip_time.store(max_round_trip, std::memory_order_relaxed);
+}
+
 void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     {
         std::lock_guard lock(member_mutex);
@@ -402,6 +516,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
+        peers_by_mac[member.mac_address] = member.peer;
         members.push_back(std::move(member));
     }
 
@@ -448,7 +563,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        EraseMember(target_member);
     }
 
     // Announce the change to all clients.
@@ -491,7 +606,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        EraseMember(target_member);
     }
 
     {
@@ -578,8 +693,7 @@ bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
 bool Room::RoomImpl::IsValidMacAddress(const MacAddress& address) const {
     // A MAC address is valid if it is not already taken by anybody else in the room.
     std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&address](const auto& member) { return member.mac_address != address; });
+    return !peers_by_mac.contains(address);
 }
 
 bool Room::RoomImpl::IsValidConsoleId(const std::string& console_id_hash) const {
@@ -846,51 +960,37 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+    // The message type, the WifiPacket type, channel and transmitter address precede the
+    // destination address
+    constexpr std::size_t destination_offset = 3 * sizeof(u8) + sizeof(MacAddress);
+    ENetPacket* const packet = event->packet;
+    if (packet->dataLength < destination_offset + sizeof(MacAddress)) {
+        return;
+    }
     MacAddress destination_address;
-    in_packet >> destination_address;
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    std::memcpy(destination_address.data(), packet->data + destination_offset,
+                sizeof(MacAddress));
 
+    // The packet is relayed without copying it, ENet counts its references
+    std::lock_guard lock(member_mutex);
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
         for (const auto& member : members) {
             if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
+                enet_peer_send(member.peer, event->channelID, packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto it = peers_by_mac.find(destination_address);
+        if (it != peers_by_mac.end()) {
+            enet_peer_send(it->second, event->channelID, packet);
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
-    enet_host_flush(server);
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -976,6 +1076,11 @@ void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
     BroadcastRoomInformation();
 }
 
+void Room::RoomImpl::EraseMember(MemberList::iterator member) {
+    peers_by_mac.erase(member->mac_address);
+    members.erase(member);
+}
+
 void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     // Remove the client from the members list.
     std::string nickname, username, ip;
@@ -992,7 +1097,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             enet_address_get_host_ip(&member->peer->address, ip_raw, sizeof(ip_raw) - 1);
             ip = ip_raw;
 
-            members.erase(member);
+            EraseMember(member);
         }
     }
 
@@ -1004,7 +1109,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
 }
 
 // Room
-Room::Room() : room_impl{std::make_unique<RoomImpl>()} {}
+Room::Room(ServiceMode service_mode) : room_impl{std::make_unique<RoomImpl>(service_mode)} {}
 
 Room::~Room() = default;
 
@@ -1042,7 +1147,9 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->username_ban_list = ban_list.first;
     room_impl->ip_ban_list = ban_list.second;
 
-    room_impl->StartLoop();
+    if (room_impl->service_mode == ServiceMode::OwnThread) {
+        room_impl->StartLoop();
+    }
     return true;
 }
 
@@ -1084,6 +1191,34 @@ bool Room::HasPassword() const {
     return !room_impl->password.empty();
 }
 
+Room::Statistics Room::GetStatistics() const {
+    Statistics statistics;
+    statistics.packets_received = room_impl->packets_received.load(std::memory_order_relaxed);
+    statistics.bytes_received = room_impl->bytes_received.load(std::memory_order_relaxed);
+    statistics.packets_sent = room_impl->packets_sent.load(std::memory_order_relaxed);
+    statistics.bytes_sent = room_impl->bytes_sent.load(std::memory_order_relaxed);
+    statistics.mean_round_trip_time =
+        room_impl->mean_round_trip_time.load(std::memory_order_relaxed);
+    statistics.max_round_trip_time = room_impl->max_round_trip_time.load(std::memory_order_relaxed);
+    statistics.service_time = room_impl->service_time.load(std::memory_order_relaxed);
+    statistics.max_event_time = room_impl->max_event_time.load(std::memory_order_relaxed);
+    {
+        std::lock_guard lock(room_impl->member_mutex);
+        statistics.num_members = static_cast<u32>(room_impl->members.size());
+    }
+    return statistics;
+}
+
+void Room::Service() {
+    if (room_impl->state != State::Closed) {
+        room_impl->ServiceEvents(0);
+    }
+}
+
+u64 Room::GetSocketHandle() const {
+    return static_cast<u64>(room_impl->server->socket);
+}
+
 void Room::SetVerifyUID(const std::string& uid) {
     std::lock_guard lock(room_impl->verify_UID_mutex);
     room_impl->verify_UID = uid;
@@ -1091,8 +1226,12 @@ void Room::SetVerifyUID(const std::string& uid) {
 
 void Room::Destroy() {
     room_impl->state = State::Closed;
-    room_impl->room_thread->join();
-    room_impl->room_thread.reset();
+    if (room_impl->room_thread) {
+        room_impl->room_thread->join();
+        room_impl->room_thread.reset();
+    } else if (room_impl->server) {
+        room_impl->SendCloseMessage();
+    }
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1102,6 +1241,7 @@ void Room::Destroy() {
     {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
+        room_impl->peers_by_mac.clear();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
@@ -104,7 +104,26 @@ public:
         MacAddress mac_address;   ///< The assigned mac address of the member.
     };
 
-    Room();
+    /// How the events received by the room are handled.
+    enum class ServiceMode : u8 {
+        OwnThread, ///< The room handles its events on a thread of its own.
+        External,  ///< The events are handled by calls to Service, like a RoomServer does.
+    };
+
+    /// Traffic and latency counters of the room, since it was created.
+    struct Statistics {
+        u64 packets_received = 0; ///< UDP packets received, including ENet protocol packets.
+        u64 bytes_received = 0;
+        u64 packets_sent = 0; ///< UDP packets sent, including ENet protocol packets.
+        u64 bytes_sent = 0;
+        u32 num_members = 0;
+        u32 mean_round_trip_time = 0; ///< Mean round trip time to the members, in milliseconds.
+        u32 max_round_trip_time = 0;  ///< Highest round trip time to a member, in milliseconds.
+        u64 service_time = 0;   ///< Time spent handling events, in microseconds.
+        u64 max_event_time = 0; ///< Longest time spent handling one event, in microseconds.
+    };
+
+    explicit Room(ServiceMode service_mode = ServiceMode::OwnThread);
     ~Room();
 
     /**
@@ -160,6 +179,22 @@ public:
      */
     BanList GetBanList() const;
 
+    /**
+     * Gets the traffic and latency counters of the room.
+     */
+    Statistics GetStatistics() const;
+
+    /**
+     * Handles the events received since the last call without waiting for new ones. Only called
+     * for rooms created with ServiceMode::External, by one thread at a time.
+     */
+    void Service();
+
+    /**
+     * Gets the ENet socket of the room, for the callers of Service to wait on.
+     */
+    u64 GetSocketHandle() const;
+
     /**
      * Destroys the socket
      */
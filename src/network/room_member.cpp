@@ -45,8 +45,12 @@ public:
     std::mutex network_mutex; ///< Mutex that controls access to the `client` variable.
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> loop_thread;
-    std::mutex send_list_mutex;  ///< Mutex that controls access to the `send_list` variable.
-    std::list<Packet> send_list; ///< A list that stores all packets to send the async
+    struct OutgoingPacket {
+        Packet packet;
+        u32 flags; ///< The ENet packet flags to send the packet with
+    };
+    std::mutex send_list_mutex; ///< Mutex that controls access to the `send_list` variable.
+    std::list<OutgoingPacket> send_list; ///< A list that stores all packets to send the async
 
     template <typename T>
     using CallbackSet = std::set<CallbackHandle<T>>;
@@ -73,10 +77,11 @@ public:
     void StartLoop();
 
     /**
-     * Sends data to the room. It will be send on channel 0 with flag RELIABLE
+     * Sends data to the room. It will be send on channel 0 with the given flags
      * @param packet The data to send
+     * @param flags The ENet packet flags, RELIABLE unless the data tolerates loss
      */
-    void Send(Packet&& packet);
+    void Send(Packet&& packet, u32 flags = ENET_PACKET_FLAG_RELIABLE);
 
     /**
      * Sends a request to the server, asking for permission to join a room with the specified
@@ -253,14 +258,14 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
             }
         }
 
-        std::list<Packet> packets;
+        std::list<OutgoingPacket> packets;
         {
             std::lock_guard send_list_lock(send_list_mutex);
             packets.swap(send_list);
         }
-        for (const auto& packet : packets) {
-            ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
-                                                        ENET_PACKET_FLAG_RELIABLE);
+        for (const auto& [packet, flags] : packets) {
+            ENetPacket* enetPacket =
+                enet_packet_create(packet.GetData(), packet.GetDataSize(), flags);
             enet_peer_send(server, 0, enetPacket);
         }
         enet_host_flush(client);
@@ -272,9 +277,9 @@ void RoomMember::RoomMemberImpl::StartLoop() {
     loop_thread = std::make_unique<std::thread>(&RoomMember::RoomMemberImpl::MemberLoop, this);
 }
 
-void RoomMember::RoomMemberImpl::Send(Packet&& packet) {
+void RoomMember::RoomMemberImpl::Send(Packet&& packet, u32 flags) {
     std::lock_guard lock(send_list_mutex);
-    send_list.push_back(std::move(packet));
+    send_list.push_back({std::move(packet), flags});
 }
 
 void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
@@ -594,7 +599,12 @@ void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
     packet << wifi_packet.transmitter_address;
     packet << wifi_packet.destination_address;
     packet << wifi_packet.data;
-    room_member_impl->Send(std::move(packet));
+    // Beacons are sent periodically and superseded by the next one, so a lost beacon needs no
+    // resending and must not hold back the packets behind it
+    const u32 flags = wifi_packet.type == WifiPacket::PacketType::Beacon
+                          ? ENET_PACKET_FLAG_UNSEQUENCED
+                          : ENET_PACKET_FLAG_RELIABLE;
+    room_member_impl->Send(std::move(packet), flags);
 }
 
 void RoomMember::SendChatMessage(const std::string& message) {
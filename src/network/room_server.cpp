@@ -0,0 +1,141 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fmt/format.h>
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+#include "enet/enet.h"
+#include "network/room_server.h"
+
+namespace Network {
+
+class RoomServer::Worker {
+public:
+    explicit Worker(std::size_t index)
+        : thread{[this, index](std::stop_token token) { WorkerLoop(token, index); }} {}
+
+    void AddRoom(std::shared_ptr<Room> room) {
+        {
+            std::scoped_lock lock{mutex};
+            rooms.push_back(std::move(room));
+            num_rooms = rooms.size();
+        }
+        rooms_changed.notify_one();
+    }
+
+    bool RemoveRoom(const std::shared_ptr<Room>& room) {
+        std::scoped_lock lock{mutex};
+        const auto it = std::find(rooms.begin(), rooms.end(), room);
+        if (it == rooms.end()) {
+            return false;
+        }
+        rooms.erase(it);
+        num_rooms = rooms.size();
+        return true;
+    }
+
+    std::size_t GetNumRooms() const {
+        return num_rooms;
+    }
+
+private:
+    void WorkerLoop(std::stop_token token, std::size_t index) {
+        Common::SetCurrentThreadName(fmt::format("RoomServer:{}", index).c_str());
+
+        using Clock = std::chrono::steady_clock;
+        auto next_full_service = Clock::now();
+        std::unique_lock lock{mutex};
+        while (!token.stop_requested()) {
+            if (rooms.empty()) {
+                Common::CondvarWait(rooms_changed, lock, token, [this] { return !rooms.empty(); });
+                continue;
+            }
+
+            ENetSocketSet sockets;
+            ENET_SOCKETSET_EMPTY(sockets);
+            ENetSocket max_socket = 0;
+            for (const auto& room : rooms) {
+                const auto socket = static_cast<ENetSocket>(room->GetSocketHandle());
+                ENET_SOCKETSET_ADD(sockets, socket);
+                max_socket = std::max(max_socket, socket);
+            }
+
+            // Wait without the lock, so that rooms can be added and removed meanwhile. Only the
+            // rooms that are still registered afterwards are serviced, and a socket that was
+            // closed or reused meanwhile at most causes a spurious wakeup.
+            const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::max(next_full_service - Clock::now(), Clock::duration::zero()));
+            lock.unlock();
+            if (enet_socketset_select(max_socket, &sockets, nullptr,
+                                      static_cast<enet_uint32>(timeout.count())) < 0) {
+                ENET_SOCKETSET_EMPTY(sockets);
+            }
+            lock.lock();
+
+            const auto now = Clock::now();
+            const bool is_full_service = now >= next_full_service;
+            if (is_full_service) {
+                next_full_service = now + std::chrono::milliseconds(ServiceInterval);
+            }
+            for (const auto& room : rooms) {
+                const auto socket = static_cast<ENetSocket>(room->GetSocketHandle());
+                if (is_full_service || ENET_SOCKETSET_CHECK(sockets, socket)) {
+                    room->Service();
+                }
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable_any rooms_changed;
+    std::vector<std::shared_ptr<Room>> rooms;
+    std::atomic<std::size_t> num_rooms{0};
+    std::jthread thread;
+};
+
+RoomServer::RoomServer(std::size_t num_workers) {
+    num_workers = std::max<std::size_t>(num_workers, 1);
+    for (std::size_t i = 0; i < num_workers; i++) {
+        workers.push_back(std::make_unique<Worker>(i));
+    }
+}
+
+RoomServer::~RoomServer() = default;
+
+void RoomServer::AddRoom(std::shared_ptr<Room> room) {
+    const auto worker =
+        std::min_element(workers.begin(), workers.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs->GetNumRooms() < rhs->GetNumRooms();
+        });
+    (*worker)->AddRoom(room);
+
+    std::scoped_lock lock{rooms_mutex};
+    rooms.push_back(std::move(room));
+}
+
+void RoomServer::RemoveRoom(const std::shared_ptr<Room>& room) {
+    for (const auto& worker : workers) {
+        if (worker->RemoveRoom(room)) {
+            break;
+        }
+    }
+
+    std::scoped_lock lock{rooms_mutex};
+    rooms.erase(std::remove(rooms.begin(), rooms.end(), room), rooms.end());
+}
+
+std::vector<std::shared_ptr<Room>> RoomServer::GetRooms() const {
+    std::scoped_lock lock{rooms_mutex};
+    return rooms;
+}
+
+std::size_t RoomServer::GetNumWorkers() const {
+    return workers.size();
+}
+
+} // namespace Network
@@ -0,0 +1,59 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "network/room.h"
+
+namespace Network {
+
+/**
+ * Hosts many rooms in one process on a fixed number of worker threads. Every room is assigned to
+ * the worker with the fewest rooms, which waits on the sockets of all of its rooms at once and
+ * only services the rooms that received packets, besides servicing every room at the interval of
+ * a room with a thread of its own. Idle rooms thus cost no thread, and a busy room only delays
+ * the rooms of its own worker.
+ */
+class RoomServer final {
+public:
+    /// Interval at which every room is serviced, for ENet to resend packets and detect timeouts.
+    static constexpr u32 ServiceInterval = 16;
+
+    explicit RoomServer(std::size_t num_workers);
+    ~RoomServer();
+
+    /**
+     * Starts servicing a room that was created with Room::ServiceMode::External.
+     */
+    void AddRoom(std::shared_ptr<Room> room);
+
+    /**
+     * Stops servicing a room. It is not touched by the workers anymore once this returns, so it
+     * can be destroyed.
+     */
+    void RemoveRoom(const std::shared_ptr<Room>& room);
+
+    /**
+     * Gets the rooms of the server, in the order they were added.
+     */
+    std::vector<std::shared_ptr<Room>> GetRooms() const;
+
+    /**
+     * Gets the number of worker threads of the server.
+     */
+    std::size_t GetNumWorkers() const;
+
+private:
+    class Worker;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::vector<std::shared_ptr<Room>> rooms; ///< Rooms of every worker
+    mutable std::mutex rooms_mutex;           ///< Mutex for rooms
+};
+
+} // namespace Network
@@ -0,0 +1,71 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/log.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+
+using OpenGL::ShaderDiskCache;
+using OpenGL::ShaderDiskCacheRaw;
+
+/**
+ * Merges the transferable OpenGL shader caches of a title, as collected from many users, into a
+ * single pack holding every shader once. Entries whose identifier does not match their contents
+ * are left out, as a single one of them makes the emulator discard the whole cache.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fmt::print(stderr, "Usage: {} <output> <transferable cache>...\n", argv[0]);
+        fmt::print(stderr, "All caches must belong to the same title. They are stored as "
+                           "shaders/opengl/transferable/<title id>.bin in the user directory.\n");
+        return 1;
+    }
+
+    Log::Filter log_filter(Log::Level::Warning);
+    Log::SetGlobalFilter(log_filter);
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    std::vector<ShaderDiskCacheRaw> pack;
+    std::unordered_set<u64> identifiers;
+    std::size_t num_read = 0;
+    std::size_t num_invalid = 0;
+    for (int i = 2; i < argc; i++) {
+        FileUtil::IOFile file(argv[i], "rb");
+        const auto raws =
+            file.IsOpen() ? ShaderDiskCache::ReadTransferableFile(file) : std::nullopt;
+        if (!raws) {
+            fmt::print(stderr, "Skipping {}, which is not a transferable cache of this version\n",
+                       argv[i]);
+            continue;
+        }
+
+        for (const ShaderDiskCacheRaw& raw : *raws) {
+            num_read++;
+            if (OpenGL::GetUniqueIdentifier(raw.GetRawShaderConfig(), raw.GetProgramCode()) !=
+                raw.GetUniqueIdentifier()) {
+                num_invalid++;
+                continue;
+            }
+            if (identifiers.insert(raw.GetUniqueIdentifier()).second) {
+                pack.push_back(raw);
+            }
+        }
+    }
+
+    FileUtil::IOFile output(argv[1], "wb");
+    if (!output.IsOpen() || !ShaderDiskCache::WriteTransferableFile(output, pack)) {
+        fmt::print(stderr, "Failed to write {}\n", argv[1]);
+        return 1;
+    }
+
+    fmt::print("Wrote {} shaders to {} ({} read, {} invalid, {} duplicates)\n", pack.size(),
+               argv[1], num_read, num_invalid, num_read - num_invalid - pack.size());
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "video_core/renderer_vulkan/vk_shader_disk_cache.h"
+
+/**
+ * Brings a SPIR-V cache of the Vulkan renderer up to date with this build, without a GPU. The
+ * input can be the cache of a title written by any build of the emulator, which records the
+ * configuration of every shader the title used. Every shader is generated and compiled again in
+ * parallel, and the ones that fail are dropped. The SPIR-V is not validated beyond checking that
+ * glslang or sirit produced a module with the SPIR-V magic number. The cache stays bound to the
+ * device it was recorded on, whose features the configurations were taken from.
+ */
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        fmt::print(stderr, "Usage: {} <recorded SPIR-V cache> [output]\n", argv[0]);
+        fmt::print(stderr, "Without an output, the cache is updated in place. Caches are stored "
+                           "as shaders/vulkan/spirv/<title id>.bin in the user directory.\n");
+        return 1;
+    }
+
+    Log::Filter log_filter(Log::Level::Warning);
+    Log::SetGlobalFilter(log_filter);
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    const std::string input = argv[1];
+    const std::string output = argc == 3 ? argv[2] : input;
+    if (!FileUtil::Exists(input)) {
+        fmt::print(stderr, "{} does not exist\n", input);
+        return 1;
+    }
+    if (output != input && !FileUtil::Copy(input, output)) {
+        fmt::print(stderr, "Failed to copy {} to {}\n", input, output);
+        return 1;
+    }
+
+    const std::size_t num_workers = std::max(std::thread::hardware_concurrency(), 2U);
+    Common::ThreadWorker workers{num_workers, "SPIR-V builders"};
+    const std::atomic_bool stop_loading{false};
+
+    Vulkan::ShaderDiskCache cache{output};
+    const auto entries = cache.Load(workers, stop_loading, {}, true);
+    if (entries.empty()) {
+        fmt::print(stderr, "No shader of {} could be generated\n", input);
+        return 1;
+    }
+
+    fmt::print("Wrote {} shaders to {}\n", entries.size(), output);
+    return 0;
+}
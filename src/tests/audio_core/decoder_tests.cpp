@@ -1,9 +1,15 @@
 // Copyright 2019 Citra Emulator Project
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
-#if defined(HAVE_MF) || defined(HAVE_FFMPEG)
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <catch2/catch_test_macros.hpp>
+#include "audio_core/hle/async_decoder.h"
+
+#if defined(HAVE_MF) || defined(HAVE_FFMPEG)
+
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/kernel/memory.h"
@@ -52,3 +58,81 @@ TEST_CASE("DSP HLE Audio Decoder", "[audio_core]") {
 }
 
 #endif
+
+namespace {
+
+/**
+ * A decoder that echoes the request size back, once it is opened. A decoder that is never opened
+ * gives up waiting after a while, so that a caller waiting for it fails instead of hanging.
+ */
+class GatedDecoder final : public AudioCore::HLE::DecoderBase {
+public:
+    GatedDecoder(std::shared_future<void> opened_, std::atomic<u32>& num_processed_)
+        : opened(std::move(opened_)), num_processed(num_processed_) {}
+
+    std::optional<AudioCore::HLE::BinaryMessage> ProcessRequest(
+        const AudioCore::HLE::BinaryMessage& request) override {
+        opened.wait_for(std::chrono::seconds(10));
+        ++num_processed;
+        AudioCore::HLE::BinaryMessage response{};
+        response.header = request.header;
+        response.header.result = AudioCore::HLE::ResultStatus::Success;
+        response.decode_aac_response.size = request.decode_aac_request.size;
+        return response;
+    }
+
+    bool IsValid() const override {
+        return true;
+    }
+
+private:
+    std::shared_future<void> opened;
+    std::atomic<u32>& num_processed;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("DSP HLE asynchronous decoder", "[audio_core]") {
+    constexpr std::size_t num_requests = 16;
+    std::promise<void> open;
+    std::atomic<u32> num_processed{0};
+
+    AudioCore::HLE::AsyncDecoder decoder(
+        std::make_unique<GatedDecoder>(open.get_future().share(), num_processed));
+    REQUIRE(decoder.IsValid());
+    REQUIRE(!decoder.HasPendingRequests());
+
+    AudioCore::HLE::BinaryMessage request{};
+    request.header.codec = AudioCore::HLE::DecoderCodec::DecodeAAC;
+    request.header.cmd = AudioCore::HLE::DecoderCommand::EncodeDecode;
+
+    // Queueing must not wait for the decoder, which is stuck on the first request until opened
+    for (u32 i = 0; i < num_requests; i++) {
+        request.decode_aac_request.size = i;
+        decoder.QueueRequest(request);
+        REQUIRE(decoder.HasPendingRequests());
+    }
+    CHECK(num_processed == 0);
+    open.set_value();
+
+    const auto responses = decoder.CollectResponses();
+    REQUIRE(responses.size() == num_requests);
+    for (u32 i = 0; i < num_requests; i++) {
+        REQUIRE(responses[i].decode_aac_response.size == i);
+        REQUIRE(responses[i].header.result == AudioCore::HLE::ResultStatus::Success);
+    }
+    REQUIRE(!decoder.HasPendingRequests());
+    REQUIRE(decoder.CollectResponses().empty());
+
+    SECTION("synchronous requests wait for queued ones") {
+        request.decode_aac_request.size = 100;
+        decoder.QueueRequest(request);
+        request.decode_aac_request.size = 200;
+        const auto response = decoder.ProcessRequest(request);
+        REQUIRE(response);
+        REQUIRE(response->decode_aac_response.size == 200);
+        const auto queued = decoder.CollectResponses();
+        REQUIRE(queued.size() == 1);
+        REQUIRE(queued[0].decode_aac_response.size == 100);
+    }
+}
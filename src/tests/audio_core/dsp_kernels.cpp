@@ -0,0 +1,128 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <random>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/codec.h"
+#include "audio_core/dsp_kernels.h"
+#include "audio_core/hle/common.h"
+
+namespace {
+
+using AudioCore::QuadFrame32;
+using AudioCore::StereoFrame16;
+using AudioCore::Kernels::KernelSet;
+
+/// A synthetic voice: ADPCM data plus the parameters a game would configure for a Source.
+struct Voice {
+    std::vector<u8> adpcm;
+    std::array<s16, 16> coeffs;
+    u64 step;
+    s32 simple_b0, simple_a1;
+    AudioCore::Kernels::BiquadCoefficients biquad;
+    std::array<std::array<float, 4>, 3> gains;
+};
+
+constexpr std::size_t num_frames = 32;
+// Enough ADPCM samples for num_frames frames at the highest rate below
+constexpr std::size_t samples_per_voice = AudioCore::samples_per_frame * num_frames * 3;
+
+std::vector<Voice> GenerateVoices() {
+    std::mt19937 rng(0xC17A);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> coeff(-4096, 4095);
+    std::uniform_real_distribution<float> rate(0.25f, 2.5f);
+    std::uniform_real_distribution<float> gain(-1.5f, 1.5f);
+
+    std::vector<Voice> voices(AudioCore::HLE::num_sources);
+    for (auto& voice : voices) {
+        voice.adpcm.resize(samples_per_voice / 14 * 8 + 8);
+        for (auto& b : voice.adpcm) {
+            b = static_cast<u8>(byte(rng));
+        }
+        for (auto& c : voice.coeffs) {
+            c = static_cast<s16>(coeff(rng));
+        }
+        voice.step = static_cast<u64>(rate(rng) * (1 << 24));
+        voice.simple_b0 = coeff(rng) * 8;
+        voice.simple_a1 = coeff(rng) * 4;
+        voice.biquad = {coeff(rng), coeff(rng) / 2, coeff(rng) * 4, coeff(rng), coeff(rng)};
+        for (auto& mix : voice.gains) {
+            for (auto& g : mix) {
+                g = gain(rng);
+            }
+        }
+    }
+    return voices;
+}
+
+/// Decodes, resamples, filters and mixes every voice, returning the three intermediate mixes of
+/// every frame.
+std::vector<std::array<QuadFrame32, 3>> RenderVoices(const std::vector<Voice>& voices,
+                                                     const KernelSet& kernels) {
+    std::vector<std::array<QuadFrame32, 3>> mixes(num_frames);
+    for (const auto& voice : voices) {
+        AudioCore::Codec::ADPCMState adpcm_state{};
+        const auto decoded = AudioCore::Codec::DecodeADPCM(voice.adpcm.data(), samples_per_voice,
+                                                           voice.coeffs, adpcm_state);
+
+        std::array<s16, 2> simple_y1{};
+        AudioCore::Kernels::BiquadHistory biquad_history{};
+        u64 fposition = 0;
+        for (auto& frame_mixes : mixes) {
+            StereoFrame16 frame;
+            kernels.interpolate_linear(decoded.data(), fposition, voice.step, frame.data(),
+                                       frame.size());
+            fposition += voice.step * frame.size();
+
+            kernels.simple_filter(frame, voice.simple_b0, voice.simple_a1, simple_y1);
+            kernels.biquad_filter(frame, voice.biquad, biquad_history);
+            for (std::size_t mix = 0; mix < 3; mix++) {
+                kernels.mix_into_quad(frame_mixes[mix], frame, voice.gains[mix]);
+            }
+        }
+    }
+    return mixes;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DSP kernels are bit-exact with the generic implementation", "[audio_core]") {
+    const auto voices = GenerateVoices();
+    const auto& generic = AudioCore::Kernels::GetGenericKernels();
+    const auto& selected = AudioCore::Kernels::GetKernels();
+
+    INFO("Selected kernels: " << selected.name);
+    REQUIRE(RenderVoices(voices, selected) == RenderVoices(voices, generic));
+
+    SECTION("Mono PCM16 to stereo") {
+        std::vector<u8> pcm(0x1003);
+        std::mt19937 rng(0x3D5);
+        for (auto& b : pcm) {
+            b = static_cast<u8>(rng());
+        }
+        // Use an odd offset to test unaligned input
+        const std::size_t count = (pcm.size() - 1) / sizeof(s16);
+        std::vector<std::array<s16, 2>> expected(count);
+        std::vector<std::array<s16, 2>> actual(count);
+        generic.mono_to_stereo(pcm.data() + 1, expected.data(), count);
+        selected.mono_to_stereo(pcm.data() + 1, actual.data(), count);
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("DSP kernels 24 voice benchmark", "[audio_core][.benchmark]") {
+    const auto voices = GenerateVoices();
+
+    BENCHMARK("Generic") {
+        return RenderVoices(voices, AudioCore::Kernels::GetGenericKernels());
+    };
+
+    BENCHMARK(AudioCore::Kernels::GetKernels().name) {
+        return RenderVoices(voices, AudioCore::Kernels::GetKernels());
+    };
+}
@@ -0,0 +1,66 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+#include "audio_core/codec.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace {
+
+/// Samples in a buffer queued by titles, about 160 ms of audio at the sample rate of the DSP
+constexpr std::size_t ADPCM_BUFFER_SAMPLES = 5280;
+constexpr std::size_t ADPCM_SAMPLES_PER_FRAME = 14;
+constexpr std::size_t ADPCM_FRAME_SIZE = 8;
+
+struct ADPCMStream {
+    std::array<s16, 16> coeffs;
+    std::vector<std::vector<u8>> buffers;
+    AudioCore::Codec::ADPCMState state{};
+};
+
+Benchmarks::Iteration SetupADPCMDecode() {
+    auto stream = std::make_shared<ADPCMStream>();
+    std::mt19937 rng(0xADC0);
+    // Coefficients of real streams are 4.11 fixed point, mostly in [-2, 2)
+    std::uniform_int_distribution<int> coeff_dist(-0x1000, 0xFFF);
+    for (auto& coeff : stream->coeffs) {
+        coeff = static_cast<s16>(coeff_dist(rng));
+    }
+    std::uniform_int_distribution<int> byte_dist(0, 0xFF);
+    std::uniform_int_distribution<int> scale_dist(0, 11);
+    std::uniform_int_distribution<int> index_dist(0, 7);
+    constexpr std::size_t buffer_size =
+        (ADPCM_BUFFER_SAMPLES + ADPCM_SAMPLES_PER_FRAME - 1) / ADPCM_SAMPLES_PER_FRAME *
+        ADPCM_FRAME_SIZE;
+    for (int i = 0; i < 64; i++) {
+        auto& buffer = stream->buffers.emplace_back(buffer_size);
+        for (std::size_t offset = 0; offset < buffer_size; offset++) {
+            buffer[offset] = static_cast<u8>(byte_dist(rng));
+        }
+        // The header of each frame holds the index of its coefficients and its scale
+        for (std::size_t offset = 0; offset < buffer_size; offset += ADPCM_FRAME_SIZE) {
+            buffer[offset] = static_cast<u8>(index_dist(rng) << 4 | scale_dist(rng));
+        }
+    }
+
+    return [stream] {
+        for (const auto& buffer : stream->buffers) {
+            const auto samples = AudioCore::Codec::DecodeADPCM(
+                buffer.data(), ADPCM_BUFFER_SAMPLES, stream->coeffs, stream->state);
+            if (samples.size() != ADPCM_BUFFER_SAMPLES) {
+                return 0.0;
+            }
+        }
+        return static_cast<double>(stream->buffers.size() * ADPCM_BUFFER_SAMPLES);
+    };
+}
+
+const Benchmarks::Registration registration{
+    {"ADPCM decode", "audio_core", "samples/s", 10e6, SetupADPCMDecode},
+};
+
+} // Anonymous namespace
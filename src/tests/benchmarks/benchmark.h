@@ -0,0 +1,42 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace Benchmarks {
+
+/// Runs the measured work once and returns the amount of it, in the unit of the benchmark.
+using Iteration = std::function<double()>;
+
+/**
+ * A benchmark of the throughput of one subsystem. Its inputs are generated from fixed seeds, so
+ * that every run measures the same work and results can be compared from one commit to the next.
+ */
+struct Benchmark {
+    /// Name of the benchmark, unique among all of them
+    std::string name;
+    /// Subsystem the benchmark measures, like the directory of its code
+    std::string subsystem;
+    /// Unit of the throughput, like "MB/s"
+    std::string unit;
+    /// Lowest median throughput that is not considered a regression
+    double budget;
+    /// Prepares the inputs outside of the measured time and returns the iteration to measure
+    std::function<Iteration()> setup;
+};
+
+/// Returns every registered benchmark, in the order they were registered in.
+[[nodiscard]] const std::vector<Benchmark>& GetBenchmarks();
+
+/// Registers benchmarks from the initializer of a static object.
+struct Registration {
+    Registration(std::initializer_list<Benchmark> benchmarks);
+};
+
+} // namespace Benchmarks
@@ -0,0 +1,244 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <span>
+#include <sstream>
+#include <vector>
+#include "common/archives.h"
+#include "common/file_util.h"
+#include "core/core_timing.h"
+#include "core/file_sys/write_behind_file.h"
+#include "core/hle/ipc.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/server_session.h"
+#include "core/hw/aes/ctr.h"
+#include "core/memory.h"
+#include "tests/benchmarks/benchmark.h"
+#include "tests/temp_directory.h"
+
+namespace {
+
+constexpr double MB = 1000.0 * 1000.0;
+
+struct TimingQueue {
+    Core::Timing timing{1, 100};
+    Core::TimingEventType* event_type = nullptr;
+    std::vector<s64> delays;
+    std::size_t num_fired = 0;
+};
+
+/**
+ * Schedules as many events as a busy frame does, cancelling every other one before it fires, like
+ * the timeouts of waits that are woken up early, and runs the timer until the others have fired.
+ */
+Benchmarks::Iteration SetupTimingScheduleCancel() {
+    auto queue = std::make_shared<TimingQueue>();
+    queue->event_type = queue->timing.RegisterEvent(
+        "benchmark", [queue = queue.get()](std::uintptr_t, s64) { queue->num_fired++; });
+    std::mt19937 rng(0x7141);
+    std::uniform_int_distribution<s64> delay_dist(100, BASE_CLOCK_RATE_ARM11 / 60);
+    queue->delays.resize(2048);
+    for (auto& delay : queue->delays) {
+        delay = delay_dist(rng);
+    }
+
+    return [queue] {
+        auto& timing = queue->timing;
+        const std::size_t num_events = queue->delays.size();
+        for (std::size_t i = 0; i < num_events; i++) {
+            timing.ScheduleEvent(queue->delays[i], queue->event_type, i, 0);
+        }
+        for (std::size_t i = 0; i < num_events; i += 2) {
+            timing.UnscheduleEvent(queue->event_type, i);
+        }
+
+        queue->num_fired = 0;
+        auto* timer = timing.GetTimer(0).get();
+        while (queue->num_fired < num_events / 2) {
+            timer->AddTicks(timer->GetDowncount());
+            timer->Advance();
+            timer->SetNextSlice();
+        }
+        return static_cast<double>(num_events + num_events / 2);
+    };
+}
+
+struct IPCSession {
+    Core::Timing timing{1, 100};
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel{memory, timing, [] {}, 0, 1, 0};
+    std::shared_ptr<Kernel::Process> process;
+    std::unique_ptr<Kernel::HLERequestContext> context;
+};
+
+/**
+ * Translates requests and replies between the command buffer of a process and an HLE service, as
+ * every call of a title to a service does. The requests carry parameters and the ID of the
+ * process, like most calls to fs and gsp do.
+ */
+Benchmarks::Iteration SetupIPCRoundTrip() {
+    auto session = std::make_shared<IPCSession>();
+    auto [server, client] = session->kernel.CreateSessionPair();
+    session->context =
+        std::make_unique<Kernel::HLERequestContext>(session->kernel, std::move(server), nullptr);
+    session->process = session->kernel.CreateProcess(session->kernel.CreateCodeSet("", 0));
+
+    return [session] {
+        constexpr int num_round_trips = 1024;
+        auto& context = *session->context;
+        u32_le request[IPC::COMMAND_BUFFER_LENGTH]{};
+        u32_le reply[IPC::COMMAND_BUFFER_LENGTH]{};
+        for (int i = 0; i < num_round_trips; i++) {
+            request[0] = IPC::MakeHeader(0x0801, 3, 2);
+            request[1] = i;
+            request[2] = 0x12345678;
+            request[3] = 0xAABBCCDD;
+            request[4] = IPC::CallingPidDesc();
+            request[5] = 0;
+            context.PopulateFromIncomingCommandBuffer(request, session->process);
+
+            // The reply echoes the first parameter and the ID of the process
+            auto* cmd_buf = context.CommandBuffer();
+            const u32 value = cmd_buf[1];
+            const u32 process_id = cmd_buf[5];
+            cmd_buf[0] = IPC::MakeHeader(0x0801, 3, 0);
+            cmd_buf[1] = RESULT_SUCCESS.raw;
+            cmd_buf[2] = value;
+            cmd_buf[3] = process_id;
+            context.WriteToOutgoingCommandBuffer(reply, *session->process);
+        }
+        return static_cast<double>(num_round_trips);
+    };
+}
+
+/// Serializes the emulated memory, which is most of the size of a save state.
+Benchmarks::Iteration SetupSaveStateSerialize() {
+    auto memory = std::make_shared<Memory::MemorySystem>();
+    std::mt19937 rng(0x5A7E);
+    std::uniform_int_distribution<u32> word_dist;
+    // Titles use about half of FCRAM, the rest stays zero
+    u8* const fcram = memory->GetFCRAMPointer(0);
+    for (std::size_t offset = 0; offset < Memory::FCRAM_SIZE / 2; offset += sizeof(u32)) {
+        const u32 word = word_dist(rng);
+        std::memcpy(fcram + offset, &word, sizeof(word));
+    }
+    auto stream = std::make_shared<std::ostringstream>();
+
+    return [memory, stream] {
+        stream->str({});
+        {
+            oarchive oa{*stream};
+            oa&* memory;
+        }
+        return static_cast<double>(stream->tellp()) / MB;
+    };
+}
+
+/// Decrypts an encrypted RomFS in reads of the size the RomFS dumper uses.
+Benchmarks::Iteration SetupAESCTRDecrypt() {
+    constexpr std::size_t DataSize = 256 * 1024 * 1024;
+    constexpr std::size_t ReadSize = 16 * 1024 * 1024;
+    auto data = std::make_shared<std::vector<u8>>(DataSize);
+    std::mt19937 rng(0xAE5C);
+    HW::AES::AESKey key;
+    HW::AES::AESIV ctr;
+    for (auto& byte : key) {
+        byte = static_cast<u8>(rng());
+    }
+    for (auto& byte : ctr) {
+        byte = static_cast<u8>(rng());
+    }
+
+    return [data, key, ctr] {
+        for (std::size_t offset = 0; offset < data->size(); offset += ReadSize) {
+            HW::AES::DecryptCTR(key, ctr, offset, data->data() + offset, ReadSize);
+        }
+        return static_cast<double>(data->size()) / MB;
+    };
+}
+
+/// Writes a save file in the small chunks games write them in, then closes it.
+Benchmarks::Iteration SetupSaveDataSmallWrites() {
+    constexpr std::size_t FileSize = 512 * 1024;
+    constexpr std::size_t ChunkSize = 64;
+    // Removed along with the iteration
+    auto temp_directory = std::make_shared<Tests::TempDirectory>("benchmark_save");
+    const auto mount_point = (temp_directory->GetPath() / "data" / "").string();
+    const auto path = mount_point + "save.bin";
+    auto chunk = std::make_shared<std::vector<u8>>(ChunkSize);
+    std::mt19937 rng(0x5AD7);
+    for (auto& byte : *chunk) {
+        byte = static_cast<u8>(rng());
+    }
+    FileUtil::CreateFullPath(path);
+    FileUtil::CreateEmptyFile(path);
+
+    return [temp_directory, mount_point, path, chunk] {
+        FileSys::Mode mode{};
+        mode.read_flag.Assign(1);
+        mode.write_flag.Assign(1);
+        FileSys::WriteBehindFile file(path, mount_point, FileSize, mode, nullptr);
+        for (std::size_t offset = 0; offset < FileSize; offset += ChunkSize) {
+            file.Write(offset, ChunkSize, true, chunk->data());
+        }
+        file.Close();
+        return static_cast<double>(FileSize / ChunkSize);
+    };
+}
+
+/**
+ * Boots the emulated memory from a boot snapshot, the part of booting from one that grows with
+ * the memory of the title, and reads every page of it as a title does right after boot.
+ */
+Benchmarks::Iteration SetupBootSnapshotMemoryLoad() {
+    // The memory follows the compressed state, aligned like in boot snapshots
+    constexpr u64 MemoryOffset = 0x10000;
+    // Removed along with the iteration
+    auto temp_directory = std::make_shared<Tests::TempDirectory>("benchmark_boot_snapshot");
+    const auto path = (temp_directory->GetPath() / "snapshot.bin").string();
+    {
+        const Memory::MemorySystem memory;
+        const std::size_t memory_size = memory.GetSnapshotMemory().size();
+        // Titles use about half of FCRAM after boot, the rest is left as a hole
+        std::vector<u8> used(Memory::FCRAM_SIZE / 2);
+        std::mt19937 rng(0xB007);
+        std::uniform_int_distribution<u32> word_dist;
+        for (std::size_t offset = 0; offset < used.size(); offset += sizeof(u32)) {
+            const u32 word = word_dist(rng);
+            std::memcpy(used.data() + offset, &word, sizeof(word));
+        }
+        FileUtil::IOFile file(path, "wb");
+        file.Seek(MemoryOffset, SEEK_SET);
+        file.WriteBytes(used.data(), used.size());
+        file.Resize(MemoryOffset + memory_size);
+    }
+
+    return [temp_directory, path] {
+        constexpr std::size_t PageSize = 0x1000;
+        Memory::MemorySystem memory;
+        memory.LoadSnapshotMemory(path, MemoryOffset);
+        const std::span<const u8> snapshot_memory = memory.GetSnapshotMemory();
+        volatile u8 total = 0;
+        for (std::size_t offset = 0; offset < snapshot_memory.size(); offset += PageSize) {
+            total = total + snapshot_memory[offset];
+        }
+        return 1.0;
+    };
+}
+
+const Benchmarks::Registration registration{
+    {"Core::Timing schedule/cancel", "core", "events/s", 500e3, SetupTimingScheduleCancel},
+    {"IPC round-trip", "core", "round-trips/s", 100e3, SetupIPCRoundTrip},
+    {"Save state serialize", "core", "MB/s", 100.0, SetupSaveStateSerialize},
+    {"AES-CTR decryption", "core", "MB/s", 500.0, SetupAESCTRDecrypt},
+    {"Save data small writes", "core", "writes/s", 200e3, SetupSaveDataSmallWrites},
+    {"Boot snapshot memory load", "core", "boots/s", 20.0, SetupBootSnapshotMemoryLoad},
+};
+
+} // Anonymous namespace
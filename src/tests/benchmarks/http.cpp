@@ -0,0 +1,94 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// The requests are only sent by builds with web services, which the HTTP module needs
+#ifdef ENABLE_WEB_SERVICE
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <httplib.h>
+#include "core/hle/service/http_c.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace {
+
+/// Size of the responses, like the small JSON and image downloads of most titles
+constexpr std::size_t RESPONSE_SIZE = 16 * 1024;
+/// Contexts a title can have open at once
+constexpr std::size_t NUM_CONTEXTS = 8;
+
+/// A server on loopback that answers every request with the same response.
+struct LocalServer {
+    httplib::Server server;
+    std::thread thread;
+    int port = -1;
+
+    ~LocalServer() {
+        server.stop();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    bool Start() {
+        const std::string response(RESPONSE_SIZE, 'A');
+        server.Get("/data", [response](const httplib::Request&, httplib::Response& res) {
+            res.set_content(response, "application/octet-stream");
+        });
+        server.set_keep_alive_max_count(100);
+        port = server.bind_to_any_port("127.0.0.1");
+        if (port < 0) {
+            return false;
+        }
+        // Connections are accepted into the backlog of the socket until the server is listening
+        thread = std::thread([this] { server.listen_after_bind(); });
+        return true;
+    }
+};
+
+struct RequestLoad {
+    LocalServer server;
+    Service::HTTP::RequestQueue queue;
+    std::string url;
+};
+
+/**
+ * Sends as many requests as a title can have contexts, all queued at once and to the same host,
+ * like the downloads of the online features of most titles, and waits for their responses.
+ */
+Benchmarks::Iteration SetupHTTPRequests() {
+    auto load = std::make_shared<RequestLoad>();
+    if (!load->server.Start()) {
+        return [] { return 0.0; };
+    }
+    load->url = "http://127.0.0.1:" + std::to_string(load->server.port) + "/data";
+
+    return [load] {
+        std::vector<std::unique_ptr<Service::HTTP::Context>> contexts(NUM_CONTEXTS);
+        for (auto& context : contexts) {
+            context = std::make_unique<Service::HTTP::Context>();
+            context->url = load->url;
+            context->method = Service::HTTP::RequestMethod::Get;
+            load->queue.Queue(*context);
+        }
+        for (const auto& context : contexts) {
+            context->request_future.wait();
+            if (context->state != Service::HTTP::RequestState::ReadyToDownloadContent ||
+                context->body.size() != RESPONSE_SIZE) {
+                return 0.0;
+            }
+        }
+        return static_cast<double>(NUM_CONTEXTS);
+    };
+}
+
+const Benchmarks::Registration registration{
+    {"HTTP:C requests", "core", "requests/s", 2e3, SetupHTTPRequests},
+};
+
+} // Anonymous namespace
+
+#endif // ENABLE_WEB_SERVICE
@@ -0,0 +1,148 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "common/settings.h"
+#include "core/frontend/hid_input.h"
+#include "core/frontend/input.h"
+#include "input_common/hid_sampler.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace {
+
+/// A button that locks on every read, like the devices of controller backends do.
+class LockedButton final : public Input::ButtonDevice {
+public:
+    bool GetStatus() const override {
+        std::scoped_lock lock{mutex};
+        return pressed;
+    }
+
+    void Set(bool pressed_) {
+        std::scoped_lock lock{mutex};
+        pressed = pressed_;
+    }
+
+private:
+    mutable std::mutex mutex;
+    bool pressed = false;
+};
+
+class LockedButtonFactory final : public Input::Factory<Input::ButtonDevice> {
+public:
+    std::unique_ptr<Input::ButtonDevice> Create(const Common::ParamPackage&) override {
+        // The devices forward to the single button, so that every reader sees the same changes
+        class Forwarder final : public Input::ButtonDevice {
+        public:
+            explicit Forwarder(const LockedButton& button_) : button{button_} {}
+            bool GetStatus() const override {
+                return button.GetStatus();
+            }
+
+        private:
+            const LockedButton& button;
+        };
+        return std::make_unique<Forwarder>(button);
+    }
+
+    LockedButton button;
+};
+
+/// Maps the A button of the input profile to a locked button for the lifetime of the object.
+class LockedProfile {
+public:
+    LockedProfile() : factory{std::make_shared<LockedButtonFactory>()} {
+        auto& buttons = Settings::values.current_input_profile.buttons;
+        old_button = buttons[Settings::NativeButton::A];
+        buttons[Settings::NativeButton::A] = "engine:locked";
+        Input::RegisterFactory<Input::ButtonDevice>("locked", factory);
+    }
+
+    ~LockedProfile() {
+        Input::UnregisterFactory<Input::ButtonDevice>("locked");
+        Settings::values.current_input_profile.buttons[Settings::NativeButton::A] = old_button;
+    }
+
+    LockedButton& Button() {
+        return factory->button;
+    }
+
+private:
+    std::shared_ptr<LockedButtonFactory> factory;
+    std::string old_button;
+};
+
+struct PolledDevices {
+    LockedProfile profile;
+    Input::HIDDevices devices;
+};
+
+struct SampledDevices {
+    LockedProfile profile;
+    InputCommon::HIDSampler sampler;
+
+    SampledDevices() {
+        sampler.Start();
+    }
+
+    ~SampledDevices() {
+        sampler.Stop();
+    }
+};
+
+constexpr int NUM_READS = 1000;
+
+/// Reads every device on the emulation thread, as the HID module does without a sampler.
+Benchmarks::Iteration SetupHIDPolledRead() {
+    auto polled = std::make_shared<PolledDevices>();
+    polled->devices.Load();
+    return [polled] {
+        int num_pressed = 0;
+        for (int i = 0; i < NUM_READS; i++) {
+            num_pressed += polled->devices.Sample().IsPressed(Settings::NativeButton::A);
+        }
+        // The button is never pressed, counting it only keeps the reads
+        return static_cast<double>(NUM_READS + num_pressed);
+    };
+}
+
+/// Reads the latest snapshot of the sampler, as the HID module does on each update.
+Benchmarks::Iteration SetupHIDSampledRead() {
+    auto sampled = std::make_shared<SampledDevices>();
+    return [sampled] {
+        int num_pressed = 0;
+        for (int i = 0; i < NUM_READS; i++) {
+            num_pressed += sampled->sampler.Read().IsPressed(Settings::NativeButton::A);
+        }
+        // The button is never pressed, counting it only keeps the reads
+        return static_cast<double>(NUM_READS + num_pressed);
+    };
+}
+
+/**
+ * Changes the state of a button and waits for the snapshots of the sampler to show it, so that the
+ * throughput is the inverse of the mean time from a change to shared memory.
+ */
+Benchmarks::Iteration SetupHIDSamplerLatency() {
+    auto sampled = std::make_shared<SampledDevices>();
+    return [sampled, pressed = false]() mutable {
+        pressed = !pressed;
+        sampled->profile.Button().Set(pressed);
+        while (sampled->sampler.Read().IsPressed(Settings::NativeButton::A) != pressed) {
+            std::this_thread::yield();
+        }
+        return 1.0;
+    };
+}
+
+const Benchmarks::Registration registration{
+    {"HID polled read", "input_common", "reads/s", 200e3, SetupHIDPolledRead},
+    {"HID sampled read", "input_common", "reads/s", 10e6, SetupHIDSampledRead},
+    {"HID sampler time to snapshot", "input_common", "changes/s", 250.0, SetupHIDSamplerLatency},
+};
+
+} // Anonymous namespace
@@ -0,0 +1,195 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include <fmt/format.h>
+#include <json.hpp>
+#include "common/scm_rev.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace Benchmarks {
+
+namespace {
+
+std::vector<Benchmark>& Registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string filter;
+    std::string json_path;
+    bool check_budgets = false;
+    /// Measured time of each benchmark
+    std::chrono::milliseconds min_time{2000};
+};
+
+struct Result {
+    const Benchmark* benchmark;
+    double median;
+    double min;
+    double max;
+    std::size_t num_iterations;
+
+    [[nodiscard]] bool WithinBudget() const {
+        return median >= benchmark->budget;
+    }
+};
+
+constexpr std::size_t NUM_SAMPLES = 16;
+
+/**
+ * Runs a benchmark in samples of at least a sixteenth of the measured time each, after warming
+ * up for one sample, and reports the median throughput of the samples. The median is used so
+ * that a few samples slowed down by the host do not show up as regressions.
+ */
+Result Run(const Benchmark& benchmark, const Options& options) {
+    const Iteration iteration = benchmark.setup();
+    const Clock::duration sample_time = options.min_time / NUM_SAMPLES;
+
+    Result result{&benchmark, 0.0, 0.0, 0.0, 0};
+    const auto run_sample = [&] {
+        double work = 0.0;
+        const auto start = Clock::now();
+        Clock::duration elapsed{};
+        do {
+            work += iteration();
+            result.num_iterations++;
+            elapsed = Clock::now() - start;
+        } while (elapsed < sample_time);
+        return work / std::chrono::duration<double>(elapsed).count();
+    };
+
+    run_sample();
+    result.num_iterations = 0;
+
+    std::vector<double> throughputs(NUM_SAMPLES);
+    std::generate(throughputs.begin(), throughputs.end(), run_sample);
+    std::sort(throughputs.begin(), throughputs.end());
+    result.median = (throughputs[NUM_SAMPLES / 2 - 1] + throughputs[NUM_SAMPLES / 2]) / 2.0;
+    result.min = throughputs.front();
+    result.max = throughputs.back();
+    return result;
+}
+
+bool WriteJson(const std::string& path, const std::vector<Result>& results) {
+    nlohmann::ordered_json json;
+    json["scm_rev"] = std::string{Common::g_scm_rev};
+    json["scm_branch"] = std::string{Common::g_scm_branch};
+    json["build_name"] = std::string{Common::g_build_name};
+    auto& entries = json["benchmarks"];
+    entries = nlohmann::ordered_json::array();
+    for (const auto& result : results) {
+        entries.push_back({
+            {"name", result.benchmark->name},
+            {"subsystem", result.benchmark->subsystem},
+            {"unit", result.benchmark->unit},
+            {"median", result.median},
+            {"min", result.min},
+            {"max", result.max},
+            {"iterations", result.num_iterations},
+            {"budget", result.benchmark->budget},
+            {"within_budget", result.WithinBudget()},
+        });
+    }
+
+    std::ofstream file(path);
+    file << json.dump(4) << '\n';
+    return file.good();
+}
+
+void PrintUsage(const char* program) {
+    fmt::print(stderr,
+               "Usage: {} [options]\n"
+               "  --filter <text>      Only run the benchmarks whose name contains the text\n"
+               "  --json <path>        Write the results to a JSON file\n"
+               "  --min-time <ms>      Measured time of each benchmark, 2000 by default\n"
+               "  --check-budgets      Fail if a benchmark is below its budget\n"
+               "  --list               List the benchmarks without running them\n",
+               program);
+}
+
+} // Anonymous namespace
+
+const std::vector<Benchmark>& GetBenchmarks() {
+    return Registry();
+}
+
+Registration::Registration(std::initializer_list<Benchmark> benchmarks) {
+    Registry().insert(Registry().end(), benchmarks.begin(), benchmarks.end());
+}
+
+} // namespace Benchmarks
+
+int main(int argc, char** argv) {
+    Benchmarks::Options options;
+    bool list = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++i];
+        } else if (arg == "--min-time" && has_value) {
+            options.min_time = std::chrono::milliseconds(std::strtoll(argv[++i], nullptr, 10));
+        } else if (arg == "--check-budgets") {
+            options.check_budgets = true;
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            Benchmarks::PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.min_time.count() <= 0) {
+        Benchmarks::PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Static initialization order differs between builds, so the benchmarks are sorted to keep the
+    // results of every build in the same order.
+    std::vector<const Benchmarks::Benchmark*> benchmarks;
+    for (const auto& benchmark : Benchmarks::GetBenchmarks()) {
+        if (benchmark.name.find(options.filter) != std::string::npos) {
+            benchmarks.push_back(&benchmark);
+        }
+    }
+    std::sort(benchmarks.begin(), benchmarks.end(), [](const auto* lhs, const auto* rhs) {
+        return std::tie(lhs->subsystem, lhs->name) < std::tie(rhs->subsystem, rhs->name);
+    });
+
+    if (list) {
+        for (const auto* benchmark : benchmarks) {
+            fmt::print("{}/{} ({})\n", benchmark->subsystem, benchmark->name, benchmark->unit);
+        }
+        return 0;
+    }
+
+    std::vector<Benchmarks::Result> results;
+    for (const auto* benchmark : benchmarks) {
+        const auto& result = results.emplace_back(Benchmarks::Run(*benchmark, options));
+        fmt::print("{:<14} {:<36} {:>14.2f} {:<14} [{:.2f} - {:.2f}]{}\n", benchmark->subsystem,
+                   benchmark->name, result.median, benchmark->unit, result.min, result.max,
+                   result.WithinBudget() ? "" : " below budget");
+    }
+
+    if (!options.json_path.empty() && !Benchmarks::WriteJson(options.json_path, results)) {
+        fmt::print(stderr, "Could not write {}\n", options.json_path);
+        return 1;
+    }
+
+    const bool within_budgets = std::all_of(
+        results.begin(), results.end(), [](const auto& result) { return result.WithinBudget(); });
+    return options.check_budgets && !within_budgets ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "enet/enet.h"
+#include "network/packet.h"
+#include "network/room.h"
+#include "network/room_member.h"
+#include "network/verify_user.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace {
+
+/// Members of a room playing a local multiplayer game, like the largest UDS networks
+constexpr std::size_t NUM_MEMBERS = 8;
+/// Size of the 802.11 frames of UDS data, as sent by most titles
+constexpr std::size_t DATA_FRAME_SIZE = 512;
+
+/// A member of the room that speaks the protocol of the room directly, without a RoomMember.
+struct SimulatedMember {
+    ENetHost* client = nullptr;
+    ENetPeer* server = nullptr;
+    Network::MacAddress mac_address{};
+    bool joined = false;
+    std::size_t num_received = 0;
+};
+
+/**
+ * A room serviced on the thread of the benchmark, with members that connect to it over loopback.
+ * The room and the members are serviced in turn, so that the measured time is the time spent by
+ * the relay and ENet rather than the time spent waiting for other threads.
+ */
+struct RelayLoad {
+    std::shared_ptr<Network::Room> room =
+        std::make_shared<Network::Room>(Network::Room::ServiceMode::External);
+    std::vector<SimulatedMember> members;
+
+    ~RelayLoad() {
+        for (auto& member : members) {
+            if (member.client) {
+                enet_host_destroy(member.client);
+            }
+        }
+        room->Destroy();
+        enet_deinitialize();
+    }
+
+    bool Open(u16 port) {
+        if (enet_initialize() != 0) {
+            return false;
+        }
+        if (!room->Create("benchmark", "", "127.0.0.1", port, "", NUM_MEMBERS, "", "benchmark", 0,
+                          std::make_unique<Network::VerifyUser::NullBackend>())) {
+            return false;
+        }
+
+        ENetAddress address;
+        enet_address_set_host(&address, "127.0.0.1");
+        address.port = port;
+        members.resize(NUM_MEMBERS);
+        for (std::size_t i = 0; i < NUM_MEMBERS; i++) {
+            auto& member = members[i];
+            member.client = enet_host_create(nullptr, 1, Network::NumChannels, 0, 0);
+            if (!member.client) {
+                return false;
+            }
+            member.server = enet_host_connect(member.client, &address, Network::NumChannels, 0);
+            if (!member.server) {
+                return false;
+            }
+            const bool connected =
+                Pump([&member] { return member.server->state == ENET_PEER_STATE_CONNECTED; });
+            if (!connected) {
+                return false;
+            }
+
+            Network::Packet packet;
+            packet << static_cast<u8>(Network::IdJoinRequest);
+            packet << "member" + std::to_string(i);
+            packet << "console" + std::to_string(i);
+            packet << Network::NoPreferredMac;
+            packet << Network::network_version;
+            packet << std::string{};
+            packet << std::string{};
+            Send(member, packet, ENET_PACKET_FLAG_RELIABLE);
+            if (!Pump([&member] { return member.joined; })) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void Send(SimulatedMember& member, const Network::Packet& packet, u32 flags) {
+        enet_peer_send(member.server, 0,
+                       enet_packet_create(packet.GetData(), packet.GetDataSize(), flags));
+        enet_host_flush(member.client);
+    }
+
+    /// Sends a UDS data frame from a member to another.
+    void SendData(std::size_t from, std::size_t to) {
+        const std::vector<u8> frame(DATA_FRAME_SIZE, 0xA5);
+
+        Network::Packet packet;
+        packet << static_cast<u8>(Network::IdWifiPacket);
+        packet << static_cast<u8>(Network::WifiPacket::PacketType::Data);
+        packet << static_cast<u8>(1); // Channel
+        packet << members[from].mac_address;
+        packet << members[to].mac_address;
+        packet << frame;
+        Send(members[from], packet, ENET_PACKET_FLAG_RELIABLE);
+    }
+
+    /// Services the room and the members until the condition holds, for at most a second.
+    template <typename Condition>
+    bool Pump(Condition&& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            room->Service();
+            for (auto& member : members) {
+                if (member.client) {
+                    ServiceMember(member);
+                }
+            }
+        }
+        return true;
+    }
+
+    static void ServiceMember(SimulatedMember& member) {
+        ENetEvent event;
+        while (enet_host_service(member.client, &event, 0) > 0) {
+            if (event.type != ENET_EVENT_TYPE_RECEIVE) {
+                continue;
+            }
+            switch (event.packet->data[0]) {
+            case Network::IdJoinSuccess:
+                std::memcpy(member.mac_address.data(), event.packet->data + 1,
+                            sizeof(Network::MacAddress));
+                member.joined = true;
+                break;
+            case Network::IdWifiPacket:
+                member.num_received++;
+                break;
+            }
+            enet_packet_destroy(event.packet);
+        }
+    }
+};
+
+/**
+ * Relays UDS data frames between the members of a room, every member sending a burst of frames
+ * to the next one, as the host and the clients of a local multiplayer game do every frame.
+ */
+Benchmarks::Iteration SetupRelayUnicast() {
+    auto load = std::make_shared<RelayLoad>();
+    if (!load->Open(24891)) {
+        return [] { return 0.0; };
+    }
+
+    return [load] {
+        constexpr std::size_t frames_per_member = 64;
+        for (auto& member : load->members) {
+            member.num_received = 0;
+        }
+        for (std::size_t i = 0; i < frames_per_member; i++) {
+            for (std::size_t from = 0; from < NUM_MEMBERS; from++) {
+                load->SendData(from, (from + 1) % NUM_MEMBERS);
+            }
+        }
+        const bool received = load->Pump([&load] {
+            for (const auto& member : load->members) {
+                if (member.num_received < frames_per_member) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        return received ? static_cast<double>(frames_per_member * NUM_MEMBERS) : 0.0;
+    };
+}
+
+/**
+ * Bounces a UDS data frame between two members of a room through the relay. Each round trip is
+ * two hops through the room, so the latency of a hop is half the inverse of the throughput.
+ */
+Benchmarks::Iteration SetupRelayPingPong() {
+    auto load = std::make_shared<RelayLoad>();
+    if (!load->Open(24892)) {
+        return [] { return 0.0; };
+    }
+
+    return [load] {
+        constexpr std::size_t num_round_trips = 256;
+        auto& ping = load->members[0];
+        auto& pong = load->members[1];
+        for (std::size_t i = 0; i < num_round_trips; i++) {
+            ping.num_received = 0;
+            pong.num_received = 0;
+            load->SendData(0, 1);
+            if (!load->Pump([&pong] { return pong.num_received > 0; })) {
+                return 0.0;
+            }
+            load->SendData(1, 0);
+            if (!load->Pump([&ping] { return ping.num_received > 0; })) {
+                return 0.0;
+            }
+        }
+        return static_cast<double>(num_round_trips);
+    };
+}
+
+const Benchmarks::Registration registration{
+    {"Room Wi-Fi relay unicast", "network", "packets/s", 50e3, SetupRelayUnicast},
+    {"Room Wi-Fi relay ping-pong", "network", "round-trips/s", 5e3, SetupRelayPingPong},
+};
+
+} // Anonymous namespace
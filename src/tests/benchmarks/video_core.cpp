@@ -0,0 +1,379 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "common/arch.h"
+#include "core/memory.h"
+#include "tests/benchmarks/benchmark.h"
+#include "video_core/index_kernels.h"
+#include "video_core/pica_state.h"
+#include "video_core/rasterizer_cache/index_range_cache.h"
+#include "video_core/rasterizer_cache/texture_codec.h"
+#include "video_core/renderer_software/sw_clipper.h"
+#include "video_core/shader/shader.h"
+#include "video_core/video_core.h"
+#if CITRA_ARCH(x86_64)
+#include <nihstro/inline_assembly.h>
+#include "video_core/shader/shader_jit_x64_compiler.h"
+#endif
+
+namespace {
+
+using Pica::float24;
+
+constexpr double MB = 1000.0 * 1000.0;
+
+/// Returns the raw value of a float24 register holding a normal float.
+u32 ToFloat24Raw(float value) {
+    u32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const u32 sign = bits >> 31;
+    const u32 exponent = ((bits >> 23) & 0xFF) - 127 + 63;
+    const u32 mantissa = (bits & 0x7FFFFF) >> 7;
+    return sign << 23 | exponent << 16 | mantissa;
+}
+
+#if CITRA_ARCH(x86_64)
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+
+/**
+ * A vertex shader that transforms the position by a matrix and lights the vertex with one
+ * directional light, as most vertex shaders of titles do.
+ */
+std::unique_ptr<Pica::Shader::ShaderSetup> CompileVertexShader() {
+    const auto v_position = SourceRegister::MakeInput(0);
+    const auto v_normal = SourceRegister::MakeInput(1);
+    const auto v_color = SourceRegister::MakeInput(2);
+    const auto o_position = DestRegister::MakeOutput(0);
+    const auto o_color = DestRegister::MakeOutput(1);
+    const auto o_normal = DestRegister::MakeOutput(2);
+    const auto c = [](int index) { return SourceRegister::MakeFloat(index); };
+    const auto r = [](int index) { return SourceRegister::MakeTemporary(index); };
+    const auto w = [](int index) { return DestRegister::MakeTemporary(index); };
+
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary({
+        // clang-format off
+        {OpCode::Id::DP4, w(0), c(0), v_position},
+        {OpCode::Id::DP4, w(1), c(1), v_position},
+        {OpCode::Id::DP4, w(2), c(2), v_position},
+        {OpCode::Id::DP4, w(3), c(3), v_position},
+        {OpCode::Id::RCP, w(4), r(3)},
+        {OpCode::Id::MUL, w(0), r(0), r(4)},
+        {OpCode::Id::MUL, w(1), r(1), r(4)},
+        {OpCode::Id::MUL, w(2), r(2), r(4)},
+        {OpCode::Id::DP3, w(5), c(4), v_normal},
+        {OpCode::Id::DP3, w(6), c(5), v_normal},
+        {OpCode::Id::DP3, w(7), c(6), v_normal},
+        {OpCode::Id::DP3, w(8), r(5), r(5)},
+        {OpCode::Id::RSQ, w(8), r(8)},
+        {OpCode::Id::MUL, w(5), r(5), r(8)},
+        {OpCode::Id::DP3, w(9), c(7), r(5)},
+        {OpCode::Id::MAX, w(9), c(8), r(9)},
+        {OpCode::Id::MUL, w(10), c(9), r(9)},
+        {OpCode::Id::ADD, w(10), c(10), r(10)},
+        {OpCode::Id::MUL, w(10), r(10), v_color},
+        {OpCode::Id::MIN, w(10), c(11), r(10)},
+        {OpCode::Id::MOV, o_position, r(0)},
+        {OpCode::Id::MOV, o_color, r(10)},
+        {OpCode::Id::MOV, o_normal, r(5)},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+
+    auto setup = std::make_unique<Pica::Shader::ShaderSetup>();
+    std::transform(shbin.program.begin(), shbin.program.end(), setup->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   setup->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+
+    std::mt19937 rng(0x5ADE);
+    std::uniform_real_distribution<float> uniform_dist(-1.0f, 1.0f);
+    for (auto& uniform : setup->uniforms.f) {
+        for (std::size_t i = 0; i < 4; i++) {
+            uniform[i] = float24::FromFloat32(uniform_dist(rng));
+        }
+    }
+    return setup;
+}
+
+/// Compiles the vertex shader from scratch, as happens whenever a title binds a new shader.
+Benchmarks::Iteration SetupShaderJitCompile() {
+    std::shared_ptr<Pica::Shader::ShaderSetup> setup = CompileVertexShader();
+    return [setup] {
+        constexpr int num_shaders = 16;
+        for (int i = 0; i < num_shaders; i++) {
+            auto shader = std::make_unique<Pica::Shader::JitShader>();
+            shader->Compile(&setup->program_code, &setup->swizzle_data);
+        }
+        return static_cast<double>(num_shaders);
+    };
+}
+
+struct ShaderBatch {
+    std::unique_ptr<Pica::Shader::ShaderSetup> setup;
+    Pica::Shader::JitShader shader;
+    std::vector<std::array<Common::Vec4<float24>, 3>> inputs;
+    Pica::Shader::UnitState unit;
+};
+
+/// Runs the vertex shader over a batch of vertices, as a draw does.
+Benchmarks::Iteration SetupShaderJitRun() {
+    auto batch = std::make_shared<ShaderBatch>();
+    batch->setup = CompileVertexShader();
+    batch->shader.Compile(&batch->setup->program_code, &batch->setup->swizzle_data);
+
+    std::mt19937 rng(0x7E87);
+    std::uniform_real_distribution<float> attribute_dist(-1.0f, 1.0f);
+    batch->inputs.resize(4096);
+    for (auto& input : batch->inputs) {
+        for (auto& attribute : input) {
+            for (std::size_t i = 0; i < 4; i++) {
+                attribute[i] = float24::FromFloat32(attribute_dist(rng));
+            }
+        }
+        input[0].w = float24::FromFloat32(1.0f);
+    }
+
+    return [batch] {
+        auto& unit = batch->unit;
+        for (const auto& input : batch->inputs) {
+            std::copy(input.begin(), input.end(), unit.registers.input.begin());
+            batch->shader.Run(*batch->setup, unit, 0);
+        }
+        return static_cast<double>(batch->inputs.size());
+    };
+}
+
+#endif // CITRA_ARCH(x86_64)
+
+struct TriangleStream {
+    std::unique_ptr<Memory::MemorySystem> memory;
+    std::vector<Pica::Shader::OutputVertex> vertices;
+};
+
+/**
+ * Draws small, depth tested triangles of a single color to a framebuffer the size of the top
+ * screen, like the meshes of a 3D scene without textures.
+ */
+Benchmarks::Iteration SetupSoftwareRasterizer() {
+    auto stream = std::make_shared<TriangleStream>();
+    stream->memory = std::make_unique<Memory::MemorySystem>();
+
+    constexpr u32 width = 400;
+    constexpr u32 height = 240;
+    auto& regs = Pica::g_state.regs;
+    regs.rasterizer.cull_mode.Assign(Pica::RasterizerRegs::CullMode::KeepAll);
+    regs.rasterizer.viewport_size_x.Assign(ToFloat24Raw(width / 2.0f));
+    regs.rasterizer.viewport_size_y.Assign(ToFloat24Raw(height / 2.0f));
+    regs.rasterizer.viewport_depth_range.Assign(ToFloat24Raw(-1.0f));
+    regs.lighting.disable.Assign(1);
+
+    auto& framebuffer = regs.framebuffer.framebuffer;
+    framebuffer.color_buffer_address.Assign(Memory::VRAM_PADDR / 8);
+    framebuffer.depth_buffer_address.Assign((Memory::VRAM_PADDR + 0x100000) / 8);
+    framebuffer.width.Assign(width);
+    framebuffer.height.Assign(height - 1);
+    framebuffer.color_format.Assign(Pica::FramebufferRegs::ColorFormat::RGBA8);
+    framebuffer.depth_format.Assign(Pica::FramebufferRegs::DepthFormat::D24);
+    framebuffer.allow_color_write.Assign(0xF);
+    framebuffer.allow_depth_stencil_write.Assign(0x3);
+
+    auto& output_merger = regs.framebuffer.output_merger;
+    output_merger.depth_test_enable.Assign(1);
+    output_merger.depth_test_func.Assign(Pica::FramebufferRegs::CompareFunc::LessThan);
+    output_merger.depth_write_enable.Assign(1);
+    output_merger.red_enable.Assign(1);
+    output_merger.green_enable.Assign(1);
+    output_merger.blue_enable.Assign(1);
+    output_merger.alpha_enable.Assign(1);
+
+    std::mt19937 rng(0x7A1A);
+    std::uniform_real_distribution<float> center_dist(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> offset_dist(-0.06f, 0.06f);
+    std::uniform_real_distribution<float> depth_dist(-1.0f, 0.0f);
+    std::uniform_real_distribution<float> color_dist(0.0f, 1.0f);
+    stream->vertices.resize(3 * 4096);
+    for (std::size_t i = 0; i < stream->vertices.size(); i += 3) {
+        const float x = center_dist(rng);
+        const float y = center_dist(rng);
+        const float z = depth_dist(rng);
+        for (std::size_t j = 0; j < 3; j++) {
+            auto& vertex = stream->vertices[i + j];
+            vertex = {};
+            vertex.pos = Common::MakeVec(float24::FromFloat32(x + offset_dist(rng)),
+                                         float24::FromFloat32(y + offset_dist(rng)),
+                                         float24::FromFloat32(z), float24::FromFloat32(1.0f));
+            vertex.color = Common::MakeVec(
+                float24::FromFloat32(color_dist(rng)), float24::FromFloat32(color_dist(rng)),
+                float24::FromFloat32(color_dist(rng)), float24::FromFloat32(1.0f));
+        }
+    }
+
+    return [stream] {
+        VideoCore::g_memory = stream->memory.get();
+        const auto& vertices = stream->vertices;
+        for (std::size_t i = 0; i < vertices.size(); i += 3) {
+            Pica::Clipper::ProcessTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+        }
+        return static_cast<double>(vertices.size() / 3);
+    };
+}
+
+struct MortonTexture {
+    std::vector<u8> linear;
+    std::vector<u8> tiled;
+};
+
+constexpr u32 MORTON_TEXTURE_SIZE = 512;
+
+std::shared_ptr<MortonTexture> GenerateMortonTexture() {
+    constexpr std::size_t size = MORTON_TEXTURE_SIZE * MORTON_TEXTURE_SIZE * 4;
+    auto texture = std::make_shared<MortonTexture>();
+    texture->linear.resize(size);
+    texture->tiled.resize(size);
+    std::mt19937 rng(0x30E7);
+    std::generate(texture->tiled.begin(), texture->tiled.end(), rng);
+    return texture;
+}
+
+/// Converts an RGBA8 texture from the tiled layout of the PICA, as texture uploads do.
+Benchmarks::Iteration SetupMortonUnswizzle() {
+    return [texture = GenerateMortonTexture()] {
+        const u32 size = static_cast<u32>(texture->tiled.size());
+        VideoCore::MortonCopy<true, VideoCore::PixelFormat::RGBA8>(
+            MORTON_TEXTURE_SIZE, MORTON_TEXTURE_SIZE, 0, size, texture->linear, texture->tiled);
+        return size / MB;
+    };
+}
+
+/// Converts an RGBA8 texture to the tiled layout of the PICA, as surface downloads do.
+Benchmarks::Iteration SetupMortonSwizzle() {
+    return [texture = GenerateMortonTexture()] {
+        const u32 size = static_cast<u32>(texture->tiled.size());
+        VideoCore::MortonCopy<false, VideoCore::PixelFormat::RGBA8>(
+            MORTON_TEXTURE_SIZE, MORTON_TEXTURE_SIZE, 0, size, texture->linear, texture->tiled);
+        return size / MB;
+    };
+}
+
+/// An indexed draw, as recorded from the PICA registers.
+struct Draw {
+    PAddr addr;
+    u32 count;
+    bool index_u16;
+};
+
+/// A frame worth of draws over the index buffers stored in memory.
+struct DrawStream {
+    std::vector<u8> memory;
+    std::vector<Draw> draws;
+};
+
+/**
+ * Generates the draws of a frame in which most meshes are drawn a few times, once per pass or
+ * per bone palette, as games do with skinned meshes.
+ */
+std::shared_ptr<DrawStream> GenerateDrawStream() {
+    std::mt19937 rng(0x1DE7);
+    std::uniform_int_distribution<u32> count_dist(24, 3000);
+    std::uniform_int_distribution<u32> repeat_dist(1, 6);
+    std::uniform_int_distribution<u32> format_dist(0, 3);
+    std::uniform_int_distribution<u32> vertex_dist(0, 0xFFFF);
+
+    auto stream = std::make_shared<DrawStream>();
+    std::vector<Draw> meshes;
+    for (int mesh = 0; mesh < 96; mesh++) {
+        const bool index_u16 = format_dist(rng) != 0;
+        const u32 count = count_dist(rng);
+        const u32 first_vertex = vertex_dist(rng) % (index_u16 ? 0xF000 : 0xC0);
+        const u32 num_vertices = index_u16 ? count / 2 : 64;
+        // Keep the buffers 2-byte aligned, like the hardware requires for u16 indices
+        const PAddr addr = static_cast<PAddr>(stream->memory.size());
+        for (u32 i = 0; i < count; i++) {
+            const u32 vertex = first_vertex + vertex_dist(rng) % num_vertices;
+            stream->memory.push_back(static_cast<u8>(vertex));
+            if (index_u16) {
+                stream->memory.push_back(static_cast<u8>(vertex >> 8));
+            }
+        }
+        stream->memory.resize((stream->memory.size() + 1) & ~std::size_t{1});
+        meshes.push_back({addr, count, index_u16});
+    }
+    for (const Draw& mesh : meshes) {
+        const u32 repeats = repeat_dist(rng);
+        for (u32 i = 0; i < repeats; i++) {
+            stream->draws.push_back(mesh);
+        }
+    }
+    std::shuffle(stream->draws.begin(), stream->draws.end(), rng);
+    return stream;
+}
+
+VideoCore::Kernels::IndexRange Scan(const VideoCore::Kernels::KernelSet& kernels,
+                                    const u8* indices, const Draw& draw) {
+    return draw.index_u16 ? kernels.index_range_u16(indices, draw.count)
+                          : kernels.index_range_u8(indices, draw.count);
+}
+
+/// Scans the index buffers of every draw of a frame for their range of vertices.
+Benchmarks::Iteration SetupIndexRangeScan(const VideoCore::Kernels::KernelSet& kernels) {
+    return [stream = GenerateDrawStream(), &kernels] {
+        u64 num_indices = 0;
+        for (const Draw& draw : stream->draws) {
+            Scan(kernels, stream->memory.data() + draw.addr, draw);
+            num_indices += draw.count;
+        }
+        return static_cast<double>(num_indices);
+    };
+}
+
+Benchmarks::Iteration SetupIndexRangeScanGeneric() {
+    return SetupIndexRangeScan(VideoCore::Kernels::GetGenericKernels());
+}
+
+Benchmarks::Iteration SetupIndexRangeScanBest() {
+    return SetupIndexRangeScan(VideoCore::Kernels::GetKernels());
+}
+
+/// Finds the range of the draws of a frame in the index range cache, scanning on misses.
+Benchmarks::Iteration SetupIndexRangeCache() {
+    return [stream = GenerateDrawStream(), &kernels = VideoCore::Kernels::GetKernels()] {
+        // Every frame starts with an empty cache, as if all buffers had been rewritten
+        VideoCore::IndexRangeCache cache;
+        u64 num_indices = 0;
+        for (const Draw& draw : stream->draws) {
+            auto range = cache.Find(draw.addr, draw.count, draw.index_u16);
+            if (!range) {
+                range = Scan(kernels, stream->memory.data() + draw.addr, draw);
+                if (cache.ShouldInsert(draw.addr, draw.count)) {
+                    cache.Insert(draw.addr, draw.count, draw.index_u16, *range);
+                }
+            }
+            num_indices += draw.count;
+        }
+        return static_cast<double>(num_indices);
+    };
+}
+
+const Benchmarks::Registration registration{
+#if CITRA_ARCH(x86_64)
+    {"Shader JIT compile", "video_core", "shaders/s", 2e3, SetupShaderJitCompile},
+    {"Shader JIT run", "video_core", "vertices/s", 1e6, SetupShaderJitRun},
+#endif
+    {"Software rasterizer", "video_core", "triangles/s", 2e3, SetupSoftwareRasterizer},
+    {"Morton unswizzle RGBA8", "video_core", "MB/s", 200.0, SetupMortonUnswizzle},
+    {"Morton swizzle RGBA8", "video_core", "MB/s", 200.0, SetupMortonSwizzle},
+    {"Index range scan generic", "video_core", "indices/s", 100e6, SetupIndexRangeScanGeneric},
+    {"Index range scan", "video_core", "indices/s", 200e6, SetupIndexRangeScanBest},
+    {"Index range cache", "video_core", "indices/s", 200e6, SetupIndexRangeCache},
+};
+
+} // Anonymous namespace
@@ -0,0 +1,134 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "common/host_memory.h"
+
+namespace {
+
+/// Offset of the memory in the files, like the memory of boot snapshots that follows their state
+constexpr u64 MEMORY_OFFSET = 0x10000;
+
+std::string WriteMemoryFile(const std::string& name, std::size_t size) {
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::vector<u8> contents(MEMORY_OFFSET + size);
+    for (std::size_t i = 0; i < contents.size(); i++) {
+        contents[i] = static_cast<u8>(i * 7 + i / 4096);
+    }
+    FileUtil::IOFile file(path, "wb");
+    REQUIRE(file.WriteBytes(contents.data(), contents.size()) == contents.size());
+    return path;
+}
+
+/// Returns the dirty pages mapped only by this process in KiB, which is the memory an instance of
+/// the emulator does not share with others, or 0 if the host does not report it.
+s64 GetPrivateMemory() {
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string key;
+    s64 value;
+    while (smaps >> key >> value) {
+        if (key == "Private_Dirty:") {
+            return value;
+        }
+        smaps.ignore(256, '\n');
+    }
+    return 0;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("HostMemory::MapFile", "[common]") {
+    const std::size_t size = 16 * Common::HostMemory::HostPageSize();
+    const std::string path = WriteMemoryFile("citra_host_memory_test.bin", size);
+    std::vector<u8> expected(size);
+    {
+        FileUtil::IOFile file(path, "rb");
+        REQUIRE(file.Seek(MEMORY_OFFSET, SEEK_SET));
+        REQUIRE(file.ReadBytes(expected.data(), size) == size);
+    }
+
+    SECTION("the file is mapped copy-on-write") {
+        Common::HostMemory memory(size);
+        if (!memory.MapFile(path, MEMORY_OFFSET)) {
+#ifndef _WIN32
+            FAIL("Mapping files is supported on POSIX hosts");
+#endif
+            return;
+        }
+        REQUIRE(std::memcmp(memory.BackingBasePointer(), expected.data(), size) == 0);
+        REQUIRE_FALSE(memory.IsShareable());
+
+        memory.BackingBasePointer()[0] ^= 0xFF;
+        memory.BackingBasePointer()[size - 1] ^= 0xFF;
+        std::vector<u8> contents(size);
+        FileUtil::IOFile file(path, "rb");
+        REQUIRE(file.Seek(MEMORY_OFFSET, SEEK_SET));
+        REQUIRE(file.ReadBytes(contents.data(), size) == size);
+        REQUIRE(contents == expected);
+    }
+
+    SECTION("files that are too small are not mapped") {
+        Common::HostMemory memory(size);
+        REQUIRE_FALSE(memory.MapFile(path, MEMORY_OFFSET * 2));
+        REQUIRE(std::all_of(memory.BackingBasePointer(), memory.BackingBasePointer() + size,
+                            [](u8 value) { return value == 0; }));
+    }
+
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("HostMemory::MapFile: boot snapshot memory", "[common][.benchmark]") {
+    // About the size of the FCRAM of a New 3DS
+    constexpr std::size_t size = 0x10000000;
+    const std::string path = WriteMemoryFile("citra_host_memory_benchmark.bin", size);
+    const std::size_t page_size = Common::HostMemory::HostPageSize();
+
+    // Every page is read, as a title reads most of its memory shortly after boot
+    const auto touch = [page_size](const Common::HostMemory& memory) {
+        u64 total = 0;
+        for (std::size_t offset = 0; offset < memory.Size(); offset += page_size) {
+            total += memory.BackingBasePointer()[offset];
+        }
+        return total;
+    };
+
+    BENCHMARK("read") {
+        Common::HostMemory memory(size);
+        FileUtil::IOFile file(path, "rb");
+        file.Seek(MEMORY_OFFSET, SEEK_SET);
+        file.ReadBytes(memory.BackingBasePointer(), size);
+        return touch(memory);
+    };
+
+    BENCHMARK("map") {
+        Common::HostMemory memory(size);
+        memory.MapFile(path, MEMORY_OFFSET);
+        return touch(memory);
+    };
+
+    const s64 base = GetPrivateMemory();
+    {
+        Common::HostMemory memory(size);
+        FileUtil::IOFile file(path, "rb");
+        file.Seek(MEMORY_OFFSET, SEEK_SET);
+        file.ReadBytes(memory.BackingBasePointer(), size);
+        WARN("Private memory when read: " << GetPrivateMemory() - base << " KiB");
+    }
+    {
+        Common::HostMemory memory(size);
+        memory.MapFile(path, MEMORY_OFFSET);
+        touch(memory);
+        WARN("Private memory when mapped: " << GetPrivateMemory() - base << " KiB");
+    }
+
+    FileUtil::Delete(path);
+}
@@ -0,0 +1,130 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
+#include "common/logging/log.h"
+
+namespace {
+
+enum class TestEnum : u16 { Value = 0x1234 };
+
+/// Encodes args the way FmtLogMessage does and builds the record the logging thread would see.
+template <typename... Args>
+Log::Record MakeRecord(std::vector<u8>& storage, const char* format, const Args&... args) {
+    static_assert((Log::Detail::IsDeferrable<Args>() && ...));
+    storage.resize((Log::Detail::EncodedArgSize(args) + ... + 0));
+    [[maybe_unused]] u8* out = storage.data();
+    ((out = Log::Detail::EncodeArg(out, args)), ...);
+
+    Log::Record record{};
+    record.log_class = Log::Class::Service_FS;
+    record.log_level = Log::Level::Trace;
+    record.filename = "tests/common/logging.cpp";
+    record.line_num = 42;
+    record.function = "MakeRecord";
+    record.format = format;
+    record.num_args = sizeof...(Args);
+    const u8* in = storage.data();
+    for (std::size_t i = 0; i < record.num_args; i++) {
+        in = Log::DecodeArg(in, record.args[i]);
+    }
+    return record;
+}
+
+template <typename... Args>
+void CheckDeferredFormat(const char* format, const Args&... args) {
+    std::vector<u8> storage;
+    const Log::Record record = MakeRecord(storage, format, args...);
+    REQUIRE(Log::CreateEntry(record).message == fmt::format(fmt::runtime(format), args...));
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Deferred log arguments format like fmt", "[common]") {
+    const std::string string = "string";
+    char buffer[16] = "char array";
+    u32 value = 0xDEADBEEF;
+
+    CheckDeferredFormat("no arguments");
+    CheckDeferredFormat("{} {} {} {}", true, 'c', static_cast<s8>(-5), static_cast<u8>(250));
+    CheckDeferredFormat("{:08X} {:#x} {}", value, static_cast<s64>(-1), static_cast<u64>(-1));
+    CheckDeferredFormat("{} {} {:.3f}", 0.1f, 0.1, 2.5f);
+    CheckDeferredFormat("{} {} {} {}", string, std::string_view{string}, buffer, "literal");
+    CheckDeferredFormat("{:>10}|{:<4}|", string.c_str(), "");
+    CheckDeferredFormat("{} {:04X}", TestEnum::Value, TestEnum::Value);
+    CheckDeferredFormat("{}", static_cast<const void*>(&value));
+
+    SECTION("invalid format strings are reported instead of thrown") {
+        std::vector<u8> storage;
+        const Log::Record record = MakeRecord(storage, "{} {}", 1);
+        REQUIRE(Log::CreateEntry(record).message.starts_with("Invalid log format string"));
+    }
+}
+
+TEST_CASE("Binary log files round trip", "[common]") {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_binary_log_test.bin").string();
+
+    std::vector<u8> storage[3];
+    const Log::Record records[] = {
+        MakeRecord(storage[0], "Opened {} with mode {:#x}", "sdmc:/file", 3u),
+        MakeRecord(storage[1], "Opened {} with mode {:#x}", "sdmc:/other", 1u),
+        MakeRecord(storage[2], "{} {} {}", 1.5, false, 'x'),
+    };
+    {
+        Log::BinaryLogWriter writer(path);
+        REQUIRE(writer.IsOpen());
+        for (const auto& record : records) {
+            writer.Write(record);
+        }
+    }
+
+    Log::BinaryLogReader reader(path);
+    REQUIRE(reader.IsOpen());
+    Log::Record record{};
+    for (const auto& expected : records) {
+        REQUIRE(reader.Read(record));
+        const Log::Entry actual_entry = Log::CreateEntry(record);
+        const Log::Entry expected_entry = Log::CreateEntry(expected);
+        REQUIRE(actual_entry.message == expected_entry.message);
+        REQUIRE(actual_entry.log_class == expected_entry.log_class);
+        REQUIRE(actual_entry.log_level == expected_entry.log_level);
+        REQUIRE(std::string(actual_entry.filename) == expected_entry.filename);
+        REQUIRE(actual_entry.function == expected_entry.function);
+        REQUIRE(actual_entry.line_num == expected_entry.line_num);
+    }
+    REQUIRE(!reader.Read(record));
+    REQUIRE(reader.IsAtEnd());
+
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("Trace logging overhead", "[common][.benchmark]") {
+    Log::SetGlobalFilter(Log::Filter(Log::Level::Trace));
+    const std::string path = "sdmc:/Nintendo 3DS/save.bin";
+    u64 offset = 0;
+    const int length = 0x200;
+
+    BENCHMARK("Formatted on the calling thread") {
+        Log::FmtLogMessageImpl(Log::Class::Service_FS, Log::Level::Trace, __FILE__, __LINE__,
+                               __func__, "Read {} at offset {:#x}, length {}",
+                               fmt::make_format_args(path, offset, length));
+        return ++offset;
+    };
+
+    BENCHMARK("Deferred to the logging thread") {
+        Log::FmtLogMessage(Log::Class::Service_FS, Log::Level::Trace, __FILE__, __LINE__,
+                           __func__, "Read {} at offset {:#x}, length {}", path, offset, length);
+        return ++offset;
+    };
+
+    Log::SetGlobalFilter(Log::Filter());
+}
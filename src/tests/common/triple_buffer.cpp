@@ -0,0 +1,50 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+#include "common/triple_buffer.h"
+
+namespace {
+
+/// A value that is only consistent if it was not written to while being read.
+struct Sample {
+    u64 sequence;
+    u64 check;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("TripleBuffer", "[common]") {
+    Common::TripleBuffer<Sample> buffer;
+    REQUIRE(buffer.Read().sequence == 0);
+
+    buffer.WriteBuffer() = {1, ~u64{1}};
+    buffer.Publish();
+    buffer.WriteBuffer() = {2, ~u64{2}};
+    buffer.Publish();
+    REQUIRE(buffer.Read().sequence == 2);
+    REQUIRE(buffer.Read().sequence == 2);
+
+    constexpr u64 num_samples = 1'000'000;
+    std::thread producer([&buffer] {
+        for (u64 sequence = 3; sequence <= num_samples; sequence++) {
+            buffer.WriteBuffer() = {sequence, ~sequence};
+            buffer.Publish();
+        }
+    });
+
+    // Values only move forward and are never torn
+    u64 last_sequence = 2;
+    bool consistent = true;
+    while (last_sequence < num_samples && consistent) {
+        const Sample& sample = buffer.Read();
+        consistent = sample.check == ~sample.sequence && sample.sequence >= last_sequence;
+        last_sequence = sample.sequence;
+    }
+    producer.join();
+    REQUIRE(consistent);
+    REQUIRE(buffer.Read().sequence == num_samples);
+}
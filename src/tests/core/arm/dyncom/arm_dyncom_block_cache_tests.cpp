@@ -0,0 +1,116 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/dyncom/arm_dyncom_interpreter.h"
+#include "core/arm/skyeye_common/armstate.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+namespace {
+
+// A loop with a call in it, so that blocks are chained through direct, conditional and indirect
+// branches.
+constexpr std::array<u32, 10> test_program{
+    0xE3A01010, // 0x00: mov r1, #16
+    0xE0800001, // 0x04: add r0, r0, r1
+    0xE0202180, // 0x08: eor r2, r0, r0, lsl #3
+    0xEB000003, // 0x0C: bl 0x20
+    0xE2511001, // 0x10: subs r1, r1, #1
+    0x1AFFFFFA, // 0x14: bne 0x04
+    0xEAFFFFF8, // 0x18: b 0x00
+    0xE1A00000, // 0x1C: nop
+    0xE0833002, // 0x20: add r3, r3, r2
+    0xE12FFF1E, // 0x24: bx lr
+};
+
+// Instructions executed by every iteration of the outer loop
+constexpr u64 instructions_per_iteration = 1 + 16 * 7 + 1;
+
+void LoadTestProgram(TestEnvironment& test_env) {
+    for (std::size_t i = 0; i < test_program.size(); i++) {
+        test_env.SetMemory32(static_cast<VAddr>(i * 4), test_program[i]);
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ARM_DynCom (block cache): chained blocks", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    LoadTestProgram(test_env);
+
+    ARMul_State state(nullptr, test_env.GetMemory(), USER32MODE);
+    state.Reg[15] = 0;
+    state.NumInstrsToExecute = instructions_per_iteration * 10;
+    InterpreterMainLoop(&state);
+
+    u32 r0 = 0, r3 = 0;
+    for (int iteration = 0; iteration < 10; iteration++) {
+        for (u32 r1 = 16; r1 != 0; r1--) {
+            r0 += r1;
+            r3 += r0 ^ (r0 << 3);
+        }
+    }
+    REQUIRE(state.Reg[15] == 0);
+    REQUIRE(state.Reg[0] == r0);
+    REQUIRE(state.Reg[1] == 0);
+    REQUIRE(state.Reg[3] == r3);
+}
+
+TEST_CASE("ARM_DynCom (block cache): InvalidateCacheRange", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0, 0xE3A00001);      // mov r0, #1
+    test_env.SetMemory32(0x1000, 0xE3A01001); // mov r1, #1
+
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE, 0, nullptr);
+    const auto step_at = [&dyncom](u32 pc) {
+        dyncom.SetPC(pc);
+        dyncom.Step();
+    };
+    step_at(0);
+    step_at(0x1000);
+    REQUIRE(dyncom.GetReg(0) == 1);
+    REQUIRE(dyncom.GetReg(1) == 1);
+
+    test_env.SetMemory32(0, 0xE3A00002);      // mov r0, #2
+    test_env.SetMemory32(0x1000, 0xE3A01002); // mov r1, #2
+
+    // Only the page of the invalidated range is translated again
+    dyncom.InvalidateCacheRange(0, 4);
+    step_at(0);
+    step_at(0x1000);
+    CHECK(dyncom.GetReg(0) == 2);
+    CHECK(dyncom.GetReg(1) == 1);
+
+    dyncom.ClearInstructionCache();
+    step_at(0x1000);
+    CHECK(dyncom.GetReg(1) == 2);
+}
+
+TEST_CASE("ARM_DynCom (block cache): MIPS", "[arm_dyncom][.benchmark]") {
+    TestEnvironment test_env(false);
+    LoadTestProgram(test_env);
+
+    ARMul_State state(nullptr, test_env.GetMemory(), USER32MODE);
+    state.Reg[15] = 0;
+    constexpr u64 instructions = 1'000'000;
+
+    // MIPS is the number of instructions divided by the mean time in microseconds
+    BENCHMARK("1M instructions") {
+        state.NumInstrsToExecute = instructions;
+        return InterpreterMainLoop(&state);
+    };
+
+    BENCHMARK("1M instructions, translated again") {
+        state.instruction_cache.Clear();
+        state.NumInstrsToExecute = instructions;
+        return InterpreterMainLoop(&state);
+    };
+}
+
+} // namespace ArmTests
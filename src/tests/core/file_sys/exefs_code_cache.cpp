@@ -0,0 +1,77 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <filesystem>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "core/file_sys/exefs_code_cache.h"
+#include "tests/temp_directory.h"
+
+namespace FileSys {
+
+TEST_CASE("ExeFSCodeCache round trip", "[core][file_sys]") {
+    const Tests::TempDirectory temp_directory("exefs_code_cache_test");
+    const auto dir = temp_directory.GetPath();
+    const ExeFSCodeCache cache(1024 * 1024, (dir / "").string());
+
+    const std::vector<u8> compressed{1, 2, 3, 4, 5, 6, 7, 8};
+    const std::vector<u8> other_compressed{1, 2, 3, 4, 5, 6, 7, 9};
+    std::vector<u8> code(0x1234);
+    for (std::size_t i = 0; i < code.size(); ++i) {
+        code[i] = static_cast<u8>(i * 7);
+    }
+
+    std::vector<u8> loaded;
+    REQUIRE_FALSE(cache.Load(compressed.data(), compressed.size(), loaded));
+
+    cache.Store(compressed.data(), compressed.size(), code, std::chrono::milliseconds(12));
+    REQUIRE(cache.Load(compressed.data(), compressed.size(), loaded));
+    REQUIRE(loaded == code);
+    REQUIRE_FALSE(cache.Load(other_compressed.data(), other_compressed.size(), loaded));
+
+    SECTION("corrupted files are not used") {
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            FileUtil::IOFile file(entry.path().string(), "r+b");
+            file.Seek(-1, SEEK_END);
+            const u8 byte = 0xFF;
+            file.WriteBytes(&byte, 1);
+        }
+        REQUIRE_FALSE(cache.Load(compressed.data(), compressed.size(), loaded));
+    }
+}
+
+TEST_CASE("ExeFSCodeCache size limit", "[core][file_sys]") {
+    const Tests::TempDirectory temp_directory("exefs_code_cache_test");
+    const auto dir = temp_directory.GetPath() / "cache";
+    const std::vector<u8> code(0x1000, 0xAB);
+    const std::vector<u8> first{1};
+    const std::vector<u8> second{2};
+    std::vector<u8> loaded;
+
+    SECTION("a size of 0 disables the cache") {
+        const ExeFSCodeCache cache(0, (dir / "").string());
+        cache.Store(first.data(), first.size(), code, std::chrono::milliseconds(1));
+        REQUIRE_FALSE(cache.Load(first.data(), first.size(), loaded));
+        REQUIRE_FALSE(std::filesystem::exists(dir));
+    }
+
+    SECTION("the oldest sections are removed past the limit") {
+        // Room for one section only
+        const ExeFSCodeCache cache(code.size() + 0x100, (dir / "").string());
+        cache.Store(first.data(), first.size(), code, std::chrono::milliseconds(1));
+        REQUIRE(cache.Load(first.data(), first.size(), loaded));
+
+        // Modification times may only have a resolution of seconds
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            const auto write_time = std::filesystem::last_write_time(entry.path());
+            std::filesystem::last_write_time(entry.path(), write_time - std::chrono::seconds(10));
+        }
+        cache.Store(second.data(), second.size(), code, std::chrono::milliseconds(1));
+        REQUIRE_FALSE(cache.Load(first.data(), first.size(), loaded));
+        REQUIRE(cache.Load(second.data(), second.size(), loaded));
+    }
+}
+
+} // namespace FileSys
@@ -0,0 +1,119 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "core/file_sys/host_directory_cache.h"
+#include "tests/temp_directory.h"
+
+namespace FileSys {
+
+namespace {
+
+using EntryType = HostDirectoryCache::EntryType;
+
+constexpr int NumDirectories = 16;
+constexpr int NumSubdirectories = 4;
+constexpr int NumFiles = 32;
+
+/// Creates a tree like the ones of titles that keep photos or caches in their extdata.
+std::vector<std::string> CreateTree(const std::string& root) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < NumDirectories; ++i) {
+        const auto directory = fmt::format("{}/dir{}", root, i);
+        paths.push_back(directory);
+        for (int j = 0; j < NumSubdirectories; ++j) {
+            const auto subdirectory = fmt::format("{}/sub{}", directory, j);
+            FileUtil::CreateFullPath(subdirectory + "/");
+            paths.push_back(subdirectory);
+            for (int k = 0; k < NumFiles; ++k) {
+                const auto file = fmt::format("{}/file{}.bin", subdirectory, k);
+                FileUtil::WriteStringToFile(false, file, std::string(k, 'x'));
+                paths.push_back(file);
+            }
+        }
+    }
+    return paths;
+}
+
+EntryType GetHostEntryType(const std::string& path) {
+    if (!FileUtil::Exists(path)) {
+        return EntryType::NotFound;
+    }
+    return FileUtil::IsDirectory(path) ? EntryType::Directory : EntryType::File;
+}
+
+u64 GetListedSize(const FileUtil::FSTEntry& directory, const std::string& name) {
+    const auto itr = std::find_if(
+        directory.children.begin(), directory.children.end(),
+        [&name](const FileUtil::FSTEntry& entry) { return entry.virtualName == name; });
+    REQUIRE(itr != directory.children.end());
+    return itr->size;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("HostDirectoryCache matches the host filesystem", "[core][file_sys]") {
+    const Tests::TempDirectory root_directory("directory_cache_test");
+    const auto root = root_directory.GetPath().string();
+    auto paths = CreateTree(root);
+    // Paths that don't exist, including under files
+    paths.push_back(root + "/missing");
+    paths.push_back(root + "/dir0/missing/file0.bin");
+    paths.push_back(root + "/dir0/sub0/file0.bin/child");
+
+    HostDirectoryCache cache;
+
+    std::mt19937 rng(0xD1C);
+    std::uniform_int_distribution<std::size_t> path_dist(0, paths.size() - 1);
+    for (int i = 0; i < 20000; ++i) {
+        const auto& path = paths[path_dist(rng)];
+        REQUIRE(cache.GetEntryType(path) == GetHostEntryType(path));
+    }
+
+    if (cache.IsEnabled()) {
+        const auto stats = cache.GetStats();
+        constexpr u64 NumTreeDirectories = 2 + NumDirectories * (1 + NumSubdirectories);
+        REQUIRE(stats.misses <= NumTreeDirectories);
+        REQUIRE(stats.hits > stats.misses * 100);
+        REQUIRE(stats.invalidations == 0);
+    }
+
+    SECTION("after files are created and deleted") {
+        const auto created = root + "/dir1/sub1/created.bin";
+        REQUIRE(cache.GetEntryType(created) == EntryType::NotFound);
+        FileUtil::CreateEmptyFile(created);
+        REQUIRE(cache.GetEntryType(created) == EntryType::File);
+        FileUtil::Delete(created);
+        REQUIRE(cache.GetEntryType(created) == EntryType::NotFound);
+    }
+
+    SECTION("after a directory is renamed") {
+        REQUIRE(cache.GetEntryType(root + "/dir2/sub2/file2.bin") == EntryType::File);
+        REQUIRE(FileUtil::Rename(root + "/dir2", root + "/renamed"));
+        REQUIRE(cache.GetEntryType(root + "/dir2/sub2/file2.bin") == EntryType::NotFound);
+        REQUIRE(cache.GetEntryType(root + "/dir2") == EntryType::NotFound);
+        REQUIRE(cache.GetEntryType(root + "/renamed/sub2/file2.bin") == EntryType::File);
+    }
+
+    SECTION("after a file is written") {
+        const auto directory = root + "/dir3/sub3";
+        REQUIRE(GetListedSize(cache.GetDirectory(directory), "file5.bin") == 5);
+        const auto invalidations = cache.GetStats().invalidations;
+        FileUtil::WriteStringToFile(false, directory + "/file5.bin", std::string(100, 'y'));
+        REQUIRE(GetListedSize(cache.GetDirectory(directory + "/"), "file5.bin") == 100);
+
+        // Writes only update the size of the file, without scanning its directory again
+        if (cache.IsEnabled()) {
+            REQUIRE(cache.GetStats().invalidations == invalidations);
+        }
+    }
+}
+
+} // namespace FileSys
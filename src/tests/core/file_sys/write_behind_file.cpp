@@ -0,0 +1,193 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "core/file_sys/errors.h"
+#include "core/file_sys/write_behind_file.h"
+#include "tests/temp_directory.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr u64 MaxSize = 1024 * 1024;
+
+std::vector<u8> ReadHostFile(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    std::vector<u8> data(file.GetSize());
+    file.ReadBytes(data.data(), data.size());
+    return data;
+}
+
+Mode ReadWriteMode() {
+    Mode mode{};
+    mode.read_flag.Assign(1);
+    mode.write_flag.Assign(1);
+    return mode;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("WriteBehindFile buffers writes until they are committed", "[core][file_sys]") {
+    const Tests::TempDirectory temp_directory("write_behind_file_test");
+    const auto mount_point = temp_directory.GetPath() / "data" / "";
+    std::filesystem::create_directories(mount_point);
+    const auto path = (mount_point / "save.bin").string();
+    FileUtil::WriteStringToFile(true, path, "0123456789");
+
+    WriteBehindFile file(path, mount_point.string(), MaxSize, ReadWriteMode(), nullptr);
+    const std::vector<u8> chunk{'a', 'b', 'c'};
+    REQUIRE(file.Write(8, chunk.size(), true, chunk.data()).Unwrap() == chunk.size());
+    REQUIRE(file.GetSize() == 11);
+    REQUIRE(ReadHostFile(path).size() == 10);
+
+    // Other files of the same path see the changes
+    WriteBehindFile other(path, mount_point.string(), MaxSize, ReadWriteMode(), nullptr);
+    std::vector<u8> read(11);
+    REQUIRE(other.Read(0, read.size(), read.data()).Unwrap() == read.size());
+    const std::vector<u8> expected{'0', '1', '2', '3', '4', '5', '6', '7', 'a', 'b', 'c'};
+    REQUIRE(read == expected);
+
+    SECTION("on flush") {
+        file.Flush();
+        REQUIRE(ReadHostFile(path) == expected);
+    }
+
+    SECTION("when the archive is committed") {
+        WriteBehindFile::FlushAll(mount_point.string());
+        REQUIRE(ReadHostFile(path) == expected);
+    }
+
+    SECTION("and drops them when the file is deleted") {
+        WriteBehindFile::DiscardAll(mount_point.string());
+        FileUtil::Delete(path);
+        file.Close();
+        REQUIRE_FALSE(FileUtil::Exists(path));
+    }
+
+    SECTION("and follows renames") {
+        const auto new_path = (mount_point / "renamed.bin").string();
+        WriteBehindFile::FlushAll(path);
+        REQUIRE(FileUtil::Rename(path, new_path));
+        WriteBehindFile::RenameAll(path, new_path);
+        REQUIRE(file.Write(0, chunk.size(), false, chunk.data()).Unwrap() == chunk.size());
+        file.Close();
+        REQUIRE(ReadHostFile(new_path).front() == 'a');
+        REQUIRE_FALSE(FileUtil::Exists(path));
+    }
+
+}
+
+TEST_CASE("WriteBehindFile writes back changes after the flush interval", "[core][file_sys]") {
+    const Tests::TempDirectory temp_directory("write_behind_file_test");
+    const auto mount_point = temp_directory.GetPath() / "data" / "";
+    std::filesystem::create_directories(mount_point);
+    const auto path = (mount_point / "save.bin").string();
+    FileUtil::WriteStringToFile(true, path, "0123456789");
+
+    WriteBehindFile file(path, mount_point.string(), MaxSize, ReadWriteMode(), nullptr);
+    const std::vector<u8> chunk{'a', 'b', 'c'};
+    REQUIRE(file.Write(0, chunk.size(), false, chunk.data()).Unwrap() == chunk.size());
+    REQUIRE(ReadHostFile(path).front() == '0');
+
+    // No further access to the file is needed
+    const auto deadline = std::chrono::steady_clock::now() + WriteBehindFile::FlushInterval * 3;
+    while (ReadHostFile(path).front() != 'a' && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    REQUIRE(ReadHostFile(path).front() == 'a');
+
+    file.Close();
+}
+
+TEST_CASE("WriteBehindFile fails accesses to files it can not read", "[core][file_sys]") {
+    const Tests::TempDirectory temp_directory("write_behind_file_test");
+    const auto mount_point = temp_directory.GetPath() / "data" / "";
+    std::filesystem::create_directories(mount_point);
+    const auto path = (mount_point / "missing.bin").string();
+
+    WriteBehindFile file(path, mount_point.string(), MaxSize, ReadWriteMode(), nullptr);
+    const std::vector<u8> chunk{'a', 'b', 'c'};
+    REQUIRE(file.Write(0, chunk.size(), false, chunk.data()).Failed());
+    std::vector<u8> read(chunk.size());
+    REQUIRE(file.Read(0, read.size(), read.data()).Failed());
+    REQUIRE_FALSE(file.SetSize(16));
+
+    // Nothing is written back over the file
+    file.Close();
+    REQUIRE_FALSE(FileUtil::Exists(path));
+}
+
+TEST_CASE("WriteBehindFile keeps its temporary files out of the archive", "[core][file_sys]") {
+    const Tests::TempDirectory temp_directory("write_behind_file_test");
+    const auto mount_point = temp_directory.GetPath() / "data" / "";
+    std::filesystem::create_directories(mount_point);
+    const auto path = (mount_point / "save.bin").string();
+    const auto guest_temp_path = path + ".tmp";
+    FileUtil::WriteStringToFile(true, path, "0123456789");
+    FileUtil::WriteStringToFile(true, guest_temp_path, "guest");
+
+    SECTION("when writing back") {
+        WriteBehindFile file(path, mount_point.string(), MaxSize, ReadWriteMode(), nullptr);
+        const std::vector<u8> chunk{'a', 'b', 'c'};
+        REQUIRE(file.Write(0, chunk.size(), false, chunk.data()).Unwrap() == chunk.size());
+        file.Flush();
+        REQUIRE(ReadHostFile(path).front() == 'a');
+        REQUIRE(ReadHostFile(guest_temp_path) == std::vector<u8>{'g', 'u', 'e', 's', 't'});
+        std::size_t num_files = 0;
+        for ([[maybe_unused]] const auto& entry :
+             std::filesystem::directory_iterator(mount_point)) {
+            ++num_files;
+        }
+        REQUIRE(num_files == 2);
+    }
+
+    SECTION("and removes the ones of interrupted write backs") {
+        const auto temp_path =
+            (temp_directory.GetPath() / "data.tmp" / "0123456789ABCDEF").string();
+        REQUIRE(FileUtil::CreateFullPath(temp_path));
+        FileUtil::WriteStringToFile(true, temp_path, "partial");
+        {
+            // Not while a file of the archive may be written back
+            WriteBehindFile file(path, mount_point.string(), MaxSize, ReadWriteMode(), nullptr);
+            WriteBehindFile::RemoveTempFiles(mount_point.string());
+            REQUIRE(FileUtil::Exists(temp_path));
+        }
+        WriteBehindFile::RemoveTempFiles(mount_point.string());
+        REQUIRE_FALSE(FileUtil::Exists(temp_path));
+        REQUIRE(FileUtil::Exists(guest_temp_path));
+    }
+
+}
+
+TEST_CASE("WriteBehindFile rejects growing past its size limit", "[core][file_sys]") {
+    const Tests::TempDirectory temp_directory("write_behind_file_test");
+    const auto mount_point = temp_directory.GetPath() / "data" / "";
+    std::filesystem::create_directories(mount_point);
+    const auto path = (mount_point / "save.bin").string();
+    FileUtil::WriteStringToFile(true, path, "0123456789");
+
+    WriteBehindFile file(path, mount_point.string(), MaxSize, ReadWriteMode(), nullptr);
+    const std::vector<u8> chunk{'a', 'b', 'c'};
+    REQUIRE(file.Write(0x1'0000'0000'0000, chunk.size(), false, chunk.data()).Code() ==
+            ERROR_INSUFFICIENT_SPACE);
+    REQUIRE(file.Write(~u64{0}, chunk.size(), false, chunk.data()).Code() ==
+            ERROR_INSUFFICIENT_SPACE);
+    REQUIRE_FALSE(file.SetSize(MaxSize + 1));
+    REQUIRE(file.GetSize() == 10);
+
+    REQUIRE(file.Write(MaxSize - chunk.size(), chunk.size(), false, chunk.data()).Unwrap() ==
+            chunk.size());
+    REQUIRE(file.GetSize() == MaxSize);
+
+    file.Close();
+}
+
+} // namespace FileSys
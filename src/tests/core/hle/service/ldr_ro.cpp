@@ -0,0 +1,222 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+#include "common/memory_ref.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/vm_manager.h"
+#include "core/hle/service/ldr_ro/cro_helper.h"
+#include "core/hle/service/ldr_ro/export_symbol_index.h"
+#include "core/memory.h"
+
+namespace Service::LDR {
+
+namespace {
+
+constexpr VAddr ModuleAddress = Memory::HEAP_VADDR;
+constexpr u32 ModuleSize = 0x2000;
+
+// The header fields the export lookup reads, see CROHelper::HeaderField
+constexpr u32 SegmentTableOffset = 18;
+constexpr u32 SegmentNum = 19;
+constexpr u32 ExportNamedSymbolTableOffset = 20;
+constexpr u32 ExportNamedSymbolNum = 21;
+constexpr u32 ExportStringsOffset = 24;
+constexpr u32 ExportStringsSize = 25;
+constexpr u32 ExportTreeTableOffset = 26;
+constexpr u32 ExportTreeNum = 27;
+
+constexpr VAddr SegmentTable = ModuleAddress + 0x200;
+constexpr VAddr NamedSymbolTable = ModuleAddress + 0x300;
+constexpr VAddr ExportStrings = ModuleAddress + 0x400;
+constexpr VAddr ExportTree = ModuleAddress + 0x500;
+constexpr VAddr CodeSegment = ModuleAddress + 0x1000;
+
+/// The symbols are at 0x10 * (index + 1) in the code segment
+constexpr VAddr SymbolAddress(u32 index) {
+    return CodeSegment + 0x10 * (index + 1);
+}
+
+/**
+ * A rebased module exporting the named symbols "a", "b", "c" and "d", with an export tree that
+ * only leads to the first three. The tree tests bit 1 of the first character, then bit 0:
+ *
+ *      [0] root
+ *       |
+ *      [1] bit 1 --0--> [1] "a"
+ *       |
+ *       1
+ *       |
+ *      [2] bit 0 --0--> [2] "b"
+ *       |
+ *       1----> [3] "c"
+ */
+struct SyntheticCRO {
+    Core::Timing timing{1, 100};
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel{memory, timing, [] {}, 0, 1, 0};
+    std::shared_ptr<Kernel::Process> process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    SyntheticCRO() {
+        MemoryRef block{std::make_shared<BufferMem>(ModuleSize)};
+        REQUIRE(process->vm_manager
+                    .MapBackingMemory(ModuleAddress, block, ModuleSize,
+                                      Kernel::MemoryState::Private)
+                    .Succeeded());
+        memory.SetCurrentPageTable(process->vm_manager.page_table);
+
+        SetField(SegmentTableOffset, SegmentTable);
+        SetField(SegmentNum, 1);
+        memory.Write32(SegmentTable, CodeSegment);
+        SetCodeSegmentSize(0x100);
+        memory.Write32(SegmentTable + 8, 0); // Code
+
+        const std::string strings{"a\0b\0c\0d\0", 8};
+        memory.WriteBlock(*process, ExportStrings, strings.data(), strings.size());
+        SetField(ExportStringsOffset, ExportStrings);
+        SetField(ExportStringsSize, static_cast<u32>(strings.size()));
+
+        SetField(ExportNamedSymbolTableOffset, NamedSymbolTable);
+        SetField(ExportNamedSymbolNum, 4);
+        for (u32 i = 0; i < 4; ++i) {
+            memory.Write32(NamedSymbolTable + i * 8, ExportStrings + i * 2);
+            // A segment tag of segment 0
+            memory.Write32(NamedSymbolTable + i * 8 + 4, (SymbolAddress(i) - CodeSegment) << 4);
+        }
+
+        SetField(ExportTreeTableOffset, ExportTree);
+        SetField(ExportTreeNum, 4);
+        SetTreeEntry(0, 0, Node(1), 0, 0);
+        SetTreeEntry(1, 1, Leaf(1), Node(2), 0);
+        SetTreeEntry(2, 0, Leaf(2), Leaf(3), 1);
+        SetTreeEntry(3, 0, 0, 0, 2);
+    }
+
+    void SetField(u32 field, u32 value) {
+        memory.Write32(ModuleAddress + CRO_HASH_SIZE + field * 4, value);
+    }
+
+    void SetCodeSegmentSize(u32 size) {
+        memory.Write32(SegmentTable + 4, size);
+    }
+
+    static u16 Node(u16 index) {
+        return index;
+    }
+
+    static u16 Leaf(u16 index) {
+        return index | 0x8000;
+    }
+
+    void SetTreeEntry(u32 index, u16 test_bit, u16 left, u16 right, u16 export_table_index) {
+        const VAddr entry = ExportTree + index * 8;
+        memory.Write16(entry, test_bit);
+        memory.Write16(entry + 2, left);
+        memory.Write16(entry + 4, right);
+        memory.Write16(entry + 6, export_table_index);
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("CROHelper finds the symbols of the export tree", "[core][ldr_ro]") {
+    SyntheticCRO module;
+    const CROHelper cro(ModuleAddress, *module.process, module.memory);
+
+    SECTION("names the tree leads to") {
+        REQUIRE(cro.WalkExportTree("a") == SymbolAddress(0));
+        REQUIRE(cro.WalkExportTree("b") == SymbolAddress(1));
+        REQUIRE(cro.WalkExportTree("c") == SymbolAddress(2));
+    }
+
+    SECTION("names the tree doesn't lead to") {
+        REQUIRE(cro.WalkExportTree("d") == 0);
+        REQUIRE(cro.WalkExportTree("ab") == 0);
+        REQUIRE(cro.WalkExportTree("") == 0);
+    }
+
+    SECTION("symbols outside of their segment") {
+        module.SetCodeSegmentSize(0x30);
+        REQUIRE(cro.WalkExportTree("b") == SymbolAddress(1));
+        REQUIRE(cro.WalkExportTree("c") == 0);
+    }
+
+    SECTION("modules without an export tree") {
+        module.SetField(ExportTreeNum, 0);
+        REQUIRE(cro.WalkExportTree("a") == 0);
+    }
+}
+
+TEST_CASE("CROHelper indexes the symbols of the export tree", "[core][ldr_ro]") {
+    SyntheticCRO module;
+    const CROHelper cro(ModuleAddress, *module.process, module.memory);
+    ExportSymbolIndex index;
+    const CROHelper indexed(ModuleAddress, *module.process, module.memory, &index);
+
+    SECTION("lookups find the same symbols as the tree") {
+        for (const std::string name : {"a", "b", "c", "d", "ab", "", "e"}) {
+            REQUIRE(indexed.FindExportNamedSymbol(name) == cro.WalkExportTree(name));
+        }
+        const auto* symbols = index.Find(ModuleAddress);
+        REQUIRE(symbols != nullptr);
+        REQUIRE(symbols->size() == 3);
+        REQUIRE(symbols->count("d") == 0);
+    }
+
+    SECTION("symbols outside of their segment are not indexed") {
+        module.SetCodeSegmentSize(0x30);
+        const auto& symbols = indexed.IndexExportNamedSymbols();
+        REQUIRE(symbols.size() == 2);
+        REQUIRE(symbols.count("c") == 0);
+    }
+}
+
+TEST_CASE("ExportSymbolIndex finds the symbols of each module", "[core][ldr_ro]") {
+    ExportSymbolIndex index;
+    REQUIRE(index.Find(0x00100000) == nullptr);
+
+    index.Add(0x00100000, {{"nnMain", 0x00100200}, {"nnroAeabiAtexit_", 0x00100400}});
+    index.Add(0x00200000, {{"nnMain", 0x00200200}});
+
+    const auto* symbols = index.Find(0x00100000);
+    REQUIRE(symbols != nullptr);
+    REQUIRE(symbols->at("nnMain") == 0x00100200);
+    REQUIRE(symbols->at("nnroAeabiAtexit_") == 0x00100400);
+    REQUIRE(symbols->count("nnroAeabiAtexit") == 0);
+
+    symbols = index.Find(0x00200000);
+    REQUIRE(symbols != nullptr);
+    REQUIRE(symbols->at("nnMain") == 0x00200200);
+    REQUIRE(symbols->count("nnroAeabiAtexit_") == 0);
+}
+
+TEST_CASE("ExportSymbolIndex drops the symbols of unloaded modules", "[core][ldr_ro]") {
+    ExportSymbolIndex index;
+    index.Add(0x00100000, {{"nnMain", 0x00100200}});
+    index.Add(0x00200000, {{"nnMain", 0x00200200}});
+
+    SECTION("a module loaded again at the same address replaces the symbols") {
+        const auto& symbols = index.Add(0x00100000, {{"nnInit", 0x00100600}});
+        REQUIRE(&symbols == index.Find(0x00100000));
+        REQUIRE(symbols.size() == 1);
+        REQUIRE(symbols.at("nnInit") == 0x00100600);
+    }
+
+    SECTION("removing a module keeps the others") {
+        index.Remove(0x00100000);
+        REQUIRE(index.Find(0x00100000) == nullptr);
+        REQUIRE(index.Find(0x00200000) != nullptr);
+    }
+
+    SECTION("clearing drops all modules") {
+        index.Clear();
+        REQUIRE(index.Find(0x00100000) == nullptr);
+        REQUIRE(index.Find(0x00200000) == nullptr);
+    }
+}
+
+} // namespace Service::LDR
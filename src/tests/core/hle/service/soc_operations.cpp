@@ -0,0 +1,268 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// The operations are exercised with POSIX sockets over loopback
+#ifndef _WIN32
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "core/hle/service/soc_operations.h"
+
+namespace Service::SOC {
+
+namespace {
+
+void SetNonBlocking(int fd) {
+    REQUIRE(::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK) == 0);
+}
+
+/// A TCP socket bound to a free port of the loopback interface.
+class LoopbackSocket {
+public:
+    LoopbackSocket() : fd{::socket(AF_INET, SOCK_STREAM, 0)} {
+        REQUIRE(fd >= 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        REQUIRE(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    }
+
+    ~LoopbackSocket() {
+        ::close(fd);
+    }
+
+    sockaddr GetAddress() const {
+        sockaddr addr{};
+        socklen_t len = sizeof(addr);
+        REQUIRE(::getsockname(fd, &addr, &len) == 0);
+        return addr;
+    }
+
+    int fd;
+};
+
+/// Echoes back everything it receives, one connection at a time, on a thread of its own.
+class EchoServer {
+public:
+    EchoServer() {
+        REQUIRE(::listen(socket.fd, 4) == 0);
+        thread = std::thread([this] { Serve(); });
+    }
+
+    ~EchoServer() {
+        // Wakes up the accept of the server thread
+        ::shutdown(socket.fd, SHUT_RDWR);
+        thread.join();
+    }
+
+    sockaddr GetAddress() const {
+        return socket.GetAddress();
+    }
+
+private:
+    void Serve() {
+        while (true) {
+            const int fd = ::accept(socket.fd, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            char buffer[256];
+            ssize_t received;
+            while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+                ::send(fd, buffer, static_cast<std::size_t>(received), 0);
+            }
+            ::close(fd);
+        }
+    }
+
+    LoopbackSocket socket;
+    std::thread thread;
+};
+
+/// A non-blocking client socket, as SOC:U makes every host socket.
+class Client {
+public:
+    Client() : fd{::socket(AF_INET, SOCK_STREAM, 0)} {
+        REQUIRE(fd >= 0);
+    }
+
+    /// Connects to the server before making the socket non-blocking.
+    explicit Client(const EchoServer& server) : Client() {
+        const sockaddr addr = server.GetAddress();
+        REQUIRE(::connect(fd, &addr, sizeof(addr)) == 0);
+        SetNonBlocking(fd);
+    }
+
+    ~Client() {
+        ::close(fd);
+    }
+
+    void Send(const std::string& data) {
+        REQUIRE(::send(fd, data.data(), data.size(), 0) == static_cast<ssize_t>(data.size()));
+    }
+
+    int fd;
+};
+
+/// Takes the completed operations, waiting for at most a second for any to complete.
+std::vector<std::shared_ptr<SocketReactor::Operation>> WaitForCompleted(SocketReactor& reactor) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    auto completed = reactor.TakeCompleted();
+    while (completed.empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        completed = reactor.TakeCompleted();
+    }
+    return completed;
+}
+
+/// Stops waiting for an operation whose guest thread timed out, as SOC:U does.
+void TimeOut(SocketReactor& reactor, const std::shared_ptr<SocketOperation>& operation) {
+    if (!reactor.Cancel(operation)) {
+        operation->TryComplete();
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SOC:U Recv wakes up once the peer sends data", "[core][soc]") {
+    EchoServer server;
+    Client client{server};
+    SocketReactor reactor;
+
+    auto operation = std::make_shared<RecvOperation>(0x08, client.fd, 16, 0, 0);
+    REQUIRE_FALSE(operation->TryComplete());
+    reactor.Submit(operation, {{client.fd, SocketReactor::Readable}});
+
+    client.Send("hello");
+    const auto completed = WaitForCompleted(reactor);
+    REQUIRE(completed.size() == 1);
+    REQUIRE(completed[0] == operation);
+    REQUIRE(operation->GetReturn() == 5);
+    REQUIRE(std::memcmp(operation->GetData().data(), "hello", 5) == 0);
+    REQUIRE_FALSE(reactor.HasOperations());
+}
+
+TEST_CASE("SOC:U Accept wakes up once a client connects", "[core][soc]") {
+    LoopbackSocket listener;
+    REQUIRE(::listen(listener.fd, 4) == 0);
+    SetNonBlocking(listener.fd);
+    SocketReactor reactor;
+
+    auto operation = std::make_shared<AcceptOperation>(listener.fd);
+    REQUIRE_FALSE(operation->TryComplete());
+    reactor.Submit(operation, {{listener.fd, SocketReactor::Readable}});
+
+    Client client;
+    const sockaddr addr = listener.GetAddress();
+    REQUIRE(::connect(client.fd, &addr, sizeof(addr)) == 0);
+    const auto completed = WaitForCompleted(reactor);
+    REQUIRE(completed.size() == 1);
+    REQUIRE(operation->GetReturn() == 0);
+    REQUIRE(operation->GetAcceptedSocket() >= 0);
+    ::close(operation->GetAcceptedSocket());
+}
+
+TEST_CASE("SOC:U Connect wakes up once the connection is established or fails", "[core][soc]") {
+    EchoServer server;
+    SocketReactor reactor;
+    Client client;
+    SetNonBlocking(client.fd);
+    auto operation = std::make_shared<ConnectOperation>(client.fd);
+
+    // Loopback connections may also complete right away
+    const auto connect = [&](const sockaddr& addr) {
+        if (operation->Start(addr)) {
+            reactor.Submit(operation, {{client.fd, SocketReactor::Writable}});
+            REQUIRE(WaitForCompleted(reactor).size() == 1);
+        }
+    };
+
+    SECTION("to a listening server") {
+        connect(server.GetAddress());
+        REQUIRE(operation->GetReturn() == 0);
+        client.Send("ping");
+    }
+
+    SECTION("to a closed port") {
+        sockaddr addr;
+        {
+            // The port is free again once the socket is closed, without anything listening on it
+            LoopbackSocket closed;
+            addr = closed.GetAddress();
+        }
+        connect(addr);
+        REQUIRE(operation->GetReturn() == SOCKET_ERROR_VALUE);
+        REQUIRE(operation->GetError() == ECONNREFUSED);
+    }
+}
+
+TEST_CASE("SOC:U Poll wakes up once a socket is ready", "[core][soc]") {
+    EchoServer server;
+    Client client{server};
+    SocketReactor reactor;
+
+    pollfd fd{};
+    fd.fd = client.fd;
+    fd.events = POLLIN;
+    auto operation = std::make_shared<PollOperation>(std::vector<pollfd>{fd}, std::vector<u8>{0});
+    REQUIRE_FALSE(operation->TryComplete());
+    reactor.Submit(operation, operation->GetWaits());
+
+    SECTION("before the timeout") {
+        client.Send("x");
+        REQUIRE(WaitForCompleted(reactor).size() == 1);
+        REQUIRE(operation->GetReturn() == 1);
+        REQUIRE((operation->GetPollFds()[0].revents & POLLIN) != 0);
+    }
+
+    SECTION("after the timeout") {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        TimeOut(reactor, operation);
+        REQUIRE(operation->GetReturn() == 0);
+        REQUIRE(operation->GetPollFds()[0].revents == 0);
+        REQUIRE_FALSE(reactor.HasOperations());
+
+        // Data that arrives afterwards does not complete the operation anymore
+        client.Send("x");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(reactor.TakeCompleted().empty());
+    }
+}
+
+TEST_CASE("SOC:U operations fail when their socket is closed while waiting", "[core][soc]") {
+    EchoServer server;
+    Client client{server};
+    SocketReactor reactor;
+
+    auto recv = std::make_shared<RecvOperation>(0x08, client.fd, 16, 0, 0);
+    pollfd fd{};
+    fd.fd = client.fd;
+    fd.events = POLLIN;
+    auto poll = std::make_shared<PollOperation>(std::vector<pollfd>{fd}, std::vector<u8>{0});
+    reactor.Submit(recv, {{client.fd, SocketReactor::Readable}});
+    reactor.Submit(poll, poll->GetWaits());
+
+    reactor.AbortSocket(client.fd);
+    REQUIRE(reactor.TakeCompleted().size() == 2);
+    REQUIRE(recv->GetReturn() == SOCKET_ERROR_VALUE);
+    REQUIRE(recv->GetError() == EBADF);
+    REQUIRE(poll->GetReturn() == SOCKET_ERROR_VALUE);
+    REQUIRE(poll->GetError() == EBADF);
+    REQUIRE_FALSE(reactor.HasOperations());
+}
+
+} // namespace Service::SOC
+
+#endif // _WIN32
@@ -0,0 +1,165 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// The reactor is exercised with a socket pair, which Windows does not have
+#ifndef _WIN32
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "core/hle/service/soc_reactor.h"
+
+namespace Service::SOC {
+
+namespace {
+
+/// Receives a byte from a non-blocking socket, as SOC:U does for a blocking guest socket.
+class RecvByte final : public SocketReactor::Operation {
+public:
+    explicit RecvByte(int socket_fd_) : socket_fd{socket_fd_} {}
+
+    bool TryComplete() override {
+        num_attempts++;
+        char byte;
+        if (::recv(socket_fd, &byte, sizeof(byte), 0) != sizeof(byte)) {
+            return false;
+        }
+        received = byte;
+        return true;
+    }
+
+    void Abort() override {
+        aborted = true;
+    }
+
+    int socket_fd;
+    std::atomic<char> received = 0;
+    std::atomic<int> num_attempts = 0;
+    bool aborted = false;
+};
+
+struct SocketPair {
+    SocketPair() {
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        for (const int fd : fds) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+    }
+
+    ~SocketPair() {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    int fds[2];
+};
+
+/// Takes the completed operations, waiting for at most a second for any to complete.
+std::vector<std::shared_ptr<SocketReactor::Operation>> WaitForCompleted(SocketReactor& reactor) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    auto completed = reactor.TakeCompleted();
+    while (completed.empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        completed = reactor.TakeCompleted();
+    }
+    return completed;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SocketReactor completes operations once their socket is ready", "[core][soc]") {
+    SocketPair pair;
+    SocketReactor reactor;
+
+    auto operation = std::make_shared<RecvByte>(pair.fds[0]);
+    REQUIRE(!operation->TryComplete());
+    reactor.Submit(operation, {{pair.fds[0], SocketReactor::Readable}});
+    REQUIRE(reactor.HasOperations());
+
+    const char byte = 'x';
+    REQUIRE(::send(pair.fds[1], &byte, sizeof(byte), 0) == sizeof(byte));
+
+    const auto completed = WaitForCompleted(reactor);
+    REQUIRE(completed.size() == 1);
+    REQUIRE(completed[0] == operation);
+    REQUIRE(operation->received == 'x');
+    REQUIRE(!reactor.HasOperations());
+}
+
+TEST_CASE("SocketReactor waits again for operations that would still block", "[core][soc]") {
+    SocketPair pair;
+    SocketReactor reactor;
+
+    // Both operations wait on the same socket, but only one byte is sent at first
+    auto first = std::make_shared<RecvByte>(pair.fds[0]);
+    auto second = std::make_shared<RecvByte>(pair.fds[0]);
+    reactor.Submit(first, {{pair.fds[0], SocketReactor::Readable}});
+    reactor.Submit(second, {{pair.fds[0], SocketReactor::Readable}});
+
+    const char bytes[] = {'a', 'b'};
+    REQUIRE(::send(pair.fds[1], &bytes[0], 1, 0) == 1);
+    auto completed = WaitForCompleted(reactor);
+    REQUIRE(completed.size() == 1);
+    REQUIRE(reactor.HasOperations());
+
+    REQUIRE(::send(pair.fds[1], &bytes[1], 1, 0) == 1);
+    completed = WaitForCompleted(reactor);
+    REQUIRE(completed.size() == 1);
+    REQUIRE(first->received != second->received);
+    REQUIRE(!reactor.HasOperations());
+}
+
+TEST_CASE("SocketReactor aborts the operations of a closed socket", "[core][soc]") {
+    SocketPair pair;
+    SocketReactor reactor;
+
+    auto operation = std::make_shared<RecvByte>(pair.fds[0]);
+    reactor.Submit(operation, {{pair.fds[0], SocketReactor::Readable}});
+    reactor.AbortSocket(pair.fds[0]);
+
+    const auto completed = reactor.TakeCompleted();
+    REQUIRE(completed.size() == 1);
+    REQUIRE(operation->aborted);
+    REQUIRE(!reactor.HasOperations());
+}
+
+TEST_CASE("SocketReactor cancels operations", "[core][soc]") {
+    SocketPair pair;
+    SocketReactor reactor;
+
+    SECTION("pending") {
+        auto operation = std::make_shared<RecvByte>(pair.fds[0]);
+        reactor.Submit(operation, {{pair.fds[0], SocketReactor::Readable}});
+        REQUIRE(!reactor.Cancel(operation));
+        REQUIRE(!reactor.HasOperations());
+
+        // The cancelled operation is no longer attempted once the socket is ready
+        const char byte = 'x';
+        REQUIRE(::send(pair.fds[1], &byte, sizeof(byte), 0) == sizeof(byte));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(operation->num_attempts == 0);
+        REQUIRE(reactor.TakeCompleted().empty());
+    }
+
+    SECTION("completed") {
+        auto operation = std::make_shared<RecvByte>(pair.fds[0]);
+        reactor.Submit(operation, {{pair.fds[0], SocketReactor::Readable}});
+        const char byte = 'x';
+        REQUIRE(::send(pair.fds[1], &byte, sizeof(byte), 0) == sizeof(byte));
+        while (operation->received == 0) {
+            std::this_thread::yield();
+        }
+        REQUIRE(reactor.Cancel(operation));
+        REQUIRE(reactor.TakeCompleted().empty());
+    }
+}
+
+} // namespace Service::SOC
+
+#endif // _WIN32
@@ -0,0 +1,65 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "core/hw/aes/ctr.h"
+
+namespace HW::AES {
+
+namespace {
+
+// From the AES-128 CTR example of NIST SP 800-38A, F.5.1
+constexpr AESKey TestKey{0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                         0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+constexpr AESIV TestCounter{0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+                            0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF};
+
+} // Anonymous namespace
+
+TEST_CASE("DecryptCTR matches the test vectors", "[core][aes]") {
+    std::vector<u8> data{0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96,
+                         0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+                         0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C,
+                         0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51};
+    const std::vector<u8> cipher{0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26,
+                                 0x1B, 0xEF, 0x68, 0x64, 0x99, 0x0D, 0xB6, 0xCE,
+                                 0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF,
+                                 0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF};
+
+    SECTION("from the start of the stream") {
+        DecryptCTR(TestKey, TestCounter, 0, data.data(), data.size());
+        REQUIRE(data == cipher);
+    }
+
+    SECTION("from the middle of a block") {
+        DecryptCTR(TestKey, TestCounter, 5, data.data() + 5, data.size() - 5);
+        REQUIRE(std::equal(data.begin() + 5, data.end(), cipher.begin() + 5));
+    }
+}
+
+TEST_CASE("DecryptCTR decrypts large data like small pieces of it", "[core][aes]") {
+    // Large enough to be split in chunks, with a partial block at both ends
+    constexpr u64 Offset = 0x1234567;
+    std::vector<u8> data(5 * 1024 * 1024 + 77);
+    std::mt19937 rng(0xC7E);
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    for (auto& byte : data) {
+        byte = static_cast<u8>(byte_dist(rng));
+    }
+
+    std::vector<u8> expected = data;
+    constexpr std::size_t PieceSize = 0x10000 + 3;
+    for (std::size_t offset = 0; offset < expected.size(); offset += PieceSize) {
+        const std::size_t size = std::min(PieceSize, expected.size() - offset);
+        DecryptCTR(TestKey, TestCounter, Offset + offset, expected.data() + offset, size);
+    }
+
+    DecryptCTR(TestKey, TestCounter, Offset, data.data(), data.size());
+    REQUIRE(data == expected);
+}
+
+} // namespace HW::AES
@@ -0,0 +1,194 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/common_funcs.h"
+#include "common/file_util.h"
+#include "common/swap.h"
+#include "common/zstd_compression.h"
+#include "core/loader/game_metadata_cache.h"
+#include "tests/temp_directory.h"
+
+namespace Loader {
+
+namespace {
+
+// The layout of the cache file, see game_metadata_cache.cpp
+struct CacheHeader {
+    u32_le magic = 0x4D444D47;
+    u32_le version = 1;
+    u64_le entry_count;
+    u64_le entries_size;
+};
+static_assert(sizeof(CacheHeader) == 0x18);
+
+struct CacheEntry {
+    u64_le size;
+    s64_le modification_time;
+    u64_le program_id;
+    u64_le extdata_id;
+    u32_le file_type;
+    u8 is_executable;
+    INSERT_PADDING_BYTES(3);
+    u32_le path_length;
+    u32_le smdh_size;
+};
+static_assert(sizeof(CacheEntry) == 0x30);
+
+constexpr u64 CachedProgramId = 0x0004000000123400;
+
+void WriteFile(const std::string& path, const std::string& contents) {
+    FileUtil::IOFile file(path, "wb");
+    REQUIRE(file.WriteString(contents) == contents.size());
+}
+
+/// Writes a cache file with an entry for each file, matching its current size and modification
+/// time. Files that aren't games can then only have a program ID if it comes from the cache.
+void WriteCacheFile(const std::string& path, const std::vector<std::string>& file_paths,
+                    u32 file_type = static_cast<u32>(FileType::CXI)) {
+    std::vector<u8> data;
+    for (std::size_t i = 0; i < file_paths.size(); ++i) {
+        const std::string& file_path = file_paths[i];
+        const std::vector<u8> smdh{1, 2, 3, static_cast<u8>(i)};
+        CacheEntry entry{};
+        entry.size = FileUtil::GetSize(file_path);
+        entry.modification_time = FileUtil::GetModificationTime(file_path);
+        entry.program_id = CachedProgramId + i;
+        entry.extdata_id = 0x1234;
+        entry.file_type = file_type;
+        entry.is_executable = 1;
+        entry.path_length = static_cast<u32>(file_path.size());
+        entry.smdh_size = static_cast<u32>(smdh.size());
+
+        const auto* entry_bytes = reinterpret_cast<const u8*>(&entry);
+        data.insert(data.end(), entry_bytes, entry_bytes + sizeof(entry));
+        data.insert(data.end(), file_path.begin(), file_path.end());
+        data.insert(data.end(), smdh.begin(), smdh.end());
+    }
+
+    CacheHeader header{};
+    header.entry_count = file_paths.size();
+    header.entries_size = data.size();
+    const std::vector<u8> compressed =
+        Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+
+    FileUtil::IOFile file(path, "wb");
+    REQUIRE(file.WriteObject(header) == 1);
+    REQUIRE(file.WriteBytes(compressed.data(), compressed.size()) == compressed.size());
+}
+
+bool IsCached(GameMetadataCache& cache, const std::string& file_path) {
+    return cache.Get(file_path).program_id != 0;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("GameMetadataCache", "[core][loader]") {
+    const Tests::TempDirectory temp_directory("game_metadata_cache_test");
+    const auto dir = temp_directory.GetPath();
+    const std::string cache_path = (dir / "metadata.bin").string();
+    const std::string first = (dir / "first.txt").string();
+    const std::string second = (dir / "second.txt").string();
+    WriteFile(first, "not a game");
+    WriteFile(second, "not a game either");
+
+    SECTION("entries are loaded") {
+        WriteCacheFile(cache_path, {first, second});
+        GameMetadataCache cache(cache_path);
+        cache.Load();
+
+        const GameMetadata metadata = cache.Get(second);
+        REQUIRE(metadata.file_type == FileType::CXI);
+        REQUIRE(metadata.is_executable);
+        REQUIRE(metadata.program_id == CachedProgramId + 1);
+        REQUIRE(metadata.extdata_id == 0x1234);
+        REQUIRE(metadata.smdh == std::vector<u8>{1, 2, 3, 1});
+
+        SECTION("and saved again") {
+            const std::string third = (dir / "third.txt").string();
+            WriteFile(third, "still not a game");
+            REQUIRE(IsCached(cache, first));
+            REQUIRE(cache.Get(third).file_type == FileType::Error);
+            cache.Save();
+
+            GameMetadataCache reloaded(cache_path);
+            reloaded.Load();
+            REQUIRE(reloaded.Get(first).program_id == CachedProgramId);
+            REQUIRE(reloaded.Get(second).smdh == std::vector<u8>{1, 2, 3, 1});
+            REQUIRE(reloaded.Get(third).file_type == FileType::Error);
+        }
+
+        SECTION("and entries that weren't used are not saved") {
+            cache.Save();
+
+            GameMetadataCache reloaded(cache_path);
+            reloaded.Load();
+            REQUIRE(IsCached(reloaded, second));
+            REQUIRE_FALSE(IsCached(reloaded, first));
+        }
+    }
+
+    SECTION("files are read again when they change") {
+        WriteCacheFile(cache_path, {first, second});
+        GameMetadataCache cache(cache_path);
+        cache.Load();
+
+        SECTION("size") {
+            WriteFile(first, "not a game, but longer");
+            REQUIRE_FALSE(IsCached(cache, first));
+            REQUIRE(IsCached(cache, second));
+        }
+
+        SECTION("modification time") {
+            const auto modification_time = std::filesystem::last_write_time(first);
+            std::filesystem::last_write_time(first, modification_time - std::chrono::hours(1));
+            REQUIRE_FALSE(IsCached(cache, first));
+            REQUIRE(IsCached(cache, second));
+        }
+    }
+
+    SECTION("invalid files are not loaded") {
+        SECTION("truncated") {
+            WriteCacheFile(cache_path, {first, second});
+            REQUIRE(FileUtil::IOFile(cache_path, "r+b").Resize(FileUtil::GetSize(cache_path) - 1));
+        }
+
+        SECTION("truncated header") {
+            WriteCacheFile(cache_path, {first, second});
+            REQUIRE(FileUtil::IOFile(cache_path, "r+b").Resize(sizeof(CacheHeader) - 1));
+        }
+
+        SECTION("wrong version") {
+            WriteCacheFile(cache_path, {first, second});
+            FileUtil::IOFile file(cache_path, "r+b");
+            const u32_le version = 2;
+            REQUIRE(file.Seek(offsetof(CacheHeader, version), SEEK_SET));
+            REQUIRE(file.WriteObject(version) == 1);
+        }
+
+        SECTION("more entries than the file has") {
+            WriteCacheFile(cache_path, {first, second});
+            FileUtil::IOFile file(cache_path, "r+b");
+            const u64_le entry_count = 3;
+            REQUIRE(file.Seek(offsetof(CacheHeader, entry_count), SEEK_SET));
+            REQUIRE(file.WriteObject(entry_count) == 1);
+        }
+
+        SECTION("invalid file type") {
+            WriteCacheFile(cache_path, {first, second}, 0xFF);
+        }
+
+        GameMetadataCache cache(cache_path);
+        cache.Load();
+        REQUIRE_FALSE(IsCached(cache, first));
+        REQUIRE_FALSE(IsCached(cache, second));
+    }
+}
+
+} // namespace Loader
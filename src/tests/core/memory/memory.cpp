@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core_timing.h"
 #include "core/hle/kernel/process.h"
@@ -52,3 +55,102 @@ TEST_CASE("memory.IsValidVirtualAddress", "[core][memory]") {
         CHECK(memory.IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+namespace {
+
+constexpr u32 fastmem_test_size = 0x10 * Memory::CITRA_PAGE_SIZE;
+
+std::shared_ptr<Kernel::Process> CreateProcessWithHeap(Kernel::KernelSystem& kernel,
+                                                       Memory::MemorySystem& memory) {
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    process->vm_manager.MapBackingMemory(Memory::HEAP_VADDR, memory.GetFCRAMRef(0x100000),
+                                         fastmem_test_size, Kernel::MemoryState::Private);
+    return process;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("memory.Fastmem", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto process = CreateProcessWithHeap(kernel, memory);
+
+    std::vector<u8> data(fastmem_test_size);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>(i * 7 + i / 251);
+    }
+
+    SECTION("block accesses reach the backing memory") {
+        memory.WriteBlock(*process, Memory::HEAP_VADDR + 3, data.data(), data.size() - 3);
+        CHECK(std::memcmp(memory.GetFCRAMPointer(0x100000 + 3), data.data(), data.size() - 3) ==
+              0);
+
+        std::vector<u8> read(data.size() - 3);
+        memory.ReadBlock(*process, Memory::HEAP_VADDR + 3, read.data(), read.size());
+        CHECK(std::memcmp(read.data(), data.data(), read.size()) == 0);
+
+        if (u8* fastmem = memory.GetFastmemPointer(*process->vm_manager.page_table)) {
+            CHECK(std::memcmp(fastmem + Memory::HEAP_VADDR + 3, data.data(), read.size()) == 0);
+        }
+    }
+
+    SECTION("overlapping copies within a process") {
+        // Arenas are created on demand, so the page table is walked until one is requested
+        SECTION("without fastmem") {}
+        SECTION("with fastmem") {
+            memory.GetFastmemPointer(*process->vm_manager.page_table);
+        }
+        std::vector<u8> read(fastmem_test_size - 0x10);
+
+        memory.WriteBlock(*process, Memory::HEAP_VADDR, data.data(), data.size());
+        memory.CopyBlock(*process, Memory::HEAP_VADDR + 0x10, Memory::HEAP_VADDR, read.size());
+        memory.ReadBlock(*process, Memory::HEAP_VADDR + 0x10, read.data(), read.size());
+        CHECK(std::memcmp(read.data(), data.data(), read.size()) == 0);
+
+        memory.WriteBlock(*process, Memory::HEAP_VADDR, data.data(), data.size());
+        memory.CopyBlock(*process, Memory::HEAP_VADDR, Memory::HEAP_VADDR + 0x10, read.size());
+        memory.ReadBlock(*process, Memory::HEAP_VADDR, read.data(), read.size());
+        CHECK(std::memcmp(read.data(), data.data() + 0x10, read.size()) == 0);
+    }
+
+    SECTION("ranges with memory outside of the emulated RAM") {
+        auto buffer = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE);
+        process->vm_manager.MapBackingMemory(Memory::HEAP_VADDR + fastmem_test_size,
+                                             MemoryRef{buffer}, Memory::CITRA_PAGE_SIZE,
+                                             Kernel::MemoryState::Private);
+        memory.WriteBlock(*process, Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE, data.data(),
+                          data.size());
+        CHECK(std::memcmp(buffer->GetPtr(), data.data() + data.size() - Memory::CITRA_PAGE_SIZE,
+                          Memory::CITRA_PAGE_SIZE) == 0);
+
+        std::vector<u8> read(data.size());
+        memory.ReadBlock(*process, Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE, read.data(),
+                         read.size());
+        CHECK(read == data);
+    }
+}
+
+TEST_CASE("memory.BlockCopies", "[core][memory][.benchmark]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto process = CreateProcessWithHeap(kernel, memory);
+    std::vector<u8> buffer(fastmem_test_size / 2);
+
+    BENCHMARK("ReadBlock") {
+        memory.ReadBlock(*process, Memory::HEAP_VADDR + 0x10, buffer.data(), buffer.size());
+        return buffer[0];
+    };
+
+    BENCHMARK("WriteBlock") {
+        memory.WriteBlock(*process, Memory::HEAP_VADDR + 0x10, buffer.data(), buffer.size());
+    };
+
+    BENCHMARK("CopyBlock") {
+        memory.CopyBlock(*process, Memory::HEAP_VADDR + fastmem_test_size / 2,
+                         Memory::HEAP_VADDR + 0x10, buffer.size() - 0x10);
+    };
+}
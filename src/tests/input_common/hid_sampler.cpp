@@ -0,0 +1,154 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+#include "common/settings.h"
+#include "core/frontend/hid_input.h"
+#include "input_common/hid_sampler.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * A button that stamps every change of its state with the time it happened at. It locks on every
+ * read, like the devices of controller backends do.
+ */
+class StampedButton final : public Input::ButtonDevice {
+public:
+    bool GetStatus() const override {
+        std::scoped_lock lock{mutex};
+        return pressed;
+    }
+
+    void Set(bool pressed_) {
+        std::scoped_lock lock{mutex};
+        pressed = pressed_;
+        change_time = Clock::now();
+    }
+
+    Clock::time_point GetChangeTime() const {
+        std::scoped_lock lock{mutex};
+        return change_time;
+    }
+
+private:
+    mutable std::mutex mutex;
+    bool pressed = false;
+    Clock::time_point change_time;
+};
+
+class StampedButtonFactory final : public Input::Factory<Input::ButtonDevice> {
+public:
+    std::unique_ptr<Input::ButtonDevice> Create(const Common::ParamPackage&) override {
+        // The devices forward to the single button, so that every reader sees the same changes
+        class Forwarder final : public Input::ButtonDevice {
+        public:
+            explicit Forwarder(const StampedButton& button_) : button{button_} {}
+            bool GetStatus() const override {
+                return button.GetStatus();
+            }
+
+        private:
+            const StampedButton& button;
+        };
+        return std::make_unique<Forwarder>(button);
+    }
+
+    StampedButton button;
+};
+
+/// Maps the A button of the input profile to a stamped button for the lifetime of the object.
+class StampedProfile {
+public:
+    StampedProfile() : factory{std::make_shared<StampedButtonFactory>()} {
+        auto& buttons = Settings::values.current_input_profile.buttons;
+        old_button = buttons[Settings::NativeButton::A];
+        buttons[Settings::NativeButton::A] = "engine:stamped";
+        Input::RegisterFactory<Input::ButtonDevice>("stamped", factory);
+    }
+
+    ~StampedProfile() {
+        Input::UnregisterFactory<Input::ButtonDevice>("stamped");
+        Settings::values.current_input_profile.buttons[Settings::NativeButton::A] = old_button;
+    }
+
+    StampedButton& Button() {
+        return factory->button;
+    }
+
+private:
+    std::shared_ptr<StampedButtonFactory> factory;
+    std::string old_button;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("HIDSampler publishes the state of the devices", "[input_common]") {
+    StampedProfile profile;
+    InputCommon::HIDSampler sampler{std::chrono::microseconds(100)};
+    sampler.Start();
+
+    const auto wait_for = [&sampler](bool pressed) {
+        const auto deadline = Clock::now() + std::chrono::seconds(5);
+        while (sampler.Read().IsPressed(Settings::NativeButton::A) != pressed) {
+            if (Clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    };
+
+    profile.Button().Set(true);
+    REQUIRE(wait_for(true));
+    REQUIRE_FALSE(sampler.Read().IsPressed(Settings::NativeButton::B));
+    REQUIRE(sampler.Read().sample_time >= profile.Button().GetChangeTime());
+    profile.Button().Set(false);
+    REQUIRE(wait_for(false));
+    sampler.Stop();
+}
+
+TEST_CASE("HIDSampler only samples during emulation sessions", "[input_common]") {
+    StampedProfile profile;
+    InputCommon::HIDSampler sampler{std::chrono::microseconds(100)};
+    const auto wait_for = [&sampler](bool pressed) {
+        const auto deadline = Clock::now() + std::chrono::seconds(5);
+        while (sampler.Read().IsPressed(Settings::NativeButton::A) != pressed) {
+            if (Clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    };
+
+    profile.Button().Set(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE_FALSE(sampler.Read().IsPressed(Settings::NativeButton::A));
+
+    // Sessions overlap while a save state is loaded
+    sampler.Start();
+    sampler.Start();
+    REQUIRE(wait_for(true));
+    sampler.Stop();
+    profile.Button().Set(false);
+    REQUIRE(wait_for(false));
+
+    profile.Button().Set(true);
+    REQUIRE(wait_for(true));
+    sampler.Stop();
+    REQUIRE_FALSE(sampler.Read().IsPressed(Settings::NativeButton::A));
+    profile.Button().Set(false);
+    profile.Button().Set(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(sampler.Read().sample_time == Clock::time_point{});
+
+    sampler.Start();
+    REQUIRE(wait_for(true));
+    sampler.Stop();
+}
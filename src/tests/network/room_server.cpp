@@ -0,0 +1,46 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "enet/enet.h"
+#include "network/room.h"
+#include "network/room_server.h"
+#include "network/verify_user.h"
+
+namespace Network {
+
+TEST_CASE("RoomServer adds and removes rooms of a busy worker", "[network]") {
+    REQUIRE(enet_initialize() == 0);
+
+    std::vector<std::shared_ptr<Room>> rooms;
+    for (int i = 0; i < 2; i++) {
+        auto room = std::make_shared<Room>(Room::ServiceMode::External);
+        REQUIRE(room->Create("test", "", "127.0.0.1", 0, "", 4, "", "test", 0,
+                             std::make_unique<VerifyUser::NullBackend>()));
+        rooms.push_back(std::move(room));
+    }
+
+    {
+        // A single worker waits on the socket of the first room while the second is added
+        RoomServer room_server(1);
+        for (const auto& room : rooms) {
+            room_server.AddRoom(room);
+        }
+        REQUIRE(room_server.GetRooms() == rooms);
+
+        for (const auto& room : rooms) {
+            room_server.RemoveRoom(room);
+        }
+        REQUIRE(room_server.GetRooms().empty());
+    }
+
+    for (const auto& room : rooms) {
+        room->Destroy();
+    }
+    enet_deinitialize();
+}
+
+} // namespace Network
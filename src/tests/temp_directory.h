@@ -0,0 +1,44 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+#include <fmt/format.h>
+#include "common/common_types.h"
+
+namespace Tests {
+
+/**
+ * A directory with a unique name in the temporary directory of the host, removed along with
+ * everything in it when destroyed. Tests that fail a REQUIRE, or run at the same time as other
+ * tests, therefore never see the files of another run.
+ */
+class TempDirectory : NonCopyable {
+public:
+    explicit TempDirectory(const std::string& name) {
+        std::random_device random;
+        do {
+            path = std::filesystem::temp_directory_path() /
+                   fmt::format("citra_{}_{:08X}", name, random());
+        } while (!std::filesystem::create_directory(path));
+    }
+
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+
+    const std::filesystem::path& GetPath() const {
+        return path;
+    }
+
+private:
+    std::filesystem::path path;
+};
+
+} // namespace Tests
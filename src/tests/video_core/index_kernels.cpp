@@ -0,0 +1,100 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/index_kernels.h"
+#include "video_core/rasterizer_cache/index_range_cache.h"
+
+namespace {
+
+using VideoCore::IndexRangeCache;
+using VideoCore::Kernels::IndexRange;
+using VideoCore::Kernels::KernelSet;
+
+} // Anonymous namespace
+
+TEST_CASE("Index kernels match the generic implementation", "[video_core]") {
+    const KernelSet& generic = VideoCore::Kernels::GetGenericKernels();
+    const KernelSet& kernels = VideoCore::Kernels::GetKernels();
+    INFO("Kernels: " << kernels.name);
+
+    std::mt19937 rng(0xC17A);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<u8> buffer(2 * 1024 + 1);
+    for (u8& value : buffer) {
+        value = static_cast<u8>(byte(rng));
+    }
+
+    // Unaligned starts and every tail length exercise the vector loops and their remainders
+    for (std::size_t offset = 0; offset < 3; offset++) {
+        for (std::size_t count = 0; count <= 513; count++) {
+            const u8* indices = buffer.data() + offset;
+            REQUIRE(kernels.index_range_u8(indices, count) ==
+                    generic.index_range_u8(indices, count));
+            REQUIRE(kernels.index_range_u16(indices, count) ==
+                    generic.index_range_u16(indices, count));
+        }
+    }
+
+    // Extremes of the unsigned range, which a signed comparison would get wrong
+    const std::vector<u8> extremes{0x00, 0x80, 0xFF, 0x7F, 0x01, 0x80, 0xFF, 0xFF, 0x00, 0x00,
+                                   0xFF, 0x7F, 0x00, 0x80, 0x34, 0x12, 0xFE, 0xFF};
+    REQUIRE(kernels.index_range_u16(extremes.data(), 9) == IndexRange{0, 0xFFFF});
+    REQUIRE(kernels.index_range_u8(extremes.data(), 18) == IndexRange{0, 0xFF});
+    REQUIRE(kernels.index_range_u8(extremes.data(), 0) == IndexRange{0xFFFF, 0});
+}
+
+TEST_CASE("IndexRangeCache", "[video_core]") {
+    IndexRangeCache cache;
+    const u32 count = IndexRangeCache::MIN_CACHED_INDICES;
+    const IndexRange range{12, 345};
+    std::vector<IndexRangeCache::Region> dropped;
+    const auto drop = [&dropped](const IndexRangeCache::Region& region) {
+        dropped.push_back(region);
+    };
+
+    REQUIRE_FALSE(cache.ShouldInsert(0x1000, count - 1));
+    REQUIRE(cache.ShouldInsert(0x1000, count));
+    REQUIRE_FALSE(cache.Insert(0x1000, count, true, range));
+    REQUIRE(cache.Find(0x1000, count, true) == range);
+    REQUIRE_FALSE(cache.Find(0x1000, count, false));
+    REQUIRE_FALSE(cache.Find(0x1000, count + 1, true));
+
+    SECTION("writes next to the buffer keep it") {
+        cache.Invalidate(0x1000 - 4, 4, drop);
+        cache.Invalidate(0x1000 + count * 2, 4, drop);
+        REQUIRE(dropped.empty());
+        REQUIRE(cache.Find(0x1000, count, true) == range);
+    }
+
+    SECTION("writes to the buffer drop it and back off") {
+        cache.Invalidate(0x1000 + count * 2 - 1, 1, drop);
+        REQUIRE(dropped.size() == 1);
+        REQUIRE(dropped[0].addr == 0x1000);
+        REQUIRE(dropped[0].size == count * 2);
+        REQUIRE_FALSE(cache.Find(0x1000, count, true));
+
+        for (u32 i = 0; i < IndexRangeCache::WRITE_BACKOFF; i++) {
+            REQUIRE_FALSE(cache.ShouldInsert(0x1000, count));
+        }
+        REQUIRE(cache.ShouldInsert(0x1000, count));
+    }
+
+    SECTION("a new buffer of the same format replaces the old one") {
+        const auto replaced = cache.Insert(0x1000, count * 2, true, range);
+        REQUIRE(replaced);
+        REQUIRE(replaced->addr == 0x1000);
+        REQUIRE(replaced->size == count * 2);
+        REQUIRE(cache.Find(0x1000, count * 2, true) == range);
+    }
+
+    SECTION("clearing forgets everything") {
+        cache.Clear();
+        cache.Invalidate(0, 0xFFFFFFFF, drop);
+        REQUIRE(dropped.empty());
+        REQUIRE_FALSE(cache.Find(0x1000, count, true));
+    }
+}
@@ -0,0 +1,113 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/thread_worker.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+
+namespace OpenGL {
+
+namespace {
+
+template <typename T>
+void AppendObject(std::vector<u8>& entries, const T& object) {
+    const auto* bytes = reinterpret_cast<const u8*>(&object);
+    entries.insert(entries.end(), bytes, bytes + sizeof(T));
+}
+
+void AppendDecompiled(std::vector<u8>& entries, u64 unique_identifier, const std::string& code,
+                      bool sanitize_mul) {
+    AppendObject(entries, u32{0});
+    AppendObject(entries, unique_identifier);
+    AppendObject(entries, static_cast<u8>(sanitize_mul));
+    AppendObject(entries, static_cast<u32>(code.size()));
+    entries.insert(entries.end(), code.begin(), code.end());
+}
+
+void AppendDump(std::vector<u8>& entries, u64 unique_identifier, GLenum binary_format,
+                const std::vector<u8>& binary) {
+    AppendObject(entries, u32{1});
+    AppendObject(entries, unique_identifier);
+    AppendObject(entries, binary_format);
+    AppendObject(entries, static_cast<u32>(binary.size()));
+    entries.insert(entries.end(), binary.begin(), binary.end());
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Compressed precompiled shader caches round-trip", "[video_core][shader_cache]") {
+    // Several chunks of a few hundred entries each, like the ones the disk cache ends at 256 KiB
+    constexpr u64 NumEntries = 3000;
+    constexpr u64 EntriesPerChunk = 700;
+    std::vector<u8> entries;
+    std::vector<std::size_t> chunk_ends;
+    for (u64 i = 0; i < NumEntries; ++i) {
+        if (i % 2 == 0) {
+            AppendDecompiled(entries, i, "void main() { /* shader " + std::to_string(i) + " */ }",
+                             i % 4 == 0);
+        } else {
+            AppendDump(entries, i, static_cast<GLenum>(0x8000 + i),
+                       std::vector<u8>(i % 200 + 1, static_cast<u8>(i)));
+        }
+        if ((i + 1) % EntriesPerChunk == 0 || i + 1 == NumEntries) {
+            chunk_ends.push_back(entries.size());
+        }
+    }
+    REQUIRE(chunk_ends.size() == 5);
+
+    std::vector<u8> file_data =
+        ShaderDiskCache::BuildCompressedPrecompiledFile(entries, chunk_ends);
+    Common::ThreadWorker workers(4, "ShaderDiskCacheTest");
+
+    SECTION("all the entries and chunks are read back") {
+        const auto precompiled = ShaderDiskCache::ReadCompressedPrecompiledFile(file_data, workers);
+        REQUIRE(precompiled);
+        REQUIRE(precompiled->entries == entries);
+        REQUIRE(precompiled->chunk_ends == chunk_ends);
+        REQUIRE(precompiled->decompiled.size() == NumEntries / 2);
+        REQUIRE(precompiled->dumps.size() == NumEntries / 2);
+
+        const auto& decompiled = precompiled->decompiled.at(1234);
+        REQUIRE(decompiled.result.code == "void main() { /* shader 1234 */ }");
+        REQUIRE_FALSE(decompiled.sanitize_mul);
+        REQUIRE(precompiled->decompiled.at(1236).sanitize_mul);
+
+        const auto& dump = precompiled->dumps.at(2345);
+        REQUIRE(dump.binary_format == 0x8000 + 2345);
+        REQUIRE(dump.binary == std::vector<u8>(2345 % 200 + 1, static_cast<u8>(2345)));
+    }
+
+    SECTION("a truncated file is rejected") {
+        file_data.resize(file_data.size() - 1);
+        REQUIRE_FALSE(ShaderDiskCache::ReadCompressedPrecompiledFile(file_data, workers));
+    }
+
+    SECTION("a file with a truncated index is rejected") {
+        file_data.resize(72 + 8 * 2);
+        REQUIRE_FALSE(ShaderDiskCache::ReadCompressedPrecompiledFile(file_data, workers));
+    }
+
+    SECTION("a file of another format is rejected") {
+        std::memcpy(file_data.data(), "XXXX", 4);
+        REQUIRE_FALSE(ShaderDiskCache::ReadCompressedPrecompiledFile(file_data, workers));
+    }
+}
+
+TEST_CASE("Empty compressed precompiled shader caches round-trip", "[video_core][shader_cache]") {
+    const std::vector<std::size_t> chunk_ends{0};
+    const std::vector<u8> file_data =
+        ShaderDiskCache::BuildCompressedPrecompiledFile({}, chunk_ends);
+    Common::ThreadWorker workers(1, "ShaderDiskCacheTest");
+
+    const auto precompiled = ShaderDiskCache::ReadCompressedPrecompiledFile(file_data, workers);
+    REQUIRE(precompiled);
+    REQUIRE(precompiled->entries.empty());
+    REQUIRE(precompiled->decompiled.empty());
+    REQUIRE(precompiled->dumps.empty());
+}
+
+} // namespace OpenGL
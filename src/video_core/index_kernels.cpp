@@ -0,0 +1,177 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "common/arch.h"
+#include "common/logging/log.h"
+#include "video_core/index_kernels.h"
+
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+namespace VideoCore::Kernels {
+
+namespace {
+
+IndexRange IndexRangeU8Generic(const u8* indices, std::size_t count) {
+    IndexRange range{0xFFFF, 0};
+    for (std::size_t i = 0; i < count; i++) {
+        range.min = std::min<u32>(range.min, indices[i]);
+        range.max = std::max<u32>(range.max, indices[i]);
+    }
+    return range;
+}
+
+IndexRange IndexRangeU16Generic(const u8* indices, std::size_t count) {
+    IndexRange range{0xFFFF, 0};
+    for (std::size_t i = 0; i < count; i++) {
+        u16 index;
+        std::memcpy(&index, indices + i * sizeof(u16), sizeof(u16));
+        range.min = std::min<u32>(range.min, index);
+        range.max = std::max<u32>(range.max, index);
+    }
+    return range;
+}
+
+/// Combines the range of the vectorized part of a buffer with the one of its tail.
+IndexRange Merge(IndexRange head, IndexRange tail) {
+    return {std::min(head.min, tail.min), std::max(head.max, tail.max)};
+}
+
+constexpr KernelSet generic_kernels{
+    .name = "generic",
+    .index_range_u8 = IndexRangeU8Generic,
+    .index_range_u16 = IndexRangeU16Generic,
+};
+
+#if CITRA_ARCH(x86_64)
+
+IndexRange IndexRangeU8SSE2(const u8* indices, std::size_t count) {
+    if (count < 16) {
+        return IndexRangeU8Generic(indices, count);
+    }
+    __m128i min = _mm_set1_epi8(-1);
+    __m128i max = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+        min = _mm_min_epu8(min, block);
+        max = _mm_max_epu8(max, block);
+    }
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 8));
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 8));
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 4));
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 4));
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 2));
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 2));
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 1));
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 1));
+    const IndexRange head{static_cast<u32>(_mm_cvtsi128_si32(min) & 0xFF),
+                          static_cast<u32>(_mm_cvtsi128_si32(max) & 0xFF)};
+    return Merge(head, IndexRangeU8Generic(indices + i, count - i));
+}
+
+IndexRange IndexRangeU16SSE2(const u8* indices, std::size_t count) {
+    if (count < 8) {
+        return IndexRangeU16Generic(indices, count);
+    }
+    // SSE2 only has signed 16-bit min/max, flipping the sign bit maps the unsigned order onto it
+    const __m128i bias = _mm_set1_epi16(static_cast<s16>(0x8000));
+    __m128i min = _mm_set1_epi16(0x7FFF);
+    __m128i max = _mm_set1_epi16(static_cast<s16>(0x8000));
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i block = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i * sizeof(u16))), bias);
+        min = _mm_min_epi16(min, block);
+        max = _mm_max_epi16(max, block);
+    }
+    min = _mm_min_epi16(min, _mm_srli_si128(min, 8));
+    max = _mm_max_epi16(max, _mm_srli_si128(max, 8));
+    min = _mm_min_epi16(min, _mm_srli_si128(min, 4));
+    max = _mm_max_epi16(max, _mm_srli_si128(max, 4));
+    min = _mm_min_epi16(min, _mm_srli_si128(min, 2));
+    max = _mm_max_epi16(max, _mm_srli_si128(max, 2));
+    const IndexRange head{static_cast<u32>((_mm_cvtsi128_si32(min) ^ 0x8000) & 0xFFFF),
+                          static_cast<u32>((_mm_cvtsi128_si32(max) ^ 0x8000) & 0xFFFF)};
+    return Merge(head, IndexRangeU16Generic(indices + i * sizeof(u16), count - i));
+}
+
+constexpr KernelSet sse2_kernels{
+    .name = "SSE2",
+    .index_range_u8 = IndexRangeU8SSE2,
+    .index_range_u16 = IndexRangeU16SSE2,
+};
+
+#elif CITRA_ARCH(arm64)
+
+IndexRange IndexRangeU8NEON(const u8* indices, std::size_t count) {
+    if (count < 16) {
+        return IndexRangeU8Generic(indices, count);
+    }
+    uint8x16_t min = vdupq_n_u8(0xFF);
+    uint8x16_t max = vdupq_n_u8(0);
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t block = vld1q_u8(indices + i);
+        min = vminq_u8(min, block);
+        max = vmaxq_u8(max, block);
+    }
+    const IndexRange head{vminvq_u8(min), vmaxvq_u8(max)};
+    return Merge(head, IndexRangeU8Generic(indices + i, count - i));
+}
+
+IndexRange IndexRangeU16NEON(const u8* indices, std::size_t count) {
+    if (count < 8) {
+        return IndexRangeU16Generic(indices, count);
+    }
+    uint16x8_t min = vdupq_n_u16(0xFFFF);
+    uint16x8_t max = vdupq_n_u16(0);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // Loaded as bytes, as the indices are not necessarily aligned
+        const uint16x8_t block = vreinterpretq_u16_u8(vld1q_u8(indices + i * sizeof(u16)));
+        min = vminq_u16(min, block);
+        max = vmaxq_u16(max, block);
+    }
+    const IndexRange head{vminvq_u16(min), vmaxvq_u16(max)};
+    return Merge(head, IndexRangeU16Generic(indices + i * sizeof(u16), count - i));
+}
+
+constexpr KernelSet neon_kernels{
+    .name = "NEON",
+    .index_range_u8 = IndexRangeU8NEON,
+    .index_range_u16 = IndexRangeU16NEON,
+};
+
+#endif
+
+const KernelSet& SelectKernels() {
+#if CITRA_ARCH(x86_64)
+    const KernelSet& kernels = sse2_kernels;
+#elif CITRA_ARCH(arm64)
+    const KernelSet& kernels = neon_kernels;
+#else
+    const KernelSet& kernels = generic_kernels;
+#endif
+    LOG_INFO(HW_GPU, "Using {} index kernels", kernels.name);
+    return kernels;
+}
+
+} // Anonymous namespace
+
+const KernelSet& GetGenericKernels() {
+    return generic_kernels;
+}
+
+const KernelSet& GetKernels() {
+    static const KernelSet& kernels = SelectKernels();
+    return kernels;
+}
+
+} // namespace VideoCore::Kernels
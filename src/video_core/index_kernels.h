@@ -0,0 +1,43 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace VideoCore::Kernels {
+
+/// Smallest and largest vertex referenced by an index buffer.
+struct IndexRange {
+    u32 min;
+    u32 max;
+
+    auto operator<=>(const IndexRange&) const = default;
+};
+
+/**
+ * Scans of the index buffers of indexed draws. The generic implementation defines the exact
+ * output of each routine; implementations using vector instructions must match it.
+ *
+ * An empty buffer yields {0xFFFF, 0}, like the scalar loop these replace.
+ */
+struct KernelSet {
+    /// Name of the implementation, for logging and benchmarks.
+    const char* name;
+
+    /// Returns the range of count u8 indices.
+    IndexRange (*index_range_u8)(const u8* indices, std::size_t count);
+
+    /// Returns the range of count (possibly unaligned) u16 indices.
+    IndexRange (*index_range_u16)(const u8* indices, std::size_t count);
+};
+
+/// Returns the portable implementation of the kernels.
+const KernelSet& GetGenericKernels();
+
+/// Returns the fastest implementation of the kernels supported by the host CPU.
+const KernelSet& GetKernels();
+
+} // namespace VideoCore::Kernels
@@ -88,6 +88,14 @@ void RasterizerAccelerated::AddTriangle(const Pica::Shader::OutputVertex& v0,
     vertex_batch.emplace_back(v2, AreQuaternionsOpposite(v0.quat, v2.quat));
 }
 
+Kernels::IndexRange RasterizerAccelerated::GetIndexRange(PAddr addr, u32 count, bool index_u16) {
+    FlushRegion(addr, count * (index_u16 ? 2 : 1));
+    const u8* indices = memory.GetPhysicalPointer(addr);
+    const auto& kernels = Kernels::GetKernels();
+    return index_u16 ? kernels.index_range_u16(indices, count)
+                     : kernels.index_range_u8(indices, count);
+}
+
 RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray(
     bool is_indexed, u32 stride_alignment) {
     const auto& vertex_attributes = regs.pipeline.vertex_attributes;
@@ -97,19 +105,12 @@ RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray
     if (is_indexed) {
         const auto& index_info = regs.pipeline.index_array;
         const PAddr address = vertex_attributes.GetPhysicalBaseAddress() + index_info.offset;
-        const u8* index_address_8 = memory.GetPhysicalPointer(address);
-        const u16* index_address_16 = reinterpret_cast<const u16*>(index_address_8);
         const bool index_u16 = index_info.format != 0;
 
-        vertex_min = 0xFFFF;
-        vertex_max = 0;
-        const u32 size = regs.pipeline.num_vertices * (index_u16 ? 2 : 1);
-        FlushRegion(address, size);
-        for (u32 index = 0; index < regs.pipeline.num_vertices; ++index) {
-            const u32 vertex = index_u16 ? index_address_16[index] : index_address_8[index];
-            vertex_min = std::min(vertex_min, vertex);
-            vertex_max = std::max(vertex_max, vertex);
-        }
+        const Kernels::IndexRange range =
+            GetIndexRange(address, regs.pipeline.num_vertices, index_u16);
+        vertex_min = range.min;
+        vertex_max = range.max;
     } else {
         vertex_min = regs.pipeline.vertex_offset;
         vertex_max = regs.pipeline.vertex_offset + regs.pipeline.num_vertices - 1;
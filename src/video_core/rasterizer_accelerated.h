@@ -5,6 +5,7 @@
 #pragma once
 
 #include "common/vector_math.h"
+#include "video_core/index_kernels.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/regs_texturing.h"
 #include "video_core/shader/shader_uniforms.h"
@@ -136,6 +137,12 @@ protected:
         u32 vs_input_size;
     };
 
+    /**
+     * Returns the range of vertices referenced by the index buffer of count indices at addr.
+     * Backends with a rasterizer cache override this to cache the ranges of repeated buffers.
+     */
+    virtual Kernels::IndexRange GetIndexRange(PAddr addr, u32 count, bool index_u16);
+
     /// Retrieve the range and the size of the input vertex
     VertexArrayInfo AnalyzeVertexArray(bool is_indexed, u32 stride_alignment = 1);
 
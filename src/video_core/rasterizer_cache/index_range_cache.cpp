@@ -0,0 +1,48 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/rasterizer_cache/index_range_cache.h"
+
+namespace VideoCore {
+
+bool IndexRangeCache::ShouldInsert(PAddr addr, u32 count) {
+    if (count < MIN_CACHED_INDICES) {
+        return false;
+    }
+    Slot& slot = slots[SlotIndex(addr)];
+    if (slot.addr == addr && slot.backoff > 0) {
+        slot.backoff--;
+        return false;
+    }
+    return true;
+}
+
+std::optional<IndexRangeCache::Region> IndexRangeCache::Insert(PAddr addr, u32 count,
+                                                               bool index_u16,
+                                                               Kernels::IndexRange range) {
+    Slot& slot = slots[SlotIndex(addr)];
+    std::optional<Region> replaced;
+    if (slot.valid) {
+        replaced = Region{slot.addr, slot.size};
+    } else {
+        num_valid++;
+    }
+    slot = Slot{
+        .addr = addr,
+        .size = count * (index_u16 ? 2 : 1),
+        .count = count,
+        .backoff = 0,
+        .range = range,
+        .index_u16 = index_u16,
+        .valid = true,
+    };
+    return replaced;
+}
+
+void IndexRangeCache::Clear() {
+    slots = {};
+    num_valid = 0;
+}
+
+} // namespace VideoCore
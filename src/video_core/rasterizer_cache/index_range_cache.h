@@ -0,0 +1,102 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include "common/common_types.h"
+#include "video_core/index_kernels.h"
+
+namespace VideoCore {
+
+/**
+ * Remembers the vertex ranges of recently drawn index buffers, so that a buffer drawn many times,
+ * like the ones of skinned meshes, is scanned only once.
+ *
+ * Entries are direct-mapped by address. While an entry is valid its owner keeps the memory of
+ * the buffer watched through the page tracking of the rasterizer cache, so that any CPU write to
+ * it reaches Invalidate.
+ */
+class IndexRangeCache {
+public:
+    /// Smaller buffers are scanned faster than their pages can be watched.
+    static constexpr u32 MIN_CACHED_INDICES = 128;
+
+    /// Number of draws a buffer is not cached for after being written to.
+    static constexpr u32 WRITE_BACKOFF = 64;
+
+    struct Region {
+        PAddr addr;
+        u32 size;
+    };
+
+    /// Returns the range of the buffer of count indices at addr, if it is cached.
+    std::optional<Kernels::IndexRange> Find(PAddr addr, u32 count, bool index_u16) const {
+        const Slot& slot = slots[SlotIndex(addr)];
+        if (!slot.valid || slot.addr != addr || slot.count != count ||
+            slot.index_u16 != index_u16) {
+            return std::nullopt;
+        }
+        return slot.range;
+    }
+
+    /**
+     * Returns whether a buffer that was not found should be inserted. Buffers that were written
+     * to since they were last cached are usually rewritten every frame, so they are skipped for
+     * a while instead of having their pages watched and unwatched on every write.
+     */
+    bool ShouldInsert(PAddr addr, u32 count);
+
+    /**
+     * Caches the range of a buffer. The caller must watch the memory of the buffer, and stop
+     * watching the returned region of the entry it replaced, if any.
+     */
+    std::optional<Region> Insert(PAddr addr, u32 count, bool index_u16,
+                                 Kernels::IndexRange range);
+
+    /// Drops the entries overlapping [addr, addr + size), passing the region of each to func.
+    template <typename Func>
+    void Invalidate(PAddr addr, u32 size, Func&& func) {
+        if (num_valid == 0) {
+            return;
+        }
+        const u64 end = u64{addr} + size;
+        for (Slot& slot : slots) {
+            if (!slot.valid || slot.addr >= end || u64{slot.addr} + slot.size <= addr) {
+                continue;
+            }
+            slot.valid = false;
+            slot.backoff = WRITE_BACKOFF;
+            num_valid--;
+            func(Region{slot.addr, slot.size});
+        }
+    }
+
+    /// Drops all entries, for when the page tracking itself is reset.
+    void Clear();
+
+private:
+    static constexpr std::size_t NUM_SLOTS = 64;
+
+    struct Slot {
+        PAddr addr;
+        u32 size;
+        u32 count;
+        u32 backoff;
+        Kernels::IndexRange range;
+        bool index_u16;
+        bool valid;
+    };
+
+    static std::size_t SlotIndex(PAddr addr) {
+        // Index buffers are at least 2-byte aligned and often page aligned
+        return ((addr >> 1) ^ (addr >> 12)) % NUM_SLOTS;
+    }
+
+    std::array<Slot, NUM_SLOTS> slots{};
+    u32 num_valid = 0;
+};
+
+} // namespace VideoCore
@@ -1196,6 +1196,7 @@ void RasterizerCache<T>::ClearAll(bool flush) {
 
     // Remove the whole cache without really looking at it.
     cached_pages -= flush_interval;
+    index_ranges.Clear();
     dirty_regions -= SurfaceInterval(0x0, 0xFFFFFFFF);
     page_table.clear();
     remove_surfaces.clear();
@@ -1279,6 +1280,10 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region
         }
     });
 
+    index_ranges.Invalidate(addr, size, [this](const IndexRangeCache::Region& region) {
+        UpdatePagesCachedCount(region.addr, region.size, -1);
+    });
+
     if (region_owner_id) {
         dirty_regions.set({invalid_interval, region_owner_id});
     } else {
@@ -1368,6 +1373,29 @@ void RasterizerCache<T>::UnregisterAll() {
     runtime.Reset();
 }
 
+template <class T>
+Kernels::IndexRange RasterizerCache<T>::GetIndexRange(PAddr addr, u32 count, bool index_u16) {
+    const u32 size = count * (index_u16 ? 2 : 1);
+    FlushRegion(addr, size);
+    if (const auto range = index_ranges.Find(addr, count, index_u16)) {
+        return *range;
+    }
+
+    const u8* indices = memory.GetPhysicalPointer(addr);
+    const auto& kernels = Kernels::GetKernels();
+    const Kernels::IndexRange range = index_u16 ? kernels.index_range_u16(indices, count)
+                                                : kernels.index_range_u8(indices, count);
+
+    // Watching the pages of the buffer makes CPU writes to it reach InvalidateRegion
+    if (index_ranges.ShouldInsert(addr, count)) {
+        if (const auto replaced = index_ranges.Insert(addr, count, index_u16, range)) {
+            UpdatePagesCachedCount(replaced->addr, replaced->size, -1);
+        }
+        UpdatePagesCachedCount(addr, size, 1);
+    }
+    return range;
+}
+
 template <class T>
 void RasterizerCache<T>::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
     const u32 num_pages =
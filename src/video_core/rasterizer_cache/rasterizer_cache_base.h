@@ -10,6 +10,7 @@
 #include <vector>
 #include <boost/icl/interval_map.hpp>
 #include <tsl/robin_map.h>
+#include "video_core/rasterizer_cache/index_range_cache.h"
 #include "video_core/rasterizer_cache/sampler_params.h"
 #include "video_core/rasterizer_cache/surface_base.h"
 
@@ -139,6 +140,9 @@ public:
     /// Clear all cached resources tracked by this cache manager
     void ClearAll(bool flush);
 
+    /// Get the range of vertices referenced by the index buffer of count indices at addr
+    Kernels::IndexRange GetIndexRange(PAddr addr, u32 count, bool index_u16);
+
 private:
     /// Iterate over all page indices in a range
     template <typename Func>
@@ -218,6 +222,7 @@ private:
     Common::SlotVector<Sampler> slot_samplers;
     SurfaceMap dirty_regions;
     PageMap cached_pages;
+    IndexRangeCache index_ranges;
     std::vector<SurfaceId> remove_surfaces;
     u32 resolution_scale_factor;
     RenderTargets render_targets;
@@ -47,7 +47,8 @@ void RendererBase::EndFrame() {
 
     render_window.PollEvents();
 
-    system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs(),
+                                         system.perf_stats->PredictFrametime());
     system.perf_stats->BeginSystemFrame();
 
     if (Pica::g_debug_context && Pica::g_debug_context->recorder) {
@@ -729,6 +729,11 @@ void RasterizerOpenGL::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
 
+VideoCore::Kernels::IndexRange RasterizerOpenGL::GetIndexRange(PAddr addr, u32 count,
+                                                               bool index_u16) {
+    return res_cache.GetIndexRange(addr, count, index_u16);
+}
+
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
     return res_cache.AccelerateDisplayTransfer(config);
 }
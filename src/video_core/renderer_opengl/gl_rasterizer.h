@@ -54,6 +54,8 @@ public:
 private:
     void SyncFixedState() override;
     void NotifyFixedFunctionPicaRegisterChanged(u32 id) override;
+    VideoCore::Kernels::IndexRange GetIndexRange(PAddr addr, u32 count,
+                                                 bool index_u16) override;
 
     /// Syncs the clip enabled status to match the PICA register
     void SyncClipEnabled();
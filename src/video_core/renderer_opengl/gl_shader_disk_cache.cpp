@@ -9,6 +9,7 @@
 #include "common/common_paths.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
@@ -33,6 +34,25 @@ enum class PrecompiledEntryKind : u32 {
 
 constexpr u32 NativeVersion = 1;
 
+// Compressed precompiled caches are split in chunks of about this size, which are compressed on
+// their own so that they can be decompressed in parallel
+constexpr std::size_t PRECOMPILED_CHUNK_SIZE = 256 * 1024;
+
+constexpr std::array<char, 4> PRECOMPILED_MAGIC{'C', 'P', 'S', 'C'};
+
+struct PrecompiledHeader {
+    std::array<char, 4> magic;
+    ShaderCacheVersionHash version_hash;
+    u32 num_chunks;
+};
+static_assert(sizeof(PrecompiledHeader) == 72, "PrecompiledHeader has incorrect size");
+
+/// Entry of the index that follows the header of compressed precompiled caches
+struct PrecompiledChunk {
+    u32 size;
+    u32 compressed_size;
+};
+
 // The hash is based on relevant files. The list of files can be found at src/common/CMakeLists.txt
 // and CMakeModules/GenerateSCMRev.cmake
 ShaderCacheVersionHash GetShaderCacheVersionHash() {
@@ -42,6 +62,81 @@ ShaderCacheVersionHash GetShaderCacheVersionHash() {
     return hash;
 }
 
+/// Parses the entries of a decompressed precompiled cache. Returns false on failure.
+static bool ParsePrecompiledEntries(std::span<const u8> data, ShaderDecompiledMap& decompiled,
+                                    ShaderDumpsMap& dumps) {
+    std::size_t offset = 0;
+    const auto read = [&](void* dest, std::size_t size) {
+        if (data.size() - offset < size) {
+            return false;
+        }
+        std::memcpy(dest, data.data() + offset, size);
+        offset += size;
+        return true;
+    };
+
+    while (offset < data.size()) {
+        PrecompiledEntryKind kind{};
+        u64 unique_identifier{};
+        if (!read(&kind, sizeof(kind)) || !read(&unique_identifier, sizeof(unique_identifier))) {
+            return false;
+        }
+
+        switch (kind) {
+        case PrecompiledEntryKind::Decompiled: {
+            bool sanitize_mul{};
+            u32 code_size{};
+            if (!read(&sanitize_mul, sizeof(sanitize_mul)) ||
+                !read(&code_size, sizeof(code_size))) {
+                return false;
+            }
+
+            std::string code(code_size, '\0');
+            if (!read(code.data(), code.size())) {
+                return false;
+            }
+
+            ShaderDiskCacheDecompiled entry;
+            entry.result.code = std::move(code);
+            entry.sanitize_mul = sanitize_mul;
+            decompiled.insert({unique_identifier, std::move(entry)});
+            break;
+        }
+        case PrecompiledEntryKind::Dump: {
+            ShaderDiskCacheDump dump;
+            u32 binary_length{};
+            if (!read(&dump.binary_format, sizeof(dump.binary_format)) ||
+                !read(&binary_length, sizeof(binary_length))) {
+                return false;
+            }
+
+            dump.binary.resize(binary_length);
+            if (!read(dump.binary.data(), dump.binary.size())) {
+                return false;
+            }
+            dumps.insert({unique_identifier, std::move(dump)});
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+u64 GetUniqueIdentifier(const Pica::Regs& regs, const ProgramCode& code) {
+    std::size_t hash = 0;
+    u64 regs_uid = Common::ComputeHash64(regs.reg_array.data(), Pica::Regs::NUM_REGS * sizeof(u32));
+    hash = Common::HashCombine(hash, regs_uid);
+
+    if (code.size() > 0) {
+        u64 code_uid = Common::ComputeHash64(code.data(), code.size() * sizeof(u32));
+        hash = Common::HashCombine(hash, code_uid);
+    }
+
+    return hash;
+}
+
 ShaderDiskCacheRaw::ShaderDiskCacheRaw(u64 unique_identifier, ProgramType program_type,
                                        RawShaderConfig config, ProgramCode program_code)
     : unique_identifier{unique_identifier}, program_type{program_type}, config{config},
@@ -145,40 +240,70 @@ std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::LoadTransferable
 
     // Version is valid, load the shaders
     std::vector<ShaderDiskCacheRaw> raws;
-    while (transferable_file.Tell() < transferable_file.GetSize()) {
+    if (!ReadTransferableEntries(transferable_file, raws)) {
+        LOG_ERROR(Render_OpenGL, "Failed to read transferable file - removing");
+        InvalidateAll();
+        return std::nullopt;
+    }
+    for (const ShaderDiskCacheRaw& raw : raws) {
+        transferable.emplace(raw.GetUniqueIdentifier(), ShaderDiskCacheRaw{});
+    }
+
+    LOG_INFO(Render_OpenGL, "Found a transferable disk cache with {} entries", raws.size());
+    return {std::move(raws)};
+}
+
+std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::ReadTransferableFile(
+    FileUtil::IOFile& file) {
+    u32 version{};
+    if (file.ReadBytes(&version, sizeof(version)) != sizeof(version) || version != NativeVersion) {
+        return std::nullopt;
+    }
+    std::vector<ShaderDiskCacheRaw> raws;
+    if (!ReadTransferableEntries(file, raws)) {
+        return std::nullopt;
+    }
+    return raws;
+}
+
+bool ShaderDiskCache::WriteTransferableFile(FileUtil::IOFile& file,
+                                            std::span<const ShaderDiskCacheRaw> raws) {
+    if (file.WriteObject(NativeVersion) != 1) {
+        return false;
+    }
+    return std::all_of(raws.begin(), raws.end(), [&file](const ShaderDiskCacheRaw& raw) {
+        return file.WriteObject(TransferableEntryKind::Raw) == 1 && raw.Save(file);
+    });
+}
+
+bool ShaderDiskCache::ReadTransferableEntries(FileUtil::IOFile& file,
+                                              std::vector<ShaderDiskCacheRaw>& raws) {
+    while (file.Tell() < file.GetSize()) {
         TransferableEntryKind kind{};
-        if (transferable_file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
-            LOG_ERROR(Render_OpenGL, "Failed to read transferable file - removing");
-            InvalidateAll();
-            return std::nullopt;
+        if (file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
+            return false;
         }
 
         switch (kind) {
         case TransferableEntryKind::Raw: {
             ShaderDiskCacheRaw entry;
-            if (!entry.Load(transferable_file)) {
-                LOG_ERROR(Render_OpenGL, "Failed to load transferable raw entry - removing");
-                InvalidateAll();
-                return std::nullopt;
+            if (!entry.Load(file)) {
+                LOG_ERROR(Render_OpenGL, "Failed to load transferable raw entry");
+                return false;
             }
-            transferable.emplace(entry.GetUniqueIdentifier(), ShaderDiskCacheRaw{});
             raws.push_back(std::move(entry));
             break;
         }
         default:
-            LOG_ERROR(Render_OpenGL, "Unknown transferable shader cache entry kind={} - removing",
-                      kind);
-            InvalidateAll();
-            return std::nullopt;
+            LOG_ERROR(Render_OpenGL, "Unknown transferable shader cache entry kind={}", kind);
+            return false;
         }
     }
-
-    LOG_INFO(Render_OpenGL, "Found a transferable disk cache with {} entries", raws.size());
-    return {std::move(raws)};
+    return true;
 }
 
 std::pair<std::unordered_map<u64, ShaderDiskCacheDecompiled>, ShaderDumpsMap>
-ShaderDiskCache::LoadPrecompiled(bool compressed) {
+ShaderDiskCache::LoadPrecompiled(bool compressed, Common::ThreadWorker& workers) {
     if (!IsUsable())
         return {};
 
@@ -188,7 +313,7 @@ ShaderDiskCache::LoadPrecompiled(bool compressed) {
         return {};
     }
 
-    const auto result = LoadPrecompiledFile(precompiled_file, compressed);
+    const auto result = LoadPrecompiledFile(precompiled_file, compressed, workers);
     if (!result) {
         LOG_INFO(Render_OpenGL,
                  "Failed to load precompiled cache for game with title id={} - removing",
@@ -199,109 +324,139 @@ ShaderDiskCache::LoadPrecompiled(bool compressed) {
     return *result;
 }
 
-std::optional<std::pair<std::unordered_map<u64, ShaderDiskCacheDecompiled>, ShaderDumpsMap>>
-ShaderDiskCache::LoadPrecompiledFile(FileUtil::IOFile& file, bool compressed) {
-    // Read compressed file from disk and decompress to virtual precompiled cache file
-    std::vector<u8> precompiled_file(file.GetSize());
-    file.ReadBytes(precompiled_file.data(), precompiled_file.size());
-    if (compressed) {
-        const std::vector<u8> decompressed =
-            Common::Compression::DecompressDataZSTD(precompiled_file);
-        SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
-    } else {
-        SaveArrayToPrecompiled(precompiled_file.data(), precompiled_file.size());
-    }
-
-    decompressed_precompiled_cache_offset = 0;
-
-    ShaderCacheVersionHash file_hash{};
-    if (!LoadArrayFromPrecompiled(file_hash.data(), file_hash.size())) {
-        return std::nullopt;
-    }
-    if (GetShaderCacheVersionHash() != file_hash) {
-        LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
+std::optional<std::pair<ShaderDecompiledMap, ShaderDumpsMap>>
+ShaderDiskCache::LoadPrecompiledFile(FileUtil::IOFile& file, bool compressed,
+                                     Common::ThreadWorker& workers) {
+    std::vector<u8> file_data(file.GetSize());
+    if (file.ReadBytes(file_data.data(), file_data.size()) != file_data.size()) {
         return std::nullopt;
     }
 
-    std::unordered_map<u64, ShaderDiskCacheDecompiled> decompiled;
+    ShaderDecompiledMap decompiled;
     ShaderDumpsMap dumps;
-    while (decompressed_precompiled_cache_offset < decompressed_precompiled_cache.size()) {
-        PrecompiledEntryKind kind{};
-        if (!LoadObjectFromPrecompiled(kind)) {
+    if (!compressed) {
+        ShaderCacheVersionHash file_hash{};
+        if (file_data.size() < file_hash.size()) {
             return std::nullopt;
         }
-
-        switch (kind) {
-        case PrecompiledEntryKind::Decompiled: {
-            u64 unique_identifier{};
-            if (!LoadObjectFromPrecompiled(unique_identifier)) {
-                return std::nullopt;
-            }
-
-            auto entry = LoadDecompiledEntry();
-            if (!entry) {
-                return std::nullopt;
-            }
-            decompiled.insert({unique_identifier, std::move(*entry)});
-            break;
+        std::memcpy(file_hash.data(), file_data.data(), file_hash.size());
+        if (GetShaderCacheVersionHash() != file_hash) {
+            LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
+            return std::nullopt;
         }
-        case PrecompiledEntryKind::Dump: {
-            u64 unique_identifier;
-            if (!LoadObjectFromPrecompiled(unique_identifier)) {
-                return std::nullopt;
-            }
-
-            ShaderDiskCacheDump dump;
-            if (!LoadObjectFromPrecompiled(dump.binary_format)) {
-                return std::nullopt;
-            }
-
-            u32 binary_length{};
-            if (!LoadObjectFromPrecompiled(binary_length)) {
-                return std::nullopt;
-            }
-
-            dump.binary.resize(binary_length);
-            if (!LoadArrayFromPrecompiled(dump.binary.data(), dump.binary.size())) {
-                return std::nullopt;
-            }
-
-            dumps.insert({unique_identifier, dump});
-            break;
+        const std::span entries{file_data.begin() + file_hash.size(), file_data.end()};
+        if (!ParsePrecompiledEntries(entries, decompiled, dumps)) {
+            return std::nullopt;
         }
-        default:
+    } else {
+        auto precompiled = ReadCompressedPrecompiledFile(file_data, workers);
+        if (!precompiled) {
             return std::nullopt;
         }
+        // Keep the loaded entries in the virtual precompiled cache file, so that they are saved
+        // along with the new ones
+        decompiled = std::move(precompiled->decompiled);
+        dumps = std::move(precompiled->dumps);
+        decompressed_precompiled_cache = std::move(precompiled->entries);
+        precompiled_chunk_ends = std::move(precompiled->chunk_ends);
     }
 
     LOG_INFO(Render_OpenGL,
              "Found a precompiled disk cache with {} decompiled entries and {} binary entries",
              decompiled.size(), dumps.size());
-    return {{decompiled, dumps}};
+    return {{std::move(decompiled), std::move(dumps)}};
 }
 
-std::optional<ShaderDiskCacheDecompiled> ShaderDiskCache::LoadDecompiledEntry() {
-
-    bool sanitize_mul;
-    if (!LoadObjectFromPrecompiled(sanitize_mul)) {
+std::optional<ShaderDiskCachePrecompiled> ShaderDiskCache::ReadCompressedPrecompiledFile(
+    std::span<const u8> file_data, Common::ThreadWorker& workers) {
+    PrecompiledHeader header{};
+    if (file_data.size() < sizeof(header)) {
         return std::nullopt;
     }
-
-    u32 code_size{};
-    if (!LoadObjectFromPrecompiled(code_size)) {
+    std::memcpy(&header, file_data.data(), sizeof(header));
+    if (header.magic != PRECOMPILED_MAGIC || header.version_hash != GetShaderCacheVersionHash()) {
+        LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
         return std::nullopt;
     }
 
-    std::string code(code_size, '\0');
-    if (!LoadArrayFromPrecompiled(code.data(), code.size())) {
+    if ((file_data.size() - sizeof(header)) / sizeof(PrecompiledChunk) < header.num_chunks) {
         return std::nullopt;
     }
+    std::vector<PrecompiledChunk> chunks(header.num_chunks);
+    const std::size_t index_size = chunks.size() * sizeof(PrecompiledChunk);
+    std::memcpy(chunks.data(), file_data.data() + sizeof(header), index_size);
 
-    ShaderDiskCacheDecompiled entry;
-    entry.result.code = std::move(code);
-    entry.sanitize_mul = sanitize_mul;
+    std::vector<std::span<const u8>> compressed_chunks;
+    std::size_t offset = sizeof(header) + index_size;
+    for (const PrecompiledChunk& chunk : chunks) {
+        if (file_data.size() - offset < chunk.compressed_size) {
+            return std::nullopt;
+        }
+        compressed_chunks.push_back(file_data.subspan(offset, chunk.compressed_size));
+        offset += chunk.compressed_size;
+    }
 
-    return entry;
+    struct LoadedChunk {
+        std::vector<u8> data;
+        ShaderDecompiledMap decompiled;
+        ShaderDumpsMap dumps;
+        bool valid = false;
+    };
+    std::vector<LoadedChunk> loaded(chunks.size());
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+        workers.QueueWork([&, i] {
+            LoadedChunk& chunk = loaded[i];
+            const std::span compressed_chunk = compressed_chunks[i];
+            chunk.data = Common::Compression::DecompressDataZSTD(
+                std::vector<u8>(compressed_chunk.begin(), compressed_chunk.end()));
+            chunk.valid = chunk.data.size() == chunks[i].size &&
+                          ParsePrecompiledEntries(chunk.data, chunk.decompiled, chunk.dumps);
+        });
+    }
+    workers.WaitForRequests();
+
+    ShaderDiskCachePrecompiled precompiled;
+    for (LoadedChunk& chunk : loaded) {
+        if (!chunk.valid) {
+            return std::nullopt;
+        }
+        precompiled.decompiled.merge(chunk.decompiled);
+        precompiled.dumps.merge(chunk.dumps);
+        precompiled.entries.insert(precompiled.entries.end(), chunk.data.begin(), chunk.data.end());
+        precompiled.chunk_ends.push_back(precompiled.entries.size());
+    }
+    return precompiled;
+}
+
+std::vector<u8> ShaderDiskCache::BuildCompressedPrecompiledFile(
+    std::span<const u8> entries, std::span<const std::size_t> chunk_ends) {
+    const PrecompiledHeader header{
+        .magic = PRECOMPILED_MAGIC,
+        .version_hash = GetShaderCacheVersionHash(),
+        .num_chunks = static_cast<u32>(chunk_ends.size()),
+    };
+    std::vector<PrecompiledChunk> chunks;
+    std::vector<std::vector<u8>> compressed_chunks;
+    std::size_t chunk_begin = 0;
+    for (const std::size_t chunk_end : chunk_ends) {
+        const std::vector<u8>& compressed =
+            compressed_chunks.emplace_back(Common::Compression::CompressDataZSTDDefault(
+                entries.data() + chunk_begin, chunk_end - chunk_begin));
+        chunks.push_back({
+            .size = static_cast<u32>(chunk_end - chunk_begin),
+            .compressed_size = static_cast<u32>(compressed.size()),
+        });
+        chunk_begin = chunk_end;
+    }
+
+    std::vector<u8> file_data(sizeof(header) + chunks.size() * sizeof(PrecompiledChunk));
+    std::memcpy(file_data.data(), &header, sizeof(header));
+    std::memcpy(file_data.data() + sizeof(header), chunks.data(),
+                chunks.size() * sizeof(PrecompiledChunk));
+    for (const std::vector<u8>& compressed : compressed_chunks) {
+        file_data.insert(file_data.end(), compressed.begin(), compressed.end());
+    }
+    return file_data;
 }
 
 void ShaderDiskCache::SaveDecompiledToFile(FileUtil::IOFile& file, u64 unique_identifier,
@@ -330,6 +485,7 @@ bool ShaderDiskCache::SaveDecompiledToCache(u64 unique_identifier,
         return false;
     }
 
+    EndPrecompiledEntry();
     return true;
 }
 
@@ -347,6 +503,7 @@ void ShaderDiskCache::InvalidateAll() {
 void ShaderDiskCache::InvalidatePrecompiled() {
     // Clear virtual precompiled cache file
     decompressed_precompiled_cache.resize(0);
+    precompiled_chunk_ends.clear();
 
     precompiled_file.Close();
     if (!FileUtil::Delete(GetPrecompiledPath())) {
@@ -381,10 +538,6 @@ void ShaderDiskCache::SaveDecompiled(u64 unique_identifier,
     if (!IsUsable())
         return;
 
-    if (decompressed_precompiled_cache.empty()) {
-        SavePrecompiledHeaderToVirtualPrecompiledCache();
-    }
-
     if (!SaveDecompiledToCache(unique_identifier, code, sanitize_mul)) {
         LOG_ERROR(Render_OpenGL,
                   "Failed to save decompiled entry to the precompiled file - removing");
@@ -413,6 +566,7 @@ void ShaderDiskCache::SaveDump(u64 unique_identifier, GLuint program) {
         InvalidatePrecompiled();
         return;
     }
+    EndPrecompiledEntry();
 }
 
 void ShaderDiskCache::SaveDumpToFile(u64 unique_identifier, GLuint program, bool sanitize_mul) {
@@ -496,19 +650,21 @@ FileUtil::IOFile ShaderDiskCache::AppendPrecompiledFile(bool write_header) {
     return file;
 }
 
-void ShaderDiskCache::SavePrecompiledHeaderToVirtualPrecompiledCache() {
-    const auto hash{GetShaderCacheVersionHash()};
-    if (!SaveArrayToPrecompiled(hash.data(), hash.size())) {
-        LOG_ERROR(
-            Render_OpenGL,
-            "Failed to write precompiled cache version hash to virtual precompiled cache file");
+void ShaderDiskCache::EndPrecompiledEntry() {
+    const std::size_t chunk_begin =
+        precompiled_chunk_ends.empty() ? 0 : precompiled_chunk_ends.back();
+    if (decompressed_precompiled_cache.size() - chunk_begin >= PRECOMPILED_CHUNK_SIZE) {
+        precompiled_chunk_ends.push_back(decompressed_precompiled_cache.size());
     }
 }
 
 void ShaderDiskCache::SaveVirtualPrecompiledFile() {
-    decompressed_precompiled_cache_offset = 0;
-    const std::vector<u8>& compressed = Common::Compression::CompressDataZSTDDefault(
-        decompressed_precompiled_cache.data(), decompressed_precompiled_cache.size());
+    std::vector<std::size_t> chunk_ends = precompiled_chunk_ends;
+    if (chunk_ends.empty() || chunk_ends.back() != decompressed_precompiled_cache.size()) {
+        chunk_ends.push_back(decompressed_precompiled_cache.size());
+    }
+    const std::vector<u8> file_data =
+        BuildCompressedPrecompiledFile(decompressed_precompiled_cache, chunk_ends);
 
     const auto precompiled_path{GetPrecompiledPath()};
 
@@ -518,9 +674,8 @@ void ShaderDiskCache::SaveVirtualPrecompiledFile() {
     }
     precompiled_file = AppendPrecompiledFile(!separable);
 
-    if (precompiled_file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
-        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                  precompiled_path);
+    if (precompiled_file.WriteBytes(file_data.data(), file_data.size()) != file_data.size()) {
+        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache in path={}", precompiled_path);
         return;
     }
 
@@ -8,6 +8,7 @@
 #include <array>
 #include <bitset>
 #include <optional>
+#include <span>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -19,6 +20,7 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
+#include "common/thread_worker.h"
 #include "video_core/regs.h"
 #include "video_core/renderer_opengl/gl_shader_decompiler.h"
 #include "video_core/renderer_opengl/gl_shader_gen.h"
@@ -41,6 +43,9 @@ using ProgramCode = std::vector<u32>;
 using ShaderDecompiledMap = std::unordered_map<u64, ShaderDiskCacheDecompiled>;
 using ShaderDumpsMap = std::unordered_map<u64, ShaderDiskCacheDump>;
 
+/// Returns the identifier of a shader in the disk cache.
+u64 GetUniqueIdentifier(const Pica::Regs& regs, const ProgramCode& code);
+
 /// Describes a shader how it's used by the guest GPU
 class ShaderDiskCacheRaw {
 public:
@@ -88,6 +93,14 @@ struct ShaderDiskCacheDump {
     std::vector<u8> binary;
 };
 
+/// Contains the entries of a compressed precompiled cache and the chunks they were parsed from
+struct ShaderDiskCachePrecompiled {
+    ShaderDecompiledMap decompiled;
+    ShaderDumpsMap dumps;
+    std::vector<u8> entries;             ///< Decompressed entries of all the chunks
+    std::vector<std::size_t> chunk_ends; ///< End offset of each chunk in entries
+};
+
 class ShaderDiskCache {
 public:
     explicit ShaderDiskCache(bool separable);
@@ -96,8 +109,10 @@ public:
     /// Loads transferable cache. If file has a old version or on failure, it deletes the file.
     std::optional<std::vector<ShaderDiskCacheRaw>> LoadTransferable();
 
-    /// Loads current game's precompiled cache. Invalidates on failure.
-    std::pair<ShaderDecompiledMap, ShaderDumpsMap> LoadPrecompiled(bool compressed);
+    /// Loads current game's precompiled cache. Invalidates on failure. The chunks of compressed
+    /// caches are decompressed and parsed in parallel on workers.
+    std::pair<ShaderDecompiledMap, ShaderDumpsMap> LoadPrecompiled(bool compressed,
+                                                                   Common::ThreadWorker& workers);
 
     /// Removes the transferable (and precompiled) cache file.
     void InvalidateAll();
@@ -121,14 +136,32 @@ public:
     /// Serializes virtual precompiled shader cache file to real file
     void SaveVirtualPrecompiledFile();
 
+    /// Reads all entries of a transferable file of the current version. Returns empty on failure.
+    static std::optional<std::vector<ShaderDiskCacheRaw>> ReadTransferableFile(
+        FileUtil::IOFile& file);
+
+    /// Writes a transferable file of the current version holding the entries.
+    static bool WriteTransferableFile(FileUtil::IOFile& file,
+                                      std::span<const ShaderDiskCacheRaw> raws);
+
+    /// Parses a compressed precompiled file of the current version, decompressing and parsing its
+    /// chunks in parallel on workers. Returns empty on failure.
+    static std::optional<ShaderDiskCachePrecompiled> ReadCompressedPrecompiledFile(
+        std::span<const u8> file_data, Common::ThreadWorker& workers);
+
+    /// Builds a compressed precompiled file of the current version holding the entries, split in a
+    /// chunk ending at each of chunk_ends.
+    static std::vector<u8> BuildCompressedPrecompiledFile(std::span<const u8> entries,
+                                                          std::span<const std::size_t> chunk_ends);
+
 private:
-    /// Loads the transferable cache. Returns empty on failure.
+    /// Loads the precompiled cache. Returns empty on failure.
     std::optional<std::pair<ShaderDecompiledMap, ShaderDumpsMap>> LoadPrecompiledFile(
-        FileUtil::IOFile& file, bool compressed);
+        FileUtil::IOFile& file, bool compressed, Common::ThreadWorker& workers);
 
-    /// Loads a decompiled cache entry from m_precompiled_cache_virtual_file. Returns empty on
-    /// failure.
-    std::optional<ShaderDiskCacheDecompiled> LoadDecompiledEntry();
+    /// Reads the entries following the version of a transferable file. Returns false on failure.
+    static bool ReadTransferableEntries(FileUtil::IOFile& file,
+                                        std::vector<ShaderDiskCacheRaw>& raws);
 
     /// Saves a decompiled entry to the passed file. Does not check for collisions.
     void SaveDecompiledToFile(FileUtil::IOFile& file, u64 unique_identifier,
@@ -147,8 +180,8 @@ private:
     /// Opens current game's precompiled file and write it's header if it doesn't exist
     FileUtil::IOFile AppendPrecompiledFile(bool write_header);
 
-    /// Save precompiled header to precompiled_cache_in_memory
-    void SavePrecompiledHeaderToVirtualPrecompiledCache();
+    /// Ends the chunk of the virtual precompiled cache once it is large enough
+    void EndPrecompiledEntry();
 
     /// Create shader disk cache directories. Returns true on success.
     bool EnsureDirectories() const;
@@ -181,16 +214,6 @@ private:
         const u8* data_view = reinterpret_cast<const u8*>(data);
         decompressed_precompiled_cache.insert(decompressed_precompiled_cache.end(), &data_view[0],
                                               &data_view[length * sizeof(T)]);
-        decompressed_precompiled_cache_offset += length * sizeof(T);
-        return true;
-    }
-
-    template <typename T>
-    bool LoadArrayFromPrecompiled(T* data, std::size_t length) {
-        u8* data_view = reinterpret_cast<u8*>(data);
-        std::copy_n(decompressed_precompiled_cache.data() + decompressed_precompiled_cache_offset,
-                    length * sizeof(T), data_view);
-        decompressed_precompiled_cache_offset += length * sizeof(T);
         return true;
     }
 
@@ -204,16 +227,12 @@ private:
         return SaveArrayToPrecompiled(&value, 1);
     }
 
-    template <typename T>
-    bool LoadObjectFromPrecompiled(T& object) {
-        return LoadArrayFromPrecompiled(&object, 1);
-    }
-
-    // Stores whole precompiled cache which will be read from or saved to the precompiled cache
-    // file
+    // Stores the entries of the whole precompiled cache which will be read from or saved to the
+    // precompiled cache file
     std::vector<u8> decompressed_precompiled_cache;
-    // Stores the current offset of the precompiled cache file for IO purposes
-    std::size_t decompressed_precompiled_cache_offset = 0;
+    // Stores the end offsets of the chunks the precompiled cache file is compressed in, except for
+    // the last one
+    std::vector<std::size_t> precompiled_chunk_ends;
 
     // Stored transferable shaders
     std::unordered_map<u64, ShaderDiskCacheRaw> transferable;
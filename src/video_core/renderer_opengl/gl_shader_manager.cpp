@@ -3,11 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <numeric>
 #include <set>
 #include <thread>
 #include <unordered_map>
 #include <variant>
 #include "common/scope_exit.h"
+#include "common/thread_worker.h"
 #include "core/frontend/emu_window.h"
 #include "video_core/renderer_opengl/gl_driver.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
@@ -19,19 +21,6 @@
 
 namespace OpenGL {
 
-static u64 GetUniqueIdentifier(const Pica::Regs& regs, const ProgramCode& code) {
-    std::size_t hash = 0;
-    u64 regs_uid = Common::ComputeHash64(regs.reg_array.data(), Pica::Regs::NUM_REGS * sizeof(u32));
-    hash = Common::HashCombine(hash, regs_uid);
-
-    if (code.size() > 0) {
-        u64 code_uid = Common::ComputeHash64(code.data(), code.size() * sizeof(u32));
-        hash = Common::HashCombine(hash, code_uid);
-    }
-
-    return hash;
-}
-
 static OGLProgram GeneratePrecompiledProgram(const ShaderDiskCacheDump& dump,
                                              const std::set<GLenum>& supported_formats,
                                              bool separable) {
@@ -87,6 +76,31 @@ static std::tuple<PicaVSConfig, Pica::Shader::ShaderSetup> BuildVSConfigFromRaw(
     return {PicaVSConfig{raw.GetRawShaderConfig().vs, setup}, setup};
 }
 
+/// A shader of the transferable cache, prepared on a worker thread for its upload to the driver
+struct PreparedShader {
+    std::variant<std::monostate, PicaVSConfig, PicaFSConfig> config;
+    /// Generated GLSL, for shaders that are built from source
+    std::optional<ShaderDecompiler::ProgramResult> result;
+};
+
+static PreparedShader PrepareShader(const ShaderDiskCacheRaw& raw, bool generate, bool separable) {
+    PreparedShader shader;
+    if (raw.GetProgramType() == ProgramType::VS) {
+        auto [conf, setup] = BuildVSConfigFromRaw(raw);
+        if (generate) {
+            shader.result = GenerateVertexShader(setup, conf, separable);
+        }
+        shader.config = conf;
+    } else if (raw.GetProgramType() == ProgramType::FS) {
+        PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
+        if (generate) {
+            shader.result = GenerateFragmentShader(conf, separable);
+        }
+        shader.config = conf;
+    }
+    return shader;
+}
+
 static void SetShaderUniformBlockBinding(GLuint shader, const char* name,
                                          Pica::Shader::UniformBindings binding,
                                          std::size_t expected_size) {
@@ -470,9 +484,14 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
     }
     const auto& raws = *transferable;
 
+    // The precompiled cache is decompressed and the GLSL of the shaders is generated on the
+    // workers, only the uploads to the driver are done on this thread.
+    const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
+    Common::ThreadWorker workers(num_workers, "GLShaderLoader");
+
     // Load uncompressed precompiled file for non-separable shaders.
     // Precompiled file for separable shaders is compressed.
-    auto [decompiled, dumps] = disk_cache.LoadPrecompiled(impl->separable);
+    auto [decompiled, dumps] = disk_cache.LoadPrecompiled(impl->separable, workers);
 
     if (stop_loading) {
         return;
@@ -484,85 +503,10 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
     // virtual precompiled cache file back to the hard drive
     bool precompiled_cache_altered = false;
 
-    std::mutex mutex;
     std::atomic_bool compilation_failed = false;
     if (callback) {
         callback(VideoCore::LoadCallbackStage::Decompile, 0, raws.size());
     }
-    std::vector<std::size_t> load_raws_index;
-    // Loads both decompiled and precompiled shaders from the cache. If either one is missing for
-    const auto LoadPrecompiledShader = [&](std::size_t begin, std::size_t end,
-                                           const std::vector<ShaderDiskCacheRaw>& raw_cache,
-                                           const ShaderDecompiledMap& decompiled_map,
-                                           const ShaderDumpsMap& dump_map) {
-        for (std::size_t i = begin; i < end; ++i) {
-            if (stop_loading || compilation_failed) {
-                return;
-            }
-            const auto& raw{raw_cache[i]};
-            const u64 unique_identifier{raw.GetUniqueIdentifier()};
-
-            const u64 calculated_hash =
-                GetUniqueIdentifier(raw.GetRawShaderConfig(), raw.GetProgramCode());
-            if (unique_identifier != calculated_hash) {
-                LOG_ERROR(Render_OpenGL,
-                          "Invalid hash in entry={:016x} (obtained hash={:016x}) - removing "
-                          "shader cache",
-                          raw.GetUniqueIdentifier(), calculated_hash);
-                disk_cache.InvalidateAll();
-                return;
-            }
-
-            const auto dump{dump_map.find(unique_identifier)};
-            const auto decomp{decompiled_map.find(unique_identifier)};
-
-            OGLProgram shader;
-
-            if (dump != dump_map.end() && decomp != decompiled_map.end()) {
-                // Only load the vertex shader if its sanitize_mul setting matches
-                if (raw.GetProgramType() == ProgramType::VS &&
-                    decomp->second.sanitize_mul != VideoCore::g_hw_shader_accurate_mul) {
-                    continue;
-                }
-
-                // If the shader is dumped, attempt to load it
-                shader =
-                    GeneratePrecompiledProgram(dump->second, supported_formats, impl->separable);
-                if (shader.handle == 0) {
-                    // If any shader failed, stop trying to compile, delete the cache, and start
-                    // loading from raws
-                    compilation_failed = true;
-                    return;
-                }
-                // we have both the binary shader and the decompiled, so inject it into the
-                // cache
-                if (raw.GetProgramType() == ProgramType::VS) {
-                    auto [conf, setup] = BuildVSConfigFromRaw(raw);
-                    std::scoped_lock lock(mutex);
-                    impl->programmable_vertex_shaders.Inject(conf, decomp->second.result.code,
-                                                             std::move(shader));
-                } else if (raw.GetProgramType() == ProgramType::FS) {
-                    PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
-                    std::scoped_lock lock(mutex);
-                    impl->fragment_shaders.Inject(conf, std::move(shader));
-                } else {
-                    // Unsupported shader type got stored somehow so nuke the cache
-
-                    LOG_CRITICAL(Frontend, "failed to load raw ProgramType {}",
-                                 raw.GetProgramType());
-                    compilation_failed = true;
-                    return;
-                }
-            } else {
-                // Since precompiled didn't have the dump, we'll load them in the next phase
-                std::scoped_lock lock(mutex);
-                load_raws_index.push_back(i);
-            }
-            if (callback) {
-                callback(VideoCore::LoadCallbackStage::Decompile, i, raw_cache.size());
-            }
-        }
-    };
 
     const auto LoadPrecompiledProgram = [&](const ShaderDecompiledMap& decompiled_map,
                                             const ShaderDumpsMap& dump_map) {
@@ -597,29 +541,129 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
-    if (impl->separable) {
-        LoadPrecompiledShader(0, raws.size(), raws, decompiled, dumps);
-    } else {
+    // TODO(SachinV): Skip loading raws until we implement a proper way to link non-seperable
+    // shaders.
+    if (!impl->separable) {
         LoadPrecompiledProgram(decompiled, dumps);
+        if (compilation_failed) {
+            // Invalidate the precompiled cache if a shader dumped shader was rejected
+            impl->program_cache.clear();
+            disk_cache.InvalidatePrecompiled();
+        }
+        return;
+    }
+
+    const auto HasPrecompiled = [&](u64 unique_identifier) {
+        return dumps.contains(unique_identifier) && decompiled.contains(unique_identifier);
+    };
+
+    // Check the entries and build their configs on the workers, along with the GLSL of the
+    // shaders missing from the precompiled cache
+    std::vector<PreparedShader> prepared(raws.size());
+    std::atomic_bool invalid_raw = false;
+    std::mutex mutex;
+    std::size_t decompiled_shaders = 0;
+    for (std::size_t i = 0; i < raws.size(); ++i) {
+        workers.QueueWork([&, i] {
+            if (stop_loading || invalid_raw) {
+                return;
+            }
+            const auto& raw{raws[i]};
+            const u64 calculated_hash =
+                GetUniqueIdentifier(raw.GetRawShaderConfig(), raw.GetProgramCode());
+            if (raw.GetUniqueIdentifier() != calculated_hash) {
+                LOG_ERROR(Render_OpenGL,
+                          "Invalid hash in entry={:016x} (obtained hash={:016x}) - removing "
+                          "shader cache",
+                          raw.GetUniqueIdentifier(), calculated_hash);
+                invalid_raw = true;
+                return;
+            }
+            const bool generate = !HasPrecompiled(raw.GetUniqueIdentifier());
+            prepared[i] = PrepareShader(raw, generate, impl->separable);
+
+            std::scoped_lock lock(mutex);
+            if (callback) {
+                callback(VideoCore::LoadCallbackStage::Decompile, ++decompiled_shaders,
+                         raws.size());
+            }
+        });
+    }
+    workers.WaitForRequests();
+
+    if (invalid_raw) {
+        disk_cache.InvalidateAll();
+        return;
+    }
+    if (stop_loading) {
+        return;
+    }
+
+    // Upload the shaders that have both the binary and the decompiled code to the driver
+    std::vector<std::size_t> load_raws_index;
+    for (std::size_t i = 0; i < raws.size(); ++i) {
+        if (stop_loading) {
+            return;
+        }
+        const auto& raw{raws[i]};
+        const u64 unique_identifier{raw.GetUniqueIdentifier()};
+        if (!HasPrecompiled(unique_identifier)) {
+            // Since precompiled didn't have the dump, we'll load them in the next phase
+            load_raws_index.push_back(i);
+            continue;
+        }
+
+        // Only load the vertex shader if its sanitize_mul setting matches
+        const auto& decomp = decompiled.at(unique_identifier);
+        if (raw.GetProgramType() == ProgramType::VS &&
+            decomp.sanitize_mul != VideoCore::g_hw_shader_accurate_mul) {
+            continue;
+        }
+
+        // If the shader is dumped, attempt to load it
+        OGLProgram shader = GeneratePrecompiledProgram(dumps.at(unique_identifier),
+                                                       supported_formats, impl->separable);
+        if (shader.handle == 0) {
+            // If any shader failed, stop trying to compile, delete the cache, and start
+            // loading from raws
+            compilation_failed = true;
+            break;
+        }
+        if (const auto* conf = std::get_if<PicaVSConfig>(&prepared[i].config)) {
+            impl->programmable_vertex_shaders.Inject(*conf, decomp.result.code, std::move(shader));
+        } else if (const auto* conf = std::get_if<PicaFSConfig>(&prepared[i].config)) {
+            impl->fragment_shaders.Inject(*conf, std::move(shader));
+        } else {
+            // Unsupported shader type got stored somehow so nuke the cache
+            LOG_CRITICAL(Frontend, "failed to load raw ProgramType {}", raw.GetProgramType());
+            compilation_failed = true;
+            break;
+        }
     }
 
-    bool load_all_raws = false;
     if (compilation_failed) {
         // Invalidate the precompiled cache if a shader dumped shader was rejected
-        impl->program_cache.clear();
         disk_cache.InvalidatePrecompiled();
         dumps.clear();
         precompiled_cache_altered = true;
-        load_all_raws = true;
-    }
-    // TODO(SachinV): Skip loading raws until we implement a proper way to link non-seperable
-    // shaders.
-    if (!impl->separable) {
-        return;
-    }
 
-    const std::size_t load_raws_size = load_all_raws ? raws.size() : load_raws_index.size();
+        // Generate the GLSL of the shaders that were expected to be loaded from binaries
+        load_raws_index.resize(raws.size());
+        std::iota(load_raws_index.begin(), load_raws_index.end(), std::size_t{0});
+        for (std::size_t i = 0; i < raws.size(); ++i) {
+            if (prepared[i].result) {
+                continue;
+            }
+            workers.QueueWork([&, i] {
+                if (!stop_loading) {
+                    prepared[i] = PrepareShader(raws[i], true, impl->separable);
+                }
+            });
+        }
+        workers.WaitForRequests();
+    }
 
+    const std::size_t load_raws_size = load_raws_index.size();
     if (callback) {
         callback(VideoCore::LoadCallbackStage::Build, 0, load_raws_size);
     }
@@ -628,39 +672,37 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
 
     std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
     const auto LoadRawSepareble = [&](std::size_t begin, std::size_t end,
-                                      Frontend::GraphicsContext* context = nullptr) {
+                                      Frontend::GraphicsContext* context) {
         const auto scope = context->Acquire();
         for (std::size_t i = begin; i < end; ++i) {
             if (stop_loading || compilation_failed) {
                 return;
             }
-
-            const std::size_t raws_index = load_all_raws ? i : load_raws_index[i];
+            const std::size_t raws_index = load_raws_index[i];
             const auto& raw{raws[raws_index]};
-            const u64 unique_identifier{raw.GetUniqueIdentifier()};
+            auto& [config, result] = prepared[raws_index];
 
+            // Build the shader from the GLSL generated on the workers and save the result to the
+            // precompiled file
             bool sanitize_mul = false;
             GLuint handle{0};
-            std::optional<ShaderDecompiler::ProgramResult> result;
-            // Otherwise decompile and build the shader at boot and save the result to the
-            // precompiled file
-            if (raw.GetProgramType() == ProgramType::VS) {
-                auto [conf, setup] = BuildVSConfigFromRaw(raw);
-                result = GenerateVertexShader(setup, conf, impl->separable);
-                OGLShaderStage stage{impl->separable};
-                stage.Create(result->code.c_str(), GL_VERTEX_SHADER);
-                handle = stage.GetHandle();
-                sanitize_mul = conf.state.sanitize_mul;
-                std::scoped_lock lock(mutex);
-                impl->programmable_vertex_shaders.Inject(conf, result->code, std::move(stage));
-            } else if (raw.GetProgramType() == ProgramType::FS) {
-                PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
-                result = GenerateFragmentShader(conf, impl->separable);
+            if (const auto* conf = std::get_if<PicaVSConfig>(&config)) {
+                // The decompilation of the program may have failed
+                if (result) {
+                    OGLShaderStage stage{impl->separable};
+                    stage.Create(result->code.c_str(), GL_VERTEX_SHADER);
+                    handle = stage.GetHandle();
+                    sanitize_mul = conf->state.sanitize_mul;
+                    std::scoped_lock lock(mutex);
+                    impl->programmable_vertex_shaders.Inject(*conf, result->code,
+                                                             std::move(stage));
+                }
+            } else if (const auto* conf = std::get_if<PicaFSConfig>(&config)) {
                 OGLShaderStage stage{impl->separable};
                 stage.Create(result->code.c_str(), GL_FRAGMENT_SHADER);
                 handle = stage.GetHandle();
                 std::scoped_lock lock(mutex);
-                impl->fragment_shaders.Inject(conf, std::move(stage));
+                impl->fragment_shaders.Inject(*conf, std::move(stage));
             } else {
                 // Unsupported shader type got stored somehow so nuke the cache
                 LOG_ERROR(Frontend, "failed to load raw ProgramType {}", raw.GetProgramType());
@@ -676,11 +718,9 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
 
             std::scoped_lock lock(mutex);
             // If this is a new separable shader, add it the precompiled cache
-            if (result) {
-                disk_cache.SaveDecompiled(unique_identifier, *result, sanitize_mul);
-                disk_cache.SaveDump(unique_identifier, handle);
-                precompiled_cache_altered = true;
-            }
+            disk_cache.SaveDecompiled(raw.GetUniqueIdentifier(), *result, sanitize_mul);
+            disk_cache.SaveDump(raw.GetUniqueIdentifier(), handle);
+            precompiled_cache_altered = true;
 
             if (callback) {
                 callback(VideoCore::LoadCallbackStage::Build, ++built_shaders, load_raws_size);
@@ -688,17 +728,19 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
+    // Drivers compile GLSL much slower than it is generated, so the shaders are compiled on
+    // several shared contexts where the frontend allows it
     if (!strict_context_required) {
-        const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
-        const std::size_t bucket_size{load_raws_size / num_workers};
-        std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts(num_workers);
-        std::vector<std::thread> threads(num_workers);
+        const std::size_t num_contexts{std::max(1U, std::thread::hardware_concurrency())};
+        const std::size_t bucket_size{load_raws_size / num_contexts};
+        std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts(num_contexts);
+        std::vector<std::thread> threads(num_contexts);
 
         emu_window.SaveContext();
-        for (std::size_t i = 0; i < num_workers; ++i) {
-            const bool is_last_worker = i + 1 == num_workers;
+        for (std::size_t i = 0; i < num_contexts; ++i) {
+            const bool is_last_context = i + 1 == num_contexts;
             const std::size_t start{bucket_size * i};
-            const std::size_t end{is_last_worker ? load_raws_size : start + bucket_size};
+            const std::size_t end{is_last_context ? load_raws_size : start + bucket_size};
 
             // On some platforms the shared context has to be created from the GUI thread
             contexts[i] = emu_window.CreateSharedContext();
@@ -8,13 +8,14 @@
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
+#include "core/core.h"
+#include "core/loader/loader.h"
 #include "video_core/renderer_vulkan/pica_to_vk.h"
 #include "video_core/renderer_vulkan/vk_descriptor_manager.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
-#include "video_core/renderer_vulkan/vk_shader_gen_spv.h"
 #include "video_core/renderer_vulkan/vk_shader_util.h"
 
 MICROPROFILE_DEFINE(Vulkan_Pipeline, "Vulkan", "Pipeline Building", MP_RGB(0, 192, 32));
@@ -389,7 +390,8 @@ PipelineCache::~PipelineCache() {
     device.destroyPipelineCache(pipeline_cache);
 }
 
-void PipelineCache::LoadDiskCache() {
+void PipelineCache::LoadDiskCache(const std::atomic_bool& stop_loading,
+                                  const VideoCore::DiskResourceLoadCallback& callback) {
     if (!Settings::values.use_disk_shader_cache || !EnsureDirectories()) {
         return;
     }
@@ -422,6 +424,21 @@ void PipelineCache::LoadDiskCache() {
 
     vk::Device device = instance.GetDevice();
     pipeline_cache = device.createPipelineCache(cache_info);
+
+    // Skip games without title id
+    u64 program_id{};
+    if (Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id) !=
+            Loader::ResultStatus::Success ||
+        program_id == 0) {
+        return;
+    }
+
+    shader_disk_cache = std::make_unique<ShaderDiskCache>(
+        ShaderDiskCache::GetTitlePath(program_id), ShaderDiskCache::MakeDeviceHash(instance));
+    for (ShaderDiskCacheEntry& entry :
+         shader_disk_cache->Load(shader_workers, stop_loading, callback)) {
+        spirv_cache.emplace(entry.key, std::move(entry.spirv));
+    }
 }
 
 void PipelineCache::SaveDiskCache() {
@@ -527,12 +544,7 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::Regs& regs,
 
         if (new_program) {
             shader.program = std::move(program);
-            const vk::Device device = instance.GetDevice();
-            shader_workers.QueueWork([device, &shader] {
-                shader.module = Compile(shader.program, vk::ShaderStageFlagBits::eVertex, device,
-                                        ShaderOptimization::Normal);
-                shader.MarkDone();
-            });
+            BuildShader(shader, ShaderDiskCacheEntry::Make(config, setup), shader.program);
         }
 
         it->second = &shader;
@@ -566,13 +578,7 @@ bool PipelineCache::UseFixedGeometryShader(const Pica::Regs& regs) {
     auto& shader = it->second;
 
     if (new_shader) {
-        const vk::Device device = instance.GetDevice();
-        shader_workers.QueueWork([gs_config, device, &shader]() {
-            const std::string code = GenerateFixedGeometryShader(gs_config);
-            shader.module = Compile(code, vk::ShaderStageFlagBits::eGeometry, device,
-                                    ShaderOptimization::Normal);
-            shader.MarkDone();
-        });
+        BuildShader(shader, ShaderDiskCacheEntry::Make(gs_config));
     }
 
     current_shaders[ProgramType::GS] = &shader;
@@ -593,27 +599,38 @@ void PipelineCache::UseFragmentShader(const Pica::Regs& regs) {
     auto& shader = it->second;
 
     if (new_shader) {
-        const bool use_spirv = Settings::values.spirv_shader_gen.GetValue();
-        const vk::Device device = instance.GetDevice();
-
-        if (use_spirv && !config.state.shadow_rendering.Value()) {
-            const std::vector code = GenerateFragmentShaderSPV(config);
-            shader.module = CompileSPV(code, device);
-            shader.MarkDone();
-        } else {
-            shader_workers.QueueWork([config, device, &shader]() {
-                const std::string code = GenerateFragmentShader(config);
-                shader.module = Compile(code, vk::ShaderStageFlagBits::eFragment, device,
-                                        ShaderOptimization::Debug);
-                shader.MarkDone();
-            });
-        }
+        const bool use_spirv = Settings::values.spirv_shader_gen.GetValue() &&
+                               !config.state.shadow_rendering.Value();
+        BuildShader(shader, ShaderDiskCacheEntry::Make(config, use_spirv));
     }
 
     current_shaders[ProgramType::FS] = &shader;
     shader_hashes[ProgramType::FS] = config.Hash();
 }
 
+void PipelineCache::BuildShader(Shader& shader, ShaderDiskCacheEntry entry, std::string glsl) {
+    const vk::Device device = instance.GetDevice();
+    if (const auto it = spirv_cache.find(entry.key); it != spirv_cache.end()) {
+        shader.module = CompileSPV(it->second, device);
+        shader.MarkDone();
+        return;
+    }
+
+    shader_workers.QueueWork([this, device, &shader, entry = std::move(entry),
+                              glsl = std::move(glsl)]() mutable {
+        if (glsl.empty() ? entry.Generate() : entry.Compile(glsl)) {
+            shader.module = CompileSPV(entry.spirv, device);
+            if (shader_disk_cache) {
+                shader_disk_cache->Append(entry);
+            }
+        } else {
+            LOG_ERROR(Render_Vulkan, "Failed to generate shader of kind {}",
+                      static_cast<u32>(entry.kind));
+        }
+        shader.MarkDone();
+    });
+}
+
 void PipelineCache::BindTexture(u32 binding, vk::ImageView image_view, vk::Sampler sampler) {
     const vk::DescriptorImageInfo image_info = {
         .sampler = sampler,
@@ -10,7 +10,9 @@
 #include "common/hash.h"
 #include "common/thread_worker.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
+#include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_vulkan/vk_common.h"
+#include "video_core/renderer_vulkan/vk_shader_disk_cache.h"
 #include "video_core/renderer_vulkan/vk_shader_gen.h"
 
 namespace Pica {
@@ -210,8 +212,9 @@ public:
                   DescriptorManager& desc_manager);
     ~PipelineCache();
 
-    /// Loads the pipeline cache stored to disk
-    void LoadDiskCache();
+    /// Loads the pipeline cache and the SPIR-V of the current title stored to disk
+    void LoadDiskCache(const std::atomic_bool& stop_loading,
+                       const VideoCore::DiskResourceLoadCallback& callback);
 
     /// Stores the generated pipeline cache to disk
     void SaveDiskCache();
@@ -254,6 +257,13 @@ private:
     /// Applies dynamic pipeline state to the current command buffer
     void ApplyDynamic(const PipelineInfo& info, bool is_dirty);
 
+    /**
+     * Creates the module of a shader from the SPIR-V cache, or queues the generation of its
+     * SPIR-V on the shader workers and adds the result to the cache. GLSL that was already
+     * generated for the shader is compiled as is rather than generated again.
+     */
+    void BuildShader(Shader& shader, ShaderDiskCacheEntry entry, std::string glsl = {});
+
     /// Builds the rasterizer pipeline layout
     void BuildLayout();
 
@@ -273,6 +283,8 @@ private:
     DescriptorManager& desc_manager;
 
     vk::PipelineCache pipeline_cache;
+    // Outlives the shader workers, which append to it
+    std::unique_ptr<ShaderDiskCache> shader_disk_cache;
     std::size_t num_worker_threads;
     Common::ThreadWorker shader_workers;
     Common::ThreadWorker pipeline_workers;
@@ -294,6 +306,7 @@ private:
     std::unordered_map<PicaFixedGSConfig, Shader> fixed_geometry_shaders;
     std::unordered_map<PicaFSConfig, Shader> fragment_shaders;
     Shader trivial_vertex_shader;
+    std::unordered_map<u64, std::vector<u32>> spirv_cache;
 };
 
 } // namespace Vulkan
@@ -139,7 +139,7 @@ void RasterizerVulkan::TickFrame() {
 
 void RasterizerVulkan::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
-    pipeline_cache.LoadDiskCache();
+    pipeline_cache.LoadDiskCache(stop_loading, callback);
 }
 
 void RasterizerVulkan::SyncFixedState() {
@@ -755,6 +755,11 @@ void RasterizerVulkan::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
 
+VideoCore::Kernels::IndexRange RasterizerVulkan::GetIndexRange(PAddr addr, u32 count,
+                                                               bool index_u16) {
+    return res_cache.GetIndexRange(addr, count, index_u16);
+}
+
 bool RasterizerVulkan::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
     return res_cache.AccelerateDisplayTransfer(config);
 }
@@ -62,6 +62,8 @@ public:
 
 private:
     void NotifyFixedFunctionPicaRegisterChanged(u32 id) override;
+    VideoCore::Kernels::IndexRange GetIndexRange(PAddr addr, u32 count,
+                                                 bool index_u16) override;
 
     /// Syncs the clip enabled status to match the PICA register
     void SyncClipEnabled();
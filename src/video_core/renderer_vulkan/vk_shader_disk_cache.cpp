@@ -0,0 +1,417 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <fmt/format.h>
+#include "common/common_paths.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/zstd_compression.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_shader_disk_cache.h"
+#include "video_core/renderer_vulkan/vk_shader_gen_spv.h"
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+#include "video_core/shader/shader.h"
+
+namespace Vulkan {
+
+namespace {
+
+constexpr std::array<char, 4> FILE_MAGIC{'C', 'S', 'P', 'V'};
+
+// Bump when the layout of the entries or of the Pica*Config structs changes, as their bytes are
+// stored as they are
+constexpr u32 FILE_VERSION = 2;
+
+constexpr u32 SPIRV_MAGIC = 0x07230203;
+
+constexpr std::size_t PROGRAM_SIZE =
+    Pica::Shader::MAX_PROGRAM_CODE_LENGTH + Pica::Shader::MAX_SWIZZLE_DATA_LENGTH;
+
+struct FileHeader {
+    std::array<char, 4> magic;
+    u32 version;
+    std::array<char, 64> revision;
+    u64 device_hash;
+};
+static_assert(sizeof(FileHeader) == 80);
+
+struct EntryHeader {
+    u64 key;
+    ShaderKind kind;
+    u32 config_size;
+    u32 program_size; ///< In words
+    u32 spirv_size;   ///< In words
+    u32 compressed_size;
+    u32 reserved;
+};
+static_assert(sizeof(EntryHeader) == 32);
+
+FileHeader MakeFileHeader(u64 device_hash) {
+    FileHeader header{
+        .magic = FILE_MAGIC,
+        .version = FILE_VERSION,
+        .revision = {},
+        .device_hash = device_hash,
+    };
+    const std::size_t length =
+        std::min(std::strlen(Common::g_shader_cache_version), header.revision.size());
+    std::memcpy(header.revision.data(), Common::g_shader_cache_version, length);
+    return header;
+}
+
+bool IsSPIRV(std::span<const u32> code) {
+    return !code.empty() && code[0] == SPIRV_MAGIC;
+}
+
+template <typename Config>
+std::vector<u8> ConfigBytes(const Config& config) {
+    std::vector<u8> bytes(sizeof(Config));
+    std::memcpy(bytes.data(), &config, sizeof(Config));
+    return bytes;
+}
+
+template <typename Config>
+std::optional<Config> ReadConfig(const std::vector<u8>& bytes) {
+    if (bytes.size() != sizeof(Config)) {
+        return std::nullopt;
+    }
+    Config config;
+    std::memcpy(&config, bytes.data(), sizeof(Config));
+    return config;
+}
+
+/// Decompresses an entry. Its SPIR-V is only kept when it was generated by this build.
+bool DecodeEntry(const EntryHeader& header, std::span<const u8> payload, bool keep_spirv,
+                 ShaderDiskCacheEntry& entry) {
+    const std::size_t program_bytes = header.program_size * sizeof(u32);
+    const std::size_t spirv_bytes = header.spirv_size * sizeof(u32);
+    const std::vector<u8> data = Common::Compression::DecompressDataZSTD(
+        std::vector<u8>(payload.begin(), payload.end()));
+    if (data.size() != header.config_size + program_bytes + spirv_bytes) {
+        return false;
+    }
+
+    const u8* pointer = data.data();
+    entry.kind = header.kind;
+    entry.key = header.key;
+    entry.config.assign(pointer, pointer + header.config_size);
+    pointer += header.config_size;
+    entry.program.resize(header.program_size);
+    std::memcpy(entry.program.data(), pointer, program_bytes);
+    pointer += program_bytes;
+    if (keep_spirv) {
+        entry.spirv.resize(header.spirv_size);
+        std::memcpy(entry.spirv.data(), pointer, spirv_bytes);
+    }
+    return true;
+}
+
+} // Anonymous namespace
+
+ShaderDiskCacheEntry ShaderDiskCacheEntry::Make(const PicaVSConfig& config,
+                                                const Pica::Shader::ShaderSetup& setup) {
+    ShaderDiskCacheEntry entry{
+        .kind = ShaderKind::Vertex,
+        .key = MakeKey(ShaderKind::Vertex, config.Hash(), config.use_clip_planes),
+        .config = ConfigBytes(config),
+    };
+    entry.program.reserve(PROGRAM_SIZE);
+    entry.program.insert(entry.program.end(), setup.program_code.begin(),
+                         setup.program_code.end());
+    entry.program.insert(entry.program.end(), setup.swizzle_data.begin(),
+                         setup.swizzle_data.end());
+    return entry;
+}
+
+ShaderDiskCacheEntry ShaderDiskCacheEntry::Make(const PicaFixedGSConfig& config) {
+    return {
+        .kind = ShaderKind::Geometry,
+        .key = MakeKey(ShaderKind::Geometry, config.Hash(), config.use_clip_planes),
+        .config = ConfigBytes(config),
+    };
+}
+
+ShaderDiskCacheEntry ShaderDiskCacheEntry::Make(const PicaFSConfig& config, bool use_spirv_gen) {
+    const ShaderKind kind = use_spirv_gen ? ShaderKind::FragmentSPV : ShaderKind::Fragment;
+    return {
+        .kind = kind,
+        .key = MakeKey(kind, config.Hash(), false),
+        .config = ConfigBytes(config),
+    };
+}
+
+u64 ShaderDiskCacheEntry::MakeKey(ShaderKind kind, u64 config_hash, bool use_clip_planes) {
+    const u64 key = Common::HashCombine(static_cast<u64>(kind), config_hash);
+    return Common::HashCombine(key, static_cast<u64>(use_clip_planes));
+}
+
+bool ShaderDiskCacheEntry::Generate() {
+    spirv.clear();
+    switch (kind) {
+    case ShaderKind::Vertex: {
+        const auto vs_config = ReadConfig<PicaVSConfig>(config);
+        if (!vs_config || program.size() != PROGRAM_SIZE) {
+            return false;
+        }
+        auto setup = std::make_unique<Pica::Shader::ShaderSetup>();
+        const auto swizzle_begin = program.begin() + Pica::Shader::MAX_PROGRAM_CODE_LENGTH;
+        std::copy(program.begin(), swizzle_begin, setup->program_code.begin());
+        std::copy(swizzle_begin, program.end(), setup->swizzle_data.begin());
+        const auto code = GenerateVertexShader(*setup, *vs_config);
+        return code && Compile(*code);
+    }
+    case ShaderKind::Geometry: {
+        const auto gs_config = ReadConfig<PicaFixedGSConfig>(config);
+        if (!gs_config) {
+            return false;
+        }
+        return Compile(GenerateFixedGeometryShader(*gs_config));
+    }
+    case ShaderKind::Fragment: {
+        const auto fs_config = ReadConfig<PicaFSConfig>(config);
+        if (!fs_config) {
+            return false;
+        }
+        return Compile(GenerateFragmentShader(*fs_config));
+    }
+    case ShaderKind::FragmentSPV: {
+        const auto fs_config = ReadConfig<PicaFSConfig>(config);
+        if (!fs_config) {
+            return false;
+        }
+        spirv = GenerateFragmentShaderSPV(*fs_config);
+        break;
+    }
+    default:
+        return false;
+    }
+    return IsSPIRV(spirv);
+}
+
+bool ShaderDiskCacheEntry::Compile(const std::string& glsl) {
+    spirv.clear();
+    switch (kind) {
+    case ShaderKind::Vertex:
+        spirv =
+            CompileGLSLtoSPV(glsl, vk::ShaderStageFlagBits::eVertex, ShaderOptimization::Normal);
+        break;
+    case ShaderKind::Geometry:
+        spirv =
+            CompileGLSLtoSPV(glsl, vk::ShaderStageFlagBits::eGeometry, ShaderOptimization::Normal);
+        break;
+    case ShaderKind::Fragment:
+        spirv =
+            CompileGLSLtoSPV(glsl, vk::ShaderStageFlagBits::eFragment, ShaderOptimization::Debug);
+        break;
+    default:
+        return false;
+    }
+    return IsSPIRV(spirv);
+}
+
+ShaderDiskCache::ShaderDiskCache(std::string path_, std::optional<u64> device_hash_)
+    : path{std::move(path_)}, device_hash{device_hash_} {}
+
+ShaderDiskCache::~ShaderDiskCache() = default;
+
+std::string ShaderDiskCache::GetTitlePath(u64 program_id) {
+    return fmt::format("{}vulkan{}spirv{}{:016X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir), DIR_SEP, DIR_SEP,
+                       program_id);
+}
+
+u64 ShaderDiskCache::MakeDeviceHash(const Instance& instance) {
+    // The features are those the shader generators query from the instance
+    const std::array<u32, 4> device{
+        instance.GetVendorID(),
+        static_cast<u32>(instance.GetDriverID()),
+        instance.GetDriverVersion(),
+        static_cast<u32>(instance.IsShaderClipDistanceSupported()),
+    };
+    return Common::ComputeStructHash64(device);
+}
+
+std::vector<ShaderDiskCacheEntry> ShaderDiskCache::Load(
+    Common::ThreadWorker& workers, const std::atomic_bool& stop_loading,
+    const VideoCore::DiskResourceLoadCallback& callback, bool force_generate) {
+    std::vector<u8> data;
+    {
+        std::scoped_lock lock{mutex};
+        file.Close();
+        FileUtil::IOFile in_file{path, "rb"};
+        if (!in_file.IsOpen() || in_file.GetSize() == 0) {
+            return {};
+        }
+        data.resize(in_file.GetSize());
+        if (in_file.ReadBytes(data.data(), data.size()) != data.size()) {
+            LOG_ERROR(Render_Vulkan, "Failed to read SPIR-V cache {}", path);
+            return {};
+        }
+    }
+
+    FileHeader header{};
+    if (data.size() >= sizeof(header)) {
+        std::memcpy(&header, data.data(), sizeof(header));
+    }
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION) {
+        LOG_INFO(Render_Vulkan, "SPIR-V cache {} has an unsupported format - removing", path);
+        FileUtil::Delete(path);
+        return {};
+    }
+    if (!device_hash) {
+        device_hash = header.device_hash;
+    } else if (header.device_hash != *device_hash) {
+        // The shaders may use features that this device does not have
+        LOG_INFO(Render_Vulkan, "SPIR-V cache {} was generated for another device - removing",
+                 path);
+        FileUtil::Delete(path);
+        return {};
+    }
+    const bool up_to_date =
+        header.revision == MakeFileHeader(*device_hash).revision && !force_generate;
+
+    std::vector<EntryHeader> headers;
+    std::vector<std::span<const u8>> payloads;
+    std::size_t offset = sizeof(header);
+    while (data.size() - offset >= sizeof(EntryHeader)) {
+        EntryHeader& entry_header = headers.emplace_back();
+        std::memcpy(&entry_header, data.data() + offset, sizeof(EntryHeader));
+        offset += sizeof(EntryHeader);
+        if (entry_header.compressed_size > data.size() - offset) {
+            // The emulator was closed while an entry was being written
+            headers.pop_back();
+            break;
+        }
+        payloads.emplace_back(data.data() + offset, entry_header.compressed_size);
+        offset += entry_header.compressed_size;
+    }
+
+    const std::size_t num_entries = headers.size();
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Build, 0, num_entries);
+    }
+
+    std::vector<ShaderDiskCacheEntry> entries(num_entries);
+    std::unique_ptr<bool[]> valid = std::make_unique<bool[]>(num_entries);
+    for (std::size_t i = 0; i < num_entries; i++) {
+        workers.QueueWork([&, i] {
+            if (stop_loading) {
+                return;
+            }
+            if (!DecodeEntry(headers[i], payloads[i], up_to_date, entries[i])) {
+                return;
+            }
+            valid[i] = up_to_date ? IsSPIRV(entries[i].spirv) : entries[i].Generate();
+        });
+    }
+    workers.WaitForRequests();
+    if (stop_loading) {
+        return {};
+    }
+
+    const std::size_t num_valid = std::count(valid.get(), valid.get() + num_entries, true);
+    if (num_valid != num_entries) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < num_entries; i++) {
+            if (valid[i]) {
+                entries[kept++] = std::move(entries[i]);
+            }
+        }
+        entries.resize(kept);
+        LOG_WARNING(Render_Vulkan, "Dropped {} invalid entries of SPIR-V cache {}",
+                    num_entries - num_valid, path);
+    }
+    if (!up_to_date || num_valid != num_entries || offset != data.size()) {
+        LOG_INFO(Render_Vulkan, "Rewriting SPIR-V cache {} with {} shaders", path, num_valid);
+        Save(entries);
+    }
+
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Complete, num_entries, num_entries);
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} shaders from SPIR-V cache {}", entries.size(), path);
+    return entries;
+}
+
+void ShaderDiskCache::Append(const ShaderDiskCacheEntry& entry) {
+    std::scoped_lock lock{mutex};
+    if (!OpenForAppend() || !WriteEntry(entry)) {
+        LOG_ERROR(Render_Vulkan, "Failed to write to SPIR-V cache {}", path);
+        file.Close();
+        return;
+    }
+    file.Flush();
+}
+
+bool ShaderDiskCache::Save(std::span<const ShaderDiskCacheEntry> entries) {
+    std::scoped_lock lock{mutex};
+    file.Close();
+    if (!FileUtil::CreateFullPath(path)) {
+        return false;
+    }
+
+    FileUtil::IOFile out_file{path, "wb"};
+    const FileHeader header = MakeFileHeader(device_hash.value_or(0));
+    if (out_file.WriteObject(header) != 1) {
+        LOG_ERROR(Render_Vulkan, "Failed to write SPIR-V cache {}", path);
+        return false;
+    }
+    file.Swap(out_file);
+    for (const ShaderDiskCacheEntry& entry : entries) {
+        if (!WriteEntry(entry)) {
+            LOG_ERROR(Render_Vulkan, "Failed to write SPIR-V cache {}", path);
+            file.Close();
+            FileUtil::Delete(path);
+            return false;
+        }
+    }
+    // Reopened for appending on the next write
+    file.Close();
+    return true;
+}
+
+bool ShaderDiskCache::OpenForAppend() {
+    if (file.IsOpen()) {
+        return true;
+    }
+    if (!FileUtil::CreateFullPath(path)) {
+        return false;
+    }
+    file = FileUtil::IOFile{path, "ab"};
+    if (!file.IsOpen()) {
+        return false;
+    }
+    return file.GetSize() != 0 || file.WriteObject(MakeFileHeader(device_hash.value_or(0))) == 1;
+}
+
+bool ShaderDiskCache::WriteEntry(const ShaderDiskCacheEntry& entry) {
+    std::vector<u8> payload(entry.config);
+    const auto append = [&payload](const std::vector<u32>& words) {
+        const u8* bytes = reinterpret_cast<const u8*>(words.data());
+        payload.insert(payload.end(), bytes, bytes + words.size() * sizeof(u32));
+    };
+    append(entry.program);
+    append(entry.spirv);
+
+    const std::vector<u8> compressed =
+        Common::Compression::CompressDataZSTDDefault(payload.data(), payload.size());
+    const EntryHeader header{
+        .key = entry.key,
+        .kind = entry.kind,
+        .config_size = static_cast<u32>(entry.config.size()),
+        .program_size = static_cast<u32>(entry.program.size()),
+        .spirv_size = static_cast<u32>(entry.spirv.size()),
+        .compressed_size = static_cast<u32>(compressed.size()),
+        .reserved = 0,
+    };
+    return file.WriteObject(header) == 1 &&
+           file.WriteBytes(compressed.data(), compressed.size()) == compressed.size();
+}
+
+} // namespace Vulkan
@@ -0,0 +1,124 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/thread_worker.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_vulkan/vk_shader_gen.h"
+
+namespace Pica::Shader {
+struct ShaderSetup;
+}
+
+namespace Vulkan {
+
+class Instance;
+
+/// The generator a cached SPIR-V module was produced by.
+enum class ShaderKind : u32 {
+    Vertex,      ///< GenerateVertexShader, compiled by glslang
+    Geometry,    ///< GenerateFixedGeometryShader, compiled by glslang
+    Fragment,    ///< GenerateFragmentShader, compiled by glslang
+    FragmentSPV, ///< GenerateFragmentShaderSPV
+};
+
+/**
+ * A generated shader along with the configuration it was generated from. The configuration is
+ * enough to generate the shader again without a GPU, so entries written by another build of the
+ * emulator can be brought up to date.
+ */
+struct ShaderDiskCacheEntry {
+    ShaderKind kind;
+    u64 key;
+    std::vector<u8> config;   ///< Bytes of the Pica*Config of the shader
+    std::vector<u32> program; ///< Program code and swizzle data of vertex shaders
+    std::vector<u32> spirv;
+
+    static ShaderDiskCacheEntry Make(const PicaVSConfig& config,
+                                     const Pica::Shader::ShaderSetup& setup);
+    static ShaderDiskCacheEntry Make(const PicaFixedGSConfig& config);
+    static ShaderDiskCacheEntry Make(const PicaFSConfig& config, bool use_spirv_gen);
+
+    /**
+     * Returns the key of the shader generated by kind from a config with the given hash. Whether
+     * the shader writes clip distances is kept apart from the hash of the config, so it is passed
+     * separately.
+     */
+    static u64 MakeKey(ShaderKind kind, u64 config_hash, bool use_clip_planes);
+
+    /**
+     * Generates the SPIR-V of the entry from its configuration. Returns false on failure. No
+     * device is needed, so this also works outside of the emulator.
+     */
+    bool Generate();
+
+    /**
+     * Compiles the GLSL of the entry, already generated from its configuration, to SPIR-V.
+     * Returns false on failure or for kinds that are not generated as GLSL.
+     */
+    bool Compile(const std::string& glsl);
+};
+
+/**
+ * Per-title store of the SPIR-V generated for the Vulkan renderer, so that shaders are not
+ * generated and compiled by glslang again on every launch.
+ *
+ * The file starts with a header holding the build revision and a hash of the device the shaders
+ * were generated for, followed by entries that are each compressed with zstd and appended as
+ * shaders are generated. Entries from another revision are regenerated from their configuration
+ * when the file is loaded, while files of another device are dropped.
+ */
+class ShaderDiskCache {
+public:
+    /**
+     * @param device_hash Hash of the device the shaders are generated for, from MakeDeviceHash.
+     * Without it, the device of the file is kept, as its configurations were recorded for it.
+     */
+    explicit ShaderDiskCache(std::string path, std::optional<u64> device_hash = std::nullopt);
+    ~ShaderDiskCache();
+
+    /// Returns the path of the cache of the title with the given program ID.
+    static std::string GetTitlePath(u64 program_id);
+
+    /// Returns a hash of the device properties and features that the generated shaders depend on.
+    static u64 MakeDeviceHash(const Instance& instance);
+
+    /**
+     * Loads all entries, decompressing or regenerating them in parallel on workers. The file is
+     * rewritten when any entry had to be regenerated or dropped.
+     * @param force_generate Generates all entries again, even if they are up to date.
+     */
+    std::vector<ShaderDiskCacheEntry> Load(Common::ThreadWorker& workers,
+                                           const std::atomic_bool& stop_loading,
+                                           const VideoCore::DiskResourceLoadCallback& callback,
+                                           bool force_generate = false);
+
+    /// Appends a generated shader to the file. May be called from any thread.
+    void Append(const ShaderDiskCacheEntry& entry);
+
+    /// Replaces the contents of the file with the entries.
+    bool Save(std::span<const ShaderDiskCacheEntry> entries);
+
+private:
+    /// Opens the file for appending, writing the header if it is empty.
+    bool OpenForAppend();
+
+    bool WriteEntry(const ShaderDiskCacheEntry& entry);
+
+    std::string path;
+    std::optional<u64> device_hash;
+    std::mutex mutex;
+    FileUtil::IOFile file;
+};
+
+} // namespace Vulkan
@@ -1498,8 +1498,11 @@ vec4 secondary_fragment_color = vec4(0.0);
         // Blend the fog
         out += "last_tex_env_out.rgb = mix(fog_color.rgb, last_tex_env_out.rgb, fog_factor);\n";
     } else if (state.fog_mode == TexturingRegs::FogMode::Gas) {
-        Core::System::GetInstance().TelemetrySession().AddField(
-            Common::Telemetry::FieldType::Session, "VideoCore_Pica_UseGasMode", true);
+        // Shaders are also generated outside of the emulator, by the SPIR-V cache builder
+        if (auto& system = Core::System::GetInstance(); system.IsPoweredOn()) {
+            system.TelemetrySession().AddField(Common::Telemetry::FieldType::Session,
+                                               "VideoCore_Pica_UseGasMode", true);
+        }
         LOG_CRITICAL(Render_OpenGL, "Unimplemented gas mode");
         out += "discard; }";
         return out;
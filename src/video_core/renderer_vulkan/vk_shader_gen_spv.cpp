@@ -198,8 +198,11 @@ void FragmentModule::WriteFog() {
 
 void FragmentModule::WriteGas() {
     // TODO: Implement me
-    Core::System::GetInstance().TelemetrySession().AddField(Common::Telemetry::FieldType::Session,
-                                                            "VideoCore_Pica_UseGasMode", true);
+    // Shaders are also generated outside of the emulator, by the SPIR-V cache builder
+    if (auto& system = Core::System::GetInstance(); system.IsPoweredOn()) {
+        system.TelemetrySession().AddField(Common::Telemetry::FieldType::Session,
+                                           "VideoCore_Pica_UseGasMode", true);
+    }
     LOG_CRITICAL(Render_Vulkan, "Unimplemented gas mode");
     OpKill();
     OpFunctionEnd();
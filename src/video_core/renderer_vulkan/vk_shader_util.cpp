@@ -141,27 +141,22 @@ EShLanguage ToEshShaderStage(vk::ShaderStageFlagBits stage) {
 }
 
 bool InitializeCompiler() {
-    static bool glslang_initialized = false;
-
-    if (glslang_initialized) {
+    // Shaders are compiled on several threads, which must not initialize glslang twice
+    static const bool glslang_initialized = [] {
+        if (!glslang::InitializeProcess()) {
+            LOG_CRITICAL(Render_Vulkan, "Failed to initialize glslang shader compiler");
+            return false;
+        }
+        std::atexit([]() { glslang::FinalizeProcess(); });
         return true;
-    }
-
-    if (!glslang::InitializeProcess()) {
-        LOG_CRITICAL(Render_Vulkan, "Failed to initialize glslang shader compiler");
-        return false;
-    }
-
-    std::atexit([]() { glslang::FinalizeProcess(); });
-
-    glslang_initialized = true;
-    return true;
+    }();
+    return glslang_initialized;
 }
 
-vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
-                         ShaderOptimization level) {
+std::vector<u32> CompileGLSLtoSPV(std::string_view code, vk::ShaderStageFlagBits stage,
+                                  ShaderOptimization level) {
     if (!InitializeCompiler()) {
-        return VK_NULL_HANDLE;
+        return {};
     }
 
     EProfile profile = ECoreProfile;
@@ -184,7 +179,7 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
         LOG_INFO(Render_Vulkan, "Shader Info Log:\n{}\n{}", shader->getInfoLog(),
                  shader->getInfoDebugLog());
         fmt::print("{}", code);
-        return VK_NULL_HANDLE;
+        return {};
     }
 
     // Even though there's only a single shader, we still need to link it to generate SPV
@@ -193,7 +188,7 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
     if (!program->link(messages)) {
         LOG_INFO(Render_Vulkan, "Program Info Log:\n{}\n{}", program->getInfoLog(),
                  program->getInfoDebugLog());
-        return VK_NULL_HANDLE;
+        return {};
     }
 
     glslang::TIntermediate* intermediate = program->getIntermediate(lang);
@@ -223,7 +218,16 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
         LOG_INFO(Render_Vulkan, "SPIR-V conversion messages: {}", spv_messages);
     }
 
-    return CompileSPV(out_code, device);
+    return out_code;
+}
+
+vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
+                         ShaderOptimization level) {
+    const std::vector<u32> spirv = CompileGLSLtoSPV(code, stage, level);
+    if (spirv.empty()) {
+        return VK_NULL_HANDLE;
+    }
+    return CompileSPV(spirv, device);
 }
 
 vk::ShaderModule CompileSPV(std::span<const u32> code, vk::Device device) {
@@ -5,12 +5,18 @@
 #pragma once
 
 #include <span>
+#include <string_view>
+#include <vector>
 #include "video_core/renderer_vulkan/vk_common.h"
 
 namespace Vulkan {
 
 enum class ShaderOptimization { Normal = 0, Debug = 1 };
 
+/// Compiles GLSL to SPIR-V, which needs no device. Returns an empty vector on failure.
+std::vector<u32> CompileGLSLtoSPV(std::string_view code, vk::ShaderStageFlagBits stage,
+                                  ShaderOptimization level);
+
 vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
                          ShaderOptimization level);
 